@@ -0,0 +1,173 @@
+--
+-- PostgreSQL login schema, mirrors sql/mysql/login/schema.sql
+--
+
+DROP TABLE IF EXISTS login_history, survey_results, suspensions, bans, guild_characters,
+	guilds, characters, patches, operating_systems, locales, architectures,
+	ip_bans, realms, schema_history, users CASCADE;
+
+CREATE TABLE users (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	username varchar(255) NOT NULL UNIQUE,
+	s bytea NOT NULL,
+	v varchar(255) NOT NULL,
+	creation_date timestamp NOT NULL DEFAULT CURRENT_TIMESTAMP,
+	email varchar(255) NOT NULL UNIQUE,
+	verified boolean DEFAULT false,
+	subscriber boolean NOT NULL DEFAULT true,
+	survey_request boolean NOT NULL DEFAULT false,
+	pin_method integer NOT NULL DEFAULT 0,
+	pin integer DEFAULT NULL,
+	totp_key varchar(45) DEFAULT NULL
+);
+
+CREATE TABLE bans (
+	user_id integer PRIMARY KEY REFERENCES users (id),
+	by_id integer NOT NULL REFERENCES users (id),
+	date timestamp NOT NULL DEFAULT CURRENT_TIMESTAMP,
+	reason text NOT NULL
+);
+
+CREATE INDEX banned_by_idx ON bans (by_id);
+
+CREATE TABLE suspensions (
+	user_id integer PRIMARY KEY REFERENCES users (id) ON DELETE CASCADE ON UPDATE CASCADE,
+	by_id integer NOT NULL REFERENCES users (id) ON DELETE CASCADE ON UPDATE CASCADE,
+	start_date timestamp NOT NULL DEFAULT CURRENT_TIMESTAMP,
+	end_date timestamp NOT NULL,
+	reason text NOT NULL
+);
+
+CREATE INDEX suspended_by_idx ON suspensions (by_id);
+
+CREATE TABLE login_history (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	user_id integer NOT NULL REFERENCES users (id) ON DELETE CASCADE ON UPDATE CASCADE,
+	ip varchar(45) NOT NULL,
+	date timestamp NOT NULL DEFAULT CURRENT_TIMESTAMP
+);
+
+CREATE INDEX login_history_user_idx ON login_history (user_id);
+
+CREATE TABLE realms (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	name varchar(45) NOT NULL,
+	ip varchar(45) NOT NULL,
+	type integer NOT NULL,
+	flags integer NOT NULL,
+	population real NOT NULL,
+	creation_setting smallint NOT NULL,
+	category integer NOT NULL DEFAULT 1,
+	region integer NOT NULL DEFAULT 1,
+	port integer NOT NULL
+);
+
+CREATE TABLE characters (
+	id bigint GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	account_id integer NOT NULL REFERENCES users (id) ON DELETE CASCADE ON UPDATE CASCADE,
+	realm_id integer NOT NULL REFERENCES realms (id) ON DELETE CASCADE ON UPDATE CASCADE,
+	name varchar(45) NOT NULL,
+	internal_name varchar(45) NOT NULL,
+	deletion_date timestamp DEFAULT NULL,
+	race smallint NOT NULL,
+	class smallint NOT NULL,
+	gender smallint NOT NULL,
+	skin smallint NOT NULL,
+	face smallint NOT NULL,
+	hairstyle smallint NOT NULL,
+	haircolour smallint NOT NULL,
+	facialhair smallint NOT NULL,
+	level smallint NOT NULL,
+	zone integer NOT NULL,
+	map integer NOT NULL,
+	x real NOT NULL,
+	y real NOT NULL,
+	z real NOT NULL,
+	o real NOT NULL,
+	flags integer NOT NULL,
+	first_login integer NOT NULL,
+	pet_display integer NOT NULL,
+	pet_level integer NOT NULL,
+	pet_family integer NOT NULL
+);
+
+COMMENT ON COLUMN characters.deletion_date IS 'Kept as NULL unless the character has been soft deleted, allowing deleted characters to share names';
+
+-- names only need to be unique amongst characters that haven't been deleted
+CREATE UNIQUE INDEX char_name_unique ON characters (realm_id, internal_name) WHERE deletion_date IS NULL;
+CREATE INDEX account_ref_idx ON characters (account_id);
+CREATE INDEX realm_ref_idx ON characters (realm_id);
+
+CREATE TABLE guilds (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	realm_id integer NOT NULL REFERENCES realms (id),
+	name varchar(45) NOT NULL,
+	UNIQUE (realm_id, name)
+);
+
+CREATE TABLE guild_characters (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	character_id bigint NOT NULL UNIQUE REFERENCES characters (id) ON DELETE CASCADE ON UPDATE CASCADE,
+	guild_id integer NOT NULL REFERENCES guilds (id) ON DELETE CASCADE ON UPDATE CASCADE,
+	rank integer NOT NULL
+);
+
+CREATE INDEX guild_ref_idx ON guild_characters (guild_id);
+
+CREATE TABLE ip_bans (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	ip varchar(45) NOT NULL,
+	cidr integer NOT NULL,
+	reason varchar(255) DEFAULT NULL
+);
+
+CREATE INDEX ip_bans_ip_idx ON ip_bans (ip);
+
+CREATE TABLE architectures (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	value varchar(45) NOT NULL UNIQUE
+);
+
+CREATE TABLE locales (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	value varchar(45) NOT NULL UNIQUE
+);
+
+CREATE TABLE operating_systems (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	value varchar(45) NOT NULL UNIQUE
+);
+
+CREATE TABLE patches (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	name varchar(255) NOT NULL,
+	locale integer DEFAULT NULL REFERENCES locales (id) ON DELETE CASCADE ON UPDATE CASCADE,
+	architecture integer DEFAULT NULL REFERENCES architectures (id) ON DELETE CASCADE ON UPDATE CASCADE,
+	os integer DEFAULT NULL REFERENCES operating_systems (id) ON DELETE CASCADE ON UPDATE CASCADE,
+	"from" integer NOT NULL,
+	"to" integer NOT NULL,
+	md5 varchar(255) DEFAULT NULL,
+	size bigint DEFAULT 0,
+	mpq boolean NOT NULL DEFAULT false,
+	rollup boolean NOT NULL DEFAULT false,
+	UNIQUE ("from", "to")
+);
+
+CREATE TABLE schema_history (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	core_version varchar(45) NOT NULL,
+	commit varchar(45) NOT NULL,
+	install_date timestamp NOT NULL,
+	installed_by varchar(45) NOT NULL,
+	file varchar(255) NOT NULL
+);
+
+CREATE TABLE survey_results (
+	id integer GENERATED BY DEFAULT AS IDENTITY PRIMARY KEY,
+	survey_id integer NOT NULL,
+	data text
+);
+
+-- Default realm
+INSERT INTO realms (name, ip, type, flags, population, creation_setting, category, region, port)
+	VALUES ('Ember', '127.0.0.1', 1, 0, 0, 0, 1, 3, 3724);
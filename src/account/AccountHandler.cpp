@@ -8,31 +8,74 @@
 
 #include "AccountHandler.h"
 #include <shared/threading/ThreadPool.h>
+#include <algorithm>
+#include <utility>
+#include <cctype>
 
 namespace ember {
 
-AccountHandler::AccountHandler(dal::UserDAO& user_dao, ThreadPool& pool)
+AccountHandler::AccountHandler(dal::UserDAO& user_dao, ThreadPool& pool, CacheConfig cache)
 	: user_dao_(user_dao),
-	  pool_(pool) {}
+	  pool_(pool),
+	  ids_(cache.capacity, cache.ttl) {}
 
-std::optional<std::uint32_t> AccountHandler::lookup_id(const std::string& username) {
+std::string AccountHandler::normalise(std::string username) {
+	std::ranges::transform(username, username.begin(), [](const unsigned char c) {
+		return std::toupper(c);
+	});
+
+	return username;
+}
+
+/*
+ * Only successful lookups are cached, so an account that's created after
+ * a failed lookup will be found without having to wait out the TTL
+ */
+std::optional<std::uint32_t> AccountHandler::fetch_id(const std::string& username) {
 	const auto user = user_dao_.user(username);
 	
 	if(!user) {
 		return std::nullopt;
 	}
 
+	ids_.put(normalise(username), user->id());
 	return user->id();
 }
 
+std::optional<std::uint32_t> AccountHandler::lookup_id(const std::string& username) {
+	if(const auto id = ids_.get(normalise(username))) {
+		return id;
+	}
+
+	return fetch_id(username);
+}
+
 void AccountHandler::lookup_id(const std::string& username, LookupCB cb) {
+	// avoid the trip through the thread pool if it's already cached
+	if(const auto id = ids_.get(normalise(username))) {
+		cb(id);
+		return;
+	}
+
 	pool_.run([=, this]() {
 		try {
-			cb(lookup_id(username));
+			cb(fetch_id(username));
 		} catch(std::exception&) {
 			cb(std::unexpected(false));
 		}
-	});
+	}, ThreadPool::Priority::HIGH);
+}
+
+void AccountHandler::invalidate(const std::string& username) {
+	ids_.erase(normalise(username));
+}
+
+void AccountHandler::invalidate_all() {
+	ids_.clear();
+}
+
+AccountHandler::Cache::Stats AccountHandler::cache_stats() const {
+	return ids_.stats();
 }
 
-} // ember
\ No newline at end of file
+} // ember
@@ -9,10 +9,13 @@
 #pragma once
 
 #include <shared/database/daos/UserDAO.h>
+#include <shared/utility/LRUCache.h>
+#include <chrono>
 #include <expected>
 #include <functional>
 #include <optional>
 #include <string>
+#include <cstddef>
 #include <cstdint>
 
 namespace ember {
@@ -24,16 +27,37 @@ public:
 	// temp. unexpected type
 	using LookupCB = std::function<void(std::expected<std::optional<std::uint32_t>, bool>)>;
 
+	struct CacheConfig {
+		std::size_t capacity;
+		std::chrono::seconds ttl;
+	};
+
+	using Cache = LRUCache<std::string, std::uint32_t>;
+
 private:
 	dal::UserDAO& user_dao_;
 	ThreadPool& pool_;
 
+	// usernames are cached in uppercase, matching dal::User
+	Cache ids_;
+
+	static std::string normalise(std::string username);
+	std::optional<std::uint32_t> fetch_id(const std::string& username);
+
 public:
-	AccountHandler(dal::UserDAO& user_dao, ThreadPool& pool);
+	AccountHandler(dal::UserDAO& user_dao, ThreadPool& pool, CacheConfig cache);
 
 	std::optional<std::uint32_t> lookup_id(const std::string& username);
 	void lookup_id(const std::string& username, LookupCB cb);
 
+	/*
+	 * A deleted or renamed account's name can be registered again with a
+	 * new ID, so cached names must be dropped when that happens
+	 */
+	void invalidate(const std::string& username);
+	void invalidate_all();
+
+	Cache::Stats cache_stats() const;
 };
 
-} // ember
\ No newline at end of file
+} // ember
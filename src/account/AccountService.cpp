@@ -45,11 +45,9 @@ AccountService::handle_session_fetch(const SessionLookup& msg, const Link& link,
 		return response;
 	}
 
-	auto key = Botan::BigInt::encode(*session);
-
 	response.status = Status::OK;
 	response.account_id = msg.account_id();
-	response.key = std::move(key);
+	response.key.assign(session->begin(), session->end());
 	return response;
 }
 
@@ -62,7 +60,7 @@ AccountService::handle_register_session(const RegisterSession& msg,	const Link&
 	};
 
 	if(msg.key() && msg.account_id()) {
-		Botan::BigInt key(msg.key()->data(), msg.key()->size());
+		const std::span key(msg.key()->data(), msg.key()->size());
 
 		if(!sessions_.register_session(msg.account_id(), key)) {
 			response.status = Status::ALREADY_LOGGED_IN;
@@ -119,4 +117,52 @@ AccountService::handle_disconnect_by_id(const DisconnectID& msg, const Link& lin
 	return std::nullopt; 
 }
 
+/*
+ * Combines the account ID and session lookups, saving the gateway a round
+ * trip on every authentication
+ */
+std::optional<SessionByNameResponseT>
+AccountService::handle_locate_session_by_name(const LocateSessionByName& msg, const Link& link, const Token& token) {
+	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
+
+	if(!msg.account_name()) {
+		return SessionByNameResponseT {
+			.status = Status::ILLFORMED_MESSAGE
+		};
+	}
+
+	locate_session(msg.account_name()->str(), link, token, true);
+	return std::nullopt;
+}
+
+void AccountService::locate_session(const std::string& username, const Link& link,
+                                    const Token& token, const bool retry) {
+	handler_.lookup_id(username, [&, username, link, token, retry](auto result) {
+		SessionByNameResponseT response;
+
+		if(!result) {
+			response.status = Status::UNKNOWN_ERROR;
+		} else if(!*result) {
+			response.status = Status::ACCOUNT_NOT_FOUND;
+		} else if(const auto key = sessions_.lookup_session(**result)) {
+			response.status = Status::OK;
+			response.account_id = **result;
+			response.key.assign(key->begin(), key->end());
+		} else if(retry) {
+			/*
+			 * The cached ID might belong to an account that's since been
+			 * deleted and had its name registered again, so check the DB
+			 */
+			handler_.invalidate(username);
+			locate_session(username, link, token, false);
+			return;
+		} else {
+			response.status = Status::SESSION_NOT_FOUND;
+			response.account_id = **result;
+		}
+
+		send(response, link, token);
+	});
+}
+
 } // ember
\ No newline at end of file
@@ -45,6 +45,14 @@ class AccountService final : public services::AccountService {
 		const spark::Link& link,
 		const spark::Token& token) override;
 
+	std::optional<rpc::Account::SessionByNameResponseT> handle_locate_session_by_name(
+		const rpc::Account::LocateSessionByName& msg,
+		const spark::Link& link,
+		const spark::Token& token) override;
+
+	void locate_session(const std::string& username, const spark::Link& link,
+	                    const spark::Token& token, bool retry);
+
 	void on_link_up(const spark::Link& link) override;
 	void on_link_down(const spark::Link& link) override;
 
@@ -16,14 +16,20 @@
 #include <conpool/Policies.h>
 #include <conpool/drivers/AutoSelect.h>
 #include <shared/database/daos/UserDAO.h>
+#include <shared/metrics/CounterDelta.h>
 #include <shared/metrics/MetricsImpl.h>
+#include <shared/metrics/MetricsPoll.h>
 #include <shared/metrics/Monitor.h>
 #include <shared/threading/ThreadPool.h>
 #include <shared/threading/Utility.h>
 #include <spark/Server.h>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
 #include <exception>
+#include <memory>
 #include <semaphore>
+#include <string>
 #include <string_view>
 #include <thread>
 #include <cstddef>
@@ -44,6 +50,10 @@ void launch(const po::variables_map& args,
             log::Logger& logger);
 
 void pool_log_callback(ep::Severity, std::string_view message, log::Logger& logger);
+void schedule_purge(boost::asio::steady_timer& timer, Sessions& sessions, log::Logger& logger);
+void install_cache_commands(Monitor& monitor, AccountHandler& handler, log::Logger& logger);
+
+constexpr auto SESSION_PURGE_INTERVAL = 60s;
 
 /*
  * Starts ASIO worker threads, blocking until the launch thread exits
@@ -105,17 +115,80 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	auto user_dao = dal::user_dao(pool);
 
 	LOG_INFO(logger) << "Initialising account handler..." << LOG_SYNC; 
-	AccountHandler handler(user_dao, thread_pool);
+	AccountHandler handler(user_dao, thread_pool, {
+		.capacity = args["cache.capacity"].as<std::size_t>(),
+		.ttl = std::chrono::seconds(args["cache.ttl"].as<std::uint32_t>())
+	});
 
 	LOG_INFO(logger) << "Starting RPC services..." << LOG_SYNC;
 	const auto& s_address = args["spark.address"].as<std::string>();
 	auto s_port = args["spark.port"].as<std::uint16_t>();
 
-	Sessions sessions(true);
+	const auto session_ttl = std::chrono::seconds(args["sessions.ttl"].as<std::uint32_t>());
+	const auto& snapshot = args["sessions.snapshot_path"].as<std::string>();
+	Sessions sessions(true, session_ttl);
+
+	if(!snapshot.empty()) {
+		const auto loaded = sessions.load(snapshot);
+		LOG_INFO_SYNC(logger, "Restored {} sessions from {}", loaded, snapshot);
+	}
+
+	boost::asio::steady_timer purge_timer(service);
+
+	if(session_ttl != 0s) {
+		schedule_purge(purge_timer, sessions, logger);
+	}
 
 	spark::Server spark(service, "account", s_address, s_port, logger);
 	AccountService acct_service(spark, handler, sessions, logger);
 
+	auto metrics = std::make_unique<Metrics>();
+
+	if(args["metrics.enabled"].as<bool>()) {
+		LOG_INFO(logger) << "Starting metrics service..." << LOG_SYNC;
+		metrics = std::make_unique<MetricsImpl>(
+			service, args["metrics.statsd_host"].as<std::string>(),
+			args["metrics.statsd_port"].as<std::uint16_t>()
+		);
+	}
+
+	// Start monitoring service
+	std::unique_ptr<Monitor> monitor;
+
+	if(args["monitor.enabled"].as<bool>()) {
+		LOG_INFO(logger) << "Starting monitoring service..." << LOG_SYNC;
+
+		monitor = std::make_unique<Monitor>(
+			service, args["monitor.interface"].as<std::string>(),
+			args["monitor.port"].as<std::uint16_t>()
+		);
+
+		install_cache_commands(*monitor, handler, logger);
+	}
+
+	MetricsPoll poller(service, *metrics);
+
+	poller.add_source([&handler, hits = CounterDelta(), misses = CounterDelta(),
+	                   evictions = CounterDelta()](Metrics& metrics) mutable {
+		const auto stats = handler.cache_stats();
+		const auto new_hits = hits(stats.hits);
+		const auto new_misses = misses(stats.misses);
+		const auto lookups = new_hits + new_misses;
+		metrics.gauge("account_cache_size", stats.size);
+		metrics.increment("account_cache_hits", new_hits);
+		metrics.increment("account_cache_misses", new_misses);
+		metrics.increment("account_cache_evictions", evictions(stats.evictions));
+
+		// over the last interval rather than since startup
+		if(lookups) {
+			metrics.gauge("account_cache_hit_ratio", new_hits * 100 / lookups);
+		}
+	}, 5s);
+
+	poller.add_source([&sessions](Metrics& metrics) {
+		metrics.gauge("account_sessions", sessions.size());
+	}, 5s);
+
 	service.dispatch([&]() {
 		LOG_INFO_SYNC(logger, "{} started successfully", APP_NAME);
 	});
@@ -123,6 +196,11 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	sem.acquire();
 
 	LOG_INFO_SYNC(logger, "{} shutting down...", APP_NAME);
+
+	if(!snapshot.empty()) {
+		sessions.save(snapshot);
+		LOG_INFO_SYNC(logger, "Saved {} sessions to {}", sessions.size(), snapshot);
+	}
 } catch(...) {
 	eptr = std::current_exception();
 }
@@ -131,6 +209,19 @@ void stop() {
 	stop_flag.release();
 }
 
+/*
+ * Accounts are deleted & renamed outside of the account service, so
+ * sending 'accounts flush' to the monitor afterwards ensures that a
+ * reused name isn't resolved to its old account ID
+ */
+void install_cache_commands(Monitor& monitor, AccountHandler& handler, log::Logger& logger) {
+	monitor.add_command("accounts flush", [&]() -> std::string {
+		handler.invalidate_all();
+		LOG_INFO_ASYNC(logger, "Account cache flushed by monitor command");
+		return "OK";
+	});
+}
+
 po::options_description options() {
 	po::options_description opts;
 	opts.add_options()
@@ -158,6 +249,10 @@ po::options_description options() {
 		("database.config_path", po::value<std::string>()->required())
 		("database.min_connections", po::value<unsigned short>()->required())
 		("database.max_connections", po::value<unsigned short>()->required())
+		("cache.capacity", po::value<std::size_t>()->default_value(65536))
+		("cache.ttl", po::value<std::uint32_t>()->default_value(300))
+		("sessions.ttl", po::value<std::uint32_t>()->default_value(86400))
+		("sessions.snapshot_path", po::value<std::string>()->default_value(""))
 		("metrics.enabled", po::bool_switch()->required())
 		("metrics.statsd_host", po::value<std::string>()->required())
 		("metrics.statsd_port", po::value<std::uint16_t>()->required())
@@ -167,6 +262,22 @@ po::options_description options() {
 	return opts;
 }
 
+void schedule_purge(boost::asio::steady_timer& timer, Sessions& sessions, log::Logger& logger) {
+	timer.expires_after(SESSION_PURGE_INTERVAL);
+
+	timer.async_wait([&](const boost::system::error_code& ec) {
+		if(ec) { // timer was cancelled
+			return;
+		}
+
+		if(const auto purged = sessions.purge_expired()) {
+			LOG_DEBUG_ASYNC(logger, "Purged {} expired sessions", purged);
+		}
+
+		schedule_purge(timer, sessions, logger);
+	});
+}
+
 void pool_log_callback(ep::Severity severity, std::string_view message, log::Logger& logger) {
 	switch(severity) {
 		case ep::Severity::DEBUG:
@@ -7,31 +7,469 @@
  */
 
 #include "Sessions.h"
+#include <boost/endian/conversion.hpp>
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <cstring>
 
 namespace ember {
 
-bool Sessions::register_session(std::uint32_t account_id, const Botan::BigInt& key) {
-	std::lock_guard guard(lock_);
+namespace {
 
-	auto it = sessions_.find(account_id);
+constexpr std::uint32_t SNAPSHOT_MAGIC = 0x53534553; // SESS
+constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+constexpr auto NEVER = std::numeric_limits<Sessions::Clock::rep>::max();
 
-	if(!allow_overwrite_ && it != sessions_.end()) {
-		return false;
+struct ReadGuard {
+	std::atomic<std::uint32_t>& readers;
+
+	explicit ReadGuard(std::atomic<std::uint32_t>& readers) : readers(readers) {
+		readers.fetch_add(1);
 	}
 
-	sessions_.insert_or_assign(account_id, key);
+	~ReadGuard() {
+		readers.fetch_sub(1, std::memory_order_release);
+	}
+};
+
+template<typename T>
+void write_le(std::ostream& stream, T value) {
+	boost::endian::native_to_little_inplace(value);
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+T read_le(std::istream& stream) {
+	T value {};
+	stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+	boost::endian::little_to_native_inplace(value);
+	return value;
+}
+
+} // unnamed
+
+Sessions::Table::Table(const std::size_t capacity)
+	: mask(capacity - 1),
+	  slots(std::make_unique<Slot[]>(capacity)) { }
+
+Sessions::Sessions(const bool allow_overwrite, const Clock::duration ttl)
+	: allow_overwrite_(allow_overwrite),
+	  ttl_(ttl),
+	  shards_(std::make_unique<Shard[]>(SHARDS)) {
+	for(std::size_t i = 0; i < SHARDS; ++i) {
+		auto& table = shards_[i].tables.emplace_back(std::make_unique<Table>(MIN_CAPACITY));
+		shards_[i].table.store(table.get(), std::memory_order_release);
+	}
+}
+
+Sessions::~Sessions() = default;
+
+std::uint64_t Sessions::hash(const std::uint32_t account_id) {
+	std::uint64_t x = account_id + 0x9e3779b97f4a7c15;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+	return x ^ (x >> 31);
+}
+
+Sessions::Shard& Sessions::shard(const std::uint64_t hash) const {
+	// top bits pick the shard, the bottom bits are left for the table
+	return shards_[hash >> (64 - std::countr_zero(SHARDS))];
+}
+
+void Sessions::write(Slot& slot, const Entry& entry) {
+	const auto seq = slot.seq.load(std::memory_order_relaxed);
+	slot.seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.account_id.store(entry.account_id, std::memory_order_relaxed);
+	slot.expiry.store(entry.expiry, std::memory_order_relaxed);
+
+	for(std::size_t i = 0; i < KEY_WORDS; ++i) {
+		std::uint64_t word;
+		std::memcpy(&word, entry.key.data() + (i * sizeof(word)), sizeof(word));
+		slot.key[i].store(word, std::memory_order_relaxed);
+	}
+
+	slot.seq.store(seq + 2, std::memory_order_release);
+}
+
+Sessions::Entry Sessions::read(const Slot& slot) {
+	Entry entry;
+
+	while(true) {
+		const auto seq = slot.seq.load(std::memory_order_acquire);
+
+		if(seq & 1) { // mid-write
+			continue;
+		}
+
+		entry.account_id = slot.account_id.load(std::memory_order_relaxed);
+		entry.expiry = slot.expiry.load(std::memory_order_relaxed);
+
+		for(std::size_t i = 0; i < KEY_WORDS; ++i) {
+			const auto word = slot.key[i].load(std::memory_order_relaxed);
+			std::memcpy(entry.key.data() + (i * sizeof(word)), &word, sizeof(word));
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if(slot.seq.load(std::memory_order_relaxed) == seq) {
+			return entry;
+		}
+	}
+}
+
+// sized to be half full, leaving room to grow before the next rebuild
+std::size_t Sessions::capacity_for(const std::size_t sessions) {
+	return std::bit_ceil(std::max(MIN_CAPACITY, sessions * 2));
+}
+
+/*
+ * Copies live sessions into a new table, dropping tombstones and expired
+ * sessions along the way. The new table isn't visible to readers until
+ * it's fully populated.
+ */
+void Sessions::rebuild(Shard& shard, const Clock::rep now) {
+	const auto& current = *shard.table.load(std::memory_order_relaxed);
+	auto table = std::make_unique<Table>(capacity_for(shard.live + 1));
+	std::size_t live = 0;
+
+	for(std::size_t i = 0; i <= current.mask; ++i) {
+		const auto entry = read(current.slots[i]);
+
+		if(entry.account_id == EMPTY || entry.account_id == TOMBSTONE || entry.expiry <= now) {
+			continue;
+		}
+
+		auto index = hash(entry.account_id) & table->mask;
+
+		while(table->slots[index].account_id.load(std::memory_order_relaxed) != EMPTY) {
+			index = (index + 1) & table->mask;
+		}
+
+		write(table->slots[index], entry);
+		++live;
+	}
+
+	shard.table.store(table.get());
+	shard.tables.emplace_back(std::move(table));
+	shard.live = live;
+	shard.used = live;
+	reclaim(shard);
+}
+
+/*
+ * Readers announce themselves before loading the table pointer and the
+ * new table was published before this check, so if there are no readers,
+ * nobody can be holding a replaced table.
+ */
+void Sessions::reclaim(Shard& shard) {
+	if(shard.tables.size() > 1 && shard.readers.load() == 0) {
+		shard.tables.erase(shard.tables.begin(), shard.tables.end() - 1);
+	}
+}
+
+Sessions::Clock::rep Sessions::expiry() const {
+	if(ttl_ == Clock::duration::zero()) {
+		return NEVER;
+	}
+
+	return (Clock::now() + ttl_).time_since_epoch().count();
+}
+
+bool Sessions::insert(const Entry& entry, const bool overwrite) {
+	const auto hashed = hash(entry.account_id);
+	auto& shard = this->shard(hashed);
+	std::lock_guard guard(shard.lock);
+
+	const auto now = Clock::now().time_since_epoch().count();
+	auto table = shard.table.load(std::memory_order_relaxed);
+
+	// keep the load factor at or below 0.75 so probes stay short and always find an empty slot
+	if((shard.used + 1) * 4 > (table->mask + 1) * 3) {
+		rebuild(shard, now);
+		table = shard.table.load(std::memory_order_relaxed);
+	}
+
+	Slot* tombstone = nullptr;
+	auto index = hashed & table->mask;
+
+	while(true) {
+		auto& slot = table->slots[index];
+		const auto id = slot.account_id.load(std::memory_order_relaxed);
+
+		if(id == entry.account_id) {
+			if(!overwrite && slot.expiry.load(std::memory_order_relaxed) > now) {
+				return false;
+			}
+
+			write(slot, entry);
+			return true;
+		}
+
+		if(id == TOMBSTONE && !tombstone) {
+			tombstone = &slot;
+		} else if(id == EMPTY) {
+			break;
+		}
+
+		index = (index + 1) & table->mask;
+	}
+
+	if(tombstone) {
+		write(*tombstone, entry);
+	} else {
+		write(table->slots[index], entry);
+		++shard.used;
+	}
+
+	++shard.live;
 	return true;
 }
 
-std::optional<Botan::BigInt> Sessions::lookup_session(std::uint32_t account_id) const {
-	std::lock_guard guard(lock_);
-	auto it = sessions_.find(account_id);
+bool Sessions::register_session(const std::uint32_t account_id, std::span<const std::uint8_t> key) {
+	if(account_id == EMPTY || account_id == TOMBSTONE) {
+		return false;
+	}
+
+	// leading zeroes don't change the key's value, so they don't count towards its size
+	while(!key.empty() && key.front() == 0) {
+		key = key.subspan(1);
+	}
+
+	if(key.size() > KEY_SIZE) {
+		return false;
+	}
+
+	Entry entry {
+		.account_id = account_id,
+		.expiry = expiry(),
+		.key = {}
+	};
+
+	std::ranges::copy(key, entry.key.end() - key.size());
+	return insert(entry, allow_overwrite_);
+}
 
-	if(it == sessions_.end()) {
+std::optional<Sessions::Key> Sessions::lookup_session(const std::uint32_t account_id) const {
+	if(account_id == EMPTY || account_id == TOMBSTONE) {
 		return std::nullopt;
 	}
 
-	return std::optional<Botan::BigInt>(it->second);
+	const auto hashed = hash(account_id);
+	auto& shard = this->shard(hashed);
+	ReadGuard guard(shard.readers);
+
+	const auto& table = *shard.table.load();
+	auto index = hashed & table.mask;
+
+	while(true) {
+		const auto& slot = table.slots[index];
+		const auto id = slot.account_id.load(std::memory_order_relaxed);
+
+		if(id == EMPTY) {
+			return std::nullopt;
+		}
+
+		// the ID can change between the probe and the read, so check it again
+		if(id == account_id) {
+			const auto entry = read(slot);
+
+			if(entry.account_id == account_id) {
+				if(entry.expiry <= Clock::now().time_since_epoch().count()) {
+					return std::nullopt;
+				}
+
+				return entry.key;
+			}
+		}
+
+		index = (index + 1) & table.mask;
+	}
+}
+
+std::size_t Sessions::purge_expired() {
+	const auto now = Clock::now().time_since_epoch().count();
+	std::size_t purged = 0;
+
+	for(std::size_t i = 0; i < SHARDS; ++i) {
+		auto& shard = shards_[i];
+		std::lock_guard guard(shard.lock);
+		auto& table = *shard.table.load(std::memory_order_relaxed);
+
+		for(std::size_t j = 0; j <= table.mask; ++j) {
+			auto& slot = table.slots[j];
+			const auto id = slot.account_id.load(std::memory_order_relaxed);
+
+			if(id == EMPTY || id == TOMBSTONE || slot.expiry.load(std::memory_order_relaxed) > now) {
+				continue;
+			}
+
+			// clears the key too, no reason to keep it around
+			write(slot, { .account_id = TOMBSTONE, .expiry = 0, .key = {} });
+			--shard.live;
+			++purged;
+		}
+
+		const auto capacity = table.mask + 1;
+
+		// rebuild if tombstones are taking up space or the table could shrink
+		if((shard.used - shard.live) * 4 > capacity || capacity_for(shard.live + 1) * 4 <= capacity) {
+			rebuild(shard, now);
+		} else {
+			reclaim(shard);
+		}
+	}
+
+	return purged;
+}
+
+std::size_t Sessions::size() const {
+	std::size_t size = 0;
+
+	for(std::size_t i = 0; i < SHARDS; ++i) {
+		std::lock_guard guard(shards_[i].lock);
+		size += shards_[i].live;
+	}
+
+	return size;
+}
+
+/*
+ * Writes to a temporary file and then replaces the snapshot, so a failed
+ * save can't leave a truncated snapshot behind. Expiry times are stored
+ * as wall clock times, given that steady clock times don't carry across
+ * restarts.
+ */
+void Sessions::save(const std::filesystem::path& path) const {
+	using namespace std::chrono;
+
+	const auto steady_now = Clock::now();
+	const auto system_now = system_clock::now();
+	std::vector<Entry> entries;
+
+	for(std::size_t i = 0; i < SHARDS; ++i) {
+		std::lock_guard guard(shards_[i].lock);
+		const auto& table = *shards_[i].table.load(std::memory_order_relaxed);
+
+		for(std::size_t j = 0; j <= table.mask; ++j) {
+			const auto entry = read(table.slots[j]);
+
+			if(entry.account_id != EMPTY && entry.account_id != TOMBSTONE
+			   && entry.expiry > steady_now.time_since_epoch().count()) {
+				entries.emplace_back(entry);
+			}
+		}
+	}
+
+	auto temp = path;
+	temp += ".tmp";
+
+	std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+
+	if(!file) {
+		throw std::runtime_error("Unable to open session snapshot, " + temp.string());
+	}
+
+	// restrict access before any keys are written
+	std::filesystem::permissions(temp, std::filesystem::perms::owner_read
+	                             | std::filesystem::perms::owner_write);
+
+	write_le(file, SNAPSHOT_MAGIC);
+	write_le(file, SNAPSHOT_VERSION);
+	write_le<std::uint64_t>(file, entries.size());
+
+	for(const auto& entry : entries) {
+		std::int64_t expiry = 0; // never expires
+
+		if(entry.expiry != NEVER) {
+			const auto remaining = Clock::duration(entry.expiry) - steady_now.time_since_epoch();
+			const auto wall = system_now + duration_cast<system_clock::duration>(remaining);
+			expiry = duration_cast<milliseconds>(wall.time_since_epoch()).count();
+		}
+
+		write_le(file, entry.account_id);
+		write_le(file, expiry);
+		file.write(reinterpret_cast<const char*>(entry.key.data()), entry.key.size());
+	}
+
+	file.close();
+
+	if(!file) {
+		throw std::runtime_error("Unable to write session snapshot, " + temp.string());
+	}
+
+	std::filesystem::rename(temp, path);
+}
+
+/*
+ * Sessions that expired while the service was down are skipped. Returns
+ * the number of sessions loaded, which is zero if there's no snapshot.
+ */
+std::size_t Sessions::load(const std::filesystem::path& path) {
+	using namespace std::chrono;
+
+	std::ifstream file(path, std::ios::binary);
+
+	if(!file) {
+		return 0;
+	}
+
+	const auto magic = read_le<std::uint32_t>(file);
+	const auto version = read_le<std::uint32_t>(file);
+	const auto count = read_le<std::uint64_t>(file);
+
+	if(!file || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+		throw std::runtime_error("Unrecognised session snapshot, " + path.string());
+	}
+
+	const auto steady_now = Clock::now();
+	const auto system_now = system_clock::now();
+	std::size_t loaded = 0;
+
+	for(std::uint64_t i = 0; i < count; ++i) {
+		Entry entry {
+			.account_id = read_le<std::uint32_t>(file),
+			.expiry = NEVER,
+			.key = {}
+		};
+
+		const auto stored_expiry = read_le<std::int64_t>(file);
+		file.read(reinterpret_cast<char*>(entry.key.data()), entry.key.size());
+
+		if(!file) {
+			throw std::runtime_error("Truncated session snapshot, " + path.string());
+		}
+
+		if(entry.account_id == EMPTY || entry.account_id == TOMBSTONE) {
+			continue;
+		}
+
+		if(stored_expiry) {
+			const auto wall = system_clock::time_point(
+				duration_cast<system_clock::duration>(milliseconds(stored_expiry))
+			);
+
+			if(wall <= system_now) {
+				continue;
+			}
+
+			const auto remaining = duration_cast<Clock::duration>(wall - system_now);
+			entry.expiry = (steady_now + remaining).time_since_epoch().count();
+		}
+
+		// don't let a snapshot outlive a TTL that's been shortened or added since
+		entry.expiry = std::min(entry.expiry, expiry());
+
+		if(insert(entry, true)) {
+			++loaded;
+		}
+	}
+
+	return loaded;
 }
 
-} // ember
\ No newline at end of file
+} // ember
@@ -8,23 +8,120 @@
 
 #pragma once
 
-#include <botan/bigint.h>
-#include <optional>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
 #include <mutex>
-#include <unordered_map>
+#include <optional>
+#include <span>
+#include <vector>
+#include <cstddef>
 #include <cstdint>
 
 namespace ember {
 
+/*
+ * Session keys for every logged in account, looked up on each gateway
+ * authentication.
+ *
+ * Accounts are spread over shards, each with an open addressing table
+ * of fixed-size slots holding the key inline. Writers lock the shard but
+ * readers don't lock at all. Each slot has a sequence number that's odd
+ * while the slot is being written, and a reader retries if the number
+ * changes while it copies the slot.
+ *
+ * Tables are replaced rather than resized in place, so a reader holding
+ * the old table can keep using it. Replaced tables are freed by the next
+ * writer to find no readers in the shard.
+ *
+ * Sessions expire after the TTL, if one is set. An expired session is
+ * treated as missing straight away, and its slot is reclaimed when
+ * purge_expired() next runs.
+ *
+ * Account IDs 0 and 0xFFFFFFFF are reserved.
+ */
 class Sessions final {
-	bool allow_overwrite_;
-	std::unordered_map<std::uint32_t, Botan::BigInt> sessions_;
-	mutable std::mutex lock_;
+public:
+	static constexpr std::size_t KEY_SIZE = 40;
+	using Key = std::array<std::uint8_t, KEY_SIZE>;
+	using Clock = std::chrono::steady_clock;
+
+private:
+	static constexpr std::size_t SHARDS = 64;
+	static constexpr std::size_t MIN_CAPACITY = 64;
+	static constexpr std::size_t KEY_WORDS = KEY_SIZE / sizeof(std::uint64_t);
+	static constexpr std::uint32_t EMPTY = 0;
+	static constexpr std::uint32_t TOMBSTONE = 0xFFFFFFFF;
+
+	static_assert(KEY_SIZE % sizeof(std::uint64_t) == 0);
+
+	// fields are atomic only so that racing reads are well-defined, the sequence does the real work
+	struct alignas(64) Slot {
+		std::atomic<std::uint32_t> seq;
+		std::atomic<std::uint32_t> account_id;
+		std::atomic<Clock::rep> expiry;
+		std::array<std::atomic<std::uint64_t>, KEY_WORDS> key;
+	};
+
+	struct Table {
+		const std::size_t mask;
+		std::unique_ptr<Slot[]> slots;
+
+		explicit Table(std::size_t capacity);
+	};
+
+	struct alignas(64) Shard {
+		std::mutex lock;
+		std::atomic<Table*> table;
+		std::atomic<std::uint32_t> readers;
+		std::vector<std::unique_ptr<Table>> tables; // current table is always the last
+		std::size_t live = 0;
+		std::size_t used = 0; // live + tombstones
+	};
+
+	struct Entry {
+		std::uint32_t account_id;
+		Clock::rep expiry;
+		Key key;
+	};
+
+	const bool allow_overwrite_;
+	const Clock::duration ttl_;
+	std::unique_ptr<Shard[]> shards_;
+
+	static std::uint64_t hash(std::uint32_t account_id);
+	static void write(Slot& slot, const Entry& entry);
+	static Entry read(const Slot& slot);
+	static std::size_t capacity_for(std::size_t sessions);
+	static void rebuild(Shard& shard, Clock::rep now);
+	static void reclaim(Shard& shard);
+
+	Shard& shard(std::uint64_t hash) const;
+	bool insert(const Entry& entry, bool overwrite);
+	Clock::rep expiry() const;
 
 public:
-	explicit Sessions(bool allow_overwrite) : allow_overwrite_(allow_overwrite) { }
-	bool register_session(std::uint32_t account_id, const Botan::BigInt& key);
-	std::optional<Botan::BigInt> lookup_session(std::uint32_t account_id) const;
+	explicit Sessions(bool allow_overwrite, Clock::duration ttl = Clock::duration::zero());
+	~Sessions();
+
+	// the key is big-endian and at most KEY_SIZE bytes, shorter keys are zero-padded
+	bool register_session(std::uint32_t account_id, std::span<const std::uint8_t> key);
+	std::optional<Key> lookup_session(std::uint32_t account_id) const;
+
+	std::size_t purge_expired();
+	std::size_t size() const;
+
+	/*
+	 * Snapshots allow sessions to survive a restart of the service. They
+	 * contain session keys, so they're only readable by the owner.
+	 */
+	void save(const std::filesystem::path& path) const;
+	std::size_t load(const std::filesystem::path& path);
+
+	Sessions(const Sessions&) = delete;
+	Sessions& operator=(const Sessions&) = delete;
 };
 
-} // ember
\ No newline at end of file
+} // ember
@@ -12,6 +12,9 @@
 #include <shared/utility/Utility.h>
 #include <shared/threading/ThreadPool.h>
 #include <boost/assert.hpp>
+#include <algorithm>
+#include <span>
+#include <utility>
 
 namespace ember {
 
@@ -66,7 +69,7 @@ void CharacterHandler::enumerate(std::uint32_t account_id, std::uint32_t realm_i
 
 	pool_.run([=, this] {
 		do_enumerate(account_id, realm_id, callback);
-	});
+	}, ThreadPool::Priority::HIGH);
 }
 
 void CharacterHandler::rename(std::uint32_t account_id, std::uint64_t character_id,
@@ -75,7 +78,7 @@ void CharacterHandler::rename(std::uint32_t account_id, std::uint64_t character_
 
 	pool_.run([=, this] {
 		do_rename(account_id, character_id, name, callback);
-	});
+	}, ThreadPool::Priority::LOW);
 }
 
 void CharacterHandler::do_create(std::uint32_t account_id, std::uint32_t realm_id,
@@ -149,12 +152,9 @@ void CharacterHandler::do_create(std::uint32_t account_id, std::uint32_t realm_i
 	const dbc::ChrRaces* race = dbc_.chr_races[character.race];
 	const dbc::ChrClasses* class_ = dbc_.chr_classes[character.class_];
 
-	auto base_info = std::ranges::find_if(dbc_.char_start_base, [&](const auto& record) {
-		return record.second.race_id == character.race
-			&& record.second.class__id == character.class_;
-	});
+	const auto base_info = dbc_.char_start_base_by_race_class.first(character.race, character.class_);
 
-	if(base_info == dbc_.char_start_base.end()) {
+	if(!base_info) {
 		LOG_ERROR_ASYNC(logger_, "Unable to find base data for {} {}",
 		                race->name.en_gb, class_->name.en_gb);
 		callback(protocol::Result::CHAR_CREATE_ERROR);
@@ -162,7 +162,7 @@ void CharacterHandler::do_create(std::uint32_t account_id, std::uint32_t realm_i
 	}
 
 	// populate zone information
-	const dbc::CharStartZones* zone = base_info->second.zone;
+	const dbc::CharStartZones* zone = base_info->zone;
 
 	if(!zone) {
 		LOG_ERROR_ASYNC(logger_, "Unable to find zone data for {} {}",
@@ -179,38 +179,32 @@ void CharacterHandler::do_create(std::uint32_t account_id, std::uint32_t realm_i
 	character.orientation = zone->orientation;
 
 	// populate starting equipment
-	const auto& items = std::ranges::find_if(dbc_.char_start_outfit, [&](const auto& record) {
-		return record.second.race_id == character.race
-			&& record.second.class__id == character.class_;
-	});
+	const auto items = dbc_.char_start_outfit_by_race_class_sex.first(
+		character.race, character.class_, static_cast<dbc::CharStartOutfit::Sex>(character.gender)
+	);
 
-	if(items != dbc_.char_start_outfit.end()) {
-		populate_items(character, items->second);
+	if(items) {
+		populate_items(character, *items);
 	} else { // could be intentional, so we'll keep going
 		LOG_DEBUG_ASYNC(logger_, "No starting item data found for {}, {}",
 		                race->name.en_gb, class_->name.en_gb);
 	}
 
 	// populate starting spells
-	const auto& spells = std::ranges::find_if(dbc_.char_start_spells, [&](const auto& record) {
-		return record.second.race_id == character.race && record.second.class__id == character.class_;
-	});
+	const auto spells = dbc_.char_start_spells_by_race_class.find(character.race, character.class_);
 
-	if(spells != dbc_.char_start_spells.end()) {
-		populate_spells(character, spells->second);
+	if(!spells.empty()) {
+		populate_spells(character, spells);
 	} else { // could be intentional, so we'll keep going
 		LOG_DEBUG_ASYNC(logger_, "No starting spell data found for {} {}",
 		                race->name.en_gb, class_->name.en_gb);
 	}
 
 	// populate starting skills
-	const auto& skills = std::ranges::find_if(dbc_.char_start_skills, [&](const auto& record) {
-		return record.second.race_id == character.race
-			&& record.second.class__id == character.class_;
-	});
+	const auto skills = dbc_.char_start_skills_by_race_class.find(character.race, character.class_);
 
-	if(skills != dbc_.char_start_skills.end()) {
-		populate_skills(character, skills->second);
+	if(!skills.empty()) {
+		populate_skills(character, skills);
 	} else { // could be intentional, so we'll keep going
 		LOG_DEBUG_ASYNC(logger_, "No starting skill data found for {} {}",
 		                race->name.en_gb, class_->name.en_gb);
@@ -374,67 +368,37 @@ bool CharacterHandler::validate_options(const Character& character, std::uint32_
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
 	// validate the race/class combination
-	auto found = std::ranges::find_if(dbc_.char_base_info, [&](auto val) {
-		return (character.class_ == val.second.class__id && character.race == val.second.race_id);
-	});
-
-	if(found == dbc_.char_base_info.end()) {
+	if(!dbc_.char_base_info_by_race_class.first(character.race, character.class_)) {
 		LOG_DEBUG_ASYNC(logger_, "Invalid race/class combination of {} {} from account ID {}",
 		                character.race, character.class_, account_id);
 		return false;
 	}
 
-	bool skin_match = false;
-	bool hair_match = false;
-	bool face_match = false;
-
 	// validate visual customisation options
-	for(auto&& [k, section] : dbc_.char_sections) {
-		if(section.npc_only || section.race_id != character.race
-		   || section.sex != static_cast<dbc::CharSections::Sex>(character.gender)) {
-			continue;
-		}
+	const auto sex = static_cast<dbc::CharSections::Sex>(character.gender);
 
-		switch(section.type) {
-			case dbc::CharSections::SelectionType::BASE_SKIN:
-				if(section.colour_index == character.skin) {
-					skin_match = true;
-					break;
-				}
-				break;
-			case dbc::CharSections::SelectionType::HAIR:
-				if(section.variation_index == character.hairstyle
-				   && section.colour_index == character.haircolour) {
-					hair_match = true;
-					break;
-				}
-				break;
-			case dbc::CharSections::SelectionType::FACE:
-				if(section.variation_index == character.face
-				   && section.colour_index == character.skin) {
-					face_match = true;
-					break;
-				}
-				break;
-			default: // shut the compiler up
-				continue;
-		}
+	const auto selectable = [](std::span<const dbc::CharSections* const> sections) {
+		return std::ranges::any_of(sections, [](const auto section) {
+			return !section->npc_only;
+		});
+	};
 
-		if(skin_match && hair_match && face_match) {
-			break;
-		}
-	}
+	const bool skin_match = selectable(dbc_.char_sections_by_colour.find(
+		character.race, sex, dbc::CharSections::SelectionType::BASE_SKIN, character.skin
+	));
 
-	// facial features (horns, markings, tusks, piercings, hair) validation
-	bool facial_feature_match = false;
+	const bool hair_match = selectable(dbc_.char_sections_by_variation.find(
+		character.race, sex, dbc::CharSections::SelectionType::HAIR, character.hairstyle, character.haircolour
+	));
 
-	for(auto&& [k, style] : dbc_.character_facial_hair_styles) {
-		if(style.race_id == character.race && style.variation_id == character.facialhair
-		   && style.sex == static_cast<dbc::CharacterFacialHairStyles::Sex>(character.gender)) {
-			facial_feature_match = true;
-			break;
-		}
-	}
+	const bool face_match = selectable(dbc_.char_sections_by_variation.find(
+		character.race, sex, dbc::CharSections::SelectionType::FACE, character.face, character.skin
+	));
+
+	// facial features (horns, markings, tusks, piercings, hair) validation
+	const bool facial_feature_match = dbc_.character_facial_hair_styles_by_variation.first(
+		character.race, static_cast<dbc::CharacterFacialHairStyles::Sex>(character.gender), character.facialhair
+	) != nullptr;
 
 	if(!facial_feature_match || !skin_match || !face_match || !hair_match) {
 		LOG_DEBUG_ASYNC(logger_, "Invalid visual customisation options, account {} - "
@@ -479,33 +443,19 @@ protocol::Result CharacterHandler::validate_name(const utf8_string& name) const
 
 	const auto& formatted_name = util::utf8::name_format(name, std::locale());
 
-	for(auto& regex : reserved_names_) {
-		int ret = util::pcre::match(formatted_name, regex);
-
-		if(ret >= 0) {
-			return protocol::Result::CHAR_NAME_RESERVED;
-		} else if(ret != PCRE_ERROR_NOMATCH) {
-			LOG_ERROR_ASYNC(logger_, "PCRE error encountered: {}", ret);
-			return protocol::Result::CHAR_NAME_FAILURE;
-		}
-	}
-
-	for(auto& regex : profane_names_) {
-		int ret = util::pcre::match(formatted_name, regex);
+	const auto lists = name_filter_.lists();
 
-		if(ret >= 0) {
-			return protocol::Result::CHAR_NAME_PROFANE;
-		} else if(ret != PCRE_ERROR_NOMATCH) {
-			LOG_ERROR_ASYNC(logger_, "PCRE error encountered: {}", ret);
-			return protocol::Result::CHAR_NAME_FAILURE;
-		}
-	}
+	const std::pair<const util::pcre::PatternSet&, protocol::Result> filters[] {
+		{ lists->reserved, protocol::Result::CHAR_NAME_RESERVED },
+		{ lists->profane, protocol::Result::CHAR_NAME_PROFANE },
+		{ lists->spam, protocol::Result::CHAR_NAME_RESERVED }
+	};
 
-	for(auto& regex : spam_names_) {
-		int ret = util::pcre::match(formatted_name, regex);
+	for(const auto& [patterns, result] : filters) {
+		const int ret = patterns.match(formatted_name);
 
 		if(ret >= 0) {
-			return protocol::Result::CHAR_NAME_RESERVED;
+			return result;
 		} else if(ret != PCRE_ERROR_NOMATCH) {
 			LOG_ERROR_ASYNC(logger_, "PCRE error encountered: {}", ret);
 			return protocol::Result::CHAR_NAME_FAILURE;
@@ -537,10 +487,12 @@ const dbc::FactionGroup* CharacterHandler::pvp_faction(const dbc::FactionTemplat
 void CharacterHandler::populate_items(Character& character, const dbc::CharStartOutfit& outfit) const {
 }
 
-void CharacterHandler::populate_spells(Character& character, const dbc::CharStartSpells& spells) const {
+void CharacterHandler::populate_spells(Character& character,
+                                       std::span<const dbc::CharStartSpells* const> spells) const {
 }
 
-void CharacterHandler::populate_skills(Character& character, const dbc::CharStartSkills& skills) const {
+void CharacterHandler::populate_skills(Character& character,
+                                       std::span<const dbc::CharStartSkills* const> skills) const {
 }
 
 } // ember
\ No newline at end of file
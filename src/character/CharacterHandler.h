@@ -8,11 +8,11 @@
 
 #pragma once
 
+#include "NameFilter.h"
 #include <Character_generated.h>
 #include <dbcreader/Storage.h>
 #include <protocol/ResultCodes.h>
 #include <shared/database/daos/CharacterDAO.h>
-#include <shared/utility/PCREHelper.h>
 #include <shared/utility/UTF8.h>
 #include <logger/LoggerFwd.h>
 //#include <boost/locale.hpp>
@@ -21,6 +21,7 @@
 #include <functional>
 #include <string>
 #include <optional>
+#include <span>
 #include <vector>
 #include <cstdint>
 #include <cstddef>
@@ -40,9 +41,7 @@ class CharacterHandler final {
 	const std::size_t MAX_CHARACTER_SLOTS_SERVER = 10;
 	const std::size_t MAX_CHARACTER_SLOTS_ACCOUNT = 100; // todo, allow config
 
-	const std::vector<util::pcre::Result> profane_names_;
-	const std::vector<util::pcre::Result> reserved_names_;
-	const std::vector<util::pcre::Result> spam_names_;
+	const NameFilter& name_filter_;
 	const dbc::Storage& dbc_;
 	const dal::CharacterDAO& dao_;
 	const std::locale locale_;
@@ -53,8 +52,8 @@ class CharacterHandler final {
 	protocol::Result validate_name(const utf8_string& name) const;
 	bool validate_options(const ember::Character& character, std::uint32_t account_id) const;
 	void populate_items(ember::Character& character, const dbc::CharStartOutfit& outfit) const;
-	void populate_spells(ember::Character& character, const dbc::CharStartSpells& spells) const;
-	void populate_skills(ember::Character& character, const dbc::CharStartSkills& skills) const;
+	void populate_spells(ember::Character& character, std::span<const dbc::CharStartSpells* const> spells) const;
+	void populate_skills(ember::Character& character, std::span<const dbc::CharStartSkills* const> skills) const;
 	const dbc::FactionGroup* pvp_faction(const dbc::FactionTemplate& fac_template) const;
 
 	/** I/O heavy functions run async in a thread pool **/
@@ -83,14 +82,10 @@ class CharacterHandler final {
 
 
 public:
-	CharacterHandler(std::vector<util::pcre::Result> profane_names,
-	                 std::vector<util::pcre::Result> reserved_names,
-	                 std::vector<util::pcre::Result> spam_names,
+	CharacterHandler(const NameFilter& name_filter,
 	                 const dbc::Storage& dbc, const dal::CharacterDAO& dao,
 	                 ThreadPool& pool, const std::locale& locale, log::Logger& logger)
-		: profane_names_(std::move(profane_names)),
-		  reserved_names_(std::move(reserved_names)),
-		  spam_names_(std::move(spam_names)),
+		: name_filter_(name_filter),
 		  dbc_(dbc),
 		  dao_(dao),
 		  pool_(pool),
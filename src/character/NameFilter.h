@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/utility/PatternSet.h>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace ember {
+
+/*
+ * The reserved, profane and spam name patterns used to validate character
+ * names. The compiled lists are immutable once published, so reloading
+ * compiles a new set and swaps it in while any in-progress validations
+ * finish against the set they started with.
+ */
+class NameFilter final {
+public:
+	struct Lists {
+		util::pcre::PatternSet profane;
+		util::pcre::PatternSet reserved;
+		util::pcre::PatternSet spam;
+	};
+
+private:
+	std::atomic<std::shared_ptr<const Lists>> lists_;
+
+	static std::shared_ptr<const Lists> build(std::span<const std::string> profane,
+	                                          std::span<const std::string> reserved,
+	                                          std::span<const std::string> spam) {
+		return std::make_shared<const Lists>(
+			util::pcre::PatternSet(profane),
+			util::pcre::PatternSet(reserved),
+			util::pcre::PatternSet(spam)
+		);
+	}
+
+public:
+	NameFilter(std::span<const std::string> profane,
+	           std::span<const std::string> reserved,
+	           std::span<const std::string> spam)
+		: lists_(build(profane, reserved, spam)) {}
+
+	/*
+	 * Throws if any of the patterns fail to compile, leaving the
+	 * current lists in place
+	 */
+	void reload(std::span<const std::string> profane,
+	            std::span<const std::string> reserved,
+	            std::span<const std::string> spam) {
+		lists_ = build(profane, reserved, spam);
+	}
+
+	std::shared_ptr<const Lists> lists() const {
+		return lists_.load();
+	}
+};
+
+} // ember
@@ -10,19 +10,24 @@
 #include "FilterTypes.h"
 #include "CharacterHandler.h"
 #include "CharacterService.h"
+#include "NameFilter.h"
 #include <dbcreader/Reader.h>
 #include <conpool/ConnectionPool.h>
 #include <conpool/Policies.h>
 #include <conpool/drivers/AutoSelect.h>
 #include <shared/database/daos/CharacterDAO.h>
 #include <shared/threading/ThreadPool.h>
-#include <shared/utility/PCREHelper.h>
+#include <shared/metrics/Monitor.h>
 #include <spark/Server.h>
 #include <boost/asio/io_context.hpp>
 #include <chrono>
 #include <exception>
+#include <format>
+#include <memory>
 #include <ranges>
 #include <semaphore>
+#include <string>
+#include <vector>
 #include <cstddef>
 #include <cstdlib>
 #include <cstdint>
@@ -41,7 +46,16 @@ void launch(const po::variables_map& args,
             std::binary_semaphore& sem,
             log::Logger& logger);
 
+struct NamePatterns {
+	std::vector<std::string> profanity;
+	std::vector<std::string> reserved;
+	std::vector<std::string> spam;
+};
+
 void pool_log_callback(ep::Severity, std::string_view message, log::Logger& logger);
+void install_name_commands(Monitor& monitor, NameFilter& filter,
+                           const std::string& dbc_path, log::Logger& logger);
+NamePatterns name_patterns(const dbc::Storage& dbc_store);
 unsigned int check_concurrency(log::Logger& logger);
 
 /*
@@ -103,19 +117,8 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	dbc::link(dbc_store);
 
 	LOG_INFO(logger) << "Compiling DBC regular expressions..." << LOG_ASYNC;
-	std::vector<util::pcre::Result> profanity, reserved, spam;
-
-	for(auto& record : dbc_store.names_profanity | std::views::values) {
-		profanity.emplace_back(util::pcre::utf8_jit_compile(record.name));
-	}
-
-	for(auto& record : dbc_store.names_reserved | std::views::values) {
-		reserved.emplace_back(util::pcre::utf8_jit_compile(record.name));
-	}
-
-	for(auto& record : dbc_store.spam_messages | std::views::values) {
-		spam.emplace_back(util::pcre::utf8_jit_compile(record.text));
-	}
+	const auto patterns = name_patterns(dbc_store);
+	NameFilter name_filter(patterns.profanity, patterns.reserved, patterns.spam);
 
 	LOG_INFO(logger) << "Initialising database driver..." << LOG_SYNC;
 	const auto&  db_config_path = args["database.config_path"].as<std::string>();
@@ -146,8 +149,7 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	std::locale temp;
 
 	ThreadPool thread_pool(concurrency);
-	CharacterHandler handler(std::move(profanity), std::move(reserved), std::move(spam),
-	                         dbc_store, character_dao, thread_pool, temp, logger);
+	CharacterHandler handler(name_filter, dbc_store, character_dao, thread_pool, temp, logger);
 
 	const auto&  s_address = args["spark.address"].as<std::string>();
 	auto s_port = args["spark.port"].as<std::uint16_t>();
@@ -155,7 +157,20 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	LOG_INFO(logger) << "Starting RPC services..." << LOG_SYNC;
 	spark::Server spark(service, "character", s_address, s_port, logger);
 	CharacterService char_service(spark, handler, logger);
-	
+
+	std::unique_ptr<Monitor> monitor;
+
+	if(args["monitor.enabled"].as<bool>()) {
+		LOG_INFO(logger) << "Starting monitoring service..." << LOG_SYNC;
+
+		monitor = std::make_unique<Monitor>(
+			service, args["monitor.interface"].as<std::string>(),
+			args["monitor.port"].as<std::uint16_t>()
+		);
+
+		install_name_commands(*monitor, name_filter, args["dbc.path"].as<std::string>(), logger);
+	}
+
 	service.dispatch([&]() {
 		LOG_INFO_SYNC(logger, "{} started successfully", APP_NAME);
 	});
@@ -166,6 +181,53 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	eptr = std::current_exception();
 }
 
+NamePatterns name_patterns(const dbc::Storage& dbc_store) {
+	NamePatterns patterns;
+
+	for(auto& record : dbc_store.names_profanity | std::views::values) {
+		patterns.profanity.emplace_back(record.name);
+	}
+
+	for(auto& record : dbc_store.names_reserved | std::views::values) {
+		patterns.reserved.emplace_back(record.name);
+	}
+
+	for(auto& record : dbc_store.spam_messages | std::views::values) {
+		patterns.spam.emplace_back(record.text);
+	}
+
+	return patterns;
+}
+
+/*
+ * Allows edited name filter DBCs to be picked up by sending
+ * 'names reload' to the monitor, without a restart
+ */
+void install_name_commands(Monitor& monitor, NameFilter& filter,
+                           const std::string& dbc_path, log::Logger& logger) {
+	monitor.add_command("names reload", [&filter, dbc_path, &logger]() -> std::string {
+		try {
+			dbc::DiskLoader loader(dbc_path, [&](auto message) {
+				LOG_DEBUG_ASYNC(logger, "{}", message);
+			});
+
+			const auto dbc_store = loader.load("NamesProfanity", "NamesReserved", "SpamMessages");
+			const auto patterns = name_patterns(dbc_store);
+			filter.reload(patterns.profanity, patterns.reserved, patterns.spam);
+
+			LOG_INFO_ASYNC(logger, "Name filters reloaded by monitor command, {} profane, "
+			               "{} reserved, {} spam patterns", patterns.profanity.size(),
+			               patterns.reserved.size(), patterns.spam.size());
+
+			return std::format("OK; {} profane, {} reserved, {} spam patterns",
+			                   patterns.profanity.size(), patterns.reserved.size(),
+			                   patterns.spam.size());
+		} catch(const std::exception& e) {
+			return std::format("ERROR; {}", e.what());
+		}
+	});
+}
+
 void pool_log_callback(ep::Severity severity, std::string_view message, log::Logger& logger) {
 #undef ERROR // Windows moment
 
@@ -13,9 +13,13 @@ namespace ember::gateway {
 
 using namespace rpc::Account;
 
-AccountClient::AccountClient(spark::Server& spark, log::Logger& logger)
+AccountClient::AccountClient(spark::Server& spark, CacheConfig cache, log::Logger& logger)
 	: services::AccountClient(spark),
 	  logger_(logger) {
+	if(cache.ttl != std::chrono::seconds::zero()) {
+		cache_.emplace(cache.capacity, cache.ttl);
+	}
+
 	connect("127.0.0.1", 6003); // temp
 }
 
@@ -32,62 +36,54 @@ void AccountClient::connect_failed(std::string_view ip, const std::uint16_t port
 	LOG_INFO_ASYNC(logger_, "Failed to connect to account service on {}:{}", ip, port);
 }
 
-void AccountClient::locate_session(const std::uint32_t account_id, LocateCB cb) const {
+void AccountClient::locate_session(const std::string& username, LocateCB cb) {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
-	SessionLookupT msg {
-		.account_id = account_id
-	};
-
-	send<SessionResponse>(msg, link_, [this, cb = std::move(cb)](auto link, auto message) {
-		handle_locate_response(message, cb);
-	});
-}
-
-void AccountClient::locate_account_id(const std::string& username, AccountCB cb) const {
-	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
+	if(cache_) {
+		if(auto session = cache_->take(username)) {
+			cb(Status::OK, session->account_id, std::move(session->key), true);
+			return;
+		}
+	}
 
-	LookupIDT msg {
+	LocateSessionByNameT msg {
 		.account_name = username
 	};
 
-	send<AccountFetchResponse>(msg, link_, [this, cb = std::move(cb)](auto link, auto message) {
-		handle_lookup_response(message, cb);
+	send<SessionByNameResponse>(msg, link_, [this, username, cb = std::move(cb)](auto link, auto message) {
+		handle_locate_response(message, username, cb);
 	});
 }
 
-void AccountClient::handle_lookup_response(
-	std::expected<const AccountFetchResponse*, spark::Result> res,
-	const AccountCB& cb) const {
-	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
-
-	if(!res) {
-		cb(Status::RPC_ERROR, {});
-		return;
+void AccountClient::hand_off(const std::string& username, const std::uint32_t account_id,
+                             Botan::BigInt key) {
+	if(cache_) {
+		cache_->put(username, { account_id, std::move(key) });
 	}
+}
 
-	const auto msg = *res;
-	cb(msg->status(), msg->account_id());
+AccountClient::Cache::Stats AccountClient::cache_stats() const {
+	return cache_? cache_->stats() : Cache::Stats{};
 }
 
-void AccountClient::handle_locate_response(std::expected<const SessionResponse*, spark::Result> res,
-                                           const LocateCB& cb) const {
+void AccountClient::handle_locate_response(std::expected<const SessionByNameResponse*, spark::Result> res,
+                                           const std::string& username, const LocateCB& cb) {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
 	if(!res) {
-		cb(Status::RPC_ERROR, {});
+		cb(Status::RPC_ERROR, {}, {}, false);
 		return;
 	}
 	
 	const auto msg = *res;
 
-	if(!msg->key()) {
-		cb(msg->status(), {});
+	if(msg->status() != Status::OK || !msg->key()) {
+		cb(msg->status(), msg->account_id(), {}, false);
 		return;
 	}
 
 	auto key = Botan::BigInt::decode(msg->key()->data(), msg->key()->size());
-	cb(msg->status(), std::move(key));
+	cb(msg->status(), msg->account_id(), std::move(key), false);
 }
 
 } // gateway, ember
\ No newline at end of file
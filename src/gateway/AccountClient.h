@@ -10,41 +10,67 @@
 
 #include <AccountClientStub.h>
 #include <logger/Logger.h>
+#include <shared/utility/LRUCache.h>
 #include <spark/Server.h>
 #include <botan/bigint.h>
+#include <chrono>
 #include <functional>
+#include <optional>
+#include <string>
+#include <cstddef>
 #include <cstdint>
 
 namespace ember::gateway {
 
+/*
+ * When an authenticated client leaves, its session is handed off to the
+ * cache for a short time so that its reconnect doesn't need a trip to the
+ * account service. Handed off sessions can only be used once and sessions
+ * fetched from the account service are never cached.
+ *
+ * The account service doesn't tell the gateway when it drops a session,
+ * so a handed off session remains usable until it expires. A cached key
+ * can also be stale if the player has since logged in again, so callers
+ * should retry if the client can't prove it.
+ */
 class AccountClient final : public services::AccountClient {
 public:
-	using LocateCB = std::function<void(rpc::Account::Status, Botan::BigInt)>;
-	using AccountCB = std::function<void(rpc::Account::Status, std::uint32_t)>;
+	// the final parameter indicates whether the result came from the cache
+	using LocateCB = std::function<void(rpc::Account::Status, std::uint32_t, Botan::BigInt, bool)>;
+
+	struct CacheConfig {
+		std::size_t capacity;
+		std::chrono::seconds ttl; // zero disables caching
+	};
 
 private:
+	struct CachedSession {
+		std::uint32_t account_id;
+		Botan::BigInt key;
+	};
+
+	using Cache = LRUCache<std::string, CachedSession>;
+
 	log::Logger& logger_;
 	spark::Link link_;
+	std::optional<Cache> cache_;
 
 	void on_link_up(const spark::Link& link) override;
 	void on_link_down(const spark::Link& link) override;
 	void connect_failed(std::string_view ip, std::uint16_t port) override;
 
 	void handle_locate_response(
-		std::expected<const rpc::Account::SessionResponse*, spark::Result> res,
+		std::expected<const rpc::Account::SessionByNameResponse*, spark::Result> res,
+		const std::string& username,
 		const LocateCB& cb
-	) const;
-
-	void handle_lookup_response(
-		std::expected<const rpc::Account::AccountFetchResponse*, spark::Result> res,
-		const AccountCB& cb
-	) const;
+	);
 
 public:
-	AccountClient(spark::Server& spark, log::Logger& logger);
+	AccountClient(spark::Server& spark, CacheConfig cache, log::Logger& logger);
 
-	void locate_session(std::uint32_t account_id, LocateCB cb) const;
-	void locate_account_id(const std::string& username, AccountCB cb) const;
+	void locate_session(const std::string& username, LocateCB cb);
+	void hand_off(const std::string& username, std::uint32_t account_id, Botan::BigInt key);
+	Cache::Stats cache_stats() const;
 };
 
 } // gateway, ember
\ No newline at end of file
@@ -15,6 +15,9 @@
 #include "ClientLogHelper.h"
 #include <logger/Logger.h>
 #include <protocol/Packets.h>
+#include <shared/metrics/LatencyTracker.h>
+#include <shared/metrics/Profiler.h>
+#include <optional>
 #include <format>
 #include <utility>
 
@@ -51,15 +54,29 @@ void ClientHandler::handle_message(BinaryStream& stream) {
 			break;
 	}
 
+	std::optional<Profiler::ScopedTag> state_tag, opcode_tag;
+
+	if(Profiler::tagging()) {
+		state_tag.emplace(Profiler::Tag::STATE, ClientState_to_string(context_.state));
+		opcode_tag.emplace(Profiler::Tag::OPCODE, protocol::to_string(opcode_));
+	}
+
+	ScopedLatency latency(Locator::latency(), std::to_underlying(opcode_));
 	update_packet[context_.state](context_, opcode_);
 }
 
 void ClientHandler::handle_event(const Event* event) {
+	std::optional<Profiler::ScopedTag> state_tag;
+
+	if(Profiler::tagging()) {
+		state_tag.emplace(Profiler::Tag::STATE, ClientState_to_string(context_.state));
+	}
+
 	update_event[context_.state](context_, event);
 }
 
 void ClientHandler::handle_event(std::unique_ptr<const Event> event) {
-	update_event[context_.state](context_, event.get());
+	handle_event(event.get());
 }
 
 void ClientHandler::state_update(ClientState new_state) {
@@ -97,14 +114,14 @@ void ClientHandler::handle_ping(BinaryStream& stream) {
 	connection_.send(response);
 }
 
+/*
+ * State timeouts are held in the thread's timing wheel, replacing
+ * any timeout that's already pending for this client
+ */
 void ClientHandler::start_timer(const std::chrono::milliseconds& time) {
-	timer_.expires_from_now(time);
-
-	timer_.async_wait([uuid = uuid_](const boost::system::error_code& ec) {
-		if(!ec) {
-			Event event { EventType::TIMER_EXPIRED };
-			Locator::dispatcher()->post_event(uuid, event);
-		}
+	timer_ = timers_.schedule(time, [uuid = uuid_] {
+		Event event { EventType::TIMER_EXPIRED };
+		Locator::dispatcher()->post_event(uuid, event);
 	});
 }
 
@@ -142,7 +159,7 @@ ClientHandler::ClientHandler(ClientConnection& connection, ClientRef uuid,
                                opcode_{},
                                logger_(logger),
                                uuid_(uuid),
-                               timer_(executor) { 
+                               timers_(TimingWheel::get(executor.context())) { 
 	context_.state = context_.prev_state = ClientState::AUTHENTICATING;
 	context_.connection = &connection_;
 	context_.handler = this;
@@ -16,7 +16,7 @@
 #include <spark/buffers/BinaryStream.h>
 #include <logger/LoggerFwd.h>
 #include <shared/ClientRef.h>
-#include <boost/asio/steady_timer.hpp>
+#include <shared/threading/TimingWheel.h>
 #include <boost/uuid/uuid.hpp>
 #include <concepts>
 #include <chrono>
@@ -33,7 +33,8 @@ class ClientHandler final {
 	ClientConnection& connection_;
 	ClientContext context_;
 	const ClientRef uuid_;
-	boost::asio::steady_timer timer_;
+	TimingWheel& timers_;
+	TimingWheel::Handle timer_;
 	protocol::ClientOpcode opcode_;
 	log::Logger& logger_;
 
@@ -13,7 +13,6 @@ namespace ember::gateway {
 enum class EventType {
 	QUEUE_SUCCESS,
     QUEUE_UPDATE_POSITION,
-	ACCOUNT_ID_RESPONSE,
 	SESSION_KEY_RESPONSE,
 	CHAR_CREATE_RESPONSE,
 	CHAR_DELETE_RESPONSE,
@@ -38,24 +38,18 @@ struct QueuePosition final : Event {
 	std::size_t position;
 };
 
-struct AccountIDResponse final : Event {
-	AccountIDResponse(rpc::Account::Status status, std::uint32_t id)
-		: Event { EventType::ACCOUNT_ID_RESPONSE },
-	      status(status),
-		  account_id(id) { }
-
-	rpc::Account::Status status;
-	std::uint32_t account_id;
-};
-
 struct SessionKeyResponse final : Event {
-	SessionKeyResponse(rpc::Account::Status status, Botan::BigInt key)
+	SessionKeyResponse(rpc::Account::Status status, std::uint32_t id, Botan::BigInt key, bool cached)
 		: Event { EventType::SESSION_KEY_RESPONSE },
 	      status(status),
-		  key(std::move(key)) { }
+		  account_id(id),
+		  key(std::move(key)),
+		  cached(cached) { }
 
 	rpc::Account::Status status;
+	std::uint32_t account_id;
 	Botan::BigInt key;
+	bool cached;
 };
 
 struct CharEnumResponse final : Event {
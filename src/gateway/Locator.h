@@ -8,6 +8,12 @@
 
 #pragma once 
 
+namespace ember {
+
+class LatencyTracker;
+
+} // ember
+
 namespace ember::gateway {
 
 class EventDispatcher;
@@ -24,9 +30,11 @@ class Locator {
 	static RealmService* realm_;
 	static RealmQueue* queue_;
 	static Config* config_;
+	static LatencyTracker* latency_;
 
 public:
 	static void set(Config* config) { config_ = config; }
+	static void set(LatencyTracker* latency) { latency_ = latency; }
 	static void set(RealmQueue* queue) { queue_ = queue; }
 	static void set(RealmService* realm) { realm_ = realm; }
 	static void set(AccountClient* account) { account_ = account; }
@@ -34,6 +42,7 @@ public:
 	static void set(EventDispatcher* dispatcher) { dispatcher_ = dispatcher; }
 
 	static Config* config() { return config_; }
+	static LatencyTracker* latency() { return latency_; }
 	static RealmQueue* queue() { return queue_; }
 	static RealmService* realm() { return realm_; }
 	static AccountClient* account() { return account_; }
@@ -22,14 +22,22 @@
 #include <dbcreader/Reader.h>
 #include <logger/Logger.h>
 #include <nsd/NSD.h>
+#include <protocol/Opcodes.h>
 #include <spark/Server.h>
 #include <shared/Banner.h>
 #include <shared/utility/EnumHelper.h>
 #include <shared/Version.h>
+#include <shared/metrics/CounterDelta.h>
+#include <shared/metrics/LatencyTracker.h>
+#include <shared/metrics/MetricsImpl.h>
+#include <shared/metrics/MetricsPoll.h>
+#include <shared/metrics/Monitor.h>
 #include <shared/utility/Utility.h>
 #include <shared/utility/LogConfig.h>
 #include <shared/utility/STUN.h>
 #include <shared/utility/PortForward.h>
+#include <shared/utility/ThreadPlacement.h>
+#include <shared/utility/ProfilerSetup.h>
 #include <shared/database/daos/RealmDAO.h>
 #include <shared/database/daos/UserDAO.h>
 #include <shared/threading/ServicePool.h>
@@ -52,6 +60,7 @@
 #include <string>
 #include <string_view>
 #include <stdexcept>
+#include <utility>
 #include <cstdlib>
 
 using namespace std::chrono_literals;
@@ -88,8 +97,9 @@ int run(const po::variables_map& args, log::Logger& logger) try {
 
 	// Start ASIO service pool
 	LOG_INFO_SYNC(logger, "Starting service pool with {} threads", concurrency);
+	const auto layout = placement_layout(args, concurrency, logger);
 	ServicePool service_pool(concurrency, BOOST_ASIO_CONCURRENCY_HINT_UNSAFE_IO);
-	service_pool.run();
+	service_pool.run(layout);
 
 	std::thread thread([&]() {
 		thread::set_name("Launcher");
@@ -236,7 +246,10 @@ void launch(const po::variables_map& args, ServicePool& service_pool,
 	LOG_INFO(logger) << "Starting RPC services..." << LOG_SYNC;
 	spark::Server spark(service_pool.get(), "realm", s_address, s_port, logger);
 	RealmService realm_svc(spark, *realm, logger);
-	AccountClient acct_svc(spark, logger);
+	AccountClient acct_svc(spark, {
+		.capacity = args["session_cache.capacity"].as<std::size_t>(),
+		.ttl = std::chrono::seconds(args["session_cache.ttl"].as<std::uint32_t>())
+	}, logger);
 	CharacterClient char_svc(spark, config, logger);
 
 	const auto nsd_host = args["nsd.host"].as<std::string>();
@@ -244,6 +257,51 @@ void launch(const po::variables_map& args, ServicePool& service_pool,
 
 	NetworkServiceDiscovery nds(spark, nsd_host, nsd_port, logger);
 
+	// Start metrics service
+	auto metrics = std::make_unique<Metrics>();
+
+	if(args["metrics.enabled"].as<bool>()) {
+		LOG_INFO(logger) << "Starting metrics service..." << LOG_SYNC;
+		metrics = std::make_unique<MetricsImpl>(
+			service, args["metrics.statsd_host"].as<std::string>(),
+			args["metrics.statsd_port"].as<std::uint16_t>()
+		);
+	}
+
+	// Per-opcode handler timings, opt-in as it adds a little overhead to every packet
+	const auto opcode_keys = std::to_underlying(protocol::ClientOpcode::CMSG_ACCEPT_LEVEL_GRANT) + 1;
+
+	LatencyTracker opcode_latency("opcodes", opcode_keys, [](const std::size_t key) {
+		return std::string(protocol::to_string(static_cast<protocol::ClientOpcode>(key)));
+	}, args["metrics.latency_instrumentation"].as<bool>());
+
+	if(opcode_latency.enabled()) {
+		LOG_INFO_SYNC(logger, "Latency instrumentation enabled ({:.3f} TSC ticks/ns)",
+		              util::tsc::ticks_per_ns());
+	}
+
+	MetricsPoll poller(service, *metrics);
+
+	poller.add_source([&](Metrics& metrics) {
+		if(!opcode_latency.enabled()) {
+			return;
+		}
+
+		const auto summaries = opcode_latency.collect();
+		opcode_latency.publish(summaries, metrics);
+
+		if(!summaries.empty()) {
+			LOG_INFO(logger) << opcode_latency.describe_slowest(summaries, 5) << LOG_ASYNC;
+		}
+	}, 60s);
+
+	poller.add_source([&acct_svc, hits = CounterDelta(), misses = CounterDelta()](Metrics& metrics) mutable {
+		const auto stats = acct_svc.cache_stats();
+		metrics.gauge("session_cache_size", stats.size);
+		metrics.increment("session_cache_hits", hits(stats.hits));
+		metrics.increment("session_cache_misses", misses(stats.misses));
+	}, 5s);
+
 	// set services - not the best design pattern but it'll do for now
 	Locator::set(&dispatcher);
 	Locator::set(&queue_service);
@@ -251,6 +309,7 @@ void launch(const po::variables_map& args, ServicePool& service_pool,
 	Locator::set(&acct_svc);
 	Locator::set(&char_svc);
 	Locator::set(&config);
+	Locator::set(&opcode_latency);
 	
 	// Misc. information
 	const auto max_socks = util::max_sockets_desc();
@@ -263,6 +322,22 @@ void launch(const po::variables_map& args, ServicePool& service_pool,
 
 	LOG_INFO_SYNC(logger, "Started network service on {}:{}", interface, server.port());
 
+	auto profiler = create_profiler(args, logger);
+
+	// Start monitoring service
+	std::unique_ptr<Monitor> monitor;
+
+	if(args["monitor.enabled"].as<bool>()) {
+		LOG_INFO(logger) << "Starting monitoring service..." << LOG_SYNC;
+
+		monitor = std::make_unique<Monitor>(
+			service, args["monitor.interface"].as<std::string>(),
+			args["monitor.port"].as<std::uint16_t>()
+		);
+
+		install_profiler_commands(*monitor, *profiler, logger);
+	}
+
 	service.dispatch([&]() {
 		realm_svc.set_online();
 		LOG_INFO_SYNC(logger, "{} started successfully", APP_NAME);
@@ -384,6 +459,8 @@ po::options_description options() {
 		("network.port", po::value<std::uint16_t>()->required())
 		("network.tcp_no_delay", po::value<bool>()->required())
 		("network.compression", po::value<std::uint8_t>()->required())
+		("session_cache.capacity", po::value<std::size_t>()->default_value(4096))
+		("session_cache.ttl", po::value<std::uint32_t>()->default_value(15))
 		("console_log.verbosity", po::value<std::string>()->required())
 		("console_log.filter-mask", po::value<std::uint32_t>()->default_value(0))
 		("console_log.colours", po::value<bool>()->required())
@@ -405,10 +482,13 @@ po::options_description options() {
 		("metrics.enabled", po::value<bool>()->required())
 		("metrics.statsd_host", po::value<std::string>()->required())
 		("metrics.statsd_port", po::value<std::uint16_t>()->required())
+		("metrics.latency_instrumentation", po::value<bool>()->default_value(false))
 		("monitor.enabled", po::value<bool>()->required())
 		("monitor.interface", po::value<std::string>()->required())
 		("monitor.port", po::value<std::uint16_t>()->required());
 
+	opts.add(placement_options("round_robin"));
+	opts.add(profiler_options("gateway.folded"));
 	return opts;
 }
 
@@ -18,6 +18,7 @@
 #include <protocol/PacketHeaders.h>
 #include <protocol/Packets.h>
 #include <spark/buffers/pmr/Buffer.h>
+#include <srp6/crypto/ThreadLocal.h>
 #include <shared/utility/EnumHelper.h>
 #include <shared/utility/UTF8String.h>
 #include <shared/utility/xoroshiro128plus.h>
@@ -42,9 +43,8 @@ void handle_queue_update(ClientContext& ctx, const QueuePosition* event);
 void handle_queue_success(ClientContext& ctx);
 void auth_success(ClientContext& ctx);
 void auth_queue(ClientContext& ctx);
-void prove_session(ClientContext& ctx, const Botan::BigInt& key);
-void fetch_session_key(const ClientContext& ctx, std::uint32_t account_id);
-void fetch_account_id(const ClientContext& ctx, const utf8_string& username);
+bool prove_session(ClientContext& ctx, const Botan::BigInt& key);
+void fetch_session(const ClientContext& ctx, const utf8_string& username);
 void handle_timeout(ClientContext& ctx);
 void send_addon_data(ClientContext& ctx);
 
@@ -82,76 +82,55 @@ void handle_authentication(ClientContext& ctx) {
 	}
 
 	auth_state(ctx, State::IN_PROGRESS);
-	fetch_account_id(ctx, auth_ctx.packet->username);
+	fetch_session(ctx, auth_ctx.packet->username);
 }
 
-void fetch_account_id(const ClientContext& ctx, const utf8_string& username) {
+void fetch_session(const ClientContext& ctx, const utf8_string& username) {
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
 
 	const auto& uuid = ctx.handler->uuid();
 
-	Locator::account()->locate_account_id(username, [uuid](auto status, auto id) {
-		AccountIDResponse event(status, id);
+	Locator::account()->locate_session(username, [uuid](auto status, auto id, auto key, auto cached) {
+		SessionKeyResponse event(status, id, std::move(key), cached);
 		Locator::dispatcher()->post_event(uuid, event);
 	});
 }
 
-void handle_account_id(ClientContext& ctx, const AccountIDResponse* event) {
+void handle_session_key(ClientContext& ctx, const SessionKeyResponse* event) {
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
-	
+
 	auto& auth_ctx = std::get<Context>(ctx.state_ctx);
 
-	if(event->status != rpc::Account::Status::OK) {
-		CLIENT_ERROR_GLOB(ctx)
-			<< "Account server returned "
-			<< util::fb_status(event->status, rpc::Account::EnumNamesStatus())
-			<< " for " << auth_ctx.packet->username << " lookup" << LOG_ASYNC;
+	CLIENT_DEBUG_GLOB(ctx)
+		<< "Account server returned "
+		<< util::fb_status(event->status, rpc::Account::EnumNamesStatus())
+		<< " for " << auth_ctx.packet->username
+		<< (event->cached? " (cached)" : "") << LOG_ASYNC;
 
+	if(event->status != rpc::Account::Status::OK || !event->account_id) {
 		auth_state(ctx, State::FAILED);
 		ctx.handler->close();
 		return;
 	}
 
-	if(event->account_id) {
-		auth_ctx.account_id = event->account_id;
-		fetch_session_key(ctx, event->account_id);
-	} else {
-		CLIENT_DEBUG_GLOB(ctx)
-			<< "Account ID lookup for failed for "
-			<< auth_ctx.packet->username << LOG_ASYNC;
-		auth_state(ctx, State::FAILED);
-		ctx.handler->close();
-	}
-}
-
-void fetch_session_key(const ClientContext& ctx, const std::uint32_t account_id) {
-	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
+	auth_ctx.account_id = event->account_id;
 
-	const auto& uuid = ctx.handler->uuid();
-
-	Locator::account()->locate_session(account_id, [uuid](auto status, auto key) {
-		SessionKeyResponse event(status, key);
-		Locator::dispatcher()->post_event(uuid, event);
-	});
-}
-
-void handle_session_key(ClientContext& ctx, const SessionKeyResponse* event) {
-	const auto& auth_ctx = std::get<Context>(ctx.state_ctx);
-
-	CLIENT_DEBUG_GLOB(ctx)
-		<< "Account server returned "
-		<< util::fb_status(event->status, rpc::Account::EnumNamesStatus())
-		<< " for " << auth_ctx.packet->username << LOG_ASYNC;
+	if(prove_session(ctx, event->key)) {
+		return;
+	}
 
-	if(event->status == rpc::Account::Status::OK) {
-		prove_session(ctx, event->key);
-	} else {
-		auth_state(ctx, State::FAILED);
-		ctx.handler->close();
+	// the player may have logged in again since the key was cached, try a fresh one
+	if(event->cached) {
+		fetch_session(ctx, auth_ctx.packet->username);
+		return;
 	}
+
+	auth_state(ctx, State::FAILED);
+	ctx.handler->close(); // key mismatch, client can't decrypt response
 }
 
-void prove_session(ClientContext& ctx, const Botan::BigInt& key) {
+// returns false if the client's digest doesn't match the key
+bool prove_session(ClientContext& ctx, const Botan::BigInt& key) {
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
 
 	// Encode the key without requiring an allocation
@@ -167,25 +146,23 @@ void prove_session(ClientContext& ctx, const Botan::BigInt& key) {
 	auto& auth_ctx = std::get<Context>(ctx.state_ctx);
 	const auto& packet = auth_ctx.packet;
 
-	auto hasher = Botan::HashFunction::create_or_throw("SHA-1");
+	auto& hasher = crypto::hasher(crypto::Hash::SHA1);
 	std::array<std::uint8_t, 20> hash;
-	BOOST_ASSERT_MSG(hash.size() == hasher->output_length(), "Bad hash length");
-	hasher->update(packet->username);
-	hasher->update_be(protocol_id);
-	hasher->update(packet->seed.data(), sizeof(packet->seed));
-	hasher->update_be(boost::endian::native_to_big(auth_ctx.seed));
-	hasher->update(k_bytes.data(), k_bytes.size());
-	hasher->final(hash.data());
+	BOOST_ASSERT_MSG(hash.size() == hasher.output_length(), "Bad hash length");
+	hasher.update(packet->username);
+	hasher.update_be(protocol_id);
+	hasher.update(packet->seed.data(), sizeof(packet->seed));
+	hasher.update_be(boost::endian::native_to_big(auth_ctx.seed));
+	hasher.update(k_bytes.data(), k_bytes.size());
+	hasher.final(hash.data());
 
 	if(hash != packet->digest) {
 		CLIENT_DEBUG_GLOB(ctx) << "Received bad digest for " << packet->username << LOG_ASYNC;
-		auth_state(ctx, State::FAILED);
-		ctx.handler->close(); // key mismatch, client can't decrypt response
-		return;
+		return false;
 	}
 
 	ctx.connection->set_key(k_bytes);
-	ctx.client_id = { auth_ctx.account_id, packet->username };
+	ctx.client_id = { auth_ctx.account_id, packet->username, key };
 
 	 // todo, allowing for multiple gateways to connect to a single world server
 	 // will require an external service to keep track of available slots
@@ -198,6 +175,7 @@ void prove_session(ClientContext& ctx, const Botan::BigInt& key) {
 	}
 
 	ctx.handler->stop_timer();
+	return true;
 }
 
 void send_auth_challenge(ClientContext& ctx) {
@@ -314,9 +292,6 @@ void handle_event(ClientContext& ctx, const Event* event) {
 		case EventType::TIMER_EXPIRED:
 			handle_timeout(ctx);
 			break;
-		case EventType::ACCOUNT_ID_RESPONSE:
-			handle_account_id(ctx, static_cast<const AccountIDResponse*>(event));
-			break;
 		case EventType::SESSION_KEY_RESPONSE:
 			handle_session_key(ctx, static_cast<const SessionKeyResponse*>(event));
 			break;
@@ -15,6 +15,7 @@
 #include <spark/buffers/pmr/Buffer.h>
 #include <protocol/PacketHeaders.h>
 #include <shared/utility/UTF8String.h>
+#include <botan/bigint.h>
 #include <optional>
 #include <variant>
 #include <cstdint>
@@ -37,6 +38,7 @@ using StateContext =
 struct ClientID {
 	std::uint32_t id;
 	utf8_string username;
+	Botan::BigInt key;
 };
 
 struct ClientContext {
@@ -7,12 +7,19 @@
  */
 
 #include "SessionClose.h"
+#include "../AccountClient.h"
 #include "../ClientHandler.h"
+#include "../Locator.h"
+#include <utility>
 
 namespace ember::gateway::session_close {
 
 void enter(ClientContext& ctx) {
-	// don't care, for now
+	// let the client reconnect without another trip to the account service
+	if(ctx.client_id) {
+		auto& [id, username, key] = *ctx.client_id;
+		Locator::account()->hand_off(username, id, std::move(key));
+	}
 }
 
 void handle_packet(ClientContext& ctx, protocol::ClientOpcode opcode) {
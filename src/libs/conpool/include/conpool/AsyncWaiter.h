@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "Connection.h"
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/execution/outstanding_work.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/prefer.hpp>
+#include <chrono>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace ember::connection_pool {
+
+/*
+ * A queued async_acquire. Completion is always posted to the executor
+ * associated with the handler, so callers resume on their own executor
+ * rather than on whichever thread happened to return a connection.
+ */
+template<typename ConType, typename State>
+class AsyncWaiter {
+public:
+	using clock = std::chrono::steady_clock;
+	using Result = std::optional<Connection<ConType, State>>;
+
+	const clock::time_point deadline;
+
+	explicit AsyncWaiter(clock::time_point deadline) : deadline(deadline) {}
+
+	virtual void complete(std::exception_ptr error, Result connection) = 0;
+	virtual ~AsyncWaiter() = default;
+};
+
+template<typename Driver, typename Handler>
+class AsyncWaiterImpl final
+	: public AsyncWaiter<typename Driver::ConnectionType, driver_state_t<Driver>> {
+	using Base = AsyncWaiter<typename Driver::ConnectionType, driver_state_t<Driver>>;
+
+	// keeps the handler's execution context alive while it waits
+	using WorkExecutor = std::decay_t<decltype(boost::asio::prefer(
+		boost::asio::get_associated_executor(std::declval<Handler&>()),
+		boost::asio::execution::outstanding_work.tracked
+	))>;
+
+	const Driver& driver_;
+	Handler handler_;
+	WorkExecutor executor_;
+
+public:
+	AsyncWaiterImpl(const Driver& driver, Handler handler, typename Base::clock::time_point deadline)
+		: Base(deadline),
+		  driver_(driver),
+		  handler_(std::move(handler)),
+		  executor_(boost::asio::prefer(boost::asio::get_associated_executor(handler_),
+		                                boost::asio::execution::outstanding_work.tracked)) {}
+
+	void complete(std::exception_ptr error, typename Base::Result connection) override {
+		boost::asio::post(executor_, [&driver = driver_, handler = std::move(handler_),
+		                              error, connection = std::move(connection)]() mutable {
+			if(connection) {
+				driver.thread_enter();
+			}
+
+			std::move(handler)(error, std::move(connection));
+		});
+	}
+};
+
+} // connection_pool, ember
@@ -12,15 +12,35 @@
 #include <functional>
 #include <mutex>
 #include <utility>
+#include <variant>
 
 namespace ember::connection_pool {
 
 namespace sc = std::chrono;
 using namespace std::chrono_literals;
 
-template<typename ConType>
+/*
+ * Drivers can keep per-connection state in the pool's slot for the
+ * connection, such as prepared statements, by defining ConnectionState
+ */
+template<typename Driver>
+struct driver_state {
+	using type = std::monostate;
+};
+
+template<typename Driver>
+requires requires { typename Driver::ConnectionState; }
+struct driver_state<Driver> {
+	using type = typename Driver::ConnectionState;
+};
+
+template<typename Driver>
+using driver_state_t = typename driver_state<Driver>::type;
+
+template<typename ConType, typename State = std::monostate>
 struct ConnDetail {
 	ConType conn{};
+	State state{};
 	sc::seconds idle = 0s;
 	unsigned int id = 0;
 	bool empty_slot   : 1 = true;
@@ -38,16 +58,16 @@ struct ConnDetail {
 	ConnDetail() = default;
 };
 
-template<typename ConType>
+template<typename ConType, typename State = std::monostate>
 class Connection final {
-	using ReleaseHandler = std::function<void(Connection<ConType>&)>;
+	using ReleaseHandler = std::function<void(Connection&)>;
 
 	ReleaseHandler rh_;
 	bool released_ = false;
 	std::mutex close_protect_;
-	mutable std::reference_wrapper<ConnDetail<ConType>> detail_;
+	mutable std::reference_wrapper<ConnDetail<ConType, State>> detail_;
 
-	Connection(ReleaseHandler handler, ConnDetail<ConType>& detail)
+	Connection(ReleaseHandler handler, ConnDetail<ConType, State>& detail)
 	           : rh_(std::move(handler)), detail_(detail) {}
 
 public:
@@ -57,18 +77,20 @@ public:
 		}
 	}
 
-	Connection(Connection<ConType>&& src) noexcept
+	Connection(Connection&& src) noexcept
 	           : detail_(std::move(src.detail_)), rh_(std::move(src.rh_)) {
 		src.released_ = true;
 	}
 
-	Connection<ConType>& operator=(Connection<ConType>&& src) noexcept {
+	Connection& operator=(Connection&& src) noexcept {
 		if(!released_) {
 			rh_(*this);
 		}
 
+		rh_ = std::move(src.rh_);
 		released_ = src.released_;
 		detail_ = src.detail_;
+		src.released_ = true;
 		return *this;
 	}
 
@@ -81,12 +103,15 @@ public:
 		}
 	}
 
-	Connection(const Connection<ConType>& src) = delete;
-	Connection<ConType>& operator=(const Connection<ConType>& src) = delete;
+	Connection(const Connection& src) = delete;
+	Connection& operator=(const Connection& src) = delete;
 
 	ConType operator->() { return detail_.get().conn; }
 	ConType operator*() { return detail_.get().conn; }
 
+	// only to be used while the connection is checked out
+	State& state() { return detail_.get().state; }
+
 	template<typename A, typename B, typename C, unsigned int> friend class Pool;
 };
 
@@ -8,27 +8,34 @@
 
 #pragma once
 
+#include "AsyncWaiter.h"
 #include "Connection.h"
+#include "IndexList.h"
 #include "PoolManager.h"
 #include "Policies.h"
 #include "Exception.h"
 #include "LogSeverity.h"
 #include <shared/threading/Semaphore.h>
-#include <shared/threading/Spinlock.h>
+#include <boost/asio/async_result.hpp>
 #include <boost/assert.hpp>
 #include <boost/container/small_vector.hpp>
+#include <algorithm>
+#include <deque>
 #include <optional>
 #include <utility>
 #include <functional>
 #include <future>
-#include <list>
 #include <exception>
+#include <memory>
 #include <string>
 #include <mutex>
 #include <chrono>
 #include <atomic>
+#include <type_traits>
+#include <variant>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 
 namespace ember::connection_pool {
 
@@ -44,18 +51,51 @@ class Pool final : private ReusePolicy, private GrowthPolicy {
 	friend class PoolManager;
 
 	using ConType = typename Driver::ConnectionType;
+	using State = driver_state_t<Driver>;
+	using Detail = ConnDetail<ConType, State>;
 	using ReusePolicy::return_clean;
 	using GrowthPolicy::grow;
 
+	/*
+	 * Counts a thread as waiting for a connection for its lifetime, so
+	 * returning threads know whether to signal the semaphore. The fences
+	 * pair with the one in make_available so that either the waiter sees
+	 * the returned connection or the returner sees the waiter.
+	 */
+	class Waiter final {
+		std::atomic<std::size_t>& waiting_;
+
+	public:
+		explicit Waiter(std::atomic<std::size_t>& waiting) : waiting_(waiting) {
+			waiting_.fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+
+		~Waiter() {
+			waiting_.fetch_sub(1, std::memory_order_relaxed);
+		}
+	};
+
 	PoolManager<ConType, Driver, ReusePolicy, GrowthPolicy, size_hint> manager_;
 	Driver& driver_;
 	const std::size_t min_, max_;
 	std::atomic<std::size_t> size_;
-	Spinlock lock_;
-	boost::container::small_vector<ConnDetail<ConType>, size_hint> pool_;
-	boost::container::small_vector<std::atomic<bool>, size_hint> pool_guards_;
+	boost::container::small_vector<Detail, size_hint> pool_;
+	std::unique_ptr<std::atomic<std::uint32_t>[]> links_;
+
+	// every slot is in exactly one of these lists unless it's checked out
+	IndexList idle_;    // open & ready for use
+	IndexList pending_; // needs cleaning or closing by the manager
+	IndexList vacant_;  // no connection open
 
+	std::atomic<std::size_t> waiting_;
 	Semaphore<std::mutex> semaphore_;
+
+	// async_acquire callers, served in the order they arrived
+	std::deque<std::unique_ptr<AsyncWaiter<ConType, State>>> async_waiters_;
+	std::atomic<std::size_t> async_waiting_;
+	std::mutex async_lock_;
+
 	std::function<void(Severity, std::string)> log_cb_;
 	std::atomic_bool closed_;
 
@@ -66,8 +106,16 @@ class Pool final : private ReusePolicy, private GrowthPolicy {
 			connection.id = connection_id;
 			++connection_id;
 		}
+
+		for(auto i = pool_.size(); i > 0; --i) {
+			vacant_.push(static_cast<std::uint32_t>(i - 1));
+		}
 	}
 
+	/*
+	 * Only called on construction and from the pool manager, never
+	 * while a thread is trying to acquire a connection
+	 */
 	void open_connections(std::size_t num)  {
 		boost::container::small_vector<std::future<ConType>, size_hint> futures;
 		futures.reserve(num);
@@ -80,85 +128,166 @@ class Pool final : private ReusePolicy, private GrowthPolicy {
 			futures.emplace_back(std::move(f));
 		}
 
-		auto pool_it = pool_.begin();
-
 		for(auto& f : futures) {
-			while(!pool_it->empty_slot) {
-				++pool_it;
-				BOOST_ASSERT_MSG(pool_it != pool_.end(), "Exceeded maximum database connection count.");
+			auto conn = f.get();
+			const auto slot = vacant_.pop();
+			BOOST_ASSERT_MSG(slot, "Exceeded maximum database connection count.");
+
+			pool_[*slot] = Detail(conn, *slot);
+
+			if constexpr(!std::is_same_v<State, std::monostate>) {
+				driver_.open_state(conn, pool_[*slot].state);
 			}
 
-			*pool_it = std::move(ConnDetail<ConType>(f.get(), pool_it->id));
 			++size_;
+			make_available(*slot);
+		}
+	}
+
+	// per-connection state is released first as it may depend on the connection
+	void close_connection(Detail& detail) {
+		detail.state = State();
+		driver_.close(detail.conn);
+	}
+
+	void make_available(const std::uint32_t slot) {
+		idle_.push(slot);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if(async_waiting_.load(std::memory_order_relaxed)) {
+			std::lock_guard guard(async_lock_);
+			serve_async_waiters();
+		}
+
+		if(waiting_.load(std::memory_order_relaxed)) {
 			semaphore_.release();
 		}
 	}
 
-	bool find_free_connection(ConnDetail<ConType>& cd) {
-		bool checked_out = pool_guards_[cd.id].load(std::memory_order_relaxed);
+	Connection<ConType, State> checkout(const std::uint32_t slot) {
+		auto& detail = pool_[slot];
+		detail.checked_out = true;
+		detail.idle = 0s;
+
+		return Connection<ConType, State>([this](Connection<ConType, State>& arg) {
+			this->return_connection(arg);
+		}, detail);
+	}
 
-		if(checked_out) {
-			return false;
+	// must be called with async_lock_ held
+	void serve_async_waiters() {
+		while(!async_waiters_.empty()) {
+			const auto slot = idle_.pop();
+
+			if(!slot) {
+				break;
+			}
+
+			auto waiter = std::move(async_waiters_.front());
+			async_waiters_.pop_front();
+			async_waiting_.fetch_sub(1, std::memory_order_relaxed);
+			waiter->complete(nullptr, checkout(*slot));
 		}
+	}
 
-		std::atomic_thread_fence(std::memory_order_acquire);
-
-		if(!cd.error && !cd.sweep && !cd.empty_slot) {
-			if(cd.dirty && !return_clean()) {
-				try {
-					if(driver_.clean(cd.conn)) {
-						cd.dirty = false;
-					} else {
-						cd.sweep = true;
-						return false;
-					}
-				} catch(const std::exception& e) {
-					if(log_cb_) {
-						log_cb_(Severity::DEBUG, "On connection clean: "s + e.what());
-					}
-					return false;
-				}
+	/*
+	 * The waiter is counted before checking the idle list, pairing with
+	 * make_available in the same way as the blocking Waiter, so a connection
+	 * returned while it's being queued can't be missed
+	 */
+	void enqueue_async(std::unique_ptr<AsyncWaiter<ConType, State>> waiter) {
+		try {
+			manager_.check_exceptions();
+		} catch(...) {
+			waiter->complete(std::current_exception(), std::nullopt);
+			return;
+		}
+
+		{
+			std::lock_guard guard(async_lock_);
+			async_waiters_.emplace_back(std::move(waiter));
+			async_waiting_.fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			serve_async_waiters();
+
+			if(async_waiters_.empty()) {
+				return;
 			}
+		}
+
+		if(size_ < max_) {
+			manager_.request_growth();
+		}
+
+		manager_.wake(); // may need to track a new deadline
+	}
 
-			cd.checked_out = true;
-			cd.idle = 0s;
-			pool_guards_[cd.id].store(true, std::memory_order_relaxed);
+	/*
+	 * Fails any waiters past their deadline, returning the earliest
+	 * deadline of those remaining
+	 */
+	sc::steady_clock::time_point expire_async_waiters(const sc::steady_clock::time_point now) {
+		auto next = sc::steady_clock::time_point::max();
+		std::lock_guard guard(async_lock_);
+
+		std::erase_if(async_waiters_, [&](auto& waiter) {
+			if(waiter->deadline > now) {
+				next = std::min(next, waiter->deadline);
+				return false;
+			}
+
+			waiter->complete(std::make_exception_ptr(no_free_connections()), std::nullopt);
+			async_waiting_.fetch_sub(1, std::memory_order_relaxed);
 			return true;
+		});
+
+		return next;
+	}
+
+	void cancel_async_waiters() {
+		std::lock_guard guard(async_lock_);
+
+		for(auto& waiter : async_waiters_) {
+			waiter->complete(std::make_exception_ptr(exception("Connection pool closed")), std::nullopt);
 		}
 
-		return false;
+		async_waiters_.clear();
+		async_waiting_ = 0;
 	}
-	
-	std::optional<Connection<ConType>> get_connection() {
+
+	/*
+	 * Checking out a connection only pops an index from the idle list.
+	 * Cleaning, keep-alives and opening new connections are handled by
+	 * the manager thread, which is asked to grow the pool if the list is
+	 * empty. The caller can wait on the semaphore for that to happen.
+	 */
+	std::optional<Connection<ConType, State>> get_connection() {
 #ifdef DEBUG_NO_THREADS
 		manager_.run();
 #endif
 		manager_.check_exceptions();
 
-		std::unique_lock guard(lock_);
+		auto slot = idle_.pop();
 
-		auto res = std::ranges::find_if(pool_, [&](auto& arg) {
-			return find_free_connection(arg);
-		});
+		if(!slot) {
+			if(size_ < max_) {
+				manager_.request_growth();
+			}
 
-		if(res == pool_.end()) {
-			open_connections(grow(size(), max_));
+#ifdef DEBUG_NO_THREADS
+			manager_.run();
+			slot = idle_.pop();
 
-			res = std::ranges::find_if(pool_, [&](auto& arg) {
-				return find_free_connection(arg);
-			});
-			
-			if(res == pool_.end()) {
+			if(!slot) {
 				return std::nullopt;
 			}
+#else
+			return std::nullopt;
+#endif
 		}
 
-		guard.unlock();
 		driver_.thread_enter();
-
-		return Connection<ConType>([this](Connection<ConType>& arg) {
-			this->return_connection(arg);
-		}, *res);
+		return checkout(*slot);
 	}
 	
 public:
@@ -169,8 +298,13 @@ public:
 	      max_(max_size),
 		  manager_(this, interval, max_idle),
 		  pool_(max_size),
-		  pool_guards_(max_size),
+		  links_(std::make_unique<std::atomic<std::uint32_t>[]>(max_size)),
+		  idle_(links_.get()),
+		  pending_(links_.get()),
+		  vacant_(links_.get()),
 		  size_(0),
+		  waiting_(0),
+		  async_waiting_(0),
 		  closed_(false) {
 		if(!max_size) {
 			throw exception("Max. database connections cannot be zero");
@@ -191,6 +325,7 @@ public:
 		}
 
 		manager_.stop();
+		cancel_async_waiters();
 
 		for(auto& c : pool_) {
 			if(c.empty_slot) {
@@ -200,7 +335,7 @@ public:
 			BOOST_ASSERT_MSG(!c.checked_out, "Closed connection pool without returning all connections.");
 
 			try {
-				driver_.close(c.conn);
+				close_connection(c);
 			} catch(const std::exception& e) { 
 				if(log_cb_) {
 					log_cb_(Severity::ERROR, "Closing pool, driver threw: "s + e.what());
@@ -218,6 +353,7 @@ public:
 		int active = 0;
 
 		manager_.stop();
+		cancel_async_waiters();
 
 		for(auto& c : pool_) {
 			if(c.empty_slot) {
@@ -229,7 +365,7 @@ public:
 				continue;
 			}
 
-			driver_.close(c.conn);
+			close_connection(c);
 		}
 
 		if(active) {
@@ -237,8 +373,8 @@ public:
 		}
 	}
 
-	std::optional<Connection<ConType>> try_acquire() {
-		std::optional<Connection<ConType>> conn(get_connection());
+	std::optional<Connection<ConType, State>> try_acquire() {
+		std::optional<Connection<ConType, State>> conn(get_connection());
 
 		if(!conn) {
 			return std::nullopt;
@@ -253,8 +389,13 @@ public:
 	 * thread, only that a connection has been added to the pool/made available
 	 * for reuse.
 	 */
-	Connection<ConType> acquire() {
-		std::optional<Connection<ConType>> conn;
+	Connection<ConType, State> acquire() {
+		if(auto conn = get_connection()) {
+			return std::move(*conn);
+		}
+
+		Waiter waiter(waiting_);
+		std::optional<Connection<ConType, State>> conn;
 		
 		while(!(conn = get_connection())) {
 			semaphore_.acquire();
@@ -271,13 +412,18 @@ public:
 	 * are available, it will wait for the next notification and keep trying until
 	 * either the time has elapsed or it manages to get a connection.
 	 */
-	Connection<ConType> try_acquire_for(std::chrono::milliseconds duration) {
-		auto start = sc::high_resolution_clock::now();
-		std::optional<Connection<ConType>> conn;
+	Connection<ConType, State> try_acquire_for(std::chrono::milliseconds duration) {
+		if(auto conn = get_connection()) {
+			return std::move(*conn);
+		}
+
+		const auto start = sc::steady_clock::now();
+		Waiter waiter(waiting_);
+		std::optional<Connection<ConType, State>> conn;
 
 		while(!(conn = get_connection())) {
-			sc::milliseconds elapsed = sc::duration_cast<sc::milliseconds>
-				(sc::high_resolution_clock::now() - start);
+			const auto elapsed = sc::duration_cast<sc::milliseconds>
+				(sc::steady_clock::now() - start);
 			
 			if(elapsed >= duration) {
 				throw no_free_connections();
@@ -292,7 +438,49 @@ public:
 		return std::move(conn.value());
 	}
 
-	void return_connection(Connection<ConType>& connection) {
+	/*
+	 * Asynchronous counterpart to acquire, completing with the signature
+	 * void(std::exception_ptr, std::optional<Connection>), e.g.
+	 *
+	 *   auto conn = co_await pool.async_acquire(boost::asio::deferred);
+	 *
+	 * Waiters are served in FIFO order among themselves, although threads
+	 * blocking in acquire or try_acquire_for may still take a returned
+	 * connection first. The handler's executor is kept alive until it runs.
+	 */
+	template<typename CompletionToken>
+	auto async_acquire(CompletionToken&& token) {
+		return async_acquire_until(sc::steady_clock::time_point::max(),
+		                           std::forward<CompletionToken>(token));
+	}
+
+	/*
+	 * As above but completes with no_free_connections if a connection
+	 * can't be obtained within the given duration
+	 */
+	template<typename CompletionToken>
+	auto async_acquire_for(std::chrono::milliseconds duration, CompletionToken&& token) {
+		return async_acquire_until(sc::steady_clock::now() + duration,
+		                           std::forward<CompletionToken>(token));
+	}
+
+	template<typename CompletionToken>
+	auto async_acquire_until(sc::steady_clock::time_point deadline, CompletionToken&& token) {
+		using Signature = void(std::exception_ptr, std::optional<Connection<ConType, State>>);
+
+		return boost::asio::async_initiate<CompletionToken, Signature>(
+			[this, deadline](auto handler) {
+				using Waiter = AsyncWaiterImpl<Driver, std::decay_t<decltype(handler)>>;
+				enqueue_async(std::make_unique<Waiter>(driver_, std::move(handler), deadline));
+			}, token
+		);
+	}
+
+	/*
+	 * Connections that need further work before they can be reused are
+	 * handed to the manager rather than going straight back to the idle list
+	 */
+	void return_connection(Connection<ConType, State>& connection) {
 		auto& detail = connection.detail_.get();
 
 		if(return_clean()) {
@@ -306,12 +494,16 @@ public:
 
 		connection.released_ = true;
 		detail.checked_out = false;
-		std::atomic_thread_fence(std::memory_order_release);
-		pool_guards_[detail.id].store(false, std::memory_order_relaxed);
-
 		driver_.thread_exit();
+
+		if(detail.dirty || detail.sweep || detail.error) {
+			pending_.push(detail.id);
+			manager_.wake();
+		} else {
+			make_available(detail.id);
+		}
+
 		manager_.check_exceptions();
-		semaphore_.release();
 	}
 
 	std::size_t size() const {
@@ -324,12 +516,12 @@ public:
 
 	auto dirty() const {
 		return std::count_if(pool_.begin(), pool_.end(),
-			[](const ConnDetail<ConType>& c) { return c.dirty; });
+			[](const Detail& c) { return c.dirty; });
 	}
 
 	auto checked_out() const {
 		return std::count_if(pool_.begin(), pool_.end(),
-			[](const ConnDetail<ConType>& c) { return c.checked_out; });
+			[](const Detail& c) { return c.checked_out; });
 	}
 
 	Driver* get_driver() const {
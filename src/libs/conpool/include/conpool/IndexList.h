@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <cstdint>
+
+namespace ember::connection_pool {
+
+/*
+ * Lock-free LIFO of connection slot indices (a Treiber stack).
+ *
+ * A slot can only be in one list at a time, so the links are held in a
+ * table shared by every list over the same slots. The head is tagged with
+ * a counter that changes on every update to avoid ABA problems when a
+ * slot is popped and pushed back while another thread is mid-pop.
+ */
+class IndexList final {
+	static constexpr std::uint32_t END = 0xffffffff;
+
+	std::atomic<std::uint64_t> head_ { END };
+	std::atomic<std::uint32_t>* links_;
+
+	static std::uint32_t index(const std::uint64_t head) {
+		return static_cast<std::uint32_t>(head);
+	}
+
+	static std::uint64_t next_head(const std::uint64_t head, const std::uint32_t index) {
+		const auto tag = (head >> 32) + 1;
+		return (tag << 32) | index;
+	}
+
+public:
+	explicit IndexList(std::atomic<std::uint32_t>* links) : links_(links) {}
+
+	void push(const std::uint32_t slot) {
+		auto head = head_.load(std::memory_order_relaxed);
+
+		do {
+			links_[slot].store(index(head), std::memory_order_relaxed);
+		} while(!head_.compare_exchange_weak(head, next_head(head, slot),
+		                                     std::memory_order_release,
+		                                     std::memory_order_relaxed));
+	}
+
+	std::optional<std::uint32_t> pop() {
+		auto head = head_.load(std::memory_order_acquire);
+
+		while(index(head) != END) {
+			const auto next = links_[index(head)].load(std::memory_order_relaxed);
+
+			if(head_.compare_exchange_weak(head, next_head(head, next),
+			                               std::memory_order_acquire,
+			                               std::memory_order_acquire)) {
+				return index(head);
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	bool empty() const {
+		return index(head_.load(std::memory_order_relaxed)) == END;
+	}
+};
+
+} // connection_pool, ember
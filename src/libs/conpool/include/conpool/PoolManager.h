@@ -12,8 +12,11 @@
 #include "Connection.h"
 #include "ConnectionPool.h"
 #include "LogSeverity.h"
+#include <shared/threading/Semaphore.h>
 #include <shared/threading/Spinlock.h>
 #include <shared/threading/Utility.h>
+#include <boost/container/small_vector.hpp>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <string>
@@ -21,9 +24,9 @@
 #include <thread>
 #include <exception>
 #include <mutex>
-#include <condition_variable>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 
 namespace ember::connection_pool {
 
@@ -33,6 +36,16 @@ using namespace std::string_literals;
 
 template<typename Driver, typename ReusePolicy, typename GrowthPolicy, unsigned int> class Pool;
 
+/*
+ * Handles everything that might block on the database so that checking
+ * out a connection never has to: closing connections that have errored
+ * or been idle for too long, keep-alives, cleaning returned connections
+ * (for CheckoutClean) and growing the pool when it runs dry.
+ *
+ * Periodic maintenance runs on the interval but the thread can also be
+ * woken early by the pool when there's work waiting for it. It also fails
+ * any async_acquire callers that reach their deadline.
+ */
 template<typename ConType, typename Driver, typename ReusePolicy, typename GrowthPolicy, unsigned int size_hint>
 class PoolManager final {
 	using ConnectionPool = Pool<Driver, ReusePolicy, GrowthPolicy, size_hint>*;
@@ -41,26 +54,29 @@ class PoolManager final {
 	sc::seconds interval_, max_idle_;
 	std::thread manager_;
 	std::exception_ptr exception_;
-	std::condition_variable cond_;
-	std::mutex cond_lock_;
+	std::atomic_bool has_exception_ { false };
+	Semaphore<std::mutex> wake_ { 0, 1 };
+	std::mutex work_lock_;
 	std::atomic_bool stop_ { false };
+	std::atomic_bool grow_ { false };
 
-	void close(ConnDetail<ConType>& conn) {
+	void close(ConnDetail<ConType, driver_state_t<Driver>>& conn) {
 		try {
-			pool_->driver_.close(conn.conn);
+			pool_->close_connection(conn);
 		} catch(const std::exception& e) { 
 			if(pool_->log_cb_) {
 				pool_->log_cb_(Severity::ERROR, "Connection close, driver threw: "s + e.what());
 			}
 		}
 
-		conn = ConnDetail<ConType>();
-		std::atomic_thread_fence(std::memory_order_release);
-		pool_->pool_guards_[conn.id].store(true, std::memory_order_relaxed);
+		const auto id = conn.id;
+		conn = ConnDetail<ConType, driver_state_t<Driver>>();
+		conn.id = id;
 		--pool_->size_;
+		pool_->vacant_.push(id);
 	}
 
-	void refresh(ConnDetail<ConType>& conn) {
+	void refresh(ConnDetail<ConType, driver_state_t<Driver>>& conn) {
 		try {
 			conn.error = !pool_->driver_.keep_alive(conn.conn);
 			conn.idle = 0s;
@@ -72,26 +88,65 @@ class PoolManager final {
 			}
 		}
 
-		conn.refresh = false;
-		conn.checked_out = false;
-		std::atomic_thread_fence(std::memory_order_release);
-		pool_->pool_guards_[conn.id].store(false, std::memory_order_relaxed);
+		if(conn.error) {
+			close(conn);
+		} else {
+			pool_->make_available(conn.id);
+		}
+	}
+
+	void clean(ConnDetail<ConType, driver_state_t<Driver>>& conn) {
+		try {
+			if(pool_->driver_.clean(conn.conn)) {
+				conn.dirty = false;
+				pool_->make_available(conn.id);
+				return;
+			}
+		} catch(const std::exception& e) {
+			if(pool_->log_cb_) {
+				pool_->log_cb_(Severity::DEBUG, "On connection clean: "s + e.what());
+			}
+		}
+
+		close(conn);
+	}
+
+	// Connections handed back by the pool that can't be reused as-is
+	void process_pending() {
+		while(auto slot = pool_->pending_.pop()) {
+			auto& conn = pool_->pool_[*slot];
+
+			if(conn.sweep || conn.error) {
+				close(conn);
+			} else if(conn.dirty) {
+				clean(conn);
+			} else {
+				pool_->make_available(conn.id);
+			}
+		}
+	}
+
+	// If a thread found no idle connections, try to grow the pool
+	void grow() {
+		if(!grow_.exchange(false) || !pool_->idle_.empty()) {
+			return;
+		}
 
-		if(!conn.error) {
-			pool_->semaphore_.release();
+		try {
+			pool_->open_connections(pool_->grow(pool_->size_, pool_->max_));
+		} catch(const std::exception& e) {
+			if(pool_->log_cb_) {
+				pool_->log_cb_(Severity::ERROR, "Failed to grow connection pool: "s + e.what());
+			}
 		}
 	}
 
 	// If the pool has grown too small, try to refill it
 	void refill() {
-		std::unique_lock guard(pool_->lock_);
-
 		if(pool_->size_ < pool_->min_) {
 			try {
 				pool_->open_connections(pool_->min_ - pool_->size_);
 			} catch(const std::exception& e) { 
-				guard.unlock();
-
 				if(pool_->log_cb_) {
 					pool_->log_cb_(Severity::ERROR, "Failed to refill connection pool: "s + e.what());
 				}
@@ -99,52 +154,61 @@ class PoolManager final {
 		}
 	}
 
-	void maintain_connections() {
-		for(auto& conn : pool_->pool_) {
-			if(conn.empty_slot) {
-				continue;
-			} else if(conn.sweep || conn.error) {
-				close(conn);
-			} else if(conn.refresh) {
-				refresh(conn);
-			}
-		}
-
-		refill();
-	}
-
-	void set_connection_flags() {
-		std::lock_guard guard(pool_->lock_);
+	/*
+	 * Takes every idle connection out of the pool to age them, immediately
+	 * putting back any that don't need attention. Anything that has been idle
+	 * for too long is closed if the pool is above its minimum size or sent a
+	 * keep-alive otherwise.
+	 */
+	void expire_idle() {
+		boost::container::small_vector<std::uint32_t, size_hint> drained, stale;
 		std::size_t excess_connections = 0;
 
 		if(pool_->size_ > pool_->min_) {
-			excess_connections = pool_->pool_.size() - pool_->min_;
+			excess_connections = pool_->size_ - pool_->min_;
 		}
 
-		for(auto& conn : pool_->pool_) {
-			if(conn.checked_out || conn.empty_slot) {
-				continue;
-			}
+		while(auto slot = pool_->idle_.pop()) {
+			drained.emplace_back(*slot);
+		}
+
+		// preserve the ordering so the most recently used remain on top
+		for(auto it = drained.rbegin(); it != drained.rend(); ++it) {
+			auto& conn = pool_->pool_[*it];
 
 			if(conn.idle < max_idle_) {
 				conn.idle += interval_;
-			} else if(excess_connections > 0) {
-				--excess_connections;
-				conn.checked_out = true;
-				conn.sweep = true;
+				pool_->make_available(*it);
 			} else {
-				conn.checked_out = true;
-				conn.refresh = true;
+				stale.emplace_back(*it);
 			}
+		}
 
-			std::atomic_thread_fence(std::memory_order_release);
-			pool_->pool_guards_[conn.id].store(conn.checked_out, std::memory_order_relaxed);
+		for(const auto slot : stale) {
+			auto& conn = pool_->pool_[slot];
+
+			if(excess_connections > 0) {
+				--excess_connections;
+				close(conn);
+			} else {
+				refresh(conn);
+			}
 		}
 	}
 
+	// returns the next deadline of any async waiters
+	sc::steady_clock::time_point service() {
+		std::lock_guard guard(work_lock_);
+		process_pending();
+		grow();
+		return pool_->expire_async_waiters(sc::steady_clock::now());
+	}
+
 	void manage_pool() {
-		set_connection_flags();
-		maintain_connections();
+		std::lock_guard guard(work_lock_);
+		expire_idle();
+		process_pending();
+		refill();
 	}
 
 public:
@@ -154,6 +218,10 @@ public:
 		  max_idle_(max_idle) {}
 
 	void check_exceptions() {
+		if(!has_exception_.load(std::memory_order_acquire)) {
+			return;
+		}
+
 		std::lock_guard lock(exception_lock_);
 
 		if(exception_) {
@@ -161,16 +229,43 @@ public:
 		}
 	}
 
+	void wake() {
+		wake_.release();
+	}
+
+	void request_growth() {
+		if(!grow_.exchange(true)) {
+			wake();
+		}
+	}
+
 	void run() try {
 		pool_->driver_.thread_enter();
-		std::unique_lock lock(cond_lock_);
 
 #ifndef DEBUG_NO_THREADS
+		auto next_maintenance = sc::steady_clock::now() + interval_;
+		auto next_deadline = sc::steady_clock::time_point::max();
+
 		while(!stop_) {
-			cond_.wait_for(lock, interval_);
-			manage_pool();
+			const auto remaining = sc::ceil<sc::milliseconds>(
+				std::min(next_maintenance, next_deadline) - sc::steady_clock::now()
+			);
+
+			wake_.try_acquire_for(std::max(remaining, sc::milliseconds(0)));
+
+			if(stop_) {
+				break;
+			}
+
+			next_deadline = service();
+
+			if(sc::steady_clock::now() >= next_maintenance) {
+				manage_pool();
+				next_maintenance = sc::steady_clock::now() + interval_;
+			}
 		}
 #else
+		service();
 		manage_pool();
 #endif
 
@@ -178,6 +273,7 @@ public:
 	} catch(...) {
 		std::lock_guard lock(exception_lock_);
 		exception_ = std::current_exception();
+		has_exception_.store(true, std::memory_order_release);
 
 		if(pool_->log_cb_) {
 			pool_->log_cb_(Severity::DEBUG, "Pool manager trapped exception - passing to next caller");
@@ -187,7 +283,7 @@ public:
 	void stop() {
 		if(manager_.joinable()) {
 			stop_ = true;
-			cond_.notify_one();
+			wake();
 			manager_.join();
 		}
 
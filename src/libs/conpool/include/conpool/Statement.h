@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+namespace ember::connection_pool {
+
+/*
+ * A query that's given a dense, process-wide ID when it's registered,
+ * allowing drivers to keep prepared statements in a per-connection
+ * array rather than looking them up by their text.
+ *
+ * Statements should be declared at namespace scope (inline) so they're
+ * registered before any connections are opened, which allows them to
+ * be prepared as soon as a connection is established. The query text
+ * must outlive the statement, so use string literals.
+ */
+class Statement final {
+	struct Registry {
+		std::mutex lock;
+		std::vector<const Statement*> statements;
+	};
+
+	static Registry& registry() {
+		static Registry registry;
+		return registry;
+	}
+
+	std::size_t id_;
+	std::string_view query_;
+
+public:
+	explicit Statement(std::string_view query) : query_(query) {
+		auto& reg = registry();
+		std::lock_guard guard(reg.lock);
+		id_ = reg.statements.size();
+		reg.statements.emplace_back(this);
+	}
+
+	Statement(const Statement&) = delete;
+	Statement& operator=(const Statement&) = delete;
+
+	std::size_t id() const {
+		return id_;
+	}
+
+	std::string_view query() const {
+		return query_;
+	}
+
+	static std::vector<const Statement*> registered() {
+		auto& reg = registry();
+		std::lock_guard guard(reg.lock);
+		return reg.statements;
+	}
+};
+
+} // connection_pool, ember
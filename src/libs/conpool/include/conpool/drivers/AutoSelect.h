@@ -12,6 +12,7 @@
 	#include <conpool/drivers/MySQL/Driver.h>
 	#include <conpool/drivers/MySQL/Config.h>
 #elif DB_POSTGRESQL
+	#include <conpool/drivers/PostgreSQL/Driver.h>
 	#include <conpool/drivers/PostgreSQL/Config.h>
 #endif
 
@@ -8,26 +8,27 @@
 
 #pragma once
 
+#include <conpool/drivers/DummyConnection.h>
 #include <string>
 
-namespace ember { 
-
-class DummyConnection;
-
-namespace drivers {
+namespace ember::drivers {
 
+/*
+ * Does nothing, for testing & benchmarking the pool itself
+ */
 class DummyDriver final {
 public:
-	DummyDriver();
+	using ConnectionType = DummyConnection;
+
 	DummyConnection open() const;
-	DummyConnection clean(DummyConnection conn) const;
+	bool clean(DummyConnection conn) const;
 	void close(DummyConnection conn) const;
 	void clear_state(DummyConnection conn) const;
-	DummyConnection keep_alive(DummyConnection conn) const;
+	bool keep_alive(DummyConnection conn) const;
 	void thread_enter() const;
 	void thread_exit() const;
 	std::string name() const;
 	std::string version() const;
 };
 
-}} // drivers, ember
\ No newline at end of file
+} // drivers, ember
@@ -8,15 +8,12 @@
 
 #pragma once
 
-#include <shared/utility/StringHash.h>
-#include <boost/unordered/unordered_flat_map.hpp>
-#include <algorithm>
-#include <functional>
+#include <conpool/Statement.h>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
-#include <utility>
+#include <vector>
 #include <cstdint>
 
 namespace sql {
@@ -36,23 +33,21 @@ struct StatementDeleter {
 class MySQL final {
 	inline static std::mutex driver_lock; // MySQL driver needs to be locked globally
 
-	using UniqueStmt = std::unique_ptr<sql::PreparedStatement, StatementDeleter>;
-
-	using QueryCache = boost::unordered_flat_map<std::string, UniqueStmt,
-		StringHash, std::equal_to<>>;
-
 	const std::string dsn, database, username, password;
 	sql::Driver* driver;
-	mutable boost::unordered_flat_map<const sql::Connection*, QueryCache> cache_;
-	mutable std::mutex cache_lock_;
-
-	QueryCache* locate_cache(const sql::Connection* conn) const;
-	void close_cache(const sql::Connection* conn) const;
-	sql::PreparedStatement* lookup_statement(const sql::Connection* conn, std::string_view key);
-	void cache_statement(const sql::Connection* conn, std::string key, UniqueStmt value);
 
 public:
 	using ConnectionType = sql::Connection*;
+	using UniqueStmt = std::unique_ptr<sql::PreparedStatement, StatementDeleter>;
+
+	/*
+	 * Held in the pool's slot for each connection, so looking up a
+	 * statement is an index into an array only ever touched by the
+	 * thread that has the connection checked out
+	 */
+	struct ConnectionState {
+		std::vector<UniqueStmt> statements; // indexed by Statement::id
+	};
 
 	MySQL(std::string user, std::string password, std::string_view host, std::uint16_t port,
 	      std::string db = "");
@@ -62,7 +57,6 @@ public:
 		  database(rhs.database),
 		  username(rhs.username),
 		  password(rhs.password),
-		  cache_(std::move(rhs.cache_)),
 		  driver(rhs.driver) { }
 
 	MySQL& operator=(MySQL&&) = delete;
@@ -73,13 +67,19 @@ public:
 	static std::string version();
 
 	sql::Connection* open() const;
+	void open_state(sql::Connection* conn, ConnectionState& state) const;
 	bool clean(sql::Connection* conn) const;
 	void close(sql::Connection* conn) const;
 	bool keep_alive(sql::Connection* conn) const;
 	void thread_enter() const;
 	void thread_exit() const;
-	sql::PreparedStatement* prepare_cached(sql::Connection* conn, std::string key);
-	sql::PreparedStatement* prepare_cached(sql::Connection* conn, std::string_view key);
+
+	sql::PreparedStatement* prepare_cached(sql::Connection* conn, ConnectionState& state,
+	                                       const connection_pool::Statement& statement) const;
+
+	sql::PreparedStatement* prepare_cached(auto& conn, const connection_pool::Statement& statement) const {
+		return prepare_cached(*conn, conn.state(), statement);
+	}
 };
 
 } // drivers, ember
\ No newline at end of file
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <conpool/drivers/PostgreSQL/Driver.h>
+#include <string>
+#include <string_view>
+
+namespace ember::drivers {
+
+PostgreSQL init_db_driver(const std::string& config_path, std::string_view section);
+
+} // drivers, ember
\ No newline at end of file
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <conpool/drivers/PostgreSQL/Params.h>
+#include <conpool/drivers/PostgreSQL/Pipeline.h>
+#include <conpool/drivers/PostgreSQL/Result.h>
+#include <conpool/Statement.h>
+#include <libpq-fe.h>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace ember::drivers {
+
+/*
+ * libpq driver. Every statement is prepared and results are always
+ * requested in the binary format, so fields are decoded directly rather
+ * than parsed from text.
+ */
+class PostgreSQL final {
+	const std::string conninfo_;
+
+	void prepare(PGconn* conn, pg::ConnectionState& state, const connection_pool::Statement& statement) const;
+
+public:
+	using ConnectionType = PGconn*;
+	using ConnectionState = pg::ConnectionState;
+
+	PostgreSQL(std::string user, std::string password, std::string_view host, std::uint16_t port,
+	           std::string db = "");
+	explicit PostgreSQL(std::string conninfo);
+
+	static std::string name();
+	static std::string version();
+
+	PGconn* open() const;
+	void open_state(PGconn* conn, ConnectionState& state) const;
+	bool clean(PGconn* conn) const;
+	void close(PGconn* conn) const;
+	bool keep_alive(PGconn* conn) const;
+	void thread_enter() const;
+	void thread_exit() const;
+
+	pg::Result execute(PGconn* conn, ConnectionState& state,
+	                   const connection_pool::Statement& statement,
+	                   const pg::Params& params = pg::Params()) const;
+
+	pg::Result execute(auto& conn, const connection_pool::Statement& statement,
+	                   const pg::Params& params = pg::Params()) const {
+		return execute(*conn, conn.state(), statement, params);
+	}
+
+	// unprepared and unparameterised, for transaction control, DDL, etc
+	pg::Result simple_query(PGconn* conn, const char* query) const;
+
+	pg::Pipeline pipeline(auto& conn) const {
+		return pg::Pipeline(*conn, conn.state());
+	}
+};
+
+} // drivers, ember
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <deque>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <cstdint>
+
+namespace ember::drivers::pg {
+
+/*
+ * Statement parameters, referenced in place rather than copied where
+ * possible, so any strings or buffers passed in must outlive execution.
+ *
+ * Strings and byte arrays are sent in the binary format, which for text
+ * and bytea is just the raw bytes and avoids any escaping. Numbers are
+ * sent as text, as the width the server expects depends on the type it
+ * inferred for the parameter when the statement was prepared.
+ *
+ * Arrays are sent as text literals (e.g. {1,2,3}), allowing multiple
+ * rows to be passed to a single statement through unnest() or ANY().
+ */
+class Params final {
+	enum Format { TEXT = 0, BINARY = 1 };
+
+	std::vector<const char*> values_;
+	std::vector<int> lengths_;
+	std::vector<int> formats_;
+	std::deque<std::array<char, 32>> scratch_;
+	std::deque<std::string> literals_;
+
+	void push(const char* value, const std::size_t length, const Format format) {
+		values_.emplace_back(value);
+		lengths_.emplace_back(static_cast<int>(length));
+		formats_.emplace_back(format);
+	}
+
+public:
+	Params() = default;
+
+	template<typename... Args>
+	explicit Params(const Args&... args) {
+		values_.reserve(sizeof...(Args));
+		lengths_.reserve(sizeof...(Args));
+		formats_.reserve(sizeof...(Args));
+		(add(args), ...);
+	}
+
+	// values may point into scratch, which doesn't survive copying
+	Params(const Params&) = delete;
+	Params& operator=(const Params&) = delete;
+	Params(Params&&) = default;
+	Params& operator=(Params&&) = default;
+
+	Params& add(std::nullopt_t) {
+		push(nullptr, 0, TEXT);
+		return *this;
+	}
+
+	Params& add(std::string_view value) {
+		push(value.data(), value.size(), BINARY);
+		return *this;
+	}
+
+	Params& add(std::span<const std::uint8_t> value) {
+		push(reinterpret_cast<const char*>(value.data()), value.size(), BINARY);
+		return *this;
+	}
+
+	template<std::same_as<bool> T>
+	Params& add(const T value) {
+		push(value? "t" : "f", 1, TEXT);
+		return *this;
+	}
+
+	template<typename T>
+	requires (std::is_arithmetic_v<T> && !std::same_as<T, bool>)
+	Params& add(const T value) {
+		auto& buffer = scratch_.emplace_back();
+		const auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size() - 1, value);
+		*end = '\0'; // text parameters are read up to the null terminator
+		push(buffer.data(), end - buffer.data(), TEXT);
+		return *this;
+	}
+
+	template<typename T>
+	requires (std::is_arithmetic_v<T> && !std::same_as<T, bool> && !std::same_as<T, std::uint8_t>)
+	Params& add(std::span<const T> values) {
+		auto& literal = literals_.emplace_back("{");
+		std::array<char, 32> buffer;
+
+		for(std::size_t i = 0; i < values.size(); ++i) {
+			if(i) {
+				literal.push_back(',');
+			}
+
+			const auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), values[i]);
+			literal.append(buffer.data(), end);
+		}
+
+		literal.push_back('}');
+		push(literal.c_str(), literal.size(), TEXT);
+		return *this;
+	}
+
+	template<typename T>
+	Params& add(const std::vector<T>& values) {
+		return add(std::span<const T>(values));
+	}
+
+	Params& add(std::span<const std::string> values) {
+		auto& literal = literals_.emplace_back("{");
+
+		// elements are quoted so that commas, braces & the like are taken literally
+		for(std::size_t i = 0; i < values.size(); ++i) {
+			literal += i? ",\"" : "\"";
+
+			for(const auto c : values[i]) {
+				if(c == '"' || c == '\\') {
+					literal.push_back('\\');
+				}
+
+				literal.push_back(c);
+			}
+
+			literal.push_back('"');
+		}
+
+		literal.push_back('}');
+		push(literal.c_str(), literal.size(), TEXT);
+		return *this;
+	}
+
+	template<typename T>
+	Params& add(const std::optional<T>& value) {
+		return value? add(*value) : add(std::nullopt);
+	}
+
+	int size() const {
+		return static_cast<int>(values_.size());
+	}
+
+	const char* const* values() const {
+		return values_.data();
+	}
+
+	const int* lengths() const {
+		return lengths_.data();
+	}
+
+	const int* formats() const {
+		return formats_.data();
+	}
+};
+
+} // pg, drivers, ember
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <conpool/drivers/PostgreSQL/Params.h>
+#include <conpool/drivers/PostgreSQL/Result.h>
+#include <conpool/Statement.h>
+#include <libpq-fe.h>
+#include <array>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember::drivers::pg {
+
+/*
+ * Held in the pool's slot for each connection. Statements are prepared
+ * server-side under a name derived from their ID, so this only needs to
+ * track which IDs have been prepared on the connection.
+ */
+struct ConnectionState {
+	std::vector<std::uint8_t> prepared; // indexed by Statement::id
+};
+
+class StatementName final {
+	std::array<char, 24> name_ {};
+
+public:
+	explicit StatementName(std::size_t id);
+
+	const char* c_str() const {
+		return name_.data();
+	}
+};
+
+/*
+ * Queues statements in libpq's pipeline mode so they're sent together
+ * and their results read back in a single round trip. Statements that
+ * haven't been prepared on this connection yet are prepared as part of
+ * the same batch.
+ *
+ * As with any pipeline, a failure aborts every statement after it, so
+ * only batch statements that are independent or that are wrapped in a
+ * transaction within the batch.
+ */
+class Pipeline final {
+	enum class Command : std::uint8_t {
+		PREPARE, QUERY
+	};
+
+	struct Queued {
+		Command command;
+		std::size_t id;
+	};
+
+	PGconn* conn_;
+	ConnectionState& state_;
+	std::vector<Queued> queued_;
+	std::size_t queries_ = 0;
+	bool active_ = false;
+
+	std::vector<Result> collect(std::string& failure);
+
+public:
+	Pipeline(PGconn* conn, ConnectionState& state);
+	~Pipeline();
+
+	Pipeline(const Pipeline&) = delete;
+	Pipeline& operator=(const Pipeline&) = delete;
+
+	// returns the index of the statement's result in the vector returned by sync
+	std::size_t send(const connection_pool::Statement& statement, const Params& params = Params());
+	std::vector<Result> sync();
+};
+
+} // pg, drivers, ember
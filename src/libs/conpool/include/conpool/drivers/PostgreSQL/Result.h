@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <conpool/Exception.h>
+#include <boost/endian/conversion.hpp>
+#include <libpq-fe.h>
+#include <bit>
+#include <concepts>
+#include <format>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace ember::drivers::pg {
+
+class error final : public connection_pool::exception {
+public:
+	error(const std::string& msg) : exception(msg) { }
+};
+
+// built-in type OIDs, as defined in pg_type.dat
+enum class Type : Oid {
+	BOOL    = 16,
+	BYTEA   = 17,
+	NAME    = 19,
+	INT8    = 20,
+	INT2    = 21,
+	INT4    = 23,
+	TEXT    = 25,
+	OID     = 26,
+	FLOAT4  = 700,
+	FLOAT8  = 701,
+	BPCHAR  = 1042,
+	VARCHAR = 1043
+};
+
+struct ResultDeleter {
+	void operator()(PGresult* res) const {
+		PQclear(res);
+	}
+};
+
+/*
+ * Wraps a result set requested in the binary format, decoding fields
+ * based on the column's type rather than parsing text. Conversions
+ * that would lose information (e.g. out of range integers, or reading
+ * an integer column as a string) throw rather than truncate.
+ */
+class Result final {
+	std::unique_ptr<PGresult, ResultDeleter> res_;
+
+	std::string_view raw(const int row, const int col) const {
+		return {
+			PQgetvalue(res_.get(), row, col),
+			static_cast<std::size_t>(PQgetlength(res_.get(), row, col))
+		};
+	}
+
+	Type type(const int col) const {
+		return static_cast<Type>(PQftype(res_.get(), col));
+	}
+
+	template<typename T>
+	T read(std::string_view data, const int col) const {
+		if(data.size() != sizeof(T)) {
+			throw error(std::format("Unexpected field length in column {}", PQfname(res_.get(), col)));
+		}
+
+		T value;
+		std::memcpy(&value, data.data(), sizeof(T));
+		return boost::endian::big_to_native(value);
+	}
+
+	std::int64_t integer(const int row, const int col) const {
+		const auto data = raw(row, col);
+
+		switch(type(col)) {
+			case Type::BOOL:
+				return read<std::uint8_t>(data, col);
+			case Type::INT2:
+				return read<std::int16_t>(data, col);
+			case Type::INT4:
+				return read<std::int32_t>(data, col);
+			case Type::OID:
+				return read<std::uint32_t>(data, col);
+			case Type::INT8:
+				return read<std::int64_t>(data, col);
+			default:
+				throw error(std::format("Column {} is not an integer", PQfname(res_.get(), col)));
+		}
+	}
+
+	double floating(const int row, const int col) const {
+		const auto data = raw(row, col);
+
+		switch(type(col)) {
+			case Type::FLOAT4:
+				return std::bit_cast<float>(read<std::uint32_t>(data, col));
+			case Type::FLOAT8:
+				return std::bit_cast<double>(read<std::uint64_t>(data, col));
+			default:
+				return static_cast<double>(integer(row, col));
+		}
+	}
+
+	// the binary format for text and bytea is the raw bytes
+	std::string_view bytes(const int row, const int col) const {
+		switch(type(col)) {
+			case Type::TEXT:
+			case Type::VARCHAR:
+			case Type::BPCHAR:
+			case Type::NAME:
+			case Type::BYTEA:
+				return raw(row, col);
+			default:
+				throw error(std::format("Column {} is not a string", PQfname(res_.get(), col)));
+		}
+	}
+
+public:
+	Result() = default;
+	explicit Result(PGresult* res) : res_(res) { }
+
+	bool ok() const {
+		switch(PQresultStatus(res_.get())) {
+			case PGRES_COMMAND_OK:
+			case PGRES_TUPLES_OK:
+			case PGRES_EMPTY_QUERY:
+			case PGRES_PIPELINE_SYNC:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	std::string message() const {
+		return res_? PQresultErrorMessage(res_.get()) : "No result";
+	}
+
+	int rows() const {
+		return res_? PQntuples(res_.get()) : 0;
+	}
+
+	bool empty() const {
+		return !rows();
+	}
+
+	// rows affected by INSERT, UPDATE, DELETE, etc
+	std::uint64_t affected() const {
+		return res_? std::strtoull(PQcmdTuples(res_.get()), nullptr, 10) : 0;
+	}
+
+	int column(const char* name) const {
+		const auto col = PQfnumber(res_.get(), name);
+
+		if(col < 0) {
+			throw error(std::format("Unknown column: {}", name));
+		}
+
+		return col;
+	}
+
+	bool is_null(const int row, const int col) const {
+		return PQgetisnull(res_.get(), row, col);
+	}
+
+	template<typename T>
+	T get(const int row, const int col) const {
+		if(is_null(row, col)) {
+			throw error(std::format("Unexpected null in column {}", PQfname(res_.get(), col)));
+		}
+
+		if constexpr(std::same_as<T, bool>) {
+			return integer(row, col) != 0;
+		} else if constexpr(std::integral<T>) {
+			const auto value = integer(row, col);
+
+			if(!std::in_range<T>(value)) {
+				throw error(std::format("Value out of range in column {}", PQfname(res_.get(), col)));
+			}
+
+			return static_cast<T>(value);
+		} else if constexpr(std::floating_point<T>) {
+			return static_cast<T>(floating(row, col));
+		} else if constexpr(std::same_as<T, std::string>) {
+			return std::string(bytes(row, col));
+		} else if constexpr(std::same_as<T, std::vector<std::uint8_t>>) {
+			const auto data = bytes(row, col);
+			return { data.begin(), data.end() };
+		} else {
+			static_assert(!sizeof(T), "Unsupported field type");
+		}
+	}
+
+	template<typename T>
+	T get(const int row, const char* name) const {
+		return get<T>(row, column(name));
+	}
+
+	template<typename T>
+	std::optional<T> get_optional(const int row, const char* name) const {
+		const auto col = column(name);
+
+		if(is_null(row, col)) {
+			return std::nullopt;
+		}
+
+		return get<T>(row, col);
+	}
+};
+
+} // pg, drivers, ember
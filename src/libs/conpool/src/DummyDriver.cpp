@@ -7,46 +7,28 @@
  */
 
 #include <conpool/drivers/DummyDriver.h>
-#include <conpool/drivers/DummyConnection.h>
-#include <iostream>
 
 namespace ember::drivers {
-	
-DummyDriver::DummyDriver() {
-	std::cout << "DummyDriver opened\n";
-}
 
 DummyConnection DummyDriver::open() const {
-	std::cout << "DummyConnection opened\n";
 	return DummyConnection();
 }
 
-DummyConnection DummyDriver::clean(DummyConnection conn) const {
-	std::cout << "DummyConnection cleaned\n";
-	return conn;
-}
-
-void DummyDriver::close(DummyConnection conn) const {
-	std::cout << "DummyConnection closed\n";
+bool DummyDriver::clean(DummyConnection conn) const {
+	return true;
 }
 
+void DummyDriver::close(DummyConnection conn) const {}
 
-void DummyDriver::clear_state(DummyConnection conn) const {
-	std::cout << "DummyConnection state cleared\n";
-}
+void DummyDriver::clear_state(DummyConnection conn) const {}
 
-DummyConnection DummyDriver::keep_alive(DummyConnection conn) const {
-	std::cout << "DummyConnection keep-alive\n";
-	return conn;
+bool DummyDriver::keep_alive(DummyConnection conn) const {
+	return true;
 }
 
-void DummyDriver::thread_enter() const {
-	std::cout << "DummyDriver thread enter\n";
-}
+void DummyDriver::thread_enter() const {}
 
-void DummyDriver::thread_exit() const {
-	std::cout << "DummyDriver thread exit\n";
-}
+void DummyDriver::thread_exit() const {}
 
 std::string DummyDriver::name() const {
 	return "DummyDriver";
@@ -56,4 +38,4 @@ std::string DummyDriver::version() const {
 	return "1.0";
 }
 
-} // drivers, ember
\ No newline at end of file
+} // drivers, ember
@@ -54,12 +54,6 @@ void MySQL::close(sql::Connection* conn) const {
 		conn->close();
 	}
 
-	auto conn_cache = locate_cache(conn);
-
-	if(conn_cache) {
-		close_cache(conn);
-	}
-
 	thread_exit();
 }
 
@@ -98,65 +92,43 @@ std::string MySQL::version() {
 		 driver->getMinorVersion(), driver->getPatchVersion());
 }
 
-sql::PreparedStatement* MySQL::prepare_cached(sql::Connection* conn, std::string key) {
-	auto stmt = lookup_statement(conn, key);
-
-	if(!stmt) {
-		stmt = conn->prepareStatement(key);
-		cache_statement(conn, std::move(key), UniqueStmt(stmt));
-	}
-
-	return stmt;
-}
+/*
+ * Prepares every statement registered so far, so the first queries on
+ * a new connection don't have to. Failures are left to be reported when
+ * the statement is actually used, as not every registered statement
+ * will be valid for the schema this connection is using.
+ */
+void MySQL::open_state(sql::Connection* conn, ConnectionState& state) const {
+	const auto statements = connection_pool::Statement::registered();
+	state.statements.resize(statements.size());
+	thread_enter();
 
-sql::PreparedStatement* MySQL::prepare_cached(sql::Connection* conn, std::string_view key) {
-	auto stmt = lookup_statement(conn, key);
-	
-	if(!stmt) {
-		std::string strkey(key);
-		stmt = conn->prepareStatement(strkey);
-		cache_statement(conn, std::move(strkey), UniqueStmt(stmt));
+	for(const auto statement : statements) {
+		try {
+			const std::string query(statement->query());
+			state.statements[statement->id()].reset(conn->prepareStatement(query));
+		} catch(const sql::SQLException&) {}
 	}
 
-	return stmt;
+	thread_exit();
 }
 
-sql::PreparedStatement* MySQL::lookup_statement(const sql::Connection* conn, std::string_view key) {
-	auto conn_cache = locate_cache(conn);
+sql::PreparedStatement* MySQL::prepare_cached(sql::Connection* conn, ConnectionState& state,
+                                              const connection_pool::Statement& statement) const {
+	const auto id = statement.id();
 
-	if(!conn_cache) {
-		return nullptr;
+	if(id >= state.statements.size()) [[unlikely]] {
+		state.statements.resize(id + 1);
 	}
 
-	auto conn_cache_it = conn_cache->find(key);
-	
-	if(conn_cache_it == conn_cache->end()) {
-		return nullptr;
-	}
+	auto& stmt = state.statements[id];
 
-	return conn_cache_it->second.get();
-}
-
-void MySQL::cache_statement(const sql::Connection* conn, std::string key, UniqueStmt value) {
-	std::lock_guard lock(cache_lock_);
-	cache_[conn].emplace(std::move(key), std::move(value));
-}
-
-MySQL::QueryCache* MySQL::locate_cache(const sql::Connection* conn) const {
-	std::lock_guard lock(cache_lock_);
-	auto cache_it = cache_.find(conn);
-
-	if(cache_it == cache_.end()) {
-		return nullptr;
+	if(!stmt) [[unlikely]] {
+		const std::string query(statement.query());
+		stmt.reset(conn->prepareStatement(query));
 	}
 
-	return &cache_it->second;
-}
-
-void MySQL::close_cache(const sql::Connection* conn) const {
-	// todo - iterators (ex. erased element) not invalidated by erase, research
-	std::lock_guard lock(cache_lock_);
-	cache_.erase(conn);
+	return stmt.get();
 }
 
 // we do this so we can forward declare sql::PreparedStatement
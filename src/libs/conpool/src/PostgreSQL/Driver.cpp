@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <conpool/drivers/PostgreSQL/Driver.h>
+#include <format>
+#include <utility>
+
+namespace ember::drivers {
+
+namespace {
+
+// conninfo values are quoted, so only quotes and backslashes need escaping
+std::string quote(std::string_view value) {
+	std::string quoted("'");
+
+	for(const auto c : value) {
+		if(c == '\'' || c == '\\') {
+			quoted.push_back('\\');
+		}
+
+		quoted.push_back(c);
+	}
+
+	quoted.push_back('\'');
+	return quoted;
+}
+
+void check(const pg::Result& result) {
+	if(!result.ok()) {
+		throw pg::error(result.message());
+	}
+}
+
+} // unnamed
+
+PostgreSQL::PostgreSQL(std::string user, std::string pass, std::string_view host, std::uint16_t port,
+                       std::string db)
+	: conninfo_(std::format("host={} port={} user={} password={}{}", quote(host), port, quote(user),
+	                        quote(pass), db.empty()? "" : " dbname=" + quote(db))) { }
+
+PostgreSQL::PostgreSQL(std::string conninfo) : conninfo_(std::move(conninfo)) { }
+
+PGconn* PostgreSQL::open() const {
+	PGconn* conn = PQconnectdb(conninfo_.c_str());
+
+	if(PQstatus(conn) != CONNECTION_OK) {
+		pg::error error(PQerrorMessage(conn));
+		PQfinish(conn);
+		throw error;
+	}
+
+	// notices (e.g. from DROP ... IF EXISTS) are written to stderr by default
+	PQsetNoticeProcessor(conn, [](void*, const char*) {}, nullptr);
+	return conn;
+}
+
+/*
+ * Prepares every statement registered so far in a single round trip.
+ * Each prepare is followed by its own sync point, so a statement that
+ * isn't valid for this connection's schema doesn't prevent the rest
+ * from being prepared. Those that fail are retried on first use.
+ */
+void PostgreSQL::open_state(PGconn* conn, ConnectionState& state) const {
+	const auto statements = connection_pool::Statement::registered();
+	state.prepared.assign(statements.size(), false);
+
+	if(statements.empty() || !PQenterPipelineMode(conn)) {
+		return;
+	}
+
+	std::size_t queued = 0;
+
+	for(const auto statement : statements) {
+		const std::string query(statement->query());
+		const pg::StatementName name(statement->id());
+
+		if(!PQsendPrepare(conn, name.c_str(), query.c_str(), 0, nullptr) || !PQpipelineSync(conn)) {
+			break;
+		}
+
+		++queued;
+	}
+
+	for(std::size_t i = 0; i < queued; ++i) {
+		pg::Result result(PQgetResult(conn));
+
+		if(result.ok()) {
+			state.prepared[statements[i]->id()] = true;
+		}
+
+		// end of the prepare's results, followed by its sync
+		while(auto res = PQgetResult(conn)) {
+			PQclear(res);
+		}
+
+		pg::Result sync(PQgetResult(conn));
+	}
+
+	PQexitPipelineMode(conn);
+}
+
+void PostgreSQL::prepare(PGconn* conn, pg::ConnectionState& state,
+                         const connection_pool::Statement& statement) const {
+	const std::string query(statement.query());
+	const pg::StatementName name(statement.id());
+	pg::Result result(PQprepare(conn, name.c_str(), query.c_str(), 0, nullptr));
+	check(result);
+	state.prepared[statement.id()] = true;
+}
+
+pg::Result PostgreSQL::execute(PGconn* conn, ConnectionState& state,
+                               const connection_pool::Statement& statement,
+                               const pg::Params& params) const {
+	const auto id = statement.id();
+
+	if(id >= state.prepared.size()) [[unlikely]] {
+		state.prepared.resize(id + 1);
+	}
+
+	if(!state.prepared[id]) [[unlikely]] {
+		prepare(conn, state, statement);
+	}
+
+	const pg::StatementName name(id);
+	constexpr int binary = 1;
+
+	pg::Result result(PQexecPrepared(conn, name.c_str(), params.size(), params.values(),
+	                                 params.lengths(), params.formats(), binary));
+	check(result);
+	return result;
+}
+
+pg::Result PostgreSQL::simple_query(PGconn* conn, const char* query) const {
+	pg::Result result(PQexec(conn, query));
+	check(result);
+	return result;
+}
+
+void PostgreSQL::close(PGconn* conn) const {
+	PQfinish(conn);
+}
+
+bool PostgreSQL::keep_alive(PGconn* conn) const {
+	pg::Result result(PQexec(conn, ""));
+	return PQstatus(conn) == CONNECTION_OK && result.ok();
+}
+
+/*
+ * Rolls back anything left open by the previous user of the connection.
+ * Prepared statements are left intact, as they're session-level and
+ * aren't affected by the transaction being rolled back.
+ */
+bool PostgreSQL::clean(PGconn* conn) const {
+	if(PQstatus(conn) != CONNECTION_OK || PQpipelineStatus(conn) != PQ_PIPELINE_OFF) {
+		return false;
+	}
+
+	switch(PQtransactionStatus(conn)) {
+		case PQTRANS_IDLE:
+			return true;
+		case PQTRANS_INTRANS:
+		case PQTRANS_INERROR: {
+			pg::Result result(PQexec(conn, "ROLLBACK"));
+			return result.ok();
+		}
+		default:
+			return false;
+	}
+}
+
+// libpq connections are safe to use from any thread, one at a time
+void PostgreSQL::thread_enter() const {}
+void PostgreSQL::thread_exit() const {}
+
+std::string PostgreSQL::name() {
+	return "PostgreSQL (libpq)";
+}
+
+std::string PostgreSQL::version() {
+	const auto version = PQlibVersion();
+	return std::format("{}.{}", version / 10000, version % 10000);
+}
+
+} // drivers, ember
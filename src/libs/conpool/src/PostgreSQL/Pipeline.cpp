@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <conpool/drivers/PostgreSQL/Pipeline.h>
+#include <charconv>
+#include <utility>
+
+namespace ember::drivers::pg {
+
+StatementName::StatementName(const std::size_t id) {
+	name_[0] = 'e';
+	std::to_chars(name_.data() + 1, name_.data() + name_.size() - 1, id);
+}
+
+Pipeline::Pipeline(PGconn* conn, ConnectionState& state) : conn_(conn), state_(state) {
+	if(!PQenterPipelineMode(conn_)) {
+		throw error(PQerrorMessage(conn_));
+	}
+
+	active_ = true;
+}
+
+Pipeline::~Pipeline() {
+	if(!active_) {
+		return;
+	}
+
+	// abandoned mid-batch, results still need to be read to leave pipeline mode
+	if(PQpipelineSync(conn_)) {
+		std::string failure;
+		collect(failure);
+	}
+}
+
+std::size_t Pipeline::send(const connection_pool::Statement& statement, const Params& params) {
+	const auto id = statement.id();
+
+	if(id >= state_.prepared.size()) [[unlikely]] {
+		state_.prepared.resize(id + 1);
+	}
+
+	const StatementName name(id);
+
+	if(!state_.prepared[id]) [[unlikely]] {
+		const std::string query(statement.query());
+
+		if(!PQsendPrepare(conn_, name.c_str(), query.c_str(), 0, nullptr)) {
+			throw error(PQerrorMessage(conn_));
+		}
+
+		// set now so it isn't prepared twice in one batch, corrected on sync
+		state_.prepared[id] = true;
+		queued_.emplace_back(Command::PREPARE, id);
+	}
+
+	constexpr int binary = 1;
+
+	if(!PQsendQueryPrepared(conn_, name.c_str(), params.size(), params.values(),
+	                        params.lengths(), params.formats(), binary)) {
+		throw error(PQerrorMessage(conn_));
+	}
+
+	queued_.emplace_back(Command::QUERY, id);
+	return queries_++;
+}
+
+/*
+ * Statements between sync points run in an implicit transaction unless
+ * the batch manages its own, so if any statement in the batch fails,
+ * the preceding statements are rolled back along with it.
+ */
+std::vector<Result> Pipeline::sync() {
+	if(!PQpipelineSync(conn_)) {
+		throw error(PQerrorMessage(conn_));
+	}
+
+	std::string failure;
+	auto results = collect(failure);
+
+	if(!failure.empty()) {
+		throw error(failure);
+	}
+
+	return results;
+}
+
+std::vector<Result> Pipeline::collect(std::string& failure) {
+	std::vector<Result> results;
+	results.reserve(queued_.size());
+
+	for(const auto& [command, id] : queued_) {
+		PGresult* res = PQgetResult(conn_);
+
+		if(!res) { // connection has gone away, leave it to the pool to discard
+			failure = PQerrorMessage(conn_);
+			active_ = false;
+			queued_.clear();
+			queries_ = 0;
+			return results;
+		}
+
+		Result result(res);
+
+		// each statement's results are terminated by a null result
+		while(auto extra = PQgetResult(conn_)) {
+			PQclear(extra);
+		}
+
+		if(!result.ok() && failure.empty()) {
+			failure = result.message();
+		}
+
+		if(command == Command::PREPARE) {
+			state_.prepared[id] = result.ok();
+		} else {
+			results.emplace_back(std::move(result));
+		}
+	}
+
+	Result sync(PQgetResult(conn_));
+	queued_.clear();
+	queries_ = 0;
+	active_ = false;
+
+	if(!PQexitPipelineMode(conn_) && failure.empty()) {
+		failure = PQerrorMessage(conn_);
+	}
+
+	return results;
+}
+
+} // pg, drivers, ember
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <dbcreader/Store.h>
+#include <functional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+namespace ember::dbc {
+
+/*
+ * Maps a composite key, made up of the given record fields, to every
+ * record in a store with matching values. These are generated from the
+ * <index> elements in the DBC definitions and built when the DBCs are
+ * linked.
+ *
+ * Records are referenced by pointer, so an index is only valid for as
+ * long as the store it was built from, which must not be modified
+ * afterwards.
+ */
+template<typename T, auto... Fields>
+class Index final {
+public:
+	using Key = std::tuple<std::remove_cvref_t<decltype(std::declval<const T&>().*Fields)>...>;
+
+private:
+	struct KeyHash {
+		std::size_t operator()(const Key& key) const {
+			return std::apply([](const auto&... values) {
+				std::size_t seed = 0;
+				((seed ^= std::hash<std::remove_cvref_t<decltype(values)>>{}(values)
+					+ 0x9e3779b9 + (seed << 6) + (seed >> 2)), ...);
+				return seed;
+			}, key);
+		}
+	};
+
+	std::unordered_map<Key, std::vector<const T*>, KeyHash> index_;
+
+	template<typename... Args>
+	static Key make_key(const Args&... args) {
+		return [&]<std::size_t... I>(std::index_sequence<I...>) {
+			return Key(static_cast<std::tuple_element_t<I, Key>>(args)...);
+		}(std::index_sequence_for<Args...>{});
+	}
+
+public:
+	void build(const Store<T>& store) {
+		index_.clear();
+
+		for(const auto& record : store.values()) {
+			index_[Key(record.*Fields...)].emplace_back(&record);
+		}
+	}
+
+	// every record matching the key, in primary key order
+	template<typename... Args>
+	requires (sizeof...(Args) == sizeof...(Fields))
+	std::span<const T* const> find(const Args&... args) const {
+		const auto it = index_.find(make_key(args...));
+
+		if(it == index_.end()) {
+			return {};
+		}
+
+		return it->second;
+	}
+
+	// the first record matching the key, for keys expected to be unique
+	template<typename... Args>
+	requires (sizeof...(Args) == sizeof...(Fields))
+	const T* first(const Args&... args) const {
+		const auto records = find(args...);
+		return records.empty()? nullptr : records.front();
+	}
+
+	std::size_t size() const {
+		return index_.size();
+	}
+};
+
+} // dbc, ember
@@ -12,6 +12,7 @@ namespace ember::dbc {
 
 struct Storage;
 
+// resolves foreign keys and builds indexes, call once all DBCs are loaded
 void link(Storage& storage);
 
 } // dbc, ember
\ No newline at end of file
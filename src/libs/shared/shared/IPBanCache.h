@@ -9,113 +9,102 @@
 #pragma once
 
 #include <shared/database/daos/shared_base/IPBanBase.h>
+#include <shared/utility/PrefixTrie.h>
 #include <boost/asio/ip/address.hpp>
-#include <boost/asio/ip/address_v6_range.hpp>
-#include <stdexcept>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <span>
-#include <vector>
+#include <string>
+#include <cstddef>
 #include <cstdint>
 
 namespace ember {
 
+/*
+ * Bans are held in a prefix trie per address family, so checking an
+ * address costs the same regardless of how many bans are loaded.
+ *
+ * The tries are immutable once published. Adding a ban or reloading the
+ * full list builds a new set and swaps it in, leaving any in-progress
+ * lookups to finish against the set they started with.
+ */
 class IPBanCache {
-	struct IPv4Entry {
-		boost::asio::ip::address_v4::uint_type range;
-		std::uint32_t mask;
+	struct Tables {
+		PrefixTrie<4> ipv4;
+		PrefixTrie<16> ipv6;
 	};
 
-	std::vector<IPv4Entry> ipv4_entries_;
-	std::vector<boost::asio::ip::address_v6_range> ipv6_entries_;
+	std::atomic<std::shared_ptr<const Tables>> tables_;
+	std::mutex lock_;
 
-	// https://stackoverflow.com/a/57288759 because lazy
-	boost::asio::ip::address_v6_range build_range(const boost::asio::ip::address_v6& address,
-	                                              const std::uint32_t prefix) const {
-		auto bytes = address.to_bytes();
-		auto offset = prefix >> 3;
-		auto shift = 1 << (8 - (prefix & 0x07));
+	static void load_ban(Tables& tables, const std::string& ip, const std::uint32_t cidr) {
+		const auto address = boost::asio::ip::make_address(ip);
 
-		while(shift) {
-			const auto value = bytes[offset] + shift;
-			bytes[offset] = value & 0xFF;
-			shift = value >> 8;
-
-			if(offset == 0) {
-				break;
-			}
-
-			--offset;
+		if(address.is_v6()) {
+			tables.ipv6.insert(address.to_v6().to_bytes(), cidr);
+		} else {
+			tables.ipv4.insert(address.to_v4().to_bytes(), cidr);
 		}
-
-		const auto end = boost::asio::ip::address_v6(bytes);
-		return boost::asio::ip::address_v6_range(address, end);
 	}
 
-	bool check_ban(const boost::asio::ip::address_v6&& ip) const {
-		for(auto& range : ipv6_entries_) {
-			if(auto it = range.find(ip); it != range.end()) {
-				return true;
-			}
-		}
+	static std::shared_ptr<const Tables> build(std::span<const IPEntry> bans) {
+		auto tables = std::make_shared<Tables>();
 
-		return false;
-	}
-
-	bool check_ban(const boost::asio::ip::address_v4&& ip) const {
-		unsigned long ip_long = ip.to_ulong();
-		
-		for(auto& e : ipv4_entries_) {
-			if((ip_long & e.mask) == (e.range & e.mask)) {
-				return true;
-			}
+		for(const auto& [ip, cidr] : bans) {
+			load_ban(*tables, ip, cidr);
 		}
 
-		return false;
-	}
-
-	void load_bans(std::span<const IPEntry> bans) {
-		for(auto& [ip, cidr] : bans) {
-			load_ban(ip, cidr);
-		}
-	}
-
-	void load_ban(const std::string& ip, const std::uint32_t cidr) {
-		auto address = boost::asio::ip::address::from_string(ip);
-
-		if(address.is_v6()) {
-			auto range = build_range(address.to_v6(), cidr);
-			ipv6_entries_.emplace_back(std::move(range));
-		} else {
-			std::uint32_t mask = (~0U) << (32 - cidr);
-			ipv4_entries_.emplace_back(address.to_v4().to_uint(), mask);
-		}
+		return tables;
 	}
 
 public:
-	IPBanCache(std::span<const IPEntry> bans) {
-		load_bans(bans);
-	}
-
-	IPBanCache() = default;
+	IPBanCache(std::span<const IPEntry> bans) : tables_(build(bans)) {}
+	IPBanCache() : tables_(std::make_shared<const Tables>()) {}
 
 	void ban(const std::string& ip, const std::uint32_t mask) {
-		load_ban(ip, mask);
+		// serialise writers so concurrent bans aren't lost (not a thread safety issue)
+		std::lock_guard guard(lock_);
+		auto copy = std::make_shared<Tables>(*tables_.load());
+		load_ban(*copy, ip, mask);
+		tables_ = std::move(copy);
 	}
 
-	bool is_banned(const std::string& ip) const {
-		if(ipv4_entries_.empty() && ipv6_entries_.empty()) {
-			return false;
-		}
+	/*
+	 * Replaces the entire ban list, e.g. with a fresh copy from the database
+	 */
+	void reload(std::span<const IPEntry> bans) {
+		auto tables = build(bans);
+		std::lock_guard guard(lock_);
+		tables_ = std::move(tables);
+	}
 
-		return is_banned(boost::asio::ip::address::from_string(ip));
+	bool is_banned(const std::string& ip) const {
+		return is_banned(boost::asio::ip::make_address(ip));
 	}
 
 	bool is_banned(const boost::asio::ip::address& ip) const {
+		const auto tables = tables_.load();
+
 		if(ip.is_v6()) {
-			return check_ban(ip.to_v6());
+			const auto ipv6 = ip.to_v6();
+
+			// clients connecting to a dual-stack socket over IPv4
+			if(ipv6.is_v4_mapped()) {
+				const auto ipv4 = boost::asio::ip::make_address_v4(boost::asio::ip::v4_mapped, ipv6);
+				return tables->ipv4.contains(ipv4.to_bytes());
+			}
+
+			return tables->ipv6.contains(ipv6.to_bytes());
 		} else {
-			return check_ban(ip.to_v4());
+			return tables->ipv4.contains(ip.to_v4().to_bytes());
 		}
 	}
+
+	std::size_t size() const {
+		const auto tables = tables_.load();
+		return tables->ipv4.size() + tables->ipv6.size();
+	}
 };
 
-} // ember
\ No newline at end of file
+} // ember
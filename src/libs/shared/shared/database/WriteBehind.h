@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/threading/Utility.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember::dal {
+
+/*
+ * Holds writes back so that they can be coalesced and written in batches,
+ * rather than each one checking out a connection to run a single statement.
+ *
+ * Records are keyed and a newer record replaces any pending record with
+ * the same key, so only the latest is written. Pending records are written
+ * once the batch size is reached or the interval elapses, whichever comes
+ * first, with each batch being handed to the writer in chunks of at most
+ * the batch size. Anything still pending is written on shutdown.
+ *
+ * If a chunk fails, its records are written one at a time so that a
+ * single bad record doesn't take the rest of the chunk down with it. Only
+ * records that fail on their own are requeued (unless they've since been
+ * superseded) and retried after the next interval. Records that fail
+ * MAX_ATTEMPTS times are dropped, so a bad record can't hold the queue up
+ * indefinitely. If the first few records fail individually as well, the
+ * problem is assumed to be the database rather than the records, so the
+ * remainder of the batch is requeued without being attempted.
+ */
+template<typename Key, typename Record>
+class WriteBehind final {
+public:
+	using Writer = std::function<void(std::span<const Record>)>;
+	using ErrorHandler = std::function<void(std::string_view)>;
+
+	static constexpr std::uint8_t MAX_ATTEMPTS = 3;
+	static constexpr std::size_t MAX_ISOLATION_FAILURES = 3;
+
+	struct Stats {
+		std::size_t queued;
+		std::uint64_t written;
+		std::uint64_t coalesced;
+		std::uint64_t batches;
+		std::uint64_t failed;
+		std::uint64_t dropped;
+	};
+
+private:
+	struct Pending {
+		std::vector<Key> keys;
+		std::vector<Record> records;
+		std::vector<std::uint8_t> attempts;
+	};
+
+	const Writer writer_;
+	const ErrorHandler on_error_;
+	const std::size_t batch_size_;
+	const std::chrono::milliseconds interval_;
+
+	mutable std::mutex lock_;
+	std::mutex write_lock_;
+	std::condition_variable_any cond_;
+	std::unordered_map<Key, std::size_t> index_;
+	Pending pending_;
+	Stats stats_ {};
+	std::jthread worker_;
+
+	void append(Key key, Record record, std::uint8_t attempts) {
+		index_.emplace(key, pending_.records.size());
+		pending_.keys.emplace_back(std::move(key));
+		pending_.records.emplace_back(std::move(record));
+		pending_.attempts.emplace_back(attempts);
+	}
+
+	void requeue(Pending& batch, const std::size_t index, const bool attempted) {
+		if(index_.contains(batch.keys[index])) { // superseded while being written
+			return;
+		}
+
+		const std::uint8_t attempts = batch.attempts[index] + attempted;
+
+		if(attempts >= MAX_ATTEMPTS) {
+			++stats_.dropped;
+			return;
+		}
+
+		append(std::move(batch.keys[index]), std::move(batch.records[index]), attempts);
+	}
+
+	void report(const std::exception& e) {
+		if(on_error_) {
+			on_error_(e.what());
+		}
+	}
+
+	/*
+	 * Writes [offset, offset + count) of the batch, falling back to writing
+	 * each record individually if the chunk as a whole fails. Returns false
+	 * if the fallback was abandoned, in which case the caller is responsible
+	 * for requeueing everything after the chunk.
+	 */
+	bool write_chunk(Pending& batch, const std::size_t offset, const std::size_t count,
+	                 std::exception_ptr& error) {
+		const std::span<const Record> chunk(batch.records.data() + offset, count);
+
+		try {
+			writer_(chunk);
+			std::lock_guard guard(lock_);
+			stats_.written += count;
+			++stats_.batches;
+			return true;
+		} catch(const std::exception& e) {
+			error = std::current_exception();
+			report(e);
+
+			std::lock_guard guard(lock_);
+			++stats_.failed;
+
+			if(count == 1) {
+				requeue(batch, offset, true);
+				return true;
+			}
+		}
+
+		std::size_t written = 0;
+		std::size_t failed = 0;
+
+		for(auto i = offset; i < offset + count; ++i) {
+			try {
+				writer_(chunk.subspan(i - offset, 1));
+				++written;
+				continue;
+			} catch(const std::exception& e) {
+				error = std::current_exception();
+				report(e);
+			}
+
+			std::lock_guard guard(lock_);
+			++stats_.failed;
+			requeue(batch, i, true);
+
+			// nothing is getting through, give up on the rest without counting it against them
+			if(!written && ++failed == MAX_ISOLATION_FAILURES) {
+				for(auto j = i + 1; j < offset + count; ++j) {
+					requeue(batch, j, false);
+				}
+
+				return false;
+			}
+		}
+
+		std::lock_guard guard(lock_);
+		stats_.written += written;
+		return true;
+	}
+
+	void run(std::stop_token token) {
+		bool backoff = false;
+
+		while(!token.stop_requested()) {
+			{
+				std::unique_lock guard(lock_);
+
+				cond_.wait_for(guard, token, interval_, [&] {
+					return !backoff && pending_.records.size() >= batch_size_;
+				});
+			}
+
+			try {
+				flush();
+				backoff = false;
+			} catch(const std::exception&) {
+				backoff = true; // already reported
+			}
+		}
+	}
+
+public:
+	WriteBehind(Writer writer, std::size_t batch_size, std::chrono::milliseconds interval,
+	            ErrorHandler on_error = nullptr)
+		: writer_(std::move(writer)),
+		  on_error_(std::move(on_error)),
+		  batch_size_(std::max<std::size_t>(batch_size, 1)),
+		  interval_(interval) {
+		worker_ = std::jthread([&](std::stop_token token) { run(token); });
+		thread::set_name(worker_, "Write-behind");
+	}
+
+	~WriteBehind() {
+		try {
+			shutdown();
+		} catch(const std::exception&) {
+			// already reported, nothing more can be done at this point
+		}
+	}
+
+	void push(Key key, Record record) {
+		std::unique_lock guard(lock_);
+
+		if(auto it = index_.find(key); it != index_.end()) {
+			pending_.records[it->second] = std::move(record);
+			pending_.attempts[it->second] = 0;
+			++stats_.coalesced;
+			return;
+		}
+
+		append(std::move(key), std::move(record), 0);
+
+		if(pending_.records.size() == batch_size_) {
+			guard.unlock();
+			cond_.notify_one();
+		}
+	}
+
+	/*
+	 * Writes everything pending, including waiting on any batch that's
+	 * already being written, so reads issued afterwards will see the
+	 * results. Throws if any record couldn't be written.
+	 */
+	void flush() {
+		std::lock_guard writing(write_lock_);
+		Pending batch;
+
+		{
+			std::lock_guard guard(lock_);
+
+			if(pending_.records.empty()) {
+				return;
+			}
+
+			std::swap(batch, pending_);
+			index_.clear();
+		}
+
+		const auto size = batch.records.size();
+		std::exception_ptr error;
+
+		for(std::size_t offset = 0; offset < size; offset += batch_size_) {
+			const auto count = std::min(batch_size_, size - offset);
+
+			if(!write_chunk(batch, offset, count, error)) {
+				std::lock_guard guard(lock_);
+
+				for(auto i = offset + count; i < size; ++i) {
+					requeue(batch, i, false);
+				}
+
+				break;
+			}
+		}
+
+		if(error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	// stops the background writer and writes anything still pending
+	void shutdown() {
+		if(worker_.joinable()) {
+			worker_.request_stop();
+			worker_.join();
+		}
+
+		flush();
+	}
+
+	Stats stats() const {
+		std::lock_guard guard(lock_);
+		auto stats = stats_;
+		stats.queued = pending_.records.size();
+		return stats;
+	}
+
+	WriteBehind(const WriteBehind&) = delete;
+	WriteBehind& operator=(const WriteBehind&) = delete;
+};
+
+} // dal, ember
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/database/WriteBehind.h>
+#include <shared/database/daos/shared_base/UserBase.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember::dal {
+
+/*
+ * Wraps another UserDAO, queueing login records and survey results to be
+ * written behind in batches. Only the latest login per account is kept
+ * from each batch. Reads are passed straight through. Anything pending is
+ * written when the DAO is destroyed, so it should be destroyed before the
+ * connection pool it writes through.
+ */
+class BatchedUserDAO final : public UserDAO {
+public:
+	using Logins = WriteBehind<std::uint32_t, LoginRecord>;
+	using Surveys = WriteBehind<std::uint32_t, SurveyRecord>;
+
+private:
+	const UserDAO& dao_;
+	mutable Logins logins_;
+	mutable Surveys surveys_;
+
+public:
+	BatchedUserDAO(const UserDAO& dao, std::size_t batch_size, std::chrono::milliseconds interval,
+	               Logins::ErrorHandler on_error = nullptr)
+		: dao_(dao),
+		  logins_([&dao](auto batch) { dao.record_logins(batch); }, batch_size, interval, on_error),
+		  surveys_([&dao](auto batch) { dao.save_surveys(batch); }, batch_size, interval, on_error) { }
+
+	std::optional<User> user(const std::string& username) const override {
+		return dao_.user(username);
+	}
+
+	std::unordered_map<std::uint32_t, std::uint32_t> character_counts(std::uint32_t account_id) const override {
+		return dao_.character_counts(account_id);
+	}
+
+	void record_last_login(std::uint32_t account_id, const std::string& ip) const override {
+		logins_.push(account_id, { account_id, ip });
+	}
+
+	void save_survey(std::uint32_t account_id, std::uint32_t survey_id, const std::string& data) const override {
+		surveys_.push(account_id, { account_id, survey_id, data });
+	}
+
+	void record_logins(std::span<const LoginRecord> logins) const override {
+		dao_.record_logins(logins);
+	}
+
+	void save_surveys(std::span<const SurveyRecord> surveys) const override {
+		dao_.save_surveys(surveys);
+	}
+
+	Logins::Stats login_stats() const {
+		return logins_.stats();
+	}
+
+	Surveys::Stats survey_stats() const {
+		return surveys_.stats();
+	}
+};
+
+} // dal, ember
@@ -10,12 +10,14 @@
 
 #include <shared/database/daos/shared_base/CharacterBase.h>
 #include <conpool/ConnectionPool.h>
+#include <conpool/Statement.h>
 #include <mysql_connection.h>
 #include <cppconn/exception.h>
 #include <conpool/drivers/MySQL/Driver.h>
 #include <cppconn/prepared_statement.h>
 #include <chrono>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 
@@ -24,6 +26,90 @@ namespace ember::dal {
 using namespace std::chrono_literals;
 using namespace std::string_view_literals;
 
+namespace statements::character {
+
+inline const connection_pool::Statement BY_NAME {
+	"SELECT c.name, c.internal_name, c.id, c.account_id, c.realm_id, c.race, c.class, "
+	"c.gender, c.skin, c.face, c.hairstyle, c.haircolour, c.facialhair, c.level, c.zone, "
+	"c.map, c.x, c.y, c.z, c.o, c.flags, c.first_login, c.pet_display, c.pet_level, "
+	"c.pet_family, gc.id as guild_id, gc.rank as guild_rank "
+	"FROM characters c "
+	"LEFT JOIN guild_characters gc ON c.id = gc.character_id "
+	"WHERE internal_name = ? AND realm_id = ? AND c.deletion_date IS NULL"
+};
+
+inline const connection_pool::Statement BY_ID {
+	"SELECT c.name, c.internal_name, c.id, c.account_id, c.realm_id, c.race, c.class, "
+	"c.gender, c.skin, c.face, c.hairstyle, c.haircolour, c.facialhair, c.level, c.zone, "
+	"c.map, c.x, c.y, c.z, c.o, c.flags, c.first_login, c.pet_display, c.pet_level, "
+	"c.pet_family, gc.id as guild_id, gc.rank as guild_rank "
+	"FROM characters c "
+	"LEFT JOIN guild_characters gc ON c.id = gc.character_id "
+	"WHERE c.id = ? AND c.deletion_date IS NULL"
+};
+
+inline constexpr std::string_view CHARACTERS_QUERY =
+	"SELECT c.name, c.internal_name, c.id, c.account_id, c.realm_id, c.race, c.class, "
+	"c.gender, c.skin, c.face, c.hairstyle, c.haircolour, c.facialhair, c.level, c.zone, "
+	"c.map, c.x, c.y, c.z, c.o, c.flags, c.first_login, c.pet_display, c.pet_level, "
+	"c.pet_family, gc.id as guild_id, gc.rank as guild_rank "
+	"FROM characters c "
+	"LEFT JOIN guild_characters gc ON c.id = gc.character_id "
+	"LEFT JOIN users u ON u.id = c.account_id "
+	"WHERE u.id = ? AND c.deletion_date IS NULL AND c.realm_id = ?";
+
+inline constexpr auto CHARACTERS_REALM_POS = CHARACTERS_QUERY.find(" AND c.realm_id = ?");
+static_assert(CHARACTERS_REALM_POS != std::string_view::npos);
+
+inline const connection_pool::Statement BY_ACCOUNT_REALM { CHARACTERS_QUERY };
+
+/// done at compile-time, obviates std::string allocation
+inline const connection_pool::Statement BY_ACCOUNT {
+	CHARACTERS_QUERY.substr(0, CHARACTERS_REALM_POS)
+};
+
+inline const connection_pool::Statement RESTORE {
+	"UPDATE characters SET deletion_date = NULL WHERE id = ?"
+};
+
+inline const connection_pool::Statement SOFT_DELETE {
+	"UPDATE characters SET deletion_date = CURTIME(), internal_name = CONCAT(name, id) WHERE id = ?"
+};
+
+inline const connection_pool::Statement HARD_DELETE {
+	"DELETE FROM characters WHERE id = ?"
+};
+
+inline const connection_pool::Statement CREATE {
+	"INSERT INTO characters (name, account_id, realm_id, race, class, gender, "
+	"skin, face, hairstyle, haircolour, facialhair, level, zone, "
+	"map, x, y, z, o, flags, first_login, pet_display, pet_level, "
+	"pet_family, internal_name) "
+	"VALUES "
+	"(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"
+};
+
+inline const connection_pool::Statement UPDATE {
+	"UPDATE characters SET name = ?, internal_name = ?, account_id = ?, "
+	"realm_id = ?, race = ?, class = ?, gender = ?, skin = ?, face = ?, "
+	"hairstyle = ?, haircolour = ?, facialhair = ?, level = ?, zone = ?, "
+	"map = ?, x = ?, y = ?, z = ?, o = ?, flags = ?, first_login = ?, pet_display = ?, "
+	"pet_level = ?, pet_family = ? "
+	"WHERE id = ?"
+};
+
+inline constexpr std::string_view COUNT_QUERY =
+	"SELECT COUNT(*) AS count FROM characters WHERE deletion_date IS NULL "
+	"AND account_id = ? AND realm_id = ?";
+
+inline constexpr auto COUNT_REALM_POS = COUNT_QUERY.find(" AND realm_id = ?");
+static_assert(COUNT_REALM_POS != std::string_view::npos);
+
+inline const connection_pool::Statement COUNT_REALM { COUNT_QUERY };
+inline const connection_pool::Statement COUNT { COUNT_QUERY.substr(0, COUNT_REALM_POS) };
+
+} // character, statements
+
 template<typename T>
 class MySQLCharacterDAO final : public CharacterDAO {
 	T& pool_;
@@ -61,21 +147,40 @@ class MySQLCharacterDAO final : public CharacterDAO {
 		return character;
 	}
 
+	static void bind_update(sql::PreparedStatement* stmt, const Character& character) {
+		stmt->setString(1, character.name);
+		stmt->setString(2, character.internal_name);
+		stmt->setUInt(3, character.account_id);
+		stmt->setUInt(4, character.realm_id);
+		stmt->setUInt(5, character.race);
+		stmt->setUInt(6, character.class_);
+		stmt->setUInt(7, character.gender);
+		stmt->setUInt(8, character.skin);
+		stmt->setUInt(9, character.face);
+		stmt->setUInt(10, character.hairstyle);
+		stmt->setUInt(11, character.haircolour);
+		stmt->setUInt(12, character.facialhair);
+		stmt->setUInt(13, character.level);
+		stmt->setUInt(14, character.zone);
+		stmt->setUInt(15, character.map);
+		stmt->setDouble(16, character.position.x);
+		stmt->setDouble(17, character.position.y);
+		stmt->setDouble(18, character.position.z);
+		stmt->setDouble(19, character.orientation);
+		stmt->setUInt(20, static_cast<std::uint32_t>(character.flags));
+		stmt->setUInt(21, character.first_login);
+		stmt->setUInt(22, character.pet_display);
+		stmt->setUInt(23, character.pet_level);
+		stmt->setUInt(24, character.pet_family);
+		stmt->setUInt64(25, character.id);
+	}
+
 public:
 	MySQLCharacterDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
 
 	std::optional<Character> character(const std::string& name, std::uint32_t realm_id) const override try {
-		std::string_view query =
-			"SELECT c.name, c.internal_name, c.id, c.account_id, c.realm_id, c.race, c.class, "
-		    "c.gender, c.skin, c.face, c.hairstyle, c.haircolour, c.facialhair, c.level, c.zone, "
-		    "c.map, c.x, c.y, c.z, c.o, c.flags, c.first_login, c.pet_display, c.pet_level, "
-		    "c.pet_family, gc.id as guild_id, gc.rank as guild_rank "
-		    "FROM characters c "
-		    "LEFT JOIN guild_characters gc ON c.id = gc.character_id "
-		    "WHERE internal_name = ? AND realm_id = ? AND c.deletion_date IS NULL";
-
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::character::BY_NAME);
 		stmt->setString(1, name);
 		stmt->setUInt(2, realm_id);
 		std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
@@ -90,17 +195,8 @@ public:
 	}
 	
 	std::optional<Character> character(std::uint64_t id) const override try {
-		std::string_view query =
-			"SELECT c.name, c.internal_name, c.id, c.account_id, c.realm_id, c.race, c.class, "
-		    "c.gender, c.skin, c.face, c.hairstyle, c.haircolour, c.facialhair, c.level, c.zone, "
-		    "c.map, c.x, c.y, c.z, c.o, c.flags, c.first_login, c.pet_display, c.pet_level, "
-		    "c.pet_family, gc.id as guild_id, gc.rank as guild_rank "
-		    "FROM characters c "
-		    "LEFT JOIN guild_characters gc ON c.id = gc.character_id "
-		    "WHERE c.id = ? AND c.deletion_date IS NULL";
-
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::character::BY_ID);
 		stmt->setUInt64(1, id);
 		std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
 
@@ -114,27 +210,11 @@ public:
 	}
 
 	std::vector<Character> characters(std::uint32_t account_id, std::uint32_t realm_id = 0) const override try {
-		constexpr std::string_view full_query =
-			"SELECT c.name, c.internal_name, c.id, c.account_id, c.realm_id, c.race, c.class, "
-			"c.gender, c.skin, c.face, c.hairstyle, c.haircolour, c.facialhair, c.level, c.zone, "
-			"c.map, c.x, c.y, c.z, c.o, c.flags, c.first_login, c.pet_display, c.pet_level, "
-			"c.pet_family, gc.id as guild_id, gc.rank as guild_rank "
-			"FROM characters c "
-			"LEFT JOIN guild_characters gc ON c.id = gc.character_id "
-			"LEFT JOIN users u ON u.id = c.account_id "
-			"WHERE u.id = ? AND c.deletion_date IS NULL AND c.realm_id = ?";
-		
-		/// done at compile-time, obviates std::string allocation
-		constexpr auto pos = full_query.find(" AND c.realm_id = ?");
-		static_assert(pos != std::string_view::npos);
-		auto query = full_query;
-
-		if(!realm_id) {
-			query = query.substr(0, pos);
-		}
+		const auto& statement = realm_id? statements::character::BY_ACCOUNT_REALM :
+		                                  statements::character::BY_ACCOUNT;
 
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statement);
 		stmt->setUInt(1, account_id);
 
 		if(realm_id) {
@@ -154,10 +234,8 @@ public:
 	}
 
 	void restore(std::uint64_t id) const override try {
-		constexpr std::string_view query = "UPDATE characters SET deletion_date = NULL WHERE id = ?";
-	
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::character::RESTORE);
 		stmt->setUInt64(1, id);
 
 		if(!stmt->executeUpdate()) {
@@ -168,12 +246,11 @@ public:
 	}
 
 	void delete_character(std::uint64_t id, bool soft_delete) const override try {
-		std::string_view query = soft_delete?
-			"UPDATE characters SET deletion_date = CURTIME(), internal_name = CONCAT(name, id) WHERE id = ?" :
-			"DELETE FROM characters WHERE id = ?";
+		const auto& statement = soft_delete? statements::character::SOFT_DELETE :
+		                                     statements::character::HARD_DELETE;
 
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statement);
 		stmt->setUInt64(1, id);
 		
 		if(!stmt->executeUpdate()) {
@@ -184,16 +261,8 @@ public:
 	}
 
 	void create(const Character& character) const override try {
-		constexpr std::string_view query = 
-			"INSERT INTO characters (name, account_id, realm_id, race, class, gender, "
-			"skin, face, hairstyle, haircolour, facialhair, level, zone, "
-			"map, x, y, z, o, flags, first_login, pet_display, pet_level, "
-			"pet_family, internal_name) "
-			"VALUES "
-			"(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
-
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::character::CREATE);
 		stmt->setString(1, character.name);
 		stmt->setUInt(2, character.account_id);
 		stmt->setUInt(3, character.realm_id);
@@ -227,41 +296,9 @@ public:
 	}
 
 	void update(const Character& character) const override try {
-		constexpr std::string_view query =
-			"UPDATE characters SET name = ?, internal_name = ?, account_id = ?, "
-			"realm_id = ?, race = ?, class = ?, gender = ?, skin = ?, face = ?, "
-			"hairstyle = ?, haircolour = ?, facialhair = ?, level = ?, zone = ?, "
-			"map = ?, x = ?, y = ?, z = ?, o = ?, flags = ?, first_login = ?, pet_display = ?, "
-			"pet_level = ?, pet_family = ? "
-			"WHERE id = ?";
-		
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
-		stmt->setString(1, character.name);
-		stmt->setString(2, character.internal_name);
-		stmt->setUInt(3, character.account_id);
-		stmt->setUInt(4, character.realm_id);
-		stmt->setUInt(5, character.race);
-		stmt->setUInt(6, character.class_);
-		stmt->setUInt(7, character.gender);
-		stmt->setUInt(8, character.skin);
-		stmt->setUInt(9, character.face);
-		stmt->setUInt(10, character.hairstyle);
-		stmt->setUInt(11, character.haircolour);
-		stmt->setUInt(12, character.facialhair);
-		stmt->setUInt(13, character.level);
-		stmt->setUInt(14, character.zone);
-		stmt->setUInt(15, character.map);
-		stmt->setDouble(16, character.position.x);
-		stmt->setDouble(17, character.position.y);
-		stmt->setDouble(18, character.position.z);
-		stmt->setDouble(19, character.orientation);
-		stmt->setUInt(20, static_cast<std::uint32_t>(character.flags));
-		stmt->setUInt(21, character.first_login);
-		stmt->setUInt(22, character.pet_display);
-		stmt->setUInt(23, character.pet_level);
-		stmt->setUInt(24, character.pet_family);
-		stmt->setUInt64(25, character.id);
+		auto stmt = driver_->prepare_cached(conn, statements::character::UPDATE);
+		bind_update(stmt, character);
 
 		if(!stmt->executeUpdate()) {
 			throw exception("Unable to update character");
@@ -270,22 +307,48 @@ public:
 		throw exception(e.what());
 	}
 
-	int count(std::uint32_t account_id, std::uint32_t realm_id) const override try {
-		constexpr std::string_view full_query =
-			"SELECT COUNT(*) AS count FROM characters WHERE deletion_date IS NULL "
-			"AND account_id = ? AND realm_id = ?";
-		
-		/// done at compile-time, obviates std::string allocation
-		constexpr auto pos = full_query.find(" AND realm_id = ?");
-		static_assert(pos != std::string_view::npos);
-		auto query = full_query;
+	/*
+	 * The characters that were updated are committed, then any that
+	 * weren't (e.g. deleted since) are reported by ID
+	 */
+	void update(std::span<const Character> characters) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		conn->setAutoCommit(false);
+		std::string missing;
+
+		try {
+			auto stmt = driver_->prepare_cached(conn, statements::character::UPDATE);
+
+			for(const auto& character : characters) {
+				bind_update(stmt, character);
+
+				if(!stmt->executeUpdate()) {
+					missing += (missing.empty()? "" : ", ") + std::to_string(character.id);
+				}
+			}
+
+			conn->commit();
+		} catch(const std::exception& e) {
+			conn->rollback();
+			conn->setAutoCommit(true);
+			throw exception(e.what());
+		}
 
-		if(!realm_id) {
-			query = query.substr(0, pos);
+		conn->setAutoCommit(true);
+
+		if(!missing.empty()) {
+			throw exception("Unable to update characters: " + missing);
 		}
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	int count(std::uint32_t account_id, std::uint32_t realm_id) const override try {
+		const auto& statement = realm_id? statements::character::COUNT_REALM :
+		                                  statements::character::COUNT;
 
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statement);
 		stmt->setUInt(1, account_id);
 
 		if(realm_id) {
@@ -10,17 +10,25 @@
 
 #include <shared/database/daos/shared_base/IPBanBase.h>
 #include <conpool/ConnectionPool.h>
+#include <conpool/Statement.h>
 #include <mysql_connection.h>
 #include <cppconn/exception.h>
 #include <conpool/drivers/MySQL/Driver.h>
 #include <cppconn/prepared_statement.h>
 #include <memory>
-#include <string_view>
 
 namespace ember::dal {
 
 using namespace std::chrono_literals;
 
+namespace statements::ip_ban {
+
+inline const connection_pool::Statement GET_MASK { "SELECT cidr FROM ip_bans WHERE ip = ?" };
+inline const connection_pool::Statement ALL_BANS { "SELECT ip, cidr FROM ip_bans" };
+inline const connection_pool::Statement BAN { "INSERT INTO ip_bans (ip, cidr) VALUES (?, ?)" };
+
+} // ip_ban, statements
+
 template<typename T>
 class MySQLIPBanDAO final : public IPBanDAO {
 	T& pool_;
@@ -30,10 +38,8 @@ public:
 	MySQLIPBanDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
 
 	std::optional<std::uint32_t> get_mask(const std::string& ip) const override try {
-		std::string_view query = "SELECT cidr FROM ip_bans WHERE ip = ?";
-
 		auto conn = pool_.try_acquire_for(60s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::ip_ban::GET_MASK);
 		stmt->setString(1, ip);
 		std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
 
@@ -47,10 +53,8 @@ public:
 	}
 
 	std::vector<IPEntry> all_bans() const override try {
-		std::string_view query = "SELECT ip, cidr FROM ip_bans";
-
 		auto conn = pool_.try_acquire_for(60s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::ip_ban::ALL_BANS);
 		std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
 		std::vector<IPEntry> entries;
 
@@ -64,10 +68,8 @@ public:
 	}
 
 	void ban(const IPEntry& ban) const override try {
-		std::string_view query = "INSERT INTO ip_bans (ip, cidr) VALUES (?, ?)";
-
 		auto conn = pool_.try_acquire_for(60s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::ip_ban::BAN);
 		stmt->setString(1, ban.first);
 		stmt->setUInt(2, ban.second);
 		stmt->executeQuery();
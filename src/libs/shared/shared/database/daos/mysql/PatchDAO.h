@@ -11,13 +11,13 @@
 #include <shared/database/daos/shared_base/PatchBase.h>
 #include <botan/bigint.h>
 #include <conpool/ConnectionPool.h>
+#include <conpool/Statement.h>
 #include <mysql_connection.h>
 #include <cppconn/exception.h>
 #include <conpool/drivers/MySQL/Driver.h>
 #include <cppconn/prepared_statement.h>
 #include <memory>
 #include <sstream>
-#include <string_view>
 #include <string>
 #include <vector>
 
@@ -25,6 +25,27 @@ namespace ember::dal {
 
 using namespace std::chrono_literals;
 
+namespace statements::patch {
+
+inline const connection_pool::Statement FETCH {
+	"SELECT patches.id, `from`, `to`, mpq, name, size, md5, os, rollup, "
+	"architecture, locale, os.value AS os_val, "
+	"arch.value AS architecture_val, l.value AS locale_val "
+	"FROM patches "
+	"LEFT JOIN architectures arch ON patches.architecture = arch.id "
+	"LEFT JOIN locales l ON patches.locale = l.id "
+	"LEFT JOIN operating_systems os ON patches.os = os.id"
+};
+
+inline const connection_pool::Statement UPDATE {
+	"UPDATE patches SET `from` = ?, `to` = ?, `mpq` = ?, "
+	"`name` = ?, `size` = ?, `md5` = ?, `locale` = ?, "
+	"`architecture` = ?, `os` = ?, `rollup` = ? "
+	"WHERE id = ?"
+};
+
+} // patch, statements
+
 template<typename T>
 class MySQLPatchDAO final : public PatchDAO {
 	T& pool_;
@@ -34,16 +55,8 @@ public:
 	MySQLPatchDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
 
 	std::vector<PatchMeta> fetch_patches() const override try {
-		std::string_view query = "SELECT patches.id, `from`, `to`, mpq, name, size, md5, os, rollup, "
-		                         "architecture, locale, os.value AS os_val, "
-		                         "arch.value AS architecture_val, l.value AS locale_val "
-		                         "FROM patches "
-		                         "LEFT JOIN architectures arch ON patches.architecture = arch.id "  
-		                         "LEFT JOIN locales l ON patches.locale = l.id "
-		                         "LEFT JOIN operating_systems os ON patches.os = os.id";
-
 		auto conn = pool_.try_acquire_for(60s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::patch::FETCH);
 		std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
 		std::vector<PatchMeta> patches;
 
@@ -78,13 +91,8 @@ public:
 	}
 
 	void update(const PatchMeta& meta) const override try {
-		std::string_view query = "UPDATE patches SET `from` = ?, `to` = ?, `mpq` = ?, "
-		                         "`name` = ?, `size` = ?, `md5` = ?, `locale` = ?, "
-		                         "`architecture` = ?, `os` = ?, `rollup` = ? "
-		                         "WHERE id = ?";
-
 		auto conn = pool_.try_acquire_for(60s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::patch::UPDATE);
 
 		stmt->setUInt(1, meta.build_from);
 		stmt->setUInt(2, meta.build_to);
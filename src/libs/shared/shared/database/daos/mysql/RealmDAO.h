@@ -10,6 +10,7 @@
 
 #include <shared/database/daos/shared_base/RealmBase.h>
 #include <conpool/ConnectionPool.h>
+#include <conpool/Statement.h>
 #include <mysql_connection.h>
 #include <cppconn/exception.h>
 #include <conpool/drivers/MySQL/Driver.h>
@@ -17,12 +18,26 @@
 #include <gsl/gsl_util>
 #include <format>
 #include <memory>
-#include <string_view>
 
 namespace ember::dal { 
 
 using namespace std::chrono_literals;
 
+namespace statements::realm {
+
+inline const connection_pool::Statement ALL_REALMS {
+	"SELECT id, name, ip, port, type, flags, category, "
+	"region, creation_setting, population FROM realms"
+};
+
+inline const connection_pool::Statement BY_ID {
+	"SELECT id, name, ip, port, type, flags, category, "
+	"region, creation_setting, population FROM realms "
+	"WHERE id = ?"
+};
+
+} // realm, statements
+
 template<typename T>
 class MySQLRealmDAO final : public RealmDAO {
 	T& pool_;
@@ -32,11 +47,8 @@ public:
 	MySQLRealmDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
 
 	std::vector<Realm> get_realms() const override try {
-		std::string_view query = "SELECT id, name, ip, port, type, flags, category, "
-		                         "region, creation_setting, population FROM realms";
-
 		auto conn = pool_.try_acquire_for(60s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::realm::ALL_REALMS);
 		std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
 		std::vector<Realm> realms;
 
@@ -64,12 +76,8 @@ public:
 	}
 
 	std::optional<Realm> get_realm(std::uint32_t id) const override try {
-		std::string_view query = "SELECT id, name, ip, port, type, flags, category, "
-		                         "region, creation_setting, population FROM realms "
-		                         "WHERE id = ?";
-	
 		auto conn = pool_.try_acquire_for(60s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::realm::BY_ID);
 		stmt->setInt(1, id);
 
 		std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
@@ -10,19 +10,55 @@
 
 #include <shared/database/daos/shared_base/UserBase.h>
 #include <conpool/ConnectionPool.h>
+#include <conpool/Statement.h>
 #include <mysql_connection.h>
 #include <cppconn/exception.h>
 #include <conpool/drivers/MySQL/Driver.h>
 #include <cppconn/prepared_statement.h>
+#include <algorithm>
 #include <chrono>
 #include <memory>
+#include <span>
 #include <string>
-#include <string_view>
 
 namespace ember::dal { 
 
 using namespace std::chrono_literals;
 
+namespace statements::user {
+
+inline const connection_pool::Statement BY_USERNAME {
+	"SELECT u.username, u.id, u.s, u.v, u.pin_method, u.pin, "
+	"u.totp_key, b.user_id as banned, u.survey_request, u.subscriber, u.verified "
+	"s.user_id as suspended FROM users u "
+	"LEFT JOIN bans b ON u.id = b.user_id "
+	"LEFT JOIN suspensions s ON u.id = s.user_id "
+	"WHERE username = ?"
+};
+
+// intentionally not storing the user ID with the survey data, not an oversight :)
+inline const connection_pool::Statement SAVE_SURVEY {
+	"INSERT INTO survey_results (survey_id, data) VALUES (?, ?)"
+};
+
+inline const connection_pool::Statement CLEAR_SURVEY_REQUEST {
+	"UPDATE users SET survey_request = 0 WHERE id = ?"
+};
+
+inline const connection_pool::Statement RECORD_LOGIN {
+	"INSERT INTO login_history (user_id, ip) VALUES "
+	"((SELECT id AS user_id FROM users WHERE id = ?), ?)"
+};
+
+inline const connection_pool::Statement CHARACTER_COUNTS {
+	"SELECT COUNT(c.id) AS count, c.realm_id "
+	"FROM users u, characters c "
+	"WHERE u.id = ? AND c.deletion_date IS NULL "
+	"GROUP BY c.realm_id"
+};
+
+} // user, statements
+
 template<typename T>
 class MySQLUserDAO final : public UserDAO {
 	T& pool_;
@@ -32,15 +68,8 @@ public:
 	MySQLUserDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
 
 	std::optional<User> user(const std::string& username) const override try {
-		std::string_view query = "SELECT u.username, u.id, u.s, u.v, u.pin_method, u.pin, "
-		                         "u.totp_key, b.user_id as banned, u.survey_request, u.subscriber, u.verified "
-		                         "s.user_id as suspended FROM users u "
-		                         "LEFT JOIN bans b ON u.id = b.user_id "
-		                         "LEFT JOIN suspensions s ON u.id = s.user_id "
-		                         "WHERE username = ?";
-
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::user::BY_USERNAME);
 		stmt->setString(1, username);
 		std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
 
@@ -68,10 +97,7 @@ public:
 		conn->setAutoCommit(false);
 
 		try {
-			// intentionally not storing the user ID with the survey data, not an oversight :)
-			std::string_view query = "INSERT INTO survey_results (survey_id, data) VALUES (?, ?)";
-
-			sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+			auto stmt = driver_->prepare_cached(conn, statements::user::SAVE_SURVEY);
 			stmt->setUInt(1, survey_id);
 			stmt->setString(2, data);
 	
@@ -79,9 +105,7 @@ public:
 				throw exception("Unable to save survey data for account ID " + std::to_string(account_id));
 			}
 
-			query = "UPDATE users SET survey_request = 0 WHERE id = ?";
-
-			stmt = driver_->prepare_cached(*conn, query);
+			stmt = driver_->prepare_cached(conn, statements::user::CLEAR_SURVEY_REQUEST);
 			stmt->setUInt(1, account_id);
 
 			if(!stmt->executeUpdate()) {
@@ -101,11 +125,8 @@ public:
 	}
 
 	void record_last_login(std::uint32_t account_id, const std::string& ip) const override try {
-		std::string_view query = "INSERT INTO login_history (user_id, ip) VALUES "
-		                         "((SELECT id AS user_id FROM users WHERE id = ?), ?)";
-
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::user::RECORD_LOGIN);
 		stmt->setUInt(1, account_id);
 		stmt->setString(2, ip);
 		
@@ -116,15 +137,88 @@ public:
 		throw exception(e.what());
 	}
 
+	/*
+	 * Written as multi-row inserts. The statement text depends on the row
+	 * count, so these aren't cached, but one prepare per chunk still beats
+	 * a round trip per row.
+	 */
+	void record_logins(std::span<const LoginRecord> logins) const override try {
+		constexpr std::size_t MAX_CHUNK = 1000;
+
+		auto conn = pool_.try_acquire_for(5s);
+		conn->setAutoCommit(false);
+
+		try {
+			for(std::size_t offset = 0; offset < logins.size(); offset += MAX_CHUNK) {
+				const auto chunk = logins.subspan(offset, std::min(MAX_CHUNK, logins.size() - offset));
+				std::string query("INSERT INTO login_history (user_id, ip) VALUES (?, ?)");
+
+				for(std::size_t i = 1; i < chunk.size(); ++i) {
+					query += ", (?, ?)";
+				}
+
+				std::unique_ptr<sql::PreparedStatement> stmt(conn->prepareStatement(query));
+				int index = 0;
+
+				for(const auto& [account_id, ip] : chunk) {
+					stmt->setUInt(++index, account_id);
+					stmt->setString(++index, ip);
+				}
+
+				stmt->executeUpdate();
+			}
+
+			conn->commit();
+		} catch(const std::exception& e) {
+			conn->rollback();
+			conn->setAutoCommit(true);
+			throw exception(e.what());
+		}
+
+		conn->setAutoCommit(true);
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	/*
+	 * Surveys that can no longer be saved because the request has already
+	 * been cleared are skipped rather than failing the rest of the batch
+	 */
+	void save_surveys(std::span<const SurveyRecord> surveys) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		conn->setAutoCommit(false);
+
+		try {
+			for(const auto& [account_id, survey_id, data] : surveys) {
+				auto stmt = driver_->prepare_cached(conn, statements::user::CLEAR_SURVEY_REQUEST);
+				stmt->setUInt(1, account_id);
+
+				if(!stmt->executeUpdate()) {
+					continue;
+				}
+
+				stmt = driver_->prepare_cached(conn, statements::user::SAVE_SURVEY);
+				stmt->setUInt(1, survey_id);
+				stmt->setString(2, data);
+				stmt->executeUpdate();
+			}
+
+			conn->commit();
+		} catch(const std::exception& e) {
+			conn->rollback();
+			conn->setAutoCommit(true);
+			throw exception(e.what());
+		}
+
+		conn->setAutoCommit(true);
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
 	std::unordered_map<std::uint32_t, std::uint32_t>
 	character_counts(std::uint32_t account_id) const override try {
-		std::string_view query = "SELECT COUNT(c.id) AS count, c.realm_id "
-		                         "FROM users u, characters c "
-		                         "WHERE u.id = ? AND c.deletion_date IS NULL "
-		                         "GROUP BY c.realm_id";
-		
 		auto conn = pool_.try_acquire_for(5s);
-		sql::PreparedStatement* stmt = driver_->prepare_cached(*conn, query);
+		auto stmt = driver_->prepare_cached(conn, statements::user::CHARACTER_COUNTS);
 		stmt->setUInt(1, account_id);
 		std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
 
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/database/daos/shared_base/CharacterBase.h>
+#include <conpool/ConnectionPool.h>
+#include <conpool/Statement.h>
+#include <conpool/drivers/PostgreSQL/Driver.h>
+#include <chrono>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+namespace ember::dal {
+
+using namespace std::chrono_literals;
+
+namespace statements::character {
+
+inline const connection_pool::Statement BY_NAME {
+	"SELECT c.name, c.internal_name, c.id, c.account_id, c.realm_id, c.race, c.class, "
+	"c.gender, c.skin, c.face, c.hairstyle, c.haircolour, c.facialhair, c.level, c.zone, "
+	"c.map, c.x, c.y, c.z, c.o, c.flags, c.first_login, c.pet_display, c.pet_level, "
+	"c.pet_family, gc.id as guild_id, gc.rank as guild_rank "
+	"FROM characters c "
+	"LEFT JOIN guild_characters gc ON c.id = gc.character_id "
+	"WHERE internal_name = $1 AND realm_id = $2 AND c.deletion_date IS NULL"
+};
+
+inline const connection_pool::Statement BY_ID {
+	"SELECT c.name, c.internal_name, c.id, c.account_id, c.realm_id, c.race, c.class, "
+	"c.gender, c.skin, c.face, c.hairstyle, c.haircolour, c.facialhair, c.level, c.zone, "
+	"c.map, c.x, c.y, c.z, c.o, c.flags, c.first_login, c.pet_display, c.pet_level, "
+	"c.pet_family, gc.id as guild_id, gc.rank as guild_rank "
+	"FROM characters c "
+	"LEFT JOIN guild_characters gc ON c.id = gc.character_id "
+	"WHERE c.id = $1 AND c.deletion_date IS NULL"
+};
+
+inline constexpr std::string_view CHARACTERS_QUERY =
+	"SELECT c.name, c.internal_name, c.id, c.account_id, c.realm_id, c.race, c.class, "
+	"c.gender, c.skin, c.face, c.hairstyle, c.haircolour, c.facialhair, c.level, c.zone, "
+	"c.map, c.x, c.y, c.z, c.o, c.flags, c.first_login, c.pet_display, c.pet_level, "
+	"c.pet_family, gc.id as guild_id, gc.rank as guild_rank "
+	"FROM characters c "
+	"LEFT JOIN guild_characters gc ON c.id = gc.character_id "
+	"WHERE c.account_id = $1 AND c.deletion_date IS NULL AND c.realm_id = $2";
+
+inline constexpr auto CHARACTERS_REALM_POS = CHARACTERS_QUERY.find(" AND c.realm_id = $2");
+static_assert(CHARACTERS_REALM_POS != std::string_view::npos);
+
+inline const connection_pool::Statement BY_ACCOUNT_REALM { CHARACTERS_QUERY };
+
+/// done at compile-time, obviates std::string allocation
+inline const connection_pool::Statement BY_ACCOUNT {
+	CHARACTERS_QUERY.substr(0, CHARACTERS_REALM_POS)
+};
+
+inline const connection_pool::Statement RESTORE {
+	"UPDATE characters SET deletion_date = NULL WHERE id = $1"
+};
+
+inline const connection_pool::Statement SOFT_DELETE {
+	"UPDATE characters SET deletion_date = CURRENT_TIMESTAMP, "
+	"internal_name = name || id WHERE id = $1"
+};
+
+inline const connection_pool::Statement HARD_DELETE {
+	"DELETE FROM characters WHERE id = $1"
+};
+
+inline const connection_pool::Statement CREATE {
+	"INSERT INTO characters (name, account_id, realm_id, race, class, gender, "
+	"skin, face, hairstyle, haircolour, facialhair, level, zone, "
+	"map, x, y, z, o, flags, first_login, pet_display, pet_level, "
+	"pet_family, internal_name) "
+	"VALUES "
+	"($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13, $14, $15, $16, $17, $18, "
+	"$19, $20, $21, $22, $23, $24)"
+};
+
+inline const connection_pool::Statement UPDATE {
+	"UPDATE characters SET name = $1, internal_name = $2, account_id = $3, "
+	"realm_id = $4, race = $5, class = $6, gender = $7, skin = $8, face = $9, "
+	"hairstyle = $10, haircolour = $11, facialhair = $12, level = $13, zone = $14, "
+	"map = $15, x = $16, y = $17, z = $18, o = $19, flags = $20, first_login = $21, "
+	"pet_display = $22, pet_level = $23, pet_family = $24 "
+	"WHERE id = $25"
+};
+
+inline constexpr std::string_view COUNT_QUERY =
+	"SELECT COUNT(*) AS count FROM characters WHERE deletion_date IS NULL "
+	"AND account_id = $1 AND realm_id = $2";
+
+inline constexpr auto COUNT_REALM_POS = COUNT_QUERY.find(" AND realm_id = $2");
+static_assert(COUNT_REALM_POS != std::string_view::npos);
+
+inline const connection_pool::Statement COUNT_REALM { COUNT_QUERY };
+inline const connection_pool::Statement COUNT { COUNT_QUERY.substr(0, COUNT_REALM_POS) };
+
+} // character, statements
+
+template<typename T>
+class PostgresCharacterDAO final : public CharacterDAO {
+	T& pool_;
+	drivers::PostgreSQL* driver_;
+
+	Character result_to_character(const drivers::pg::Result& res, const int row) const {
+		Character character;
+		character.name = res.get<std::string>(row, "name");
+		character.internal_name = res.get<std::string>(row, "internal_name");
+		character.id = res.get<std::uint64_t>(row, "id");
+		character.account_id = res.get<std::uint32_t>(row, "account_id");
+		character.realm_id = res.get<std::uint32_t>(row, "realm_id");
+		character.race = res.get<std::uint8_t>(row, "race");
+		character.class_ = res.get<std::uint8_t>(row, "class");
+		character.gender = res.get<std::uint8_t>(row, "gender");
+		character.skin = res.get<std::uint8_t>(row, "skin");
+		character.face = res.get<std::uint8_t>(row, "face");
+		character.hairstyle = res.get<std::uint8_t>(row, "hairstyle");
+		character.haircolour = res.get<std::uint8_t>(row, "haircolour");
+		character.facialhair = res.get<std::uint8_t>(row, "facialhair");
+		character.level = res.get<std::uint8_t>(row, "level");
+		character.zone = res.get<std::uint32_t>(row, "zone");
+		character.map = res.get<std::uint32_t>(row, "map");
+		character.guild_id = res.get_optional<std::uint32_t>(row, "guild_id").value_or(0);
+		character.guild_rank = res.get_optional<std::uint32_t>(row, "guild_rank").value_or(0);
+		character.position.x = res.get<float>(row, "x");
+		character.position.y = res.get<float>(row, "y");
+		character.position.z = res.get<float>(row, "z");
+		character.orientation = res.get<float>(row, "o");
+		character.flags = static_cast<Character::Flags>(res.get<std::uint32_t>(row, "flags"));
+		character.first_login = res.get<bool>(row, "first_login");
+		character.pet_display = res.get<std::uint32_t>(row, "pet_display");
+		character.pet_level = res.get<std::uint32_t>(row, "pet_level");
+		character.pet_family = res.get<std::uint32_t>(row, "pet_family");
+		return character;
+	}
+
+	static drivers::pg::Params update_params(const Character& character) {
+		return drivers::pg::Params(
+			character.name, character.internal_name, character.account_id, character.realm_id,
+			character.race, character.class_, character.gender, character.skin, character.face,
+			character.hairstyle, character.haircolour, character.facialhair, character.level,
+			character.zone, character.map, character.position.x, character.position.y,
+			character.position.z, character.orientation,
+			static_cast<std::uint32_t>(character.flags),
+			static_cast<std::uint32_t>(character.first_login),
+			character.pet_display, character.pet_level, character.pet_family, character.id
+		);
+	}
+
+public:
+	PostgresCharacterDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
+
+	std::optional<Character> character(const std::string& name, std::uint32_t realm_id) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::character::BY_NAME,
+		                                                 drivers::pg::Params(name, realm_id));
+
+		if(!res.empty()) {
+			return result_to_character(res, 0);
+		}
+
+		return std::nullopt;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	std::optional<Character> character(std::uint64_t id) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::character::BY_ID,
+		                                                 drivers::pg::Params(id));
+
+		if(!res.empty()) {
+			return result_to_character(res, 0);
+		}
+
+		return std::nullopt;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	std::vector<Character> characters(std::uint32_t account_id, std::uint32_t realm_id = 0) const override try {
+		drivers::pg::Params params(account_id);
+
+		if(realm_id) {
+			params.add(realm_id);
+		}
+
+		const auto& statement = realm_id? statements::character::BY_ACCOUNT_REALM :
+		                                  statements::character::BY_ACCOUNT;
+
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statement, params);
+		std::vector<Character> characters;
+		characters.reserve(res.rows());
+
+		for(auto i = 0; i < res.rows(); ++i) {
+			characters.emplace_back(result_to_character(res, i));
+		}
+
+		return characters;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	void restore(std::uint64_t id) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::character::RESTORE,
+		                                                 drivers::pg::Params(id));
+
+		if(!res.affected()) {
+			throw exception("Unable to restore character " + std::to_string(id));
+		}
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	void delete_character(std::uint64_t id, bool soft_delete) const override try {
+		const auto& statement = soft_delete? statements::character::SOFT_DELETE :
+		                                     statements::character::HARD_DELETE;
+
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statement, drivers::pg::Params(id));
+
+		if(!res.affected()) {
+			throw exception("Unable to delete character " + std::to_string(id));
+		}
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	void create(const Character& character) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+
+		const drivers::pg::Params params(
+			character.name, character.account_id, character.realm_id, character.race,
+			character.class_, character.gender, character.skin, character.face,
+			character.hairstyle, character.haircolour, character.facialhair, character.level,
+			character.zone, character.map, character.position.x, character.position.y,
+			character.position.z, character.orientation,
+			static_cast<std::uint32_t>(character.flags),
+			static_cast<std::uint32_t>(character.first_login),
+			character.pet_display, character.pet_level, character.pet_family,
+			character.internal_name
+		);
+
+		const drivers::pg::Result res = driver_->execute(conn, statements::character::CREATE, params);
+
+		if(!res.affected()) {
+			throw exception("Unable to create character");
+		}
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	void update(const Character& character) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::character::UPDATE,
+		                                                 update_params(character));
+
+		if(!res.affected()) {
+			throw exception("Unable to update character");
+		}
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	/*
+	 * Pipelined, so the batch is a single round trip and implicit transaction.
+	 * The characters that were updated are committed, then any that weren't
+	 * (e.g. deleted since) are reported by ID.
+	 */
+	void update(std::span<const Character> characters) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		auto pipeline = driver_->pipeline(conn);
+		std::vector<std::size_t> indices;
+
+		for(const auto& character : characters) {
+			indices.emplace_back(pipeline.send(statements::character::UPDATE, update_params(character)));
+		}
+
+		const auto results = pipeline.sync();
+		std::string missing;
+
+		for(std::size_t i = 0; i < characters.size(); ++i) {
+			if(!results[indices[i]].affected()) {
+				missing += (missing.empty()? "" : ", ") + std::to_string(characters[i].id);
+			}
+		}
+
+		if(!missing.empty()) {
+			throw exception("Unable to update characters: " + missing);
+		}
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	int count(std::uint32_t account_id, std::uint32_t realm_id) const override try {
+		drivers::pg::Params params(account_id);
+
+		if(realm_id) {
+			params.add(realm_id);
+		}
+
+		const auto& statement = realm_id? statements::character::COUNT_REALM :
+		                                  statements::character::COUNT;
+
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statement, params);
+
+		if(!res.empty()) {
+			return res.get<int>(0, "count");
+		}
+
+		return 0;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+};
+
+template<typename T>
+PostgresCharacterDAO<T> character_dao(T& pool) {
+	return PostgresCharacterDAO<T>(pool);
+}
+
+} // dal, ember
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/database/daos/shared_base/IPBanBase.h>
+#include <conpool/ConnectionPool.h>
+#include <conpool/Statement.h>
+#include <conpool/drivers/PostgreSQL/Driver.h>
+#include <chrono>
+
+namespace ember::dal {
+
+using namespace std::chrono_literals;
+
+namespace statements::ip_ban {
+
+inline const connection_pool::Statement GET_MASK { "SELECT cidr FROM ip_bans WHERE ip = $1" };
+inline const connection_pool::Statement ALL_BANS { "SELECT ip, cidr FROM ip_bans" };
+inline const connection_pool::Statement BAN { "INSERT INTO ip_bans (ip, cidr) VALUES ($1, $2)" };
+
+} // ip_ban, statements
+
+template<typename T>
+class PostgresIPBanDAO final : public IPBanDAO {
+	T& pool_;
+	drivers::PostgreSQL* driver_;
+
+public:
+	PostgresIPBanDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
+
+	std::optional<std::uint32_t> get_mask(const std::string& ip) const override try {
+		auto conn = pool_.try_acquire_for(60s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::ip_ban::GET_MASK,
+		                                                 drivers::pg::Params(ip));
+
+		if(!res.empty()) {
+			return res.get<std::uint32_t>(0, "cidr");
+		}
+
+		return std::nullopt;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	std::vector<IPEntry> all_bans() const override try {
+		auto conn = pool_.try_acquire_for(60s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::ip_ban::ALL_BANS);
+		std::vector<IPEntry> entries;
+		entries.reserve(res.rows());
+
+		for(auto i = 0; i < res.rows(); ++i) {
+			entries.emplace_back(res.get<std::string>(i, "ip"), res.get<std::uint32_t>(i, "cidr"));
+		}
+
+		return entries;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	void ban(const IPEntry& ban) const override try {
+		auto conn = pool_.try_acquire_for(60s);
+		driver_->execute(conn, statements::ip_ban::BAN, drivers::pg::Params(ban.first, ban.second));
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+};
+
+template<typename T>
+PostgresIPBanDAO<T> ip_ban_dao(T& pool) {
+	return PostgresIPBanDAO<T>(pool);
+}
+
+} // dal, ember
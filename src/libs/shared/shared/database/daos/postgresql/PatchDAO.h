@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/database/daos/shared_base/PatchBase.h>
+#include <botan/bigint.h>
+#include <conpool/ConnectionPool.h>
+#include <conpool/Statement.h>
+#include <conpool/drivers/PostgreSQL/Driver.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ember::dal {
+
+using namespace std::chrono_literals;
+
+namespace statements::patch {
+
+inline const connection_pool::Statement FETCH {
+	"SELECT patches.id, \"from\", \"to\", mpq, name, size, md5, os, rollup, "
+	"architecture, locale, os.value AS os_val, "
+	"arch.value AS architecture_val, l.value AS locale_val "
+	"FROM patches "
+	"LEFT JOIN architectures arch ON patches.architecture = arch.id "
+	"LEFT JOIN locales l ON patches.locale = l.id "
+	"LEFT JOIN operating_systems os ON patches.os = os.id"
+};
+
+inline const connection_pool::Statement UPDATE {
+	"UPDATE patches SET \"from\" = $1, \"to\" = $2, mpq = $3, "
+	"name = $4, size = $5, md5 = $6, locale = $7, "
+	"architecture = $8, os = $9, rollup = $10 "
+	"WHERE id = $11"
+};
+
+} // patch, statements
+
+template<typename T>
+class PostgresPatchDAO final : public PatchDAO {
+	T& pool_;
+	drivers::PostgreSQL* driver_;
+
+public:
+	PostgresPatchDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
+
+	std::vector<PatchMeta> fetch_patches() const override try {
+		auto conn = pool_.try_acquire_for(60s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::patch::FETCH);
+		std::vector<PatchMeta> patches;
+		patches.reserve(res.rows());
+
+		for(auto i = 0; i < res.rows(); ++i) {
+			PatchMeta meta{};
+			meta.id = res.get<std::uint32_t>(i, "id");
+			meta.build_from = res.get<std::uint16_t>(i, "from");
+			meta.build_to = res.get<std::uint16_t>(i, "to");
+			meta.os_id = res.get_optional<std::uint32_t>(i, "os").value_or(0);
+			meta.arch_id = res.get_optional<std::uint32_t>(i, "architecture").value_or(0);
+			meta.locale_id = res.get_optional<std::uint32_t>(i, "locale").value_or(0);
+			meta.mpq = res.get<bool>(i, "mpq");
+			meta.file_meta.name = res.get<std::string>(i, "name");
+			meta.file_meta.size = res.get_optional<std::uint64_t>(i, "size").value_or(0);
+			meta.os = res.get_optional<std::string>(i, "os_val").value_or("");
+			meta.locale = res.get_optional<std::string>(i, "locale_val").value_or("");
+			meta.arch = res.get_optional<std::string>(i, "architecture_val").value_or("");
+			meta.rollup = res.get<bool>(i, "rollup");
+
+			const auto md5 = res.get_optional<std::string>(i, "md5").value_or("");
+			Botan::BigInt md5_int(reinterpret_cast<const std::uint8_t*>(md5.c_str()), md5.length(),
+			                      Botan::BigInt::Base::Hexadecimal);
+			Botan::BigInt::encode_1363(reinterpret_cast<std::uint8_t*>(meta.file_meta.md5.data()),
+			                           meta.file_meta.md5.size(), md5_int);
+			patches.emplace_back(std::move(meta));
+		}
+
+		return patches;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	void update(const PatchMeta& meta) const override try {
+		auto md5 = Botan::BigInt::decode(reinterpret_cast<const std::uint8_t*>(meta.file_meta.md5.data()),
+		                                 meta.file_meta.md5.size());
+		std::stringstream md5_str;
+		md5_str << std::hex << md5;
+		const auto md5_hex = md5_str.str();
+
+		auto conn = pool_.try_acquire_for(60s);
+		const drivers::pg::Params params(
+			meta.build_from, meta.build_to, meta.mpq, meta.file_meta.name, meta.file_meta.size,
+			md5_hex, meta.locale_id, meta.arch_id, meta.os_id, meta.rollup, meta.id
+		);
+
+		const drivers::pg::Result res = driver_->execute(conn, statements::patch::UPDATE, params);
+
+		if(!res.affected()) {
+			throw exception("Unable to update patch #" + std::to_string(meta.id));
+		}
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+};
+
+template<typename T>
+PostgresPatchDAO<T> patch_dao(T& pool) {
+	return PostgresPatchDAO<T>(pool);
+}
+
+} // dal, ember
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/database/daos/shared_base/RealmBase.h>
+#include <conpool/ConnectionPool.h>
+#include <conpool/Statement.h>
+#include <conpool/drivers/PostgreSQL/Driver.h>
+#include <chrono>
+#include <format>
+
+namespace ember::dal {
+
+using namespace std::chrono_literals;
+
+namespace statements::realm {
+
+inline const connection_pool::Statement ALL_REALMS {
+	"SELECT id, name, ip, port, type, flags, category, "
+	"region, creation_setting, population FROM realms"
+};
+
+inline const connection_pool::Statement BY_ID {
+	"SELECT id, name, ip, port, type, flags, category, "
+	"region, creation_setting, population FROM realms "
+	"WHERE id = $1"
+};
+
+} // realm, statements
+
+template<typename T>
+class PostgresRealmDAO final : public RealmDAO {
+	T& pool_;
+	drivers::PostgreSQL* driver_;
+
+	Realm result_to_realm(const drivers::pg::Result& res, const int row) const {
+		Realm realm {
+			.id = res.get<std::uint32_t>(row, "id"),
+			.name = res.get<std::string>(row, "name"),
+			.ip = res.get<std::string>(row, "ip"),
+			.port = res.get<std::uint16_t>(row, "port"),
+			.population = res.get<float>(row, "population"),
+			.type = static_cast<Realm::Type>(res.get<std::uint32_t>(row, "type")),
+			.flags = static_cast<Realm::Flags>(res.get<std::uint32_t>(row, "flags")),
+			.category = static_cast<dbc::Cfg_Categories::Category>(res.get<std::uint32_t>(row, "category")),
+			.region = static_cast<dbc::Cfg_Categories::Region>(res.get<std::uint32_t>(row, "region")),
+			.creation_setting = static_cast<Realm::CreationSetting>(res.get<std::uint32_t>(row, "creation_setting"))
+		};
+
+		realm.address = std::format("{}:{}", realm.ip, realm.port);
+		return realm;
+	}
+
+public:
+	PostgresRealmDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
+
+	std::vector<Realm> get_realms() const override try {
+		auto conn = pool_.try_acquire_for(60s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::realm::ALL_REALMS);
+		std::vector<Realm> realms;
+		realms.reserve(res.rows());
+
+		for(auto i = 0; i < res.rows(); ++i) {
+			realms.emplace_back(result_to_realm(res, i));
+		}
+
+		return realms;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	std::optional<Realm> get_realm(std::uint32_t id) const override try {
+		auto conn = pool_.try_acquire_for(60s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::realm::BY_ID,
+		                                                 drivers::pg::Params(id));
+
+		if(!res.empty()) {
+			return result_to_realm(res, 0);
+		}
+
+		return std::nullopt;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+};
+
+template<typename T>
+PostgresRealmDAO<T> realm_dao(T& pool) {
+	return PostgresRealmDAO<T>(pool);
+}
+
+} // dal, ember
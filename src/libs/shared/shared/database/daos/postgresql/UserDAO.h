@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/database/daos/shared_base/UserBase.h>
+#include <conpool/ConnectionPool.h>
+#include <conpool/Statement.h>
+#include <conpool/drivers/PostgreSQL/Driver.h>
+#include <chrono>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ember::dal {
+
+using namespace std::chrono_literals;
+
+namespace statements::user {
+
+inline const connection_pool::Statement BY_USERNAME {
+	"SELECT u.username, u.id, u.s, u.v, u.pin_method, u.pin, u.totp_key, "
+	"b.user_id IS NOT NULL AS banned, s.user_id IS NOT NULL AS suspended, "
+	"u.survey_request, u.subscriber, u.verified FROM users u "
+	"LEFT JOIN bans b ON u.id = b.user_id "
+	"LEFT JOIN suspensions s ON u.id = s.user_id "
+	"WHERE username = $1"
+};
+
+/*
+ * Only stores the results if the survey request could be cleared, in a
+ * single statement rather than a transaction spanning two round trips.
+ * Intentionally not storing the user ID with the survey data, not an oversight :)
+ */
+inline const connection_pool::Statement SAVE_SURVEY {
+	"WITH cleared AS (UPDATE users SET survey_request = false WHERE id = $1 AND survey_request "
+	"RETURNING id) "
+	"INSERT INTO survey_results (survey_id, data) SELECT $2::integer, $3::text FROM cleared"
+};
+
+inline const connection_pool::Statement RECORD_LOGIN {
+	"INSERT INTO login_history (user_id, ip) VALUES ($1, $2)"
+};
+
+inline const connection_pool::Statement RECORD_LOGINS {
+	"INSERT INTO login_history (user_id, ip) "
+	"SELECT * FROM unnest($1::integer[], $2::varchar[])"
+};
+
+inline const connection_pool::Statement CHARACTER_COUNTS {
+	"SELECT COUNT(id) AS count, realm_id FROM characters "
+	"WHERE account_id = $1 AND deletion_date IS NULL "
+	"GROUP BY realm_id"
+};
+
+} // user, statements
+
+template<typename T>
+class PostgresUserDAO final : public UserDAO {
+	T& pool_;
+	drivers::PostgreSQL* driver_;
+
+public:
+	PostgresUserDAO(T& pool) : pool_(pool), driver_(pool.get_driver()) { }
+
+	std::optional<User> user(const std::string& username) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::user::BY_USERNAME,
+		                                                 drivers::pg::Params(username));
+
+		if(res.empty()) {
+			return std::nullopt;
+		}
+
+		User user(res.get<std::uint32_t>(0, "id"), res.get<std::string>(0, "username"),
+		          res.get<std::vector<std::uint8_t>>(0, "s"), res.get<std::string>(0, "v"),
+		          static_cast<PINMethod>(res.get<std::uint32_t>(0, "pin_method")),
+		          res.get_optional<std::uint32_t>(0, "pin").value_or(0),
+		          res.get_optional<std::string>(0, "totp_key").value_or(""),
+		          res.get<bool>(0, "banned"), res.get<bool>(0, "suspended"),
+		          res.get<bool>(0, "survey_request"), res.get<bool>(0, "subscriber"),
+		          res.get_optional<bool>(0, "verified").value_or(false));
+		return user;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	void save_survey(std::uint32_t account_id, std::uint32_t survey_id,
+	                 const std::string& data) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::user::SAVE_SURVEY,
+		                                                 drivers::pg::Params(account_id, survey_id, data));
+
+		if(!res.affected()) {
+			throw exception("Unable to save survey data for account ID " + std::to_string(account_id));
+		}
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	void record_last_login(std::uint32_t account_id, const std::string& ip) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::user::RECORD_LOGIN,
+		                                                 drivers::pg::Params(account_id, ip));
+
+		if(!res.affected()) {
+			throw exception("Unable to set last login for account ID " + std::to_string(account_id));
+		}
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	void record_logins(std::span<const LoginRecord> logins) const override try {
+		std::vector<std::uint32_t> ids;
+		std::vector<std::string> ips;
+		ids.reserve(logins.size());
+		ips.reserve(logins.size());
+
+		for(const auto& [account_id, ip] : logins) {
+			ids.emplace_back(account_id);
+			ips.emplace_back(ip);
+		}
+
+		auto conn = pool_.try_acquire_for(5s);
+		driver_->execute(conn, statements::user::RECORD_LOGINS, drivers::pg::Params(ids, ips));
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	/*
+	 * Surveys that can no longer be saved because the request has already
+	 * been cleared are skipped rather than failing the rest of the batch
+	 */
+	void save_surveys(std::span<const SurveyRecord> surveys) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		auto pipeline = driver_->pipeline(conn);
+
+		for(const auto& [account_id, survey_id, data] : surveys) {
+			pipeline.send(statements::user::SAVE_SURVEY, drivers::pg::Params(account_id, survey_id, data));
+		}
+
+		pipeline.sync();
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+
+	std::unordered_map<std::uint32_t, std::uint32_t>
+	character_counts(std::uint32_t account_id) const override try {
+		auto conn = pool_.try_acquire_for(5s);
+		const drivers::pg::Result res = driver_->execute(conn, statements::user::CHARACTER_COUNTS,
+		                                                 drivers::pg::Params(account_id));
+
+		std::unordered_map<std::uint32_t, std::uint32_t> counts;
+
+		for(auto i = 0; i < res.rows(); ++i) {
+			counts.emplace(res.get<std::uint32_t>(i, "realm_id"), res.get<std::uint32_t>(i, "count"));
+		}
+
+		return counts;
+	} catch(const std::exception& e) {
+		throw exception(e.what());
+	}
+};
+
+template<typename T>
+PostgresUserDAO<T> user_dao(T& pool) {
+	return PostgresUserDAO<T>(pool);
+}
+
+} // dal, ember
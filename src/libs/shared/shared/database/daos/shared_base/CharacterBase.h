@@ -12,6 +12,7 @@
 #include <shared/database/objects/Character.h>
 #include <string>
 #include <optional>
+#include <span>
 #include <vector>
 #include <cstdint>
 
@@ -26,6 +27,7 @@ public:
 	virtual void restore(std::uint64_t id) const = 0;
 	virtual void create(const Character& character) const = 0;
 	virtual void update(const Character& character) const = 0;
+	virtual void update(std::span<const Character> characters) const = 0; // single transaction
 	virtual int count(std::uint32_t account_id, std::uint32_t realm_id = 0) const = 0;
 	virtual ~CharacterDAO() = default;
 };
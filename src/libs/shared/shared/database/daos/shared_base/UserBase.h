@@ -12,17 +12,33 @@
 #include <shared/database/objects/User.h>
 #include <unordered_map>
 #include <optional>
+#include <span>
 #include <string>
 #include <cstdint>
 
 namespace ember::dal {
 
+struct LoginRecord {
+	std::uint32_t account_id;
+	std::string ip;
+};
+
+struct SurveyRecord {
+	std::uint32_t account_id;
+	std::uint32_t survey_id;
+	std::string data;
+};
+
 class UserDAO {
 public:
 	virtual std::optional<User> user(const std::string& username) const = 0;
 	virtual void record_last_login(std::uint32_t account_id, const std::string& ip) const = 0;
 	virtual std::unordered_map<std::uint32_t, std::uint32_t> character_counts(std::uint32_t account_id) const = 0;
 	virtual void save_survey(std::uint32_t account_id, std::uint32_t survey_id, const std::string& data) const = 0;
+
+	// batched writes, each batch is written in a single transaction
+	virtual void record_logins(std::span<const LoginRecord> logins) const = 0;
+	virtual void save_surveys(std::span<const SurveyRecord> surveys) const = 0;
 	virtual ~UserDAO() = default;
 };
 
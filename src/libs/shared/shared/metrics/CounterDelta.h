@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Turns a running total into the increase since the last call, for
+ * publishing cumulative stats as counters rather than gauges
+ */
+class CounterDelta final {
+	std::uintmax_t last_ = 0;
+
+public:
+	std::intmax_t operator()(const std::uintmax_t total) {
+		const auto delta = total - last_;
+		last_ = total;
+		return static_cast<std::intmax_t>(delta);
+	}
+};
+
+} // ember
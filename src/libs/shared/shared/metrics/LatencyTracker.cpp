@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "LatencyTracker.h"
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <utility>
+
+namespace ember {
+
+namespace {
+
+std::atomic<std::size_t> next_tracker_id = 0;
+
+// indexed by tracker ID - IDs are never reused, so stale entries are never touched
+thread_local std::vector<void*> tls_tables;
+
+} // unnamed
+
+LatencyTracker::ThreadTable::ThreadTable(const std::size_t size)
+	: slots(std::make_unique<std::atomic<Histogram*>[]>(size)), size(size) {}
+
+LatencyTracker::ThreadTable::~ThreadTable() {
+	for(std::size_t i = 0; i < size; ++i) {
+		delete slots[i].load(std::memory_order_relaxed);
+	}
+}
+
+LatencyTracker::LatencyTracker(std::string name, const std::size_t keys,
+                               KeyName key_name, const bool enabled)
+	: name_(std::move(name)),
+	  keys_(keys),
+	  id_(next_tracker_id++),
+	  key_name_(std::move(key_name)),
+	  enabled_(enabled),
+	  previous_(keys) {}
+
+LatencyTracker::ThreadTable& LatencyTracker::local_table() {
+	if(tls_tables.size() <= id_) {
+		tls_tables.resize(id_ + 1);
+	}
+
+	if(auto table = tls_tables[id_]) {
+		return *static_cast<ThreadTable*>(table);
+	}
+
+	std::lock_guard guard(lock_);
+	auto& table = tables_.emplace_back(std::make_unique<ThreadTable>(keys_));
+	tls_tables[id_] = table.get();
+	return *table;
+}
+
+/*
+ * Only ever called by the thread that owns the histogram, so there's
+ * no need for atomic RMW operations - the atomics only exist so that
+ * the collector can read the values without tearing
+ */
+void LatencyTracker::record(const std::size_t key, const std::uint64_t ticks) {
+	if(key >= keys_) {
+		return;
+	}
+
+	auto& table = local_table();
+	auto histogram = table.slots[key].load(std::memory_order_relaxed);
+
+	if(!histogram) {
+		histogram = new Histogram {};
+		table.slots[key].store(histogram, std::memory_order_release);
+	}
+
+	const auto ns = static_cast<std::uint64_t>(util::tsc::to_duration(ticks).count());
+	const auto bucket = std::min<std::size_t>(std::bit_width(ns), BUCKETS - 1);
+	auto& count = histogram->buckets[bucket];
+	count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	auto& total = histogram->total_ns;
+	total.store(total.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds LatencyTracker::bucket_bound(const std::size_t bucket) {
+	return std::chrono::nanoseconds(std::uint64_t(1) << bucket);
+}
+
+/*
+ * Returns a summary of each key that has been recorded since the last
+ * call. The percentiles are reported as the upper bound of the bucket
+ * they fall into, so they'll err on the side of pessimism.
+ */
+std::vector<LatencyTracker::Summary> LatencyTracker::collect() {
+	std::vector<Summary> summaries;
+	std::lock_guard guard(lock_);
+
+	for(std::size_t key = 0; key < keys_; ++key) {
+		Snapshot current {};
+
+		for(const auto& table : tables_) {
+			const auto histogram = table->slots[key].load(std::memory_order_acquire);
+
+			if(!histogram) {
+				continue;
+			}
+
+			for(std::size_t i = 0; i < BUCKETS; ++i) {
+				current.buckets[i] += histogram->buckets[i].load(std::memory_order_relaxed);
+			}
+
+			current.total_ns += histogram->total_ns.load(std::memory_order_relaxed);
+		}
+
+		auto& previous = previous_[key];
+		std::array<std::uint64_t, BUCKETS> delta {};
+		std::uint64_t count = 0;
+
+		for(std::size_t i = 0; i < BUCKETS; ++i) {
+			delta[i] = current.buckets[i] - previous.buckets[i];
+			count += delta[i];
+		}
+
+		const auto total_ns = current.total_ns - previous.total_ns;
+		previous = current;
+
+		if(!count) {
+			continue;
+		}
+
+		Summary summary {
+			.key = key,
+			.count = count,
+			.mean = std::chrono::nanoseconds(total_ns / count)
+		};
+
+		const auto p50_rank = (count + 1) / 2;
+		const auto p99_rank = count - (count / 100);
+		std::uint64_t seen = 0;
+
+		for(std::size_t i = 0; i < BUCKETS; ++i) {
+			if(!delta[i]) {
+				continue;
+			}
+
+			const auto before = seen;
+			seen += delta[i];
+
+			if(before < p50_rank && seen >= p50_rank) {
+				summary.p50 = bucket_bound(i);
+			}
+
+			if(before < p99_rank && seen >= p99_rank) {
+				summary.p99 = bucket_bound(i);
+			}
+
+			summary.max = bucket_bound(i);
+		}
+
+		summaries.emplace_back(summary);
+	}
+
+	return summaries;
+}
+
+void LatencyTracker::publish(std::span<const Summary> summaries, Metrics& metrics) const {
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	for(const auto& summary : summaries) {
+		const auto prefix = std::format("latency.{}.{}", name_, key_name_(summary.key));
+		const auto p50 = duration_cast<microseconds>(summary.p50).count();
+		const auto p99 = duration_cast<microseconds>(summary.p99).count();
+		const auto max = duration_cast<microseconds>(summary.max).count();
+		metrics.gauge((prefix + ".count").c_str(), summary.count);
+		metrics.gauge((prefix + ".p50_us").c_str(), p50);
+		metrics.gauge((prefix + ".p99_us").c_str(), p99);
+		metrics.gauge((prefix + ".max_us").c_str(), max);
+	}
+}
+
+/*
+ * Builds a single line listing the keys with the worst p99, for logging
+ */
+std::string LatencyTracker::describe_slowest(std::span<const Summary> summaries,
+                                             const std::size_t count) const {
+	std::vector<const Summary*> sorted;
+
+	for(const auto& summary : summaries) {
+		sorted.emplace_back(&summary);
+	}
+
+	const auto end = sorted.begin() + std::min(count, sorted.size());
+
+	std::partial_sort(sorted.begin(), end, sorted.end(), [](const Summary* lhs, const Summary* rhs) {
+		return lhs->p99 > rhs->p99;
+	});
+
+	std::string description = std::format("Slowest {} (p99/mean/count):", name_);
+
+	for(auto it = sorted.begin(); it != end; ++it) {
+		const auto summary = *it;
+
+		description += std::format(
+			" {} {}us/{}us/{}", key_name_(summary->key),
+			std::chrono::duration_cast<std::chrono::microseconds>(summary->p99).count(),
+			std::chrono::duration_cast<std::chrono::microseconds>(summary->mean).count(),
+			summary->count
+		);
+	}
+
+	return description;
+}
+
+} // ember
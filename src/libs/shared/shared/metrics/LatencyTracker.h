@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/metrics/Metrics.h>
+#include <shared/utility/TSC.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Records how long something keyed by a small integer (an opcode, a state)
+ * takes, for finding out where time is actually going.
+ *
+ * Each thread records into its own histograms, so recording never
+ * contends with other threads and only costs a couple of TSC reads
+ * and relaxed stores. The histograms use power-of-two nanosecond buckets,
+ * which is plenty of resolution for spotting slow handlers.
+ *
+ * collect() aggregates the threads' histograms and returns the activity
+ * since the previous call, so it should be driven by a single poller
+ * (e.g. MetricsPoll).
+ *
+ * Disabled trackers cost a single relaxed load per measurement.
+ */
+class LatencyTracker final {
+public:
+	using KeyName = std::function<std::string(std::size_t key)>;
+	static constexpr std::size_t BUCKETS = 40; // bucket n is [2^(n-1), 2^n) ns
+
+	struct Summary {
+		std::size_t key;
+		std::uint64_t count;
+		std::chrono::nanoseconds mean;
+		std::chrono::nanoseconds p50;
+		std::chrono::nanoseconds p99;
+		std::chrono::nanoseconds max;
+	};
+
+private:
+	struct Histogram {
+		std::array<std::atomic<std::uint64_t>, BUCKETS> buckets;
+		std::atomic<std::uint64_t> total_ns;
+	};
+
+	struct ThreadTable {
+		std::unique_ptr<std::atomic<Histogram*>[]> slots;
+		const std::size_t size;
+
+		explicit ThreadTable(std::size_t size);
+		~ThreadTable();
+	};
+
+	struct Snapshot {
+		std::array<std::uint64_t, BUCKETS> buckets;
+		std::uint64_t total_ns;
+	};
+
+	const std::string name_;
+	const std::size_t keys_;
+	const std::size_t id_;
+	const KeyName key_name_;
+	std::atomic_bool enabled_;
+
+	std::mutex lock_;
+	std::vector<std::unique_ptr<ThreadTable>> tables_;
+	std::vector<Snapshot> previous_;
+
+	ThreadTable& local_table();
+	static std::chrono::nanoseconds bucket_bound(std::size_t bucket);
+
+public:
+	LatencyTracker(std::string name, std::size_t keys, KeyName key_name, bool enabled = false);
+
+	void record(std::size_t key, std::uint64_t ticks);
+	std::vector<Summary> collect();
+
+	void publish(std::span<const Summary> summaries, Metrics& metrics) const;
+	std::string describe_slowest(std::span<const Summary> summaries, std::size_t count) const;
+
+	void enable(bool enabled) {
+		enabled_.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool enabled() const {
+		return enabled_.load(std::memory_order_relaxed);
+	}
+
+	const std::string& name() const {
+		return name_;
+	}
+
+	std::string key_name(std::size_t key) const {
+		return key_name_(key);
+	}
+};
+
+/*
+ * Times the enclosing scope. The key can be changed after construction,
+ * for when it isn't known until part way through (e.g. after reading
+ * an opcode).
+ */
+class ScopedLatency final {
+	LatencyTracker* tracker_;
+	std::size_t key_;
+	std::uint64_t start_;
+
+public:
+	ScopedLatency(LatencyTracker* tracker, std::size_t key)
+		: tracker_(tracker && tracker->enabled()? tracker : nullptr),
+		  key_(key),
+		  start_(tracker_? util::tsc::now() : 0) {}
+
+	void key(std::size_t key) {
+		key_ = key;
+	}
+
+	void cancel() {
+		tracker_ = nullptr;
+	}
+
+	~ScopedLatency() {
+		if(tracker_) {
+			tracker_->record(key_, util::tsc::now() - start_);
+		}
+	}
+
+	ScopedLatency(const ScopedLatency&) = delete;
+	ScopedLatency& operator=(const ScopedLatency&) = delete;
+};
+
+} // ember
@@ -12,6 +12,10 @@ namespace ember {
 
 MetricsPoll::MetricsPoll(boost::asio::io_context& service, Metrics& metrics)
                          : timer_(service), metrics_(metrics) {
+	set_timer();
+}
+
+void MetricsPoll::set_timer() {
 	timer_.expires_from_now(FREQUENCY);
 
 	timer_.async_wait([this](const boost::system::error_code& ec) {
@@ -33,6 +37,8 @@ void MetricsPoll::timeout(const boost::system::error_code& ec) {
 		return;
 	}
 
+	std::unique_lock guard(lock_);
+
 	for(auto& cb : callbacks_) {
 		cb.timer -=  FREQUENCY;
 
@@ -48,7 +54,8 @@ void MetricsPoll::timeout(const boost::system::error_code& ec) {
 		}
 	}
 
-	timer_.expires_from_now(FREQUENCY);
+	guard.unlock();
+	set_timer();
 }
 
 } // ember
\ No newline at end of file
@@ -34,6 +34,7 @@ class MetricsPoll {
 	std::vector<MetricMeta> callbacks_;
 	Metrics& metrics_;
 
+	void set_timer();
 	void timeout(const boost::system::error_code& ec);
 
 public:
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/metrics/MetricsRegistry.h>
+#include <format>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <cctype>
+
+namespace ember {
+
+MetricsRegistry::MetricsRegistry(std::string prefix, std::unique_ptr<Metrics> forward)
+	: prefix_(std::move(prefix)),
+	  forward_(forward? std::move(forward) : std::make_unique<Metrics>()),
+	  entries_(std::make_shared<EntryMap>()) {}
+
+/*
+ * Prometheus metric names must match [a-zA-Z_:][a-zA-Z0-9_:]*, whereas
+ * StatsD keys are commonly dot-delimited, so anything that doesn't fit
+ * is replaced with an underscore
+ */
+std::string MetricsRegistry::sanitise(std::string_view key) const {
+	std::string name = prefix_;
+	name.reserve(prefix_.size() + key.size());
+
+	for(const auto c : key) {
+		const auto uc = static_cast<unsigned char>(c);
+		name.push_back((std::isalnum(uc) || c == '_' || c == ':')? c : '_');
+	}
+
+	if(name.empty() || std::isdigit(static_cast<unsigned char>(name.front()))) {
+		name.insert(name.begin(), '_');
+	}
+
+	return name;
+}
+
+auto MetricsRegistry::entry(std::string_view key, const Type type) -> Entry& {
+	auto entries = entries_.load();
+
+	if(auto it = entries->find(key); it != entries->end()) {
+		return *it->second;
+	}
+
+	std::lock_guard guard(lock_);
+
+	// may have been added while we were waiting on the lock
+	entries = entries_.load();
+
+	if(auto it = entries->find(key); it != entries->end()) {
+		return *it->second;
+	}
+
+	auto entry = std::make_shared<Entry>();
+	entry->type = type;
+	entry->name = sanitise(key);
+
+	auto copy = std::make_shared<EntryMap>(*entries);
+	copy->emplace(std::string(key), entry);
+	entries_ = std::move(copy);
+	return *entry;
+}
+
+void MetricsRegistry::increment(const char* key, const std::intmax_t value) {
+	entry(key, Type::COUNTER).value.fetch_add(value, std::memory_order_relaxed);
+	forward_->increment(key, value);
+}
+
+void MetricsRegistry::timing(const char* key, const std::chrono::milliseconds& value) {
+	auto& histogram = entry(key, Type::HISTOGRAM);
+	const auto ms = static_cast<std::intmax_t>(value.count());
+	std::size_t bucket = 0;
+
+	for(; bucket < BUCKETS.size(); ++bucket) {
+		if(ms <= BUCKETS[bucket]) {
+			break;
+		}
+	}
+
+	histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	histogram.sum.fetch_add(ms, std::memory_order_relaxed);
+	forward_->timing(key, value);
+}
+
+void MetricsRegistry::gauge(const char* key, const std::uintmax_t value, const Adjustment adjustment) {
+	auto& gauge = entry(key, Type::GAUGE);
+	const auto signed_val = static_cast<std::intmax_t>(value);
+
+	switch(adjustment) {
+		case Adjustment::POSITIVE:
+			gauge.value.fetch_add(signed_val, std::memory_order_relaxed);
+			break;
+		case Adjustment::NEGATIVE:
+			gauge.value.fetch_sub(signed_val, std::memory_order_relaxed);
+			break;
+		case Adjustment::NONE:
+			gauge.value.store(signed_val, std::memory_order_relaxed);
+			break;
+	}
+
+	forward_->gauge(key, value, adjustment);
+}
+
+void MetricsRegistry::set(const char* key, const std::intmax_t value) {
+	entry(key, Type::GAUGE).value.store(value, std::memory_order_relaxed);
+	forward_->set(key, value);
+}
+
+/*
+ * Renders the current values in the Prometheus text exposition format
+ * (version 0.0.4). The output string is appended to rather than replaced
+ * so the caller can reuse its capacity between scrapes.
+ */
+void MetricsRegistry::render(std::string& out) const {
+	const auto entries = entries_.load();
+	auto it = std::back_inserter(out);
+
+	for(const auto& entry : *entries | std::views::values) {
+		const auto& name = entry->name;
+
+		switch(entry->type) {
+			case Type::COUNTER:
+				std::format_to(it, "# TYPE {} counter\n{} {}\n",
+				               name, name, entry->value.load(std::memory_order_relaxed));
+				break;
+			case Type::GAUGE:
+				std::format_to(it, "# TYPE {} gauge\n{} {}\n",
+				               name, name, entry->value.load(std::memory_order_relaxed));
+				break;
+			case Type::HISTOGRAM: {
+				std::format_to(it, "# TYPE {} histogram\n", name);
+				std::uintmax_t cumulative = 0;
+
+				for(std::size_t i = 0; i < BUCKETS.size(); ++i) {
+					cumulative += entry->buckets[i].load(std::memory_order_relaxed);
+					std::format_to(it, "{}_bucket{{le=\"{}\"}} {}\n", name, BUCKETS[i], cumulative);
+				}
+
+				// count is derived from the buckets to keep +Inf and _count in agreement
+				cumulative += entry->buckets.back().load(std::memory_order_relaxed);
+				std::format_to(it, "{}_bucket{{le=\"+Inf\"}} {}\n", name, cumulative);
+				std::format_to(it, "{}_sum {}\n", name, entry->sum.load(std::memory_order_relaxed));
+				std::format_to(it, "{}_count {}\n", name, cumulative);
+				break;
+			}
+		}
+	}
+}
+
+std::size_t MetricsRegistry::size() const {
+	return entries_.load()->size();
+}
+
+} // ember
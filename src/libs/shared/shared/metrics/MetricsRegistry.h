@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/metrics/Metrics.h>
+#include <shared/utility/StringHash.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Keeps the current value of every metric reported through the Metrics
+ * interface so that it can be scraped (pulled) rather than pushed.
+ *
+ * Each metric is registered the first time its key is seen. The key map is
+ * copy-on-write, so neither the reporting threads nor the scraper take
+ * a lock unless a new key is being added. Values are plain atomics, meaning
+ * a snapshot is consistent per-metric but not across metrics, which is
+ * the same guarantee Prometheus' own client libraries give.
+ *
+ * Timings are recorded into fixed histogram buckets (milliseconds) and
+ * StatsD sets, which have no Prometheus equivalent, are exposed as gauges.
+ * Anything reported is also forwarded to the downstream sink, allowing
+ * StatsD pushing to continue alongside.
+ */
+class MetricsRegistry final : public Metrics {
+public:
+	enum class Type {
+		COUNTER, GAUGE, HISTOGRAM
+	};
+
+	static constexpr std::array<std::intmax_t, 14> BUCKETS {
+		1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000
+	};
+
+	struct Entry {
+		Type type;
+		std::string name;
+		std::atomic<std::intmax_t> value;
+		std::atomic<std::intmax_t> sum;
+		std::array<std::atomic<std::uintmax_t>, BUCKETS.size() + 1> buckets; // last is +Inf
+	};
+
+private:
+	using EntryMap = std::unordered_map<std::string, std::shared_ptr<Entry>,
+	                                    StringHash, std::equal_to<>>;
+
+	const std::string prefix_;
+	std::unique_ptr<Metrics> forward_;
+	std::atomic<std::shared_ptr<const EntryMap>> entries_;
+	std::mutex lock_;
+
+	Entry& entry(std::string_view key, Type type);
+	std::string sanitise(std::string_view key) const;
+
+public:
+	explicit MetricsRegistry(std::string prefix, std::unique_ptr<Metrics> forward = nullptr);
+
+	void increment(const char* key, std::intmax_t value = 1) override;
+	void timing(const char* key, const std::chrono::milliseconds& value) override;
+	void gauge(const char* key, std::uintmax_t value, Adjustment adjustment = Adjustment::NONE) override;
+	void set(const char* key, std::intmax_t value) override;
+
+	void render(std::string& out) const;
+	std::size_t size() const;
+};
+
+} // ember
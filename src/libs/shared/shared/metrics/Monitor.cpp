@@ -7,9 +7,11 @@
  */
 
 #include <shared/metrics/Monitor.h>
-#include <array>
+#include <algorithm>
 #include <memory>
 #include <sstream>
+#include <string_view>
+#include <cctype>
 
 namespace ember {
 
@@ -34,22 +36,49 @@ void Monitor::shutdown() {
 }
 
 void Monitor::receive() {
-	std::array<char, 1> buffer;
-
-	socket_.async_receive_from(boost::asio::buffer(buffer), endpoint_, 
-		strand_.wrap([this](const boost::system::error_code& ec, std::size_t) {
+	socket_.async_receive_from(boost::asio::buffer(buffer_), endpoint_, 
+		strand_.wrap([this](const boost::system::error_code& ec, std::size_t size) {
 			if(!ec || ec == boost::asio::error::message_size) {
-				send_health_status();
+				handle_request(size);
 				receive();
 			}
 	}));
 }
 
+/*
+ * Anything that isn't a registered command gets the health status,
+ * so existing probes that send a single arbitrary byte still work
+ */
+void Monitor::handle_request(const std::size_t size) {
+	std::string_view request(buffer_.data(), std::min(size, buffer_.size()));
+
+	while(!request.empty() && std::isspace(static_cast<unsigned char>(request.back()))) {
+		request.remove_suffix(1);
+	}
+
+	std::unique_lock guard(source_lock_);
+	auto it = commands_.find(std::string(request));
+
+	if(it == commands_.end()) {
+		guard.unlock();
+		send_health_status();
+		return;
+	}
+
+	auto command = it->second;
+	guard.unlock();
+	send_response(command());
+}
+
 void Monitor::send_health_status() {
-	auto message = std::make_shared<std::string>(generate_message());
+	send_response(generate_message());
+}
 
-	socket_.async_send_to(boost::asio::buffer(*message), endpoint_,
-		strand_.wrap([message](const boost::system::error_code&, std::size_t) { }));
+void Monitor::send_response(std::string message) {
+	auto buffer = std::make_shared<std::string>(std::move(message));
+
+	socket_.async_send_to(boost::asio::buffer(*buffer), endpoint_,
+		strand_.wrap([buffer](const boost::system::error_code&, std::size_t) { }));
 }
 
 void Monitor::add_source(Source source, Severity severity, LogCallback log_callback) {
@@ -58,6 +87,11 @@ void Monitor::add_source(Source source, Severity severity, LogCallback log_callb
 	sources_.emplace_back(source, severity, log_callback, 0s);
 }
 
+void Monitor::add_command(std::string name, Command command) {
+	std::lock_guard guard(source_lock_);
+	commands_[std::move(name)] = std::move(command);
+}
+
 void Monitor::timer_tick(const boost::system::error_code& ec) {
 	if(ec) { // timer was cancelled
 		return;
@@ -13,6 +13,7 @@
 #include <boost/asio/signal_set.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/ip/udp.hpp>
+#include <array>
 #include <chrono>
 #include <functional>
 #include <string>
@@ -45,6 +46,7 @@ public:
 	};
 
 	using LogCallback = std::function<void(const Source, Severity, std::intmax_t)>;
+	using Command = std::function<std::string()>;
 
 private:
 	const std::chrono::seconds TIMER_FREQUENCY;
@@ -57,10 +59,14 @@ private:
 	std::vector<std::tuple<Source, Severity, LogCallback, std::chrono::seconds>> sources_;
 	mutable std::mutex source_lock_;
 	std::unordered_map<Severity, unsigned int> counters_;
+	std::unordered_map<std::string, Command> commands_;
+	std::array<char, 64> buffer_;
 
 	void receive();
 	void set_timer();
 	void send_health_status();
+	void send_response(std::string message);
+	void handle_request(std::size_t size);
 	void timer_tick(const boost::system::error_code& ec);
 	void execute_source(Source& source, Severity severity, const LogCallback& log,
 	                    std::chrono::seconds& last_tick);
@@ -73,6 +79,7 @@ public:
 	        std::uint16_t port, std::chrono::seconds frequency = 5s);
 
 	void add_source(Source source, Severity severity, LogCallback log_callback);
+	void add_command(std::string name, Command command);
 };
 
 } // ember
\ No newline at end of file
@@ -0,0 +1,498 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Profiler.h"
+#include <algorithm>
+#include <array>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#if defined __linux__
+	#include <cxxabi.h>
+	#include <dlfcn.h>
+	#include <execinfo.h>
+	#include <pthread.h>
+	#include <signal.h>
+	#include <sys/syscall.h>
+	#include <time.h>
+	#include <unistd.h>
+
+	#ifndef sigev_notify_thread_id
+		#define sigev_notify_thread_id _sigev_un._tid
+	#endif
+#endif
+
+namespace ember {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::size_t MAX_FRAMES = 48;
+constexpr std::size_t SKIP_FRAMES = 2; // signal handler & signal trampoline
+constexpr std::size_t MAX_TAG_LEN = 32;
+constexpr std::size_t RING_SIZE = 64;
+constexpr auto TAG_COUNT = std::to_underlying(Profiler::Tag::MAX);
+constexpr auto DRAIN_INTERVAL = 100ms;
+
+struct Sample {
+	std::array<void*, MAX_FRAMES> frames;
+	std::array<std::array<char, MAX_TAG_LEN>, TAG_COUNT> tags;
+	std::array<std::uint8_t, TAG_COUNT> tag_lengths;
+	std::uint8_t depth;
+};
+
+struct ThreadState {
+	std::string name;
+	std::array<Sample, RING_SIZE> ring;
+	std::atomic<std::uint32_t> head; // only written by the signal handler
+	std::atomic<std::uint32_t> tail; // only written by the drainer
+	std::atomic<std::uint64_t> dropped;
+#if defined __linux__
+	timer_t timer;
+#endif
+	bool has_timer;
+};
+
+/*
+ * Tags are written by the owning thread and read by the signal handler
+ * on the same thread, so only compiler reordering matters. The size is
+ * zeroed before the pointer changes, so an interrupted update can only
+ * ever be seen as an empty tag, never a mismatched pointer & length.
+ */
+struct TagSlot {
+	std::atomic<const char*> data;
+	std::atomic<std::size_t> size;
+};
+
+thread_local std::array<TagSlot, TAG_COUNT> tls_tags;
+thread_local std::atomic<ThreadState*> tls_state;
+
+std::mutex registry_lock;
+std::vector<ThreadState*> registry;
+std::vector<std::unique_ptr<ThreadState>> retired; // exited, with samples yet to be collected
+std::chrono::nanoseconds sample_interval;
+std::atomic_bool active = false;
+
+#if defined __linux__
+void arm(ThreadState& state, const std::chrono::nanoseconds interval) {
+	if(!state.has_timer) {
+		return;
+	}
+
+	const auto secs = std::chrono::duration_cast<std::chrono::seconds>(interval);
+
+	itimerspec spec {};
+	spec.it_interval.tv_sec = secs.count();
+	spec.it_interval.tv_nsec = (interval - secs).count();
+	spec.it_value = spec.it_interval;
+	timer_settime(state.timer, 0, &spec, nullptr);
+}
+
+void on_signal(int, siginfo_t*, void*) {
+	const auto saved_errno = errno;
+	const auto state = tls_state.load(std::memory_order_relaxed);
+
+	if(!state) {
+		errno = saved_errno;
+		return;
+	}
+
+	const auto head = state->head.load(std::memory_order_relaxed);
+	const auto tail = state->tail.load(std::memory_order_acquire);
+
+	if(head - tail >= RING_SIZE) {
+		state->dropped.fetch_add(1, std::memory_order_relaxed);
+		errno = saved_errno;
+		return;
+	}
+
+	auto& sample = state->ring[head % RING_SIZE];
+	std::array<void*, MAX_FRAMES + SKIP_FRAMES> frames;
+	const auto depth = backtrace(frames.data(), frames.size());
+	const auto usable = depth > int(SKIP_FRAMES)? depth - SKIP_FRAMES : 0;
+	std::memcpy(sample.frames.data(), frames.data() + SKIP_FRAMES, usable * sizeof(void*));
+	sample.depth = static_cast<std::uint8_t>(usable);
+
+	for(std::size_t i = 0; i < TAG_COUNT; ++i) {
+		const auto size = std::min(tls_tags[i].size.load(std::memory_order_relaxed), MAX_TAG_LEN);
+		const auto data = tls_tags[i].data.load(std::memory_order_relaxed);
+
+		if(size && data) {
+			std::memcpy(sample.tags[i].data(), data, size);
+		}
+
+		sample.tag_lengths[i] = data? static_cast<std::uint8_t>(size) : 0;
+	}
+
+	state->head.store(head + 1, std::memory_order_release);
+	errno = saved_errno;
+}
+
+void install_handler() {
+	static std::once_flag flag;
+
+	std::call_once(flag, [] {
+		// backtrace() lazily loads libgcc on first use, which isn't safe to do in a handler
+		std::array<void*, 1> frames;
+		backtrace(frames.data(), frames.size());
+
+		struct sigaction action {};
+		action.sa_sigaction = on_signal;
+		action.sa_flags = SA_RESTART | SA_SIGINFO;
+		sigemptyset(&action.sa_mask);
+
+		if(sigaction(SIGPROF, &action, nullptr) == -1) {
+			throw std::system_error(errno, std::generic_category(), "Unable to install SIGPROF handler");
+		}
+	});
+}
+#endif
+
+/*
+ * Unregisters the thread when it exits, handing its ring over to the
+ * profiler if it still holds samples so they aren't lost
+ */
+struct Registration {
+	std::unique_ptr<ThreadState> state;
+
+	~Registration() {
+		if(!state) {
+			return;
+		}
+
+		std::lock_guard guard(registry_lock);
+
+#if defined __linux__
+		if(state->has_timer) {
+			timer_delete(state->timer);
+		}
+#endif
+
+		tls_state.store(nullptr, std::memory_order_relaxed);
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		std::erase(registry, state.get());
+
+		if(state->head != state->tail || state->dropped) {
+			retired.emplace_back(std::move(state));
+		}
+	}
+};
+
+thread_local Registration tls_registration;
+
+} // unnamed
+
+Profiler::ScopedTag::ScopedTag(const Tag tag, const std::string_view value)
+	: tag_(tag),
+	  prev_(tls_tags[std::to_underlying(tag)].data.load(std::memory_order_relaxed),
+	        tls_tags[std::to_underlying(tag)].size.load(std::memory_order_relaxed)) {
+	auto& slot = tls_tags[std::to_underlying(tag_)];
+	slot.size.store(0, std::memory_order_relaxed);
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+	slot.data.store(value.data(), std::memory_order_relaxed);
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+	slot.size.store(value.size(), std::memory_order_relaxed);
+}
+
+Profiler::ScopedTag::~ScopedTag() {
+	auto& slot = tls_tags[std::to_underlying(tag_)];
+	slot.size.store(0, std::memory_order_relaxed);
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+	slot.data.store(prev_.data(), std::memory_order_relaxed);
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+	slot.size.store(prev_.size(), std::memory_order_relaxed);
+}
+
+Profiler::Profiler(std::filesystem::path output, const unsigned int frequency,
+                   const std::chrono::seconds flush_interval, ErrorHandler on_error)
+	: output_(std::move(output)),
+	  frequency_(frequency),
+	  flush_interval_(flush_interval),
+	  on_error_(std::move(on_error)),
+	  samples_(0),
+	  dropped_(0),
+	  running_(false) {
+	if(!frequency_) {
+		throw std::invalid_argument("Profiler sampling frequency must be non-zero");
+	}
+}
+
+Profiler::~Profiler() {
+	try {
+		stop();
+	} catch(const std::exception& e) {
+		report(e);
+	}
+}
+
+/*
+ * Must be called by every thread that should be sampled, before it
+ * starts doing anything interesting. Samples are measured against the
+ * thread's own CPU time, so there's no cost to registering threads
+ * that spend most of their lives blocked.
+ */
+void Profiler::register_thread(const std::string_view name) {
+	if(tls_registration.state) {
+		return;
+	}
+
+	auto state = std::make_unique<ThreadState>();
+	state->name = name;
+	state->has_timer = false;
+
+	// touch the thread-locals so they're allocated before the handler can run
+	tls_tags[0].size.store(0, std::memory_order_relaxed);
+
+#if defined __linux__
+	clockid_t clock;
+
+	if(pthread_getcpuclockid(pthread_self(), &clock) == 0) {
+		sigevent event {};
+		event.sigev_notify = SIGEV_THREAD_ID;
+		event.sigev_signo = SIGPROF;
+		event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+		state->has_timer = timer_create(clock, &event, &state->timer) == 0;
+	}
+#endif
+
+	std::lock_guard guard(registry_lock);
+	tls_state.store(state.get(), std::memory_order_relaxed);
+	registry.emplace_back(state.get());
+
+#if defined __linux__
+	if(active) {
+		arm(*state, sample_interval);
+	}
+#endif
+
+	tls_registration.state = std::move(state);
+}
+
+/*
+ * Whether tags are worth setting, for callers that have to do some
+ * work to produce them
+ */
+bool Profiler::tagging() {
+	return active.load(std::memory_order_relaxed);
+}
+
+void Profiler::start() {
+#if defined __linux__
+	if(running_.exchange(true)) {
+		return;
+	}
+
+	try {
+		install_handler();
+		std::lock_guard guard(registry_lock);
+
+		if(active.exchange(true)) {
+			throw std::logic_error("Only one profiler may run at a time");
+		}
+
+		sample_interval = std::chrono::nanoseconds(1s) / frequency_;
+
+		for(auto state : registry) {
+			arm(*state, sample_interval);
+		}
+	} catch(...) {
+		running_ = false;
+		throw;
+	}
+
+	drainer_ = std::jthread([&](std::stop_token token) { drain(token); });
+#else
+	throw std::runtime_error("Sampling profiler is not supported on this platform");
+#endif
+}
+
+void Profiler::stop() {
+	if(!running_.exchange(false)) {
+		return;
+	}
+
+#if defined __linux__
+	{
+		std::lock_guard guard(registry_lock);
+		active = false;
+
+		for(auto state : registry) {
+			arm(*state, 0ns);
+		}
+	}
+#endif
+
+	drainer_.request_stop();
+	drainer_.join();
+	flush();
+}
+
+bool Profiler::running() const {
+	return running_;
+}
+
+void Profiler::drain(std::stop_token token) {
+	auto last_flush = std::chrono::steady_clock::now();
+
+	while(!token.stop_requested()) {
+		std::this_thread::sleep_for(DRAIN_INTERVAL);
+		collect();
+
+		const auto now = std::chrono::steady_clock::now();
+
+		if(flush_interval_.count() && now - last_flush >= flush_interval_) {
+			// nobody to throw to on this thread, so report it and try again next time
+			try {
+				write();
+			} catch(const std::exception& e) {
+				report(e);
+			}
+
+			last_flush = now;
+		}
+	}
+}
+
+/*
+ * Moves the samples out of each thread's ring buffer and into the
+ * aggregated stacks, ordered root first as the collapsed format expects
+ */
+void Profiler::collect() {
+	std::lock_guard registry_guard(registry_lock);
+	std::lock_guard guard(lock_);
+	std::string key;
+
+	auto states = registry;
+
+	for(const auto& state : retired) {
+		states.emplace_back(state.get());
+	}
+
+	for(auto state : states) {
+		auto tail = state->tail.load(std::memory_order_relaxed);
+		const auto head = state->head.load(std::memory_order_acquire);
+
+		for(; tail != head; ++tail) {
+			const auto& sample = state->ring[tail % RING_SIZE];
+			key = state->name;
+
+			for(std::size_t i = 0; i < TAG_COUNT; ++i) {
+				if(sample.tag_lengths[i]) {
+					key += ";[";
+					key.append(sample.tags[i].data(), sample.tag_lengths[i]);
+					key += ']';
+				}
+			}
+
+			for(auto i = sample.depth; i > 0; --i) {
+				key += ';';
+				key += symbol(sample.frames[i - 1]);
+			}
+
+			++stacks_[key];
+			++samples_;
+		}
+
+		state->tail.store(tail, std::memory_order_release);
+		dropped_ += state->dropped.exchange(0, std::memory_order_relaxed);
+	}
+
+	retired.clear();
+}
+
+/*
+ * Only exported symbols can be resolved at runtime, so link with
+ * -rdynamic for readable output. Anything else is left as module+offset
+ * so it can be resolved offline with addr2line.
+ */
+const std::string& Profiler::symbol(void* address) {
+	auto it = symbols_.find(address);
+
+	if(it != symbols_.end()) {
+		return it->second;
+	}
+
+	std::string name = std::format("{}", address);
+
+#if defined __linux__
+	Dl_info info {};
+
+	if(dladdr(address, &info)) {
+		if(info.dli_sname) {
+			int status = 0;
+			std::unique_ptr<char, decltype(&std::free)> demangled(
+				abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status), &std::free
+			);
+
+			name = status == 0? demangled.get() : info.dli_sname;
+		} else if(info.dli_fname) {
+			const auto offset = static_cast<const char*>(address)
+				- static_cast<const char*>(info.dli_fbase);
+			name = std::format("{}+{:#x}", std::filesystem::path(info.dli_fname).filename().string(),
+			                   offset);
+		}
+	}
+#endif
+
+	std::ranges::replace(name, ';', ':');
+	return symbols_.emplace(address, std::move(name)).first->second;
+}
+
+/*
+ * Rewrites the output file with everything collected so far, going
+ * through a temporary file so readers never see a partial profile
+ */
+void Profiler::write() {
+	std::lock_guard guard(lock_);
+	auto temp = output_;
+	temp += ".tmp";
+
+	{
+		std::ofstream file(temp, std::ios::trunc);
+
+		if(!file) {
+			throw std::runtime_error(std::format("Unable to open {}", temp.string()));
+		}
+
+		for(const auto& [stack, count] : stacks_) {
+			file << stack << ' ' << count << '\n';
+		}
+	}
+
+	std::filesystem::rename(temp, output_);
+}
+
+void Profiler::flush() {
+	collect();
+	write();
+}
+
+void Profiler::report(const std::exception& e) const {
+	if(on_error_) {
+		on_error_(e.what());
+	}
+}
+
+std::uint64_t Profiler::samples() const {
+	return samples_;
+}
+
+std::uint64_t Profiler::dropped() const {
+	return dropped_;
+}
+
+} // ember
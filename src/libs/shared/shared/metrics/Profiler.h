@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * In-process sampling profiler, intended to be cheap enough to leave
+ * running on a production server.
+ *
+ * Each registered thread gets a timer that fires SIGPROF after every
+ * interval of CPU time the thread consumes, so idle threads cost nothing.
+ * The signal handler captures the stack along with whatever tags the
+ * thread has set (client state, opcode, spark channel) into a per-thread
+ * ring buffer, which a background thread drains and aggregates.
+ *
+ * Output is in the collapsed stack format, one stack per line followed
+ * by its sample count, as consumed by flamegraph.pl, inferno, speedscope, etc.
+ *
+ * Only threads that call register_thread() are sampled. Linux only.
+ *
+ * Errors writing the output on the background thread are passed to the
+ * error handler rather than thrown, as are any from stopping on destruction.
+ */
+class Profiler final {
+public:
+	using ErrorHandler = std::function<void(std::string_view)>;
+
+	enum class Tag {
+		STATE, OPCODE, CHANNEL,
+		MAX
+	};
+
+	/*
+	 * Tags the samples taken on this thread for the lifetime of the scope.
+	 * The string's storage must outlive the scope.
+	 */
+	class ScopedTag final {
+		const Tag tag_;
+		const std::string_view prev_;
+
+	public:
+		ScopedTag(Tag tag, std::string_view value);
+		~ScopedTag();
+
+		ScopedTag(const ScopedTag&) = delete;
+		ScopedTag& operator=(const ScopedTag&) = delete;
+	};
+
+private:
+	const std::filesystem::path output_;
+	const unsigned int frequency_;
+	const std::chrono::seconds flush_interval_;
+	const ErrorHandler on_error_;
+
+	std::mutex lock_;
+	std::jthread drainer_;
+	std::unordered_map<std::string, std::uint64_t> stacks_;
+	std::unordered_map<void*, std::string> symbols_;
+	std::atomic<std::uint64_t> samples_;
+	std::atomic<std::uint64_t> dropped_;
+	std::atomic_bool running_;
+
+	void drain(std::stop_token token);
+	void collect();
+	void write();
+	const std::string& symbol(void* address);
+	void report(const std::exception& e) const;
+
+public:
+	Profiler(std::filesystem::path output, unsigned int frequency,
+	         std::chrono::seconds flush_interval, ErrorHandler on_error = nullptr);
+	~Profiler();
+
+	static void register_thread(std::string_view name);
+	static bool tagging();
+
+	void start();
+	void stop();
+	bool running() const;
+	void flush();
+
+	std::uint64_t samples() const;
+	std::uint64_t dropped() const;
+
+	Profiler(const Profiler&) = delete;
+	Profiler& operator=(const Profiler&) = delete;
+};
+
+} // ember
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/metrics/PrometheusExporter.h>
+#include <boost/asio/write.hpp>
+#include <format>
+#include <functional>
+#include <utility>
+
+namespace ember {
+
+namespace bai = boost::asio::ip;
+
+PrometheusExporter::PrometheusExporter(boost::asio::io_context& service, const std::string& interface,
+                                       std::uint16_t port, const MetricsRegistry& registry)
+	: acceptor_(service, bai::tcp::endpoint(bai::address::from_string(interface), port)),
+	  signals_(service, SIGINT, SIGTERM),
+	  registry_(registry) {
+	signals_.async_wait(std::bind(&PrometheusExporter::shutdown, this));
+	acceptor_.set_option(bai::tcp::acceptor::reuse_address(true));
+	accept();
+}
+
+void PrometheusExporter::shutdown() {
+	boost::system::error_code ec; // we don't care about any errors
+	acceptor_.close(ec);
+}
+
+void PrometheusExporter::accept() {
+	acceptor_.async_accept([this](const boost::system::error_code& ec, bai::tcp::socket socket) {
+		if(ec == boost::asio::error::operation_aborted) {
+			return;
+		}
+
+		if(!ec) {
+			std::make_shared<Connection>(std::move(socket), registry_)->start();
+		}
+
+		accept();
+	});
+}
+
+std::uint16_t PrometheusExporter::port() const {
+	return acceptor_.local_endpoint().port();
+}
+
+PrometheusExporter::Connection::Connection(bai::tcp::socket socket, const MetricsRegistry& registry)
+	: socket_(std::move(socket)),
+	  timer_(socket_.get_executor()),
+	  registry_(registry) {}
+
+void PrometheusExporter::Connection::start() {
+	auto self(shared_from_this());
+
+	timer_.expires_from_now(REQUEST_TIMEOUT);
+	timer_.async_wait([this, self](const boost::system::error_code& ec) {
+		if(!ec) {
+			close();
+		}
+	});
+
+	read();
+}
+
+void PrometheusExporter::Connection::read() {
+	auto self(shared_from_this());
+	auto buffer = boost::asio::buffer(buffer_.data() + received_, buffer_.size() - received_);
+
+	socket_.async_read_some(buffer, [this, self](const boost::system::error_code& ec, std::size_t size) {
+		if(ec) {
+			close();
+			return;
+		}
+
+		received_ += size;
+		const std::string_view request(buffer_.data(), received_);
+
+		// we only care about the request line, so headers are never parsed
+		if(request.find("\r\n\r\n") != std::string_view::npos) {
+			handle_request(request);
+		} else if(received_ == buffer_.size()) {
+			respond("431 Request Header Fields Too Large", false);
+		} else {
+			read();
+		}
+	});
+}
+
+void PrometheusExporter::Connection::handle_request(std::string_view request) {
+	const auto line = request.substr(0, request.find("\r\n"));
+	const auto method_end = line.find(' ');
+	const auto target_end = line.find(' ', method_end + 1);
+
+	if(method_end == std::string_view::npos || target_end == std::string_view::npos) {
+		respond("400 Bad Request", false);
+		return;
+	}
+
+	const auto method = line.substr(0, method_end);
+	auto target = line.substr(method_end + 1, target_end - method_end - 1);
+	target = target.substr(0, target.find('?'));
+
+	if(method != "GET" && method != "HEAD") {
+		respond("405 Method Not Allowed", false);
+	} else if(target != "/metrics") {
+		respond("404 Not Found", false);
+	} else {
+		registry_.render(body_);
+		respond("200 OK", method == "GET");
+	}
+}
+
+void PrometheusExporter::Connection::respond(std::string_view status, const bool include_body) {
+	auto self(shared_from_this());
+
+	header_ = std::format(
+		"HTTP/1.1 {}\r\n"
+		"Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+		"Content-Length: {}\r\n"
+		"Connection: close\r\n\r\n",
+		status, body_.size()
+	);
+
+	if(!include_body) {
+		body_.clear();
+	}
+
+	const std::array buffers {
+		boost::asio::const_buffer(header_.data(), header_.size()),
+		boost::asio::const_buffer(body_.data(), body_.size())
+	};
+
+	boost::asio::async_write(socket_, buffers,
+		[this, self](const boost::system::error_code&, std::size_t) {
+			close();
+		}
+	);
+}
+
+void PrometheusExporter::Connection::close() {
+	boost::system::error_code ec; // we don't care about any errors
+	timer_.cancel(ec);
+	socket_.shutdown(bai::tcp::socket::shutdown_both, ec);
+	socket_.close(ec);
+}
+
+} // ember
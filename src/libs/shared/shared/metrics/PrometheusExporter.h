@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/metrics/MetricsRegistry.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Minimal HTTP/1.1 endpoint that serves the registry's contents on
+ * GET /metrics for Prometheus to scrape. It only understands enough of
+ * HTTP to satisfy a scraper - each connection handles a single request
+ * and is then closed.
+ */
+class PrometheusExporter final {
+	static constexpr std::chrono::seconds REQUEST_TIMEOUT { 5 };
+	static constexpr std::size_t MAX_REQUEST_SIZE = 2048;
+
+	class Connection final : public std::enable_shared_from_this<Connection> {
+		boost::asio::ip::tcp::socket socket_;
+		boost::asio::steady_timer timer_;
+		const MetricsRegistry& registry_;
+		std::array<char, MAX_REQUEST_SIZE> buffer_;
+		std::size_t received_ = 0;
+		std::string header_;
+		std::string body_;
+
+		void read();
+		void handle_request(std::string_view request);
+		void respond(std::string_view status, bool include_body);
+		void close();
+
+	public:
+		Connection(boost::asio::ip::tcp::socket socket, const MetricsRegistry& registry);
+		void start();
+	};
+
+	boost::asio::ip::tcp::acceptor acceptor_;
+	boost::asio::signal_set signals_;
+	const MetricsRegistry& registry_;
+
+	void accept();
+	void shutdown();
+
+public:
+	PrometheusExporter(boost::asio::io_context& service, const std::string& interface,
+	                   std::uint16_t port, const MetricsRegistry& registry);
+
+	std::uint16_t port() const;
+};
+
+} // ember
@@ -8,6 +8,7 @@
 
 #include "ServicePool.h"
 #include <shared/threading/Utility.h>
+#include <shared/metrics/Profiler.h>
 #include <utility>
 #include <stdexcept>
 
@@ -57,11 +58,40 @@ boost::asio::io_context* ServicePool::get_if(const std::size_t index) const {
 
 void ServicePool::run() {
 	const auto core_count = std::thread::hardware_concurrency();
+	std::vector<unsigned int> layout;
 
 	for(std::size_t i = 0; i < pool_size_; ++i) {
-		threads_.emplace_back(static_cast<std::size_t(boost::asio::io_context::*)()>
-			(&boost::asio::io_context::run), services_[i].get());
-		thread::set_affinity(threads_[i], i % core_count);
+		layout.emplace_back(i % core_count);
+	}
+
+	run(layout);
+}
+
+/*
+ * Threads pin themselves before running their io_context, rather than
+ * being pinned after creation, so that any thread-local pools (e.g.
+ * TLSBlockAllocator) are first touched on the intended CPU and thus
+ * allocated from its NUMA node. An empty layout leaves placement to the OS.
+ */
+void ServicePool::run(std::span<const unsigned int> layout) {
+	if(!layout.empty() && layout.size() != pool_size_) {
+		throw std::invalid_argument("Thread layout does not match the service pool size");
+	}
+
+	for(std::size_t i = 0; i < pool_size_; ++i) {
+		auto service = services_[i].get();
+		const auto pin = !layout.empty();
+		const auto core = pin? layout[i] : 0;
+
+		threads_.emplace_back([service, pin, core] {
+			if(pin) {
+				thread::set_affinity(core);
+			}
+
+			Profiler::register_thread("service_pool");
+			service->run();
+		});
+
 		thread::set_name(threads_[i], "Service Pool");
 	}
 }
@@ -11,6 +11,7 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/container/small_vector.hpp>
 #include <memory>
+#include <span>
 #include <thread>
 #include <vector>
 #include <cstddef>
@@ -36,6 +37,7 @@ public:
 	boost::asio::io_context* get_if(std::size_t index) const;
 
 	void run();
+	void run(std::span<const unsigned int> layout);
 	void stop();
 	std::size_t size() const;
 
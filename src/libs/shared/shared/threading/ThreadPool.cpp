@@ -8,25 +8,202 @@
 
 #include "ThreadPool.h"
 #include <shared/threading/Utility.h>
+#include <shared/metrics/Profiler.h>
+#include <mutex>
+#include <stdexcept>
 
 namespace ember {
 
-ThreadPool::ThreadPool(std::size_t initial_count) : work_(service_) {
+namespace {
+
+// allows work posted from a worker to stay on that worker's queues
+thread_local const ThreadPool* tls_pool = nullptr;
+thread_local std::size_t tls_index = 0;
+
+} // unnamed
+
+ThreadPool::ThreadPool(std::size_t initial_count, std::size_t max_queued)
+	: max_queued_(max_queued),
+	  pending_(0),
+	  stopped_(false),
+	  next_queue_(0),
+	  queued_(0),
+	  stolen_(0),
+	  rejected_(0) {
+	if(initial_count == 0) {
+		throw std::invalid_argument("Cannot have an empty thread pool!");
+	}
+
+	queues_.reserve(initial_count);
 	workers_.reserve(initial_count);
 
 	for(std::size_t i = 0; i < initial_count; ++i) {
-		workers_.emplace_back(static_cast<std::size_t(boost::asio::io_context::*)()>
-			(&boost::asio::io_context::run), &service_);
+		queues_.emplace_back(std::make_unique<Worker>());
+	}
+
+	for(std::size_t i = 0; i < initial_count; ++i) {
+		workers_.emplace_back(&ThreadPool::process_tasks, this, i);
 		thread::set_name(workers_[i], "Thread Pool");
 	}
 }
 
+void ThreadPool::enqueue(Work work, const Priority priority) {
+	const auto level = static_cast<std::size_t>(priority);
+	std::size_t index = 0;
+
+	if(tls_pool == this) {
+		index = tls_index;
+	} else {
+		index = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+	}
+
+	auto& queue = queues_[index]->queues[level];
+
+	{
+		std::lock_guard guard(queue.lock);
+		queue.tasks.emplace_back(std::move(work), Clock::now());
+		queue.size.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	queued_by_priority_[level].fetch_add(1, std::memory_order_relaxed);
+	pending_.release();
+}
+
+/*
+ * Owners take from the front to preserve submission order, thieves take
+ * from the back to keep contention with the owner to a minimum
+ */
+bool ThreadPool::try_pop(Queue& queue, const bool steal, Task& task) {
+	if(!queue.size.load(std::memory_order_relaxed)) {
+		return false;
+	}
+
+	std::lock_guard guard(queue.lock);
+
+	if(queue.tasks.empty()) {
+		return false;
+	}
+
+	if(steal) {
+		task = std::move(queue.tasks.back());
+		queue.tasks.pop_back();
+	} else {
+		task = std::move(queue.tasks.front());
+		queue.tasks.pop_front();
+	}
+
+	queue.size.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool ThreadPool::execute_next(const std::size_t index) {
+	const auto count = queues_.size();
+	Task task;
+
+	for(std::size_t level = 0; level < PRIORITY_LEVELS; ++level) {
+		bool found = try_pop(queues_[index]->queues[level], false, task);
+
+		for(std::size_t i = 1; !found && i < count; ++i) {
+			found = try_pop(queues_[(index + i) % count]->queues[level], true, task);
+
+			if(found) {
+				stolen_.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		if(found) {
+			queued_.fetch_sub(1, std::memory_order_relaxed);
+			queued_by_priority_[level].fetch_sub(1, std::memory_order_relaxed);
+			record_wait(static_cast<Priority>(level), Clock::now() - task.enqueued);
+			task.work();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::record_wait(const Priority priority, const Clock::duration wait) {
+	const auto us = std::chrono::duration_cast<std::chrono::microseconds>(wait).count();
+	auto& stats = wait_stats_[static_cast<std::size_t>(priority)];
+	stats.count.fetch_add(1, std::memory_order_relaxed);
+	stats.total_us.fetch_add(us, std::memory_order_relaxed);
+
+	auto max = stats.max_us.load(std::memory_order_relaxed);
+
+	while(static_cast<std::uint64_t>(us) > max
+	      && !stats.max_us.compare_exchange_weak(max, us, std::memory_order_relaxed)) {}
+}
+
+/*
+ * Each acquired permit corresponds to a queued task, so a worker that has
+ * acquired one is guaranteed to find work somewhere in the pool, even if
+ * it has to look more than once while other workers shuffle things around
+ */
+void ThreadPool::process_tasks(const std::size_t index) {
+	tls_pool = this;
+	tls_index = index;
+	Profiler::register_thread("thread_pool");
+
+	while(true) {
+		pending_.acquire();
+
+		if(stopped_.load(std::memory_order_acquire)) {
+			return;
+		}
+
+		while(!execute_next(index)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+/*
+ * Maximum wait times are reset on each call, so polling this
+ * periodically will give the maximum wait since the previous poll
+ */
+auto ThreadPool::stats() -> Stats {
+	Stats stats{};
+
+	for(std::size_t i = 0; i < PRIORITY_LEVELS; ++i) {
+		auto& wait = wait_stats_[i];
+		const auto count = wait.count.load(std::memory_order_relaxed);
+		const auto total = wait.total_us.load(std::memory_order_relaxed);
+
+		stats.queued[i] = queued_by_priority_[i].load(std::memory_order_relaxed);
+		stats.max_wait[i] = std::chrono::microseconds(wait.max_us.exchange(0, std::memory_order_relaxed));
+		stats.mean_wait[i] = std::chrono::microseconds(count? total / count : 0);
+		stats.executed += count;
+	}
+
+	stats.stolen = stolen_.load(std::memory_order_relaxed);
+	stats.rejected = rejected_.load(std::memory_order_relaxed);
+	return stats;
+}
+
+std::size_t ThreadPool::size() const {
+	return workers_.size();
+}
+
+/*
+ * Any work still queued at this point is discarded
+ */
 void ThreadPool::shutdown() {
-	service_.stop();
+	if(stopped_.exchange(true, std::memory_order_acq_rel)) {
+		return;
+	}
+
+	pending_.release(static_cast<std::ptrdiff_t>(workers_.size()));
+
+	for(auto& worker : workers_) {
+		if(worker.joinable()) {
+			worker.join();
+		}
+	}
 }
 
 ThreadPool::~ThreadPool() {
 	shutdown();
 }
 
-} // ember
\ No newline at end of file
+} // ember
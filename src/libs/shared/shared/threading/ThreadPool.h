@@ -8,31 +8,132 @@
 
 #pragma once
 
-#include <boost/asio/io_context.hpp>
+#include <shared/threading/Spinlock.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <semaphore>
 #include <thread>
 #include <utility>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 
 namespace ember {
 
+/*
+ * Work-stealing pool intended for blocking work (i.e. database queries)
+ * that can't be allowed to run on the network threads.
+ *
+ * Each worker owns a deque per priority level. Work posted from outside of
+ * the pool is distributed round-robin, while work posted from within a
+ * worker is kept local. Idle workers steal from the others, always taking
+ * the highest priority work available anywhere in the pool before falling
+ * back to lower priorities, so a backlog of low priority work can't
+ * delay anything more urgent that arrives later.
+ *
+ * If a queue limit is given, try_run() will refuse work once the limit
+ * has been reached. run() always accepts work, matching the original
+ * io_context based implementation.
+ */
 class ThreadPool final {
-	boost::asio::io_context service_;
-	boost::asio::io_context::work work_;
+public:
+	// declaration order is the order in which queues are serviced
+	enum class Priority {
+		HIGH, NORMAL, LOW
+	};
+
+	static constexpr std::size_t PRIORITY_LEVELS = 3;
+
+	struct Stats {
+		std::array<std::size_t, PRIORITY_LEVELS> queued;
+		std::array<std::chrono::microseconds, PRIORITY_LEVELS> max_wait;
+		std::array<std::chrono::microseconds, PRIORITY_LEVELS> mean_wait;
+		std::uint64_t executed;
+		std::uint64_t stolen;
+		std::uint64_t rejected;
+	};
+
+private:
+	using Work = std::move_only_function<void()>;
+	using Clock = std::chrono::steady_clock;
+
+	struct Task {
+		Work work;
+		Clock::time_point enqueued;
+	};
+
+	struct alignas(64) Queue {
+		Spinlock lock;
+		std::deque<Task> tasks;
+		std::atomic<std::size_t> size;
+	};
+
+	struct Worker {
+		std::array<Queue, PRIORITY_LEVELS> queues;
+	};
+
+	struct alignas(64) WaitStats {
+		std::atomic<std::uint64_t> count;
+		std::atomic<std::uint64_t> total_us;
+		std::atomic<std::uint64_t> max_us;
+	};
+
+	const std::size_t max_queued_;
+	std::vector<std::unique_ptr<Worker>> queues_;
 	std::vector<std::jthread> workers_;
+	std::counting_semaphore<> pending_;
+	std::atomic_bool stopped_;
+
+	std::atomic<std::size_t> next_queue_;
+	std::atomic<std::size_t> queued_;
+	std::array<std::atomic<std::size_t>, PRIORITY_LEVELS> queued_by_priority_;
+	std::array<WaitStats, PRIORITY_LEVELS> wait_stats_;
+	std::atomic<std::uint64_t> stolen_;
+	std::atomic<std::uint64_t> rejected_;
+
+	void enqueue(Work work, Priority priority);
+	bool try_pop(Queue& queue, bool steal, Task& task);
+	bool execute_next(std::size_t index);
+	void record_wait(Priority priority, Clock::duration wait);
+	void process_tasks(std::size_t index);
 
 public:
-	explicit ThreadPool(std::size_t initial_count);
+	explicit ThreadPool(std::size_t initial_count, std::size_t max_queued = 0);
 	~ThreadPool();
 
-	void run(auto&& work) {
+	void run(auto&& work, Priority priority = Priority::NORMAL) {
 #ifdef DEBUG_NO_THREADS
 		work();
 #else
-		service_.post(std::move(work));
+		queued_.fetch_add(1, std::memory_order_relaxed);
+		enqueue(std::forward<decltype(work)>(work), priority);
+#endif
+	}
+
+	bool try_run(auto&& work, Priority priority = Priority::NORMAL) {
+#ifdef DEBUG_NO_THREADS
+		work();
+		return true;
+#else
+		const auto queued = queued_.fetch_add(1, std::memory_order_relaxed);
+
+		if(max_queued_ && queued >= max_queued_) {
+			queued_.fetch_sub(1, std::memory_order_relaxed);
+			rejected_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		enqueue(std::forward<decltype(work)>(work), priority);
+		return true;
 #endif
 	}
 
+	Stats stats();
+	std::size_t size() const;
 	void shutdown();
 };
 
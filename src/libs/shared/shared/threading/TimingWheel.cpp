@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "TimingWheel.h"
+#include <algorithm>
+#include <utility>
+
+namespace ember {
+
+TimingWheel::TimingWheel(boost::asio::io_context& ctx, const clock::duration tick)
+	: boost::asio::io_context::service(ctx),
+	  tick_(tick),
+	  timer_(std::in_place, ctx),
+	  cursor_(0),
+	  size_(0),
+	  running_(false) {}
+
+/*
+ * Deadlines past the wheel's horizon are placed in the furthest slot
+ * and will simply be moved along again once it comes around
+ */
+std::size_t TimingWheel::slot(const clock::time_point now, const clock::time_point deadline) const {
+	std::size_t ticks = 1;
+
+	if(deadline > now) {
+		ticks = static_cast<std::size_t>((deadline - now + tick_ - clock::duration(1)) / tick_);
+		ticks = std::clamp<std::size_t>(ticks, 1, SLOTS - 1);
+	}
+
+	return (cursor_ + ticks) % SLOTS;
+}
+
+auto TimingWheel::schedule(const clock::duration timeout, std::function<void()> expired) -> Handle {
+	const auto now = clock::now();
+
+	auto entry = std::make_shared<Entry>(
+		(now + timeout).time_since_epoch().count(), timeout, std::move(expired), false
+	);
+
+	std::lock_guard guard(lock_);
+
+	if(!timer_) {
+		return Handle(); // shutting down
+	}
+
+	slots_[slot(now, now + timeout)].emplace_back(entry);
+	++size_;
+
+	if(!running_) {
+		start_ticking();
+	}
+
+	return Handle(std::move(entry));
+}
+
+// must be called with the lock held
+void TimingWheel::start_ticking() {
+	running_ = true;
+	timer_->expires_after(tick_);
+	timer_->async_wait([&](const boost::system::error_code& ec) {
+		on_tick(ec);
+	});
+}
+
+void TimingWheel::on_tick(const boost::system::error_code& ec) {
+	if(ec == boost::asio::error::operation_aborted) {
+		return;
+	}
+
+	std::vector<EntryPtr> expired;
+
+	{
+		std::lock_guard guard(lock_);
+
+		if(!timer_) {
+			return;
+		}
+
+		const auto now = clock::now();
+		auto pending = std::move(slots_[cursor_]);
+		slots_[cursor_].clear();
+
+		for(auto& entry : pending) {
+			if(entry->cancelled.load(std::memory_order_relaxed)) {
+				--size_;
+				continue;
+			}
+
+			const auto deadline = clock::time_point(clock::duration(
+				entry->deadline.load(std::memory_order_relaxed)
+			));
+
+			if(deadline <= now) {
+				--size_;
+
+				// the owner may have cancelled since we checked
+				if(!entry->cancelled.exchange(true, std::memory_order_relaxed)) {
+					expired.emplace_back(std::move(entry));
+				}
+			} else {
+				slots_[slot(now, deadline)].emplace_back(std::move(entry));
+			}
+		}
+
+		// reuse the slot's allocation rather than freeing it every lap
+		pending.clear();
+		slots_[cursor_].swap(pending);
+		cursor_ = (cursor_ + 1) % SLOTS;
+
+		if(size_) {
+			timer_->expires_at(timer_->expiry() + tick_);
+			timer_->async_wait([&](const boost::system::error_code& ec) {
+				on_tick(ec);
+			});
+		} else {
+			running_ = false; // nothing left to track, sleep until the next schedule
+		}
+	}
+
+	for(auto& entry : expired) {
+		entry->expired();
+		entry->expired = nullptr;
+	}
+}
+
+std::size_t TimingWheel::size() const {
+	std::lock_guard guard(lock_);
+	return size_;
+}
+
+void TimingWheel::shutdown() {
+	std::lock_guard guard(lock_);
+
+	for(auto& slot : slots_) {
+		slot.clear();
+	}
+
+	size_ = 0;
+	running_ = false;
+	timer_.reset();
+}
+
+auto TimingWheel::Handle::operator=(Handle&& rhs) noexcept -> Handle& {
+	if(this != &rhs) {
+		cancel();
+		entry_ = std::move(rhs.entry_);
+	}
+
+	return *this;
+}
+
+TimingWheel::Handle::~Handle() {
+	cancel();
+}
+
+void TimingWheel::Handle::touch() {
+	if(entry_) {
+		const auto deadline = clock::now() + entry_->timeout;
+		entry_->deadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+	}
+}
+
+void TimingWheel::Handle::cancel() {
+	if(entry_) {
+		entry_->cancelled.store(true, std::memory_order_relaxed);
+		entry_.reset();
+	}
+}
+
+bool TimingWheel::Handle::active() const {
+	return entry_ && !entry_->cancelled.load(std::memory_order_relaxed);
+}
+
+} // ember
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <cstddef>
+
+namespace ember {
+
+/*
+ * Hashed timing wheel for coarse-grained timeouts, such as closing idle
+ * connections. A single wheel exists per io_context (retrieve it with get)
+ * and is driven by one timer, rather than each connection arming its own.
+ *
+ * Resetting a timeout only stores a new deadline in the entry. Each tick
+ * sweeps a single slot, expiring entries that are past their deadline and
+ * moving the rest along to the slot their deadline now falls in. Timeouts
+ * are accurate to within roughly one tick.
+ *
+ * Expiry callbacks are invoked on the wheel's io_context, not on whatever
+ * executor or strand the owner of the entry uses.
+ */
+class TimingWheel final : public boost::asio::io_context::service {
+public:
+	using clock = std::chrono::steady_clock;
+
+	static constexpr clock::duration DEFAULT_TICK = std::chrono::seconds(1);
+	static constexpr std::size_t SLOTS = 512;
+
+private:
+	struct Entry {
+		std::atomic<clock::rep> deadline;
+		const clock::duration timeout;
+		std::function<void()> expired;
+		std::atomic_bool cancelled;
+	};
+
+	using EntryPtr = std::shared_ptr<Entry>;
+
+	const clock::duration tick_;
+	std::optional<boost::asio::steady_timer> timer_;
+	std::array<std::vector<EntryPtr>, SLOTS> slots_;
+	std::size_t cursor_;
+	std::size_t size_;
+	bool running_;
+	mutable std::mutex lock_;
+
+	std::size_t slot(clock::time_point now, clock::time_point deadline) const;
+	void start_ticking();
+	void on_tick(const boost::system::error_code& ec);
+	void shutdown() override;
+
+public:
+	static inline boost::asio::io_context::id id;
+
+	/*
+	 * Owns a scheduled timeout, cancelling it when reassigned or destroyed
+	 */
+	class Handle final {
+		EntryPtr entry_;
+
+	public:
+		Handle() = default;
+		explicit Handle(EntryPtr entry) : entry_(std::move(entry)) {}
+
+		Handle(Handle&&) noexcept = default;
+		Handle& operator=(Handle&& rhs) noexcept;
+		Handle(const Handle&) = delete;
+		Handle& operator=(const Handle&) = delete;
+		~Handle();
+
+		// pushes the deadline back out to the full timeout from now
+		void touch();
+		void cancel();
+		bool active() const;
+	};
+
+	explicit TimingWheel(boost::asio::io_context& ctx, clock::duration tick = DEFAULT_TICK);
+
+	Handle schedule(clock::duration timeout, std::function<void()> expired);
+	std::size_t size() const;
+
+	static TimingWheel& get(boost::asio::io_context& ctx) {
+		return boost::asio::use_service<TimingWheel>(ctx);
+	}
+};
+
+} // ember
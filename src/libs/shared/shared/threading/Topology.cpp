@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Topology.h"
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <ranges>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+namespace ember::thread {
+
+namespace {
+
+[[maybe_unused]] std::string read_line(const std::filesystem::path& path) {
+	std::ifstream file(path);
+	std::string line;
+	std::getline(file, line);
+	return line;
+}
+
+[[maybe_unused]] unsigned int read_uint(const std::filesystem::path& path, unsigned int fallback) {
+	const auto line = read_line(path);
+	unsigned int value = 0;
+	const auto res = std::from_chars(line.data(), line.data() + line.size(), value);
+	return res.ec == std::errc()? value : fallback;
+}
+
+std::vector<CPU> fallback_cpus() {
+	const auto count = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<CPU> cpus;
+
+	for(unsigned int i = 0; i < count; ++i) {
+		cpus.emplace_back(i, i, 0, 0, false);
+	}
+
+	return cpus;
+}
+
+std::vector<CPU> detect_cpus() {
+#if defined __linux__
+	namespace fs = std::filesystem;
+	const fs::path root("/sys/devices/system/cpu");
+	std::error_code ec;
+
+	if(!fs::exists(root / "online", ec)) {
+		return fallback_cpus();
+	}
+
+	const auto online = parse_cpu_list(read_line(root / "online"));
+	const auto isolated = parse_cpu_list(read_line(root / "isolated"));
+	std::map<unsigned int, unsigned int> nodes;
+
+	for(const auto& entry : fs::directory_iterator("/sys/devices/system/node", ec)) {
+		const auto name = entry.path().filename().string();
+
+		if(!name.starts_with("node")) {
+			continue;
+		}
+
+		unsigned int node = 0;
+		const auto res = std::from_chars(name.data() + 4, name.data() + name.size(), node);
+
+		if(res.ec != std::errc()) {
+			continue;
+		}
+
+		for(auto id : parse_cpu_list(read_line(entry.path() / "cpulist"))) {
+			nodes[id] = node;
+		}
+	}
+
+	// core IDs are only unique within a package, so remap them to be unique overall
+	std::map<std::pair<unsigned int, unsigned int>, unsigned int> core_ids;
+	std::vector<CPU> cpus;
+
+	for(auto id : online) {
+		const auto topology = root / std::format("cpu{}", id) / "topology";
+		const auto package = read_uint(topology / "physical_package_id", 0);
+		const auto core_id = read_uint(topology / "core_id", id);
+		const auto [it, _] = core_ids.try_emplace({ package, core_id }, core_ids.size());
+
+		cpus.emplace_back(
+			id, it->second, package, nodes.contains(id)? nodes[id] : 0,
+			std::ranges::find(isolated, id) != isolated.end()
+		);
+	}
+
+	return cpus.empty()? fallback_cpus() : cpus;
+#else
+	return fallback_cpus();
+#endif
+}
+
+} // unnamed
+
+Topology::Topology(std::vector<CPU> cpus) : cpus_(std::move(cpus)) {}
+
+Topology Topology::detect() {
+	return Topology(detect_cpus());
+}
+
+std::span<const CPU> Topology::cpus() const {
+	return cpus_;
+}
+
+const CPU* Topology::cpu(const unsigned int id) const {
+	auto it = std::ranges::find(cpus_, id, &CPU::id);
+	return it == cpus_.end()? nullptr : &*it;
+}
+
+/*
+ * Returns the lowest numbered logical CPU of each physical core, ordered
+ * so that a NUMA node is filled before moving onto the next one
+ */
+std::vector<unsigned int> Topology::physical_cores() const {
+	std::map<unsigned int, const CPU*> cores;
+
+	for(const auto& cpu : cpus_) {
+		auto [it, inserted] = cores.try_emplace(cpu.core, &cpu);
+
+		if(!inserted && cpu.id < it->second->id) {
+			it->second = &cpu;
+		}
+	}
+
+	std::vector<const CPU*> ordered;
+
+	for(const auto cpu : cores | std::views::values) {
+		ordered.emplace_back(cpu);
+	}
+
+	std::ranges::stable_sort(ordered, [](const CPU* lhs, const CPU* rhs) {
+		return std::tie(lhs->node, lhs->id) < std::tie(rhs->node, rhs->id);
+	});
+
+	std::vector<unsigned int> ids;
+
+	for(const auto cpu : ordered) {
+		ids.emplace_back(cpu->id);
+	}
+
+	return ids;
+}
+
+std::size_t Topology::node_count() const {
+	std::set<unsigned int> nodes;
+
+	for(const auto& cpu : cpus_) {
+		nodes.emplace(cpu.node);
+	}
+
+	return nodes.size();
+}
+
+PlacementMode parse_placement_mode(std::string_view mode) {
+	if(mode == "none") {
+		return PlacementMode::none;
+	} else if(mode == "round_robin") {
+		return PlacementMode::round_robin;
+	} else if(mode == "physical_cores") {
+		return PlacementMode::physical_cores;
+	} else if(mode == "cpu_list") {
+		return PlacementMode::cpu_list;
+	}
+
+	throw std::invalid_argument(std::format("Unknown thread placement mode, {}", mode));
+}
+
+/*
+ * Parses the kernel's CPU list format, e.g. "0-3,8,10-11"
+ */
+std::vector<unsigned int> parse_cpu_list(std::string_view list) {
+	std::vector<unsigned int> cpus;
+
+	for(const auto token : list | std::views::split(',')) {
+		std::string_view range(token.begin(), token.end());
+
+		while(!range.empty() && (range.front() == ' ' || range.front() == '\t')) {
+			range.remove_prefix(1);
+		}
+
+		while(!range.empty() && (range.back() == ' ' || range.back() == '\t'
+		      || range.back() == '\n')) {
+			range.remove_suffix(1);
+		}
+
+		if(range.empty()) {
+			continue;
+		}
+
+		const auto dash = range.find('-');
+		const auto first_str = range.substr(0, dash);
+		unsigned int first = 0, last = 0;
+
+		auto res = std::from_chars(first_str.data(), first_str.data() + first_str.size(), first);
+
+		if(res.ec != std::errc() || res.ptr != first_str.data() + first_str.size()) {
+			throw std::invalid_argument(std::format("Malformed CPU list, {}", list));
+		}
+
+		last = first;
+
+		if(dash != std::string_view::npos) {
+			const auto last_str = range.substr(dash + 1);
+			res = std::from_chars(last_str.data(), last_str.data() + last_str.size(), last);
+
+			if(res.ec != std::errc() || res.ptr != last_str.data() + last_str.size() || last < first) {
+				throw std::invalid_argument(std::format("Malformed CPU list, {}", list));
+			}
+		}
+
+		for(auto i = first; i <= last; ++i) {
+			cpus.emplace_back(i);
+		}
+	}
+
+	return cpus;
+}
+
+/*
+ * Finds the CPUs that are servicing interrupts for the given network
+ * interface, going by the IRQ names in /proc/interrupts (e.g. eth0-TxRx-0)
+ */
+std::vector<unsigned int> irq_cpus([[maybe_unused]] std::string_view interface) {
+	std::set<unsigned int> cpus;
+
+#if defined __linux__
+	if(interface.empty()) {
+		return {};
+	}
+
+	std::ifstream interrupts("/proc/interrupts");
+	std::string line;
+
+	while(std::getline(interrupts, line)) {
+		const auto colon = line.find(':');
+
+		if(colon == std::string::npos) {
+			continue;
+		}
+
+		std::string_view irq(line.data(), colon);
+
+		while(!irq.empty() && irq.front() == ' ') {
+			irq.remove_prefix(1);
+		}
+
+		std::istringstream tokens(line.substr(colon + 1));
+		std::string token, last;
+
+		while(tokens >> token) {
+			last = token;
+		}
+
+		if(!last.starts_with(interface)) {
+			continue;
+		}
+
+		const auto path = std::format("/proc/irq/{}/smp_affinity_list", irq);
+
+		for(auto cpu : parse_cpu_list(read_line(path))) {
+			cpus.emplace(cpu);
+		}
+	}
+#endif
+
+	return { cpus.begin(), cpus.end() };
+}
+
+/*
+ * Decides which CPU each thread should be pinned to, returning an empty
+ * layout if the threads shouldn't be pinned at all. If there are more
+ * threads than eligible CPUs, the layout wraps around.
+ */
+std::vector<unsigned int> plan_placement(const Topology& topology, const PlacementConfig& config,
+                                         const std::size_t threads) {
+	std::vector<unsigned int> candidates;
+
+	switch(config.mode) {
+		case PlacementMode::none:
+			return {};
+		case PlacementMode::round_robin:
+			for(const auto& cpu : topology.cpus()) {
+				if(!cpu.isolated) {
+					candidates.emplace_back(cpu.id);
+				}
+			}
+			break;
+		case PlacementMode::physical_cores:
+			for(const auto id : topology.physical_cores()) {
+				if(!topology.cpu(id)->isolated) {
+					candidates.emplace_back(id);
+				}
+			}
+			break;
+		case PlacementMode::cpu_list: // isolated CPUs are allowed if explicitly requested
+			for(const auto id : config.cpus) {
+				if(!topology.cpu(id)) {
+					throw std::invalid_argument(std::format("Unknown CPU in placement list, {}", id));
+				}
+
+				candidates.emplace_back(id);
+			}
+			break;
+	}
+
+	auto excluded = irq_cpus(config.irq_interface);
+	excluded.insert(excluded.end(), config.exclude.begin(), config.exclude.end());
+
+	std::erase_if(candidates, [&](const unsigned int id) {
+		return std::ranges::find(excluded, id) != excluded.end();
+	});
+
+	if(candidates.empty()) {
+		throw std::runtime_error("No CPUs left to place threads on after exclusions");
+	}
+
+	std::vector<unsigned int> layout;
+	layout.reserve(threads);
+
+	for(std::size_t i = 0; i < threads; ++i) {
+		layout.emplace_back(candidates[i % candidates.size()]);
+	}
+
+	return layout;
+}
+
+std::string describe_placement(const Topology& topology, std::span<const unsigned int> layout) {
+	if(layout.empty()) {
+		return "threads are not pinned";
+	}
+
+	std::string description = std::format(
+		"{} logical CPU(s), {} NUMA node(s)", topology.cpus().size(), topology.node_count()
+	);
+
+	for(std::size_t i = 0; i < layout.size(); ++i) {
+		const auto cpu = topology.cpu(layout[i]);
+
+		if(!cpu) {
+			description += std::format("\n thread {} -> CPU {}", i, layout[i]);
+			continue;
+		}
+
+		description += std::format(
+			"\n thread {} -> CPU {} (core {}, package {}, node {}{})",
+			i, cpu->id, cpu->core, cpu->package, cpu->node, cpu->isolated? ", isolated" : ""
+		);
+	}
+
+	return description;
+}
+
+} // thread, ember
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+namespace ember::thread {
+
+struct CPU {
+	unsigned int id;      // logical CPU, as used for affinity
+	unsigned int core;    // physical core, shared by SMT siblings
+	unsigned int package;
+	unsigned int node;    // NUMA node
+	bool isolated;        // removed from the scheduler (isolcpus)
+};
+
+class Topology final {
+	std::vector<CPU> cpus_;
+
+public:
+	explicit Topology(std::vector<CPU> cpus);
+
+	static Topology detect();
+
+	std::span<const CPU> cpus() const;
+	const CPU* cpu(unsigned int id) const;
+	std::vector<unsigned int> physical_cores() const;
+	std::size_t node_count() const;
+};
+
+enum class PlacementMode {
+	none,           // leave it to the OS scheduler
+	round_robin,    // thread n -> logical CPU n, ignoring SMT and NUMA
+	physical_cores, // one thread per physical core, filling a NUMA node at a time
+	cpu_list        // explicitly listed CPUs
+};
+
+struct PlacementConfig {
+	PlacementMode mode = PlacementMode::round_robin;
+	std::vector<unsigned int> cpus;
+	std::vector<unsigned int> exclude;
+	std::string irq_interface;
+};
+
+PlacementMode parse_placement_mode(std::string_view mode);
+std::vector<unsigned int> parse_cpu_list(std::string_view list);
+std::vector<unsigned int> irq_cpus(std::string_view interface);
+
+std::vector<unsigned int> plan_placement(const Topology& topology,
+                                         const PlacementConfig& config,
+                                         std::size_t threads);
+
+std::string describe_placement(const Topology& topology,
+                               std::span<const unsigned int> layout);
+
+} // thread, ember
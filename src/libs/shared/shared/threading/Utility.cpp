@@ -62,6 +62,14 @@ void set_affinity(std::jthread& thread, unsigned int core) {
 	set_affinity(thread.native_handle(), core);
 }
 
+void set_affinity(unsigned int core) {
+#ifdef _WIN32
+	set_affinity(GetCurrentThread(), core);
+#elif defined __linux__ || defined __unix__ || defined TARGET_OS_MAC
+	set_affinity(pthread_self(), core);
+#endif
+}
+
 Result set_name([[maybe_unused]] auto& handle, const char* name) {
 	if(strlen(name) >= MAX_NAME_LEN) {
 		throw std::runtime_error("set_name: thread name too long");
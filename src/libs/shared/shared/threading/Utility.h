@@ -20,6 +20,7 @@ enum Result {
 
 void set_affinity(std::thread& thread, unsigned int core);
 void set_affinity(std::jthread& thread, unsigned int core);
+void set_affinity(unsigned int core);
 
 Result set_name(const char* ascii_name);
 Result set_name(std::thread& thread, const char* ascii_name);
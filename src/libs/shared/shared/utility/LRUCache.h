@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Bounded, thread-safe LRU cache with a fixed time-to-live for entries.
+ *
+ * Keys are spread over a number of independently locked shards to keep
+ * contention down, with each shard evicting its own least recently used
+ * entry once it's full, so the capacity is divided evenly between shards
+ * rather than being global. Expired entries are removed when they're
+ * next looked up or when they reach the end of the LRU list.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache final {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Stats {
+		std::uint64_t hits;
+		std::uint64_t misses;
+		std::uint64_t evictions;
+		std::uint64_t expirations;
+		std::size_t size;
+	};
+
+private:
+	struct Entry {
+		Key key;
+		Value value;
+		Clock::time_point expiry;
+	};
+
+	using List = std::list<Entry>;
+
+	struct alignas(64) Shard {
+		mutable std::mutex lock;
+		List entries; // most recently used at the front
+		std::unordered_map<Key, typename List::iterator, Hash> index;
+		Stats stats {};
+	};
+
+	const Clock::duration ttl_;
+	const std::size_t shard_capacity_;
+	const std::size_t mask_;
+	std::unique_ptr<Shard[]> shards_;
+
+	static std::size_t shard_count(const std::size_t shards) {
+		return std::bit_ceil(std::max<std::size_t>(shards, 1));
+	}
+
+	Shard& shard(const Key& key) const {
+		return shards_[Hash{}(key) & mask_];
+	}
+
+	void remove(Shard& shard, typename List::iterator it) {
+		shard.index.erase(it->key);
+		shard.entries.erase(it);
+	}
+
+public:
+	LRUCache(std::size_t capacity, Clock::duration ttl, std::size_t shards = 16)
+		: ttl_(ttl),
+		  shard_capacity_(std::max<std::size_t>(capacity / shard_count(shards), 1)),
+		  mask_(shard_count(shards) - 1),
+		  shards_(std::make_unique<Shard[]>(mask_ + 1)) { }
+
+	std::optional<Value> get(const Key& key) {
+		auto& shard = this->shard(key);
+		std::lock_guard guard(shard.lock);
+		auto it = shard.index.find(key);
+
+		if(it == shard.index.end()) {
+			++shard.stats.misses;
+			return std::nullopt;
+		}
+
+		if(it->second->expiry <= Clock::now()) {
+			remove(shard, it->second);
+			++shard.stats.expirations;
+			++shard.stats.misses;
+			return std::nullopt;
+		}
+
+		shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+		++shard.stats.hits;
+		return it->second->value;
+	}
+
+	// removes & returns an unexpired entry in one step, for entries that may only be used once
+	std::optional<Value> take(const Key& key) {
+		auto& shard = this->shard(key);
+		std::lock_guard guard(shard.lock);
+		auto it = shard.index.find(key);
+
+		if(it == shard.index.end()) {
+			++shard.stats.misses;
+			return std::nullopt;
+		}
+
+		if(it->second->expiry <= Clock::now()) {
+			remove(shard, it->second);
+			++shard.stats.expirations;
+			++shard.stats.misses;
+			return std::nullopt;
+		}
+
+		auto value = std::move(it->second->value);
+		remove(shard, it->second);
+		++shard.stats.hits;
+		return value;
+	}
+
+	void put(const Key& key, Value value) {
+		auto& shard = this->shard(key);
+		std::lock_guard guard(shard.lock);
+		const auto expiry = Clock::now() + ttl_;
+
+		if(auto it = shard.index.find(key); it != shard.index.end()) {
+			it->second->value = std::move(value);
+			it->second->expiry = expiry;
+			shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+			return;
+		}
+
+		if(shard.entries.size() >= shard_capacity_) {
+			const auto last = std::prev(shard.entries.end());
+
+			if(last->expiry <= Clock::now()) {
+				++shard.stats.expirations;
+			} else {
+				++shard.stats.evictions;
+			}
+
+			remove(shard, last);
+		}
+
+		shard.entries.emplace_front(key, std::move(value), expiry);
+		shard.index.emplace(key, shard.entries.begin());
+	}
+
+	// returns the removed value, if there was one, regardless of whether it had expired
+	std::optional<Value> erase(const Key& key) {
+		auto& shard = this->shard(key);
+		std::lock_guard guard(shard.lock);
+		auto it = shard.index.find(key);
+
+		if(it == shard.index.end()) {
+			return std::nullopt;
+		}
+
+		auto value = std::move(it->second->value);
+		remove(shard, it->second);
+		return value;
+	}
+
+	void clear() {
+		for(std::size_t i = 0; i <= mask_; ++i) {
+			std::lock_guard guard(shards_[i].lock);
+			shards_[i].entries.clear();
+			shards_[i].index.clear();
+		}
+	}
+
+	Stats stats() const {
+		Stats total {};
+
+		for(std::size_t i = 0; i <= mask_; ++i) {
+			std::lock_guard guard(shards_[i].lock);
+			const auto& stats = shards_[i].stats;
+			total.hits += stats.hits;
+			total.misses += stats.misses;
+			total.evictions += stats.evictions;
+			total.expirations += stats.expirations;
+			total.size += shards_[i].entries.size();
+		}
+
+		return total;
+	}
+
+	std::size_t capacity() const {
+		return shard_capacity_ * (mask_ + 1);
+	}
+};
+
+} // ember
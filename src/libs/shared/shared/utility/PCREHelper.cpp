@@ -21,8 +21,8 @@ Result utf8_jit_compile(std::string expression) {
 	const char* error = 0;
 
 	// <\ isn't handled by PCRE (unless you happen to be WoW.exe), replace with \b
-	boost::replace_first(expression, R"(\<)", R"(\b)");
-	boost::replace_first(expression, R"(\>)", R"(\b)");
+	boost::replace_all(expression, R"(\<)", R"(\b)");
+	boost::replace_all(expression, R"(\>)", R"(\b)");
 
 	auto compiled = std::unique_ptr<::pcre, void(*)(void*)>(
 		pcre_compile(expression.c_str(), PCRE_UTF8 | PCRE_CASELESS, &error, &error_offset, nullptr),
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "PatternSet.h"
+#include <stdexcept>
+#include <pcre.h>
+
+namespace ember::util::pcre {
+
+namespace {
+
+bool is_digit(const char c) {
+	return c >= '0' && c <= '9';
+}
+
+/*
+ * Anything that refers to a group by number (or to the whole expression)
+ * would refer to something else once joined, so these patterns are kept
+ * apart. Named references are included since names can clash, as are
+ * conditionals testing a group or recursion, e.g. (?(1)...) or (?(+1)...).
+ * Only assertion conditionals, (?(?=...)...), are safe to join.
+ */
+bool joinable(const std::string& pattern) {
+	for(std::size_t i = 0; i + 1 < pattern.size(); ++i) {
+		const char next = pattern[i + 1];
+
+		if(pattern[i] == '\\') {
+			if(is_digit(next) || next == 'g' || next == 'k' || next == 'Q') {
+				return false;
+			}
+
+			++i; // skip the escaped character
+		} else if(pattern[i] == '(' && next == '?' && i + 2 < pattern.size()) {
+			const char type = pattern[i + 2];
+
+			if(type == 'R' || type == '&' || type == 'P' || is_digit(type)) {
+				return false;
+			}
+
+			if((type == '+' || type == '-') && i + 3 < pattern.size() && is_digit(pattern[i + 3])) {
+				return false;
+			}
+
+			if(type == '(' && i + 3 < pattern.size() && pattern[i + 3] != '?') {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+} // unnamed
+
+PatternSet::PatternSet(std::span<const std::string> patterns)
+	: patterns_(patterns.size()) {
+	std::vector<std::string> group;
+	std::size_t length = 0;
+
+	for(const auto& pattern : patterns) {
+		if(!joinable(pattern)) {
+			compile_group({ &pattern, 1 });
+			continue;
+		}
+
+		if(!group.empty() && length + pattern.size() > MAX_EXPRESSION_LENGTH) {
+			compile_group(group);
+			group.clear();
+			length = 0;
+		}
+
+		length += pattern.size() + 6; // (?:)|
+		group.emplace_back(pattern);
+	}
+
+	if(!group.empty()) {
+		compile_group(group);
+	}
+}
+
+void PatternSet::compile_group(std::span<const std::string> patterns) {
+	if(patterns.size() == 1) {
+		expressions_.emplace_back(utf8_jit_compile(patterns.front()));
+		return;
+	}
+
+	std::string expression;
+
+	for(const auto& pattern : patterns) {
+		if(!expression.empty()) {
+			expression += '|';
+		}
+
+		expression += "(?:" + pattern + ")";
+	}
+
+	try {
+		expressions_.emplace_back(utf8_jit_compile(std::move(expression)));
+	} catch(const std::runtime_error&) {
+		// something in the group doesn't play well with others, go it alone
+		for(const auto& pattern : patterns) {
+			expressions_.emplace_back(utf8_jit_compile(pattern));
+		}
+	}
+}
+
+int PatternSet::match(const std::string& needle) const {
+	for(const auto& expression : expressions_) {
+		const int ret = pcre::match(needle, expression);
+
+		if(ret != PCRE_ERROR_NOMATCH) {
+			return ret;
+		}
+	}
+
+	return PCRE_ERROR_NOMATCH;
+}
+
+std::size_t PatternSet::size() const {
+	return patterns_;
+}
+
+std::size_t PatternSet::expressions() const {
+	return expressions_.size();
+}
+
+} // pcre, util, ember
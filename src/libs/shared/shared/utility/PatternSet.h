@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/utility/PCREHelper.h>
+#include <span>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace ember::util::pcre {
+
+/*
+ * Matches a string against a list of patterns, returning as soon as any
+ * of them match.
+ *
+ * Rather than compiling every pattern individually, they're joined into
+ * alternations of up to MAX_EXPRESSION_LENGTH characters, so a list of
+ * thousands of patterns becomes a handful of JIT compiled expressions.
+ * Patterns using backreferences can't be joined without renumbering them,
+ * so those are compiled on their own, as are the members of any group
+ * that fails to compile as a whole.
+ */
+class PatternSet final {
+	static constexpr std::size_t MAX_EXPRESSION_LENGTH = 4096;
+
+	std::vector<Result> expressions_;
+	std::size_t patterns_ = 0;
+
+	void compile_group(std::span<const std::string> patterns);
+
+public:
+	PatternSet() = default;
+	explicit PatternSet(std::span<const std::string> patterns);
+
+	// same return values as pcre_exec, >= 0 upon any pattern matching
+	int match(const std::string& needle) const;
+
+	std::size_t size() const;
+	std::size_t expressions() const;
+};
+
+} // pcre, util, ember
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Path-compressed binary trie (PATRICIA) over fixed-width big-endian keys,
+ * such as IPv4 or IPv6 addresses, for answering whether a key falls within
+ * any of the stored prefixes.
+ *
+ * Nodes only exist where prefixes diverge, so a lookup visits at most one
+ * node per stored prefix length along its path rather than one per bit.
+ * Prefixes covered by a shorter prefix are discarded on insertion, since
+ * they can never change the result.
+ *
+ * Nodes are stored by index in a single vector to keep them close together.
+ */
+template<std::size_t Bytes>
+class PrefixTrie final {
+public:
+	using Key = std::array<std::uint8_t, Bytes>;
+	static constexpr std::size_t BITS = Bytes * 8;
+
+private:
+	static constexpr std::uint32_t NONE = 0; // the root can never be a child
+
+	struct Node {
+		Key prefix;
+		std::uint32_t length;
+		std::uint32_t children[2];
+		bool terminal;
+	};
+
+	std::vector<Node> nodes_ { Node { {}, 0, { NONE, NONE }, false } };
+	std::size_t prefixes_ = 0;
+
+	static unsigned int bit(const Key& key, const std::size_t index) {
+		return (key[index / 8] >> (7 - (index % 8))) & 1;
+	}
+
+	static Key mask(Key key, const std::size_t length) {
+		for(std::size_t i = 0; i < Bytes; ++i) {
+			const auto start = i * 8;
+
+			if(start >= length) {
+				key[i] = 0;
+			} else if(length - start < 8) {
+				key[i] &= static_cast<std::uint8_t>(0xff << (8 - (length - start)));
+			}
+		}
+
+		return key;
+	}
+
+	// number of leading bits shared by both keys, up to the limit
+	static std::size_t common(const Key& lhs, const Key& rhs, const std::size_t limit) {
+		for(std::size_t i = 0; i < Bytes && i * 8 < limit; ++i) {
+			if(const auto diff = lhs[i] ^ rhs[i]; diff) {
+				const auto bits = i * 8 + std::countl_zero(static_cast<std::uint8_t>(diff));
+				return bits < limit? bits : limit;
+			}
+		}
+
+		return limit;
+	}
+
+	std::uint32_t add_node(const Key& prefix, const std::size_t length, const bool terminal) {
+		nodes_.emplace_back(Node {
+			prefix, static_cast<std::uint32_t>(length), { NONE, NONE }, terminal
+		});
+
+		return static_cast<std::uint32_t>(nodes_.size() - 1);
+	}
+
+public:
+	void insert(Key key, std::size_t length) {
+		if(length > BITS) {
+			length = BITS;
+		}
+
+		key = mask(key, length);
+		std::uint32_t index = 0;
+
+		while(true) {
+			if(nodes_[index].terminal) {
+				return; // already covered by a shorter prefix
+			}
+
+			if(nodes_[index].length == length) {
+				nodes_[index].terminal = true;
+				nodes_[index].children[0] = nodes_[index].children[1] = NONE;
+				++prefixes_;
+				return;
+			}
+
+			const auto branch = bit(key, nodes_[index].length);
+			const auto child = nodes_[index].children[branch];
+
+			if(child == NONE) {
+				const auto leaf = add_node(key, length, true);
+				nodes_[index].children[branch] = leaf;
+				++prefixes_;
+				return;
+			}
+
+			const auto& child_node = nodes_[child];
+			const auto shared = common(key, child_node.prefix, std::min<std::size_t>(length, child_node.length));
+
+			if(shared == child_node.length) {
+				index = child;
+				continue;
+			}
+
+			if(shared == length) {
+				// the new prefix covers the child's entire subtree
+				const auto node = add_node(key, length, true);
+				nodes_[index].children[branch] = node;
+				++prefixes_;
+				return;
+			}
+
+			// diverges part way along the child's prefix, split it
+			const auto child_branch = bit(child_node.prefix, shared);
+			const auto split = add_node(mask(key, shared), shared, false);
+			const auto leaf = add_node(key, length, true);
+			nodes_[split].children[child_branch] = child;
+			nodes_[split].children[child_branch ^ 1] = leaf;
+			nodes_[index].children[branch] = split;
+			++prefixes_;
+			return;
+		}
+	}
+
+	bool contains(const Key& key) const {
+		std::uint32_t index = 0;
+
+		while(true) {
+			const auto& node = nodes_[index];
+
+			if(node.length && common(key, node.prefix, node.length) != node.length) {
+				return false;
+			}
+
+			if(node.terminal) {
+				return true;
+			}
+
+			if(node.length == BITS) {
+				return false;
+			}
+
+			index = node.children[bit(key, node.length)];
+
+			if(index == NONE) {
+				return false;
+			}
+		}
+	}
+
+	// number of prefixes inserted that weren't already covered at the time
+	std::size_t size() const {
+		return prefixes_;
+	}
+
+	bool empty() const {
+		return !nodes_[0].terminal && nodes_[0].children[0] == NONE && nodes_[0].children[1] == NONE;
+	}
+};
+
+} // ember
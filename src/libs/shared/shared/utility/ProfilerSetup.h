@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/metrics/Monitor.h>
+#include <shared/metrics/Profiler.h>
+#include <logger/Logger.h>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <exception>
+#include <format>
+#include <memory>
+#include <string>
+
+namespace po = boost::program_options;
+
+namespace ember {
+
+inline po::options_description profiler_options(const std::string& default_output) {
+	po::options_description opts;
+	opts.add_options()
+		("profiler.enabled", po::value<bool>()->default_value(false))
+		("profiler.frequency", po::value<unsigned int>()->default_value(99))
+		("profiler.output", po::value<std::string>()->default_value(default_output))
+		("profiler.flush_interval", po::value<unsigned int>()->default_value(60));
+	return opts;
+}
+
+inline std::unique_ptr<Profiler> create_profiler(const po::variables_map& args, log::Logger& logger) {
+	auto profiler = std::make_unique<Profiler>(
+		args["profiler.output"].as<std::string>(),
+		args["profiler.frequency"].as<unsigned int>(),
+		std::chrono::seconds(args["profiler.flush_interval"].as<unsigned int>()),
+		[&logger](std::string_view error) {
+			LOG_ERROR_ASYNC(logger, "Profiler: {}", error);
+		}
+	);
+
+	if(args["profiler.enabled"].as<bool>()) {
+		profiler->start();
+		LOG_INFO_SYNC(logger, "Sampling profiler writing to {}", args["profiler.output"].as<std::string>());
+	}
+
+	return profiler;
+}
+
+/*
+ * Allows the profiler to be toggled at runtime by sending
+ * 'profiler start', 'profiler stop' or 'profiler flush' to the monitor
+ */
+inline void install_profiler_commands(Monitor& monitor, Profiler& profiler, log::Logger& logger) {
+	monitor.add_command("profiler start", [&]() -> std::string {
+		try {
+			profiler.start();
+			LOG_INFO_ASYNC(logger, "Sampling profiler started by monitor command");
+			return "OK";
+		} catch(const std::exception& e) {
+			return std::format("ERROR; {}", e.what());
+		}
+	});
+
+	monitor.add_command("profiler stop", [&]() -> std::string {
+		try {
+			profiler.stop();
+			LOG_INFO_ASYNC(logger, "Sampling profiler stopped by monitor command, {} samples",
+			               profiler.samples());
+			return "OK";
+		} catch(const std::exception& e) {
+			return std::format("ERROR; {}", e.what());
+		}
+	});
+
+	monitor.add_command("profiler flush", [&]() -> std::string {
+		try {
+			profiler.flush();
+			return std::format("OK; {} samples, {} dropped", profiler.samples(), profiler.dropped());
+		} catch(const std::exception& e) {
+			return std::format("ERROR; {}", e.what());
+		}
+	});
+}
+
+} // ember
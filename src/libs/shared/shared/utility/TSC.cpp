@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "TSC.h"
+#include <thread>
+
+namespace ember::util::tsc {
+
+namespace {
+
+double calibrate() {
+#if defined _MSC_VER || defined __x86_64__ || defined __i386__
+	using namespace std::chrono_literals;
+
+	const auto start_time = std::chrono::steady_clock::now();
+	const auto start_ticks = now();
+	std::this_thread::sleep_for(20ms);
+	const auto end_ticks = now();
+	const auto end_time = std::chrono::steady_clock::now();
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time);
+
+	if(elapsed.count() <= 0 || end_ticks <= start_ticks) {
+		return 1.0;
+	}
+
+	return static_cast<double>(end_ticks - start_ticks) / elapsed.count();
+#else
+	return 1.0;
+#endif
+}
+
+} // unnamed
+
+/*
+ * Calibrated against steady_clock on first use, which will block
+ * the caller for a short period, so call it during startup
+ */
+double ticks_per_ns() {
+	static const double ratio = calibrate();
+	return ratio;
+}
+
+std::chrono::nanoseconds to_duration(const std::uint64_t ticks) {
+	return std::chrono::nanoseconds(static_cast<std::int64_t>(ticks / ticks_per_ns()));
+}
+
+} // tsc, util, ember
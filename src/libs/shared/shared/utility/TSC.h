@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined _MSC_VER
+	#include <intrin.h>
+#elif defined __x86_64__ || defined __i386__
+	#include <x86intrin.h>
+#endif
+
+namespace ember::util::tsc {
+
+/*
+ * Reads the timestamp counter, which is far cheaper than going through
+ * the OS clock but only useful for measuring intervals. Assumes an
+ * invariant TSC, which is the case for anything that's likely to be
+ * running this code. Other architectures fall back to steady_clock.
+ */
+inline std::uint64_t now() {
+#if defined _MSC_VER || defined __x86_64__ || defined __i386__
+	return __rdtsc();
+#else
+	const auto time = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+#endif
+}
+
+double ticks_per_ns();
+std::chrono::nanoseconds to_duration(std::uint64_t ticks);
+
+} // tsc, util, ember
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/threading/Topology.h>
+#include <logger/Logger.h>
+#include <boost/program_options.hpp>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace po = boost::program_options;
+
+namespace ember {
+
+inline po::options_description placement_options(const std::string& default_mode) {
+	po::options_description opts;
+	opts.add_options()
+		("placement.mode", po::value<std::string>()->default_value(default_mode))
+		("placement.cpus", po::value<std::string>()->default_value(""))
+		("placement.exclude", po::value<std::string>()->default_value(""))
+		("placement.irq_interface", po::value<std::string>()->default_value(""));
+	return opts;
+}
+
+/*
+ * Determines the CPU each of the service's threads should be pinned to,
+ * based on the [placement] config section, and logs the chosen layout
+ */
+inline std::vector<unsigned int> placement_layout(const po::variables_map& args,
+                                                  const std::size_t threads,
+                                                  log::Logger& logger) {
+	const thread::PlacementConfig config {
+		.mode = thread::parse_placement_mode(args["placement.mode"].as<std::string>()),
+		.cpus = thread::parse_cpu_list(args["placement.cpus"].as<std::string>()),
+		.exclude = thread::parse_cpu_list(args["placement.exclude"].as<std::string>()),
+		.irq_interface = args["placement.irq_interface"].as<std::string>()
+	};
+
+	const auto topology = thread::Topology::detect();
+	auto layout = thread::plan_placement(topology, config, threads);
+	LOG_INFO_SYNC(logger, "Thread placement: {}", thread::describe_placement(topology, layout));
+	return layout;
+}
+
+} // ember
@@ -11,6 +11,7 @@
 #include <spark/Common.h>
 #include <spark/buffers/BinaryStream.h>
 #include <spark/buffers/BufferAdaptor.h>
+#include <shared/metrics/Profiler.h>
 #include <cassert>
 
 namespace ember::spark {
@@ -38,6 +39,7 @@ bool Channel::is_open() const {
 
 void Channel::dispatch(const MessageHeader& header, std::span<const std::uint8_t> data) {
 	link_.channel = weak_from_this();
+	Profiler::ScopedTag tag(Profiler::Tag::CHANNEL, link_.service_name);
 
 	if(!header.response || header.uuid.is_nil()) {
 		handler_->on_message(link_, data, header.uuid);
@@ -8,12 +8,20 @@
 
 #pragma once
 
+#include <srp6/detail/Modular.h>
 #include <botan/bigint.h>
-#include <botan/numthry.h>
+#include <memory>
 #include <utility>
+#include <cstddef>
 
 namespace ember::srp6 {
 
+/*
+ * If fixed_base_bits is non-zero, a precomputed table is built to
+ * speed up exponents of up to that many bits. This costs a few
+ * milliseconds and some memory up front, so it's intended for
+ * generators that live for the lifetime of the process.
+ */
 struct Generator {
 	enum class Group {
 		_256_BIT, _1024_BIT,
@@ -22,21 +30,19 @@ struct Generator {
 		_6144_BIT, _8192_BIT
 	};
 
-	Generator(Botan::BigInt g, Botan::BigInt N)
-		: g_(std::move(g)), N_(std::move(N)) {}
-	explicit Generator(Group group);
+	Generator(Botan::BigInt g, Botan::BigInt N, std::size_t fixed_base_bits = 0);
+	explicit Generator(Group group, std::size_t fixed_base_bits = 0);
 
 	inline const Botan::BigInt& prime() const { return N_; }
 	inline const Botan::BigInt& generator() const { return g_; }
-	inline Botan::BigInt operator()(const Botan::BigInt& x) const {
-		return Botan::power_mod(g_, x, N_);
-	}
+	Botan::BigInt operator()(const Botan::BigInt& x) const;
 
 private:
 	Botan::BigInt g_from_group(Generator::Group& group);
 	Botan::BigInt n_from_group(Generator::Group& group);
 
 	Botan::BigInt g_, N_;
+	std::shared_ptr<const detail::FixedBaseTable> table_;
 };
 
 } // srp6, ember
\ No newline at end of file
@@ -11,21 +11,30 @@
 #include <srp6/Util.h>
 #include <srp6/Generator.h>
 #include <srp6/Exception.h>
-#include <botan/auto_rng.h>
 #include <botan/bigint.h>
 #include <cstddef>
 
 namespace ember::srp6 {
 
-class Server final {
-	static inline thread_local Botan::AutoSeeded_RNG rng;
+/*
+ * The server's private ephemeral and g^b mod N, which can be generated
+ * ahead of time as it has no dependency on the user
+ */
+struct Ephemeral {
+	Botan::BigInt b;
+	Botan::BigInt g_b;
+};
 
+class Server final {
 	const Botan::BigInt v_, N_, b_;
 	Botan::BigInt B_, k_{ 3 };
 
 public:
 	Server(const Generator& gen, Botan::BigInt v, Botan::BigInt b, bool srp6a = false);
 	Server(const Generator& gen, Botan::BigInt v, std::size_t key_size = 32, bool srp6a = false);
+	Server(const Generator& gen, Botan::BigInt v, Ephemeral ephemeral, bool srp6a = false);
+
+	static Ephemeral generate_ephemeral(const Generator& gen, std::size_t key_size = 32);
 
 	SessionKey session_key(const Botan::BigInt& A,
 	                       Compliance mode = Compliance::GAME,
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <botan/auto_rng.h>
+#include <botan/hash.h>
+#include <botan/mac.h>
+#include <array>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+namespace ember::crypto {
+
+/*
+ * Per-thread instances of the RNG, hash and MAC objects used on the
+ * login path, saving a heap allocation (and for the RNG, a reseed
+ * from the system) every time one would otherwise be constructed.
+ *
+ * Hash and MAC objects are cleared before being handed out, so any
+ * state left behind by an exception is discarded. MACs must be keyed
+ * by the caller. The returned reference must not be held across a call
+ * that might request the same algorithm, as it'll be the same object.
+ */
+enum class Hash {
+	SHA1, MD5, CRC32,
+	MAX
+};
+
+enum class Mac {
+	HMAC_SHA1,
+	MAX
+};
+
+namespace detail {
+
+constexpr const char* hash_names[] { "SHA-1", "MD5", "CRC32" };
+constexpr const char* mac_names[] { "HMAC(SHA-1)" };
+
+static_assert(std::size(hash_names) == std::to_underlying(Hash::MAX));
+static_assert(std::size(mac_names) == std::to_underlying(Mac::MAX));
+
+} // detail
+
+inline Botan::RandomNumberGenerator& rng() {
+	thread_local Botan::AutoSeeded_RNG rng;
+	return rng;
+}
+
+inline Botan::HashFunction& hasher(const Hash hash) {
+	thread_local std::array<std::unique_ptr<Botan::HashFunction>, std::to_underlying(Hash::MAX)> hashers;
+	auto& hasher = hashers[std::to_underlying(hash)];
+
+	if(!hasher) {
+		hasher = Botan::HashFunction::create_or_throw(detail::hash_names[std::to_underlying(hash)]);
+	} else {
+		hasher->clear();
+	}
+
+	return *hasher;
+}
+
+inline Botan::MessageAuthenticationCode& mac(const Mac mac) {
+	thread_local std::array<std::unique_ptr<Botan::MessageAuthenticationCode>, std::to_underlying(Mac::MAX)> macs;
+	auto& instance = macs[std::to_underlying(mac)];
+
+	if(!instance) {
+		instance = Botan::MessageAuthenticationCode::create_or_throw(detail::mac_names[std::to_underlying(mac)]);
+	} else {
+		instance->clear();
+	}
+
+	return *instance;
+}
+
+} // crypto, ember
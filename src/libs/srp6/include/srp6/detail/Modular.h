@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <botan/bigint.h>
+#include <botan/reducer.h>
+#include <vector>
+#include <cstddef>
+
+namespace ember::srp6::detail {
+
+/*
+ * Modular exponentiation & multiplication using a per-thread context
+ * for the modulus, saving the Montgomery & Barrett setup that
+ * Botan::power_mod repeats on every call. The modulus is expected to
+ * be fixed for the lifetime of the process, so only the most recently
+ * used modulus is kept.
+ */
+Botan::BigInt power_mod(const Botan::BigInt& base, const Botan::BigInt& exp,
+                        const Botan::BigInt& mod);
+
+Botan::BigInt multiply_mod(const Botan::BigInt& x, const Botan::BigInt& y,
+                           const Botan::BigInt& mod);
+
+/*
+ * Fixed-base windowed exponentiation table for g^x mod N.
+ *
+ * Row i holds g^(j * 2^(w * i)) for every w-bit digit j, so g^x is the
+ * product of one entry per digit of x with no squarings required.
+ * Exponents wider than the table was built for should be handed
+ * to power_mod instead.
+ *
+ * Every digit costs a multiplication, including zero digits, and every
+ * entry in a row is read for every digit, so neither the operation count
+ * nor the memory access pattern depends on the exponent.
+ */
+class FixedBaseTable final {
+	const Botan::Modular_Reducer reducer_;
+	const std::size_t window_;
+	const std::size_t max_bits_;
+	std::vector<Botan::BigInt> table_;
+
+public:
+	FixedBaseTable(const Botan::BigInt& g, const Botan::BigInt& N,
+	               std::size_t max_bits, std::size_t window = 0);
+
+	Botan::BigInt operator()(const Botan::BigInt& x) const;
+
+	std::size_t max_bits() const { return max_bits_; }
+	std::size_t window() const { return window_; }
+};
+
+} // detail, srp6, ember
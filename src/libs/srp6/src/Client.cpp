@@ -7,7 +7,7 @@
  */
 
 #include <srp6/Client.h>
-#include <botan/auto_rng.h>
+#include <srp6/crypto/ThreadLocal.h>
 #include <botan/bigint.h>
 #include <botan/numthry.h>
 #include <botan/rng.h>
@@ -15,13 +15,12 @@
 
 using Botan::BigInt;
 using Botan::power_mod;
-using Botan::AutoSeeded_RNG;
 
 namespace ember::srp6 {
 
 Client::Client(std::string identifier, std::string password, Generator gen, std::size_t key_size, bool srp6a)
                : Client(std::move(identifier), std::move(password), gen,
-                 BigInt::decode((AutoSeeded_RNG()).random_vec(key_size)) % gen.prime(), srp6a) { }
+                 BigInt::decode(crypto::rng().random_vec(key_size)) % gen.prime(), srp6a) { }
 
 Client::Client(std::string identifier, std::string password, Generator gen, BigInt a, bool srp6a)
                : gen_(std::move(gen)),
@@ -9,6 +9,7 @@
 #include <srp6/Generator.h>
 #include <srp6/detail/Primes.h>
 #include <boost/assert.hpp>
+#include <utility>
 
 namespace ember::srp6 {
 
@@ -61,8 +62,22 @@ Botan::BigInt Generator::n_from_group(Group& group) {
 	}
 }
 
-Generator::Generator(Group group)
-	: g_(g_from_group(group)),
-	  N_(n_from_group(group)) { }
+Generator::Generator(Botan::BigInt g, Botan::BigInt N, const std::size_t fixed_base_bits)
+	: g_(std::move(g)), N_(std::move(N)) {
+	if(fixed_base_bits) {
+		table_ = std::make_shared<const detail::FixedBaseTable>(g_, N_, fixed_base_bits);
+	}
+}
+
+Generator::Generator(Group group, const std::size_t fixed_base_bits)
+	: Generator(g_from_group(group), n_from_group(group), fixed_base_bits) { }
+
+Botan::BigInt Generator::operator()(const Botan::BigInt& x) const {
+	if(table_ && !x.is_negative() && x.bits() <= table_->max_bits()) {
+		return (*table_)(x);
+	}
+
+	return detail::power_mod(g_, x, N_);
+}
 
 } // srp6, ember
\ No newline at end of file
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <srp6/detail/Modular.h>
+#include <botan/pow_mod.h>
+#include <boost/assert.hpp>
+#include <memory>
+
+namespace ember::srp6::detail {
+
+namespace {
+
+struct ModularContext {
+	const Botan::BigInt mod;
+	const Botan::Modular_Reducer reducer;
+	const Botan::Power_Mod pow;
+
+	explicit ModularContext(const Botan::BigInt& mod)
+		: mod(mod), reducer(mod), pow(mod) {}
+};
+
+const ModularContext& context(const Botan::BigInt& mod) {
+	thread_local std::unique_ptr<ModularContext> ctx;
+
+	if(!ctx || ctx->mod != mod) {
+		ctx = std::make_unique<ModularContext>(mod);
+	}
+
+	return *ctx;
+}
+
+/*
+ * Every entry in a row is read for each digit, so the cost of a lookup
+ * doubles with each bit added to the window. Four bits keeps the scan
+ * cheap relative to the multiplication it feeds.
+ */
+std::size_t select_window(const Botan::BigInt&) {
+	return 4;
+}
+
+// branch-free, the comparison must not leak the digit either
+bool ct_is_equal(const std::size_t x, const std::size_t y) {
+	const std::size_t diff = x ^ y;
+	return ((diff | (0 - diff)) >> (sizeof(std::size_t) * 8 - 1)) ^ 1;
+}
+
+} // unnamed
+
+Botan::BigInt power_mod(const Botan::BigInt& base, const Botan::BigInt& exp,
+                        const Botan::BigInt& mod) {
+	const auto& ctx = context(mod);
+	ctx.pow.set_base(base);
+	ctx.pow.set_exponent(exp);
+	return ctx.pow.execute();
+}
+
+Botan::BigInt multiply_mod(const Botan::BigInt& x, const Botan::BigInt& y,
+                           const Botan::BigInt& mod) {
+	return context(mod).reducer.multiply(x, y);
+}
+
+FixedBaseTable::FixedBaseTable(const Botan::BigInt& g, const Botan::BigInt& N,
+                               const std::size_t max_bits, const std::size_t window)
+	: reducer_(N),
+	  window_(window? window : select_window(N)),
+	  max_bits_(max_bits) {
+	BOOST_ASSERT_MSG(window_ && window_ <= 16, "Unsupported window size");
+
+	const std::size_t row_len = std::size_t(1) << window_;
+	const std::size_t rows = (max_bits_ + window_ - 1) / window_;
+	table_.reserve(rows * row_len);
+
+	const std::size_t words = N.sig_words();
+	Botan::BigInt base = reducer_.reduce(g);
+
+	for(std::size_t i = 0; i < rows; ++i) {
+		table_.emplace_back(1);
+		table_.emplace_back(base);
+
+		for(std::size_t j = 2; j < row_len; ++j) {
+			table_.emplace_back(reducer_.multiply(table_.back(), base));
+		}
+
+		// g^(2^(w * (i + 1))) for the next row
+		base = reducer_.multiply(table_.back(), base);
+	}
+
+	// same width for every entry, so a masked copy touches the same words for each
+	for(auto& entry : table_) {
+		entry.grow_to(words);
+	}
+}
+
+Botan::BigInt FixedBaseTable::operator()(const Botan::BigInt& x) const {
+	BOOST_ASSERT_MSG(!x.is_negative() && x.bits() <= max_bits_, "Exponent out of range");
+
+	const std::size_t row_len = std::size_t(1) << window_;
+	const std::size_t rows = table_.size() / row_len;
+	Botan::BigInt result = 1;
+
+	for(std::size_t i = 0; i < rows; ++i) {
+		const std::size_t digit = x.get_substring(i * window_, window_);
+		const auto row = table_.begin() + i * row_len;
+
+		/*
+		 * The digit comes from a secret exponent, so rather than indexing
+		 * the row with it, read every entry and keep only the wanted one
+		 */
+		Botan::BigInt entry = *row;
+
+		for(std::size_t j = 1; j < row_len; ++j) {
+			entry.ct_cond_assign(ct_is_equal(j, digit), row[j]);
+		}
+
+		result = reducer_.multiply(result, entry);
+	}
+
+	return result;
+}
+
+} // detail, srp6, ember
@@ -7,12 +7,12 @@
  */
 
 #include <srp6/Server.h>
-#include <botan/numthry.h>
+#include <srp6/detail/Modular.h>
+#include <srp6/crypto/ThreadLocal.h>
 #include <botan/rng.h>
 #include <utility>
 
 using Botan::BigInt;
-using Botan::power_mod;
 
 namespace ember::srp6 {
 
@@ -26,9 +26,28 @@ Server::Server(const Generator& gen, BigInt v, BigInt b, bool srp6a)
 }
 
 Server::Server(const Generator& gen, BigInt v, std::size_t key_size, bool srp6a)
-               : Server(gen, std::move(v), BigInt(rng, key_size * 8) % gen.prime(),
+               : Server(gen, std::move(v), BigInt(crypto::rng(), key_size * 8) % gen.prime(),
                  srp6a) { }
 
+/*
+ * Skips the modular exponentiation by using a precomputed g^b mod N,
+ * leaving only the cheap multiplication & reduction to derive B
+ */
+Server::Server(const Generator& gen, BigInt v, Ephemeral ephemeral, bool srp6a)
+              : v_(std::move(v)), N_(gen.prime()), b_(std::move(ephemeral.b)) {
+	if(srp6a) {
+		k_ = detail::compute_k(gen.generator(), N_);
+	}
+
+	B_ = (k_ * v_ + ephemeral.g_b) % N_;
+}
+
+Ephemeral Server::generate_ephemeral(const Generator& gen, const std::size_t key_size) {
+	BigInt b = BigInt(crypto::rng(), key_size * 8) % gen.prime();
+	BigInt g_b = gen(b);
+	return { std::move(b), std::move(g_b) };
+}
+
 SessionKey Server::session_key(const BigInt& A, Compliance mode, bool interleave_override) const {
 	bool interleave = (mode == Compliance::GAME);
 	
@@ -41,7 +60,8 @@ SessionKey Server::session_key(const BigInt& A, Compliance mode, bool interleave
 	}
 
 	BigInt u = detail::scrambler(A, B_, N_.bytes(), mode);
-	BigInt S = power_mod(A * power_mod(v_, u, N_), b_, N_);
+	const BigInt v_u = detail::power_mod(v_, u, N_);
+	const BigInt S = detail::power_mod(detail::multiply_mod(A, v_u, N_), b_, N_);
 
 	if(interleave) {
 		return SessionKey(detail::interleaved_hash(detail::encode_flip_1363(S, N_.bytes())));
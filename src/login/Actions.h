@@ -9,11 +9,15 @@
 #pragma once
 
 #include "AccountClient.h"
+#include "Authenticator.h"
+#include "PatchCache.h"
 #include "grunt/Packet.h"
 #include <shared/database/objects/User.h>
 #include <shared/database/daos/UserDAO.h>
+#include <shared/threading/ThreadPool.h>
 #include <exception>
 #include <future>
+#include <memory>
 #include <string>
 #include <optional>
 #include <utility>
@@ -24,6 +28,17 @@ namespace ember {
 class Action {
 public:
 	virtual void execute() = 0;
+
+	// anything on the login path should take precedence over housekeeping
+	virtual ThreadPool::Priority priority() const {
+		return ThreadPool::Priority::HIGH;
+	}
+
+	// crypto work goes to its own pool so it can't starve DB/RPC actions
+	virtual bool cpu_bound() const {
+		return false;
+	}
+
 	virtual ~Action() = default;
 };
 
@@ -104,6 +119,90 @@ public:
 	}
 };
 
+/*
+ * Runs on a crypto pool thread, so holds its own copy of the authenticator
+ * (verifier, ephemerals, salt and username) rather than a reference into
+ * the handler, which may change state or be destroyed in the meantime
+ */
+class VerifyProofAction final : public Action {
+	const LoginAuthenticator authenticator_;
+	const Botan::BigInt A_;
+	const Botan::BigInt M1_;
+
+	srp6::SessionKey key_;
+	Botan::BigInt server_proof_;
+	bool match_;
+	std::exception_ptr exception_;
+
+public:
+	VerifyProofAction(LoginAuthenticator authenticator, Botan::BigInt A, Botan::BigInt M1)
+		: authenticator_(std::move(authenticator)),
+		  A_(std::move(A)),
+		  M1_(std::move(M1)),
+		  match_(false) {}
+
+	virtual void execute() override try {
+		key_ = authenticator_.session_key(A_);
+		match_ = (authenticator_.expected_proof(key_, A_) == M1_);
+
+		if(match_) {
+			server_proof_ = authenticator_.server_proof(key_, A_, M1_);
+		}
+	} catch(const std::exception&) {
+		exception_ = std::current_exception();
+	}
+
+	bool cpu_bound() const override {
+		return true;
+	}
+
+	bool get_result() const {
+		if(exception_) {
+			std::rethrow_exception(exception_);
+		}
+
+		return match_;
+	}
+
+	const srp6::SessionKey& session_key() const {
+		return key_;
+	}
+
+	const Botan::BigInt& server_proof() const {
+		return server_proof_;
+	}
+};
+
+class MapPatchAction final : public Action {
+	PatchCache& cache_;
+	const PatchMeta meta_;
+	std::shared_ptr<const PatchCache::Mapping> mapping_;
+	std::exception_ptr exception_;
+
+public:
+	MapPatchAction(PatchCache& cache, PatchMeta meta)
+		: cache_(cache),
+		  meta_(std::move(meta)) {}
+
+	virtual void execute() override try {
+		mapping_ = cache_.acquire(meta_);
+	} catch(const std::exception&) {
+		exception_ = std::current_exception();
+	}
+
+	std::shared_ptr<const PatchCache::Mapping> get_result() const {
+		if(exception_) {
+			std::rethrow_exception(exception_);
+		}
+
+		return mapping_;
+	}
+
+	const PatchMeta& meta() const {
+		return meta_;
+	}
+};
+
 class FetchUserAction final : public Action {
 	const utf8_string username_;
 	const dal::UserDAO& user_src_;
@@ -190,6 +289,10 @@ public:
 		error_ = true;
 	}
 
+	ThreadPool::Priority priority() const override {
+		return ThreadPool::Priority::LOW;
+	}
+
 	bool error() const {
 		return error_;
 	}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "AdmissionControl.h"
+#include <algorithm>
+#include <utility>
+
+namespace ember {
+
+namespace bai = boost::asio::ip;
+
+// how often fully refilled buckets are swept out of the maps
+constexpr auto PRUNE_INTERVAL = std::chrono::seconds(30);
+
+AdmissionControl::AdmissionControl(Config config)
+	: config_(config), last_prune_(clock::now()), handshakes_(0) {}
+
+/*
+ * Refills the bucket for the time elapsed since it was last touched,
+ * returning null if the check is disabled. Tokens aren't taken here, so
+ * that a connection rejected by a later check doesn't use any up.
+ */
+auto AdmissionControl::refill(Buckets& buckets, const Key& key,
+                              const double rate, const double burst,
+                              const clock::time_point now) -> Bucket* {
+	if(rate <= 0.0) {
+		return nullptr;
+	}
+
+	auto [it, inserted] = buckets.try_emplace(key, Bucket { burst, now });
+	auto& bucket = it->second;
+
+	if(!inserted) {
+		const std::chrono::duration<double> elapsed = now - bucket.updated;
+		bucket.tokens = std::min(burst, bucket.tokens + (elapsed.count() * rate));
+		bucket.updated = now;
+	}
+
+	return &bucket;
+}
+
+/*
+ * Any bucket that would have refilled by now is indistinguishable
+ * from one that doesn't exist, so there's no need to keep it around
+ */
+void AdmissionControl::prune(Buckets& buckets, const double rate, const double burst,
+                             const clock::time_point now) {
+	if(rate <= 0.0) {
+		buckets.clear();
+		return;
+	}
+
+	std::erase_if(buckets, [&](const auto& entry) {
+		const auto& [_, bucket] = entry;
+		const std::chrono::duration<double> elapsed = now - bucket.updated;
+		return bucket.tokens + (elapsed.count() * rate) >= burst;
+	});
+}
+
+/*
+ * Dual-stack listeners deliver IPv4 clients as IPv4-mapped IPv6 addresses,
+ * which need to be treated as IPv4 or they'd all share a /64 subnet
+ */
+bai::address AdmissionControl::unmap(const bai::address& ip) {
+	if(ip.is_v6() && ip.to_v6().is_v4_mapped()) {
+		return bai::make_address_v4(bai::v4_mapped, ip.to_v6());
+	}
+
+	return ip;
+}
+
+auto AdmissionControl::key(const bai::address& address) -> Key {
+	const auto ip = unmap(address);
+
+	if(ip.is_v4()) {
+		return bai::make_address_v6(bai::v4_mapped, ip.to_v4()).to_bytes();
+	}
+
+	return ip.to_v6().to_bytes();
+}
+
+auto AdmissionControl::subnet(const bai::address& address) const -> Key {
+	const auto ip = unmap(address);
+	auto bytes = key(ip);
+	auto prefix = std::min(config_.ipv6_prefix, 128u);
+
+	// the mapped address occupies the last four bytes
+	if(ip.is_v4()) {
+		prefix = 96 + std::min(config_.ipv4_prefix, 32u);
+	}
+
+	for(std::size_t i = 0; i < bytes.size(); ++i) {
+		const auto bit = i * 8;
+
+		if(bit >= prefix) {
+			bytes[i] = 0;
+		} else if(prefix - bit < 8) {
+			bytes[i] &= static_cast<unsigned char>(0xff << (8 - (prefix - bit)));
+		}
+	}
+
+	return bytes;
+}
+
+auto AdmissionControl::admit(const bai::address& ip, const clock::time_point now)
+	-> std::expected<Ticket, Rejection> {
+	std::lock_guard guard(lock_);
+
+	if(now - last_prune_ >= PRUNE_INTERVAL) {
+		prune(ip_buckets_, config_.ip_rate, config_.ip_burst, now);
+		prune(subnet_buckets_, config_.subnet_rate, config_.subnet_burst, now);
+		last_prune_ = now;
+	}
+
+	auto ip_bucket = refill(ip_buckets_, key(ip), config_.ip_rate, config_.ip_burst, now);
+
+	if(ip_bucket && ip_bucket->tokens < 1.0) {
+		return std::unexpected(Rejection::IP_RATE_LIMITED);
+	}
+
+	auto subnet_bucket = refill(subnet_buckets_, subnet(ip), config_.subnet_rate,
+	                            config_.subnet_burst, now);
+
+	if(subnet_bucket && subnet_bucket->tokens < 1.0) {
+		return std::unexpected(Rejection::SUBNET_RATE_LIMITED);
+	}
+
+	Ticket ticket;
+
+	if(config_.max_handshakes) {
+		auto current = handshakes_.load(std::memory_order_relaxed);
+
+		do {
+			if(current >= config_.max_handshakes) {
+				return std::unexpected(Rejection::HANDSHAKE_LIMIT);
+			}
+		} while(!handshakes_.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+
+		ticket = Ticket(this);
+	}
+
+	// every check has passed, only now are the tokens spent
+	if(ip_bucket) {
+		ip_bucket->tokens -= 1.0;
+	}
+
+	if(subnet_bucket) {
+		subnet_bucket->tokens -= 1.0;
+	}
+
+	return ticket;
+}
+
+std::size_t AdmissionControl::handshakes() const {
+	return handshakes_.load(std::memory_order_relaxed);
+}
+
+std::size_t AdmissionControl::tracked() const {
+	std::lock_guard guard(lock_);
+	return ip_buckets_.size() + subnet_buckets_.size();
+}
+
+AdmissionControl::Ticket::Ticket(Ticket&& rhs) noexcept
+	: owner_(std::exchange(rhs.owner_, nullptr)) {}
+
+auto AdmissionControl::Ticket::operator=(Ticket&& rhs) noexcept -> Ticket& {
+	if(this != &rhs) {
+		release();
+		owner_ = std::exchange(rhs.owner_, nullptr);
+	}
+
+	return *this;
+}
+
+AdmissionControl::Ticket::~Ticket() {
+	release();
+}
+
+void AdmissionControl::Ticket::release() {
+	if(owner_) {
+		owner_->handshakes_.fetch_sub(1, std::memory_order_relaxed);
+		owner_ = nullptr;
+	}
+}
+
+} // ember
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <boost/asio/ip/address.hpp>
+#include <atomic>
+#include <chrono>
+#include <expected>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <cstddef>
+
+namespace ember {
+
+/*
+ * Decides whether a new connection is allowed to proceed to having a
+ * session created for it. Checked by the listener straight after accept,
+ * so rejected connections cost no more than closing the socket.
+ *
+ * Each address and subnet has a token bucket, refilled at a fixed rate up
+ * to a burst limit, with every admitted connection consuming a token.
+ * There's also a cap on the number of concurrent handshakes, where a
+ * handshake lasts from accept until the client has authenticated or
+ * disconnected.
+ *
+ * A rate or limit of zero disables that check.
+ */
+class AdmissionControl final {
+public:
+	using clock = std::chrono::steady_clock;
+
+	struct Config {
+		double ip_rate;
+		double ip_burst;
+		double subnet_rate;
+		double subnet_burst;
+		unsigned int ipv4_prefix;
+		unsigned int ipv6_prefix;
+		std::size_t max_handshakes;
+	};
+
+	enum class Rejection {
+		IP_RATE_LIMITED, SUBNET_RATE_LIMITED, HANDSHAKE_LIMIT
+	};
+
+	/*
+	 * Holds one of the handshake slots until released or destroyed
+	 */
+	class Ticket final {
+		AdmissionControl* owner_ = nullptr;
+
+	public:
+		Ticket() = default;
+		explicit Ticket(AdmissionControl* owner) : owner_(owner) {}
+		Ticket(Ticket&& rhs) noexcept;
+		Ticket& operator=(Ticket&& rhs) noexcept;
+		~Ticket();
+
+		void release();
+
+		Ticket(const Ticket&) = delete;
+		Ticket& operator=(const Ticket&) = delete;
+	};
+
+private:
+	struct Bucket {
+		double tokens;
+		clock::time_point updated;
+	};
+
+	// IPv4 addresses are stored as IPv4-mapped IPv6 addresses
+	using Key = boost::asio::ip::address_v6::bytes_type;
+
+	struct KeyHash {
+		std::size_t operator()(const Key& key) const noexcept {
+			const std::string_view bytes(reinterpret_cast<const char*>(key.data()), key.size());
+			return std::hash<std::string_view>()(bytes);
+		}
+	};
+
+	using Buckets = std::unordered_map<Key, Bucket, KeyHash>;
+
+	const Config config_;
+
+	mutable std::mutex lock_;
+	Buckets ip_buckets_;
+	Buckets subnet_buckets_;
+	clock::time_point last_prune_;
+	std::atomic<std::size_t> handshakes_;
+
+	static Bucket* refill(Buckets& buckets, const Key& key,
+	                      double rate, double burst, clock::time_point now);
+	static void prune(Buckets& buckets, double rate, double burst, clock::time_point now);
+	static boost::asio::ip::address unmap(const boost::asio::ip::address& ip);
+	static Key key(const boost::asio::ip::address& ip);
+	Key subnet(const boost::asio::ip::address& ip) const;
+
+public:
+	explicit AdmissionControl(Config config);
+
+	std::expected<Ticket, Rejection> admit(const boost::asio::ip::address& ip,
+	                                       clock::time_point now = clock::now());
+
+	std::size_t handshakes() const;
+	std::size_t tracked() const;
+};
+
+constexpr const char* to_string(const AdmissionControl::Rejection rejection) {
+	switch(rejection) {
+		case AdmissionControl::Rejection::IP_RATE_LIMITED:
+			return "IP rate limited";
+		case AdmissionControl::Rejection::SUBNET_RATE_LIMITED:
+			return "subnet rate limited";
+		case AdmissionControl::Rejection::HANDSHAKE_LIMIT:
+			return "handshake limit reached";
+		default:
+			return "unknown";
+	}
+}
+
+} // ember
@@ -8,6 +8,7 @@
 
 #include "Authenticator.h"
 #include <logger/Logger.h>
+#include <srp6/crypto/ThreadLocal.h>
 #include <srp6/Util.h>
 #include <boost/assert.hpp>
 #include <botan/hash.h>
@@ -16,9 +17,10 @@
 
 namespace ember {
 
-LoginAuthenticator::LoginAuthenticator(User user)
+LoginAuthenticator::LoginAuthenticator(User user, std::optional<srp6::Ephemeral> ephemeral)
 	: user_(std::move(user)),
-	  srp_(gen_, Botan::BigInt(user_.verifier())) {}
+	  srp_(ephemeral? srp6::Server(gen_, Botan::BigInt(user_.verifier()), std::move(*ephemeral))
+	                : srp6::Server(gen_, Botan::BigInt(user_.verifier()))) {}
 
 auto LoginAuthenticator::challenge_reply() const -> ChallengeResponse {
 	Botan::BigInt salt { user_.salt().data(), user_.salt().size_bytes() };
@@ -56,13 +58,13 @@ ReconnectAuthenticator::ReconnectAuthenticator(utf8_string username,
 bool ReconnectAuthenticator::proof_check(std::span<const std::uint8_t> salt,
                                          std::span<const std::uint8_t> proof) const {
 	std::array<std::uint8_t, 20> res;
-	auto hasher = Botan::HashFunction::create_or_throw("SHA-1");
-	BOOST_ASSERT_MSG(hasher->output_length() == res.size(), "Bad hash size");
-	hasher->update(username_);
-	hasher->update(salt.data(), salt.size());
-	hasher->update(salt_.data(), salt_.size());
-	hasher->update(sess_key_.t.data(), sess_key_.t.size());
-	hasher->final(res.data());
+	auto& hasher = crypto::hasher(crypto::Hash::SHA1);
+	BOOST_ASSERT_MSG(hasher.output_length() == res.size(), "Bad hash size");
+	hasher.update(username_);
+	hasher.update(salt.data(), salt.size());
+	hasher.update(salt_.data(), salt_.size());
+	hasher.update(sess_key_.t.data(), sess_key_.t.size());
+	hasher.final(res.data());
 	return std::ranges::equal(res, proof);
 }
 
@@ -12,6 +12,7 @@
 #include <shared/database/objects/User.h>
 #include <shared/utility/UTF8String.h>
 #include <array>
+#include <optional>
 #include <span>
 
 namespace ember {
@@ -35,7 +36,8 @@ public:
 };
 
 class LoginAuthenticator final {
-	const static inline srp6::Generator gen_ { srp6::Generator::Group::_256_BIT };
+	// server ephemerals are 256 bits, so g^b can always use the fixed-base table
+	const static inline srp6::Generator gen_ { srp6::Generator::Group::_256_BIT, 256 };
 
 	struct ChallengeResponse {
 		const Botan::BigInt& B;
@@ -47,7 +49,7 @@ class LoginAuthenticator final {
 	srp6::Server srp_;
 
 public:
-	explicit LoginAuthenticator(User user);
+	explicit LoginAuthenticator(User user, std::optional<srp6::Ephemeral> ephemeral = std::nullopt);
 
 	ChallengeResponse challenge_reply() const;
 
@@ -59,6 +61,8 @@ public:
 	                             const Botan::BigInt& A) const;
 
 	srp6::SessionKey session_key(const Botan::BigInt& A) const;
+
+	static const srp6::Generator& generator() { return gen_; }
 };
 
 } // ember
\ No newline at end of file
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "EphemeralPool.h"
+#include <shared/metrics/Metrics.h>
+#include <shared/threading/Utility.h>
+#include <utility>
+
+namespace ember {
+
+EphemeralPool::EphemeralPool(const srp6::Generator& gen, const std::size_t depth,
+                             const std::size_t threads, Metrics& metrics)
+	: gen_(gen), depth_(depth), metrics_(metrics), pending_(0), exhausted_(0) {
+	if(!depth_) {
+		return;
+	}
+
+	for(std::size_t i = 0; i < threads; ++i) {
+		workers_.emplace_back([&](std::stop_token token) { refill(token); });
+		thread::set_name(workers_.back(), "Ephemeral Pool");
+	}
+}
+
+EphemeralPool::~EphemeralPool() {
+	for(auto& worker : workers_) {
+		worker.request_stop();
+	}
+
+	cond_.notify_all();
+}
+
+void EphemeralPool::refill(std::stop_token token) {
+	while(!token.stop_requested()) {
+		{
+			std::unique_lock guard(lock_);
+
+			if(!cond_.wait(guard, token, [&] { return entries_.size() + pending_ < depth_; })) {
+				return;
+			}
+
+			++pending_;
+		}
+
+		auto ephemeral = srp6::Server::generate_ephemeral(gen_);
+
+		std::lock_guard guard(lock_);
+		--pending_;
+		entries_.emplace_back(std::move(ephemeral));
+	}
+}
+
+std::optional<srp6::Ephemeral> EphemeralPool::pop() {
+	std::unique_lock guard(lock_);
+
+	if(entries_.empty()) {
+		guard.unlock();
+
+		if(depth_) {
+			++exhausted_;
+			metrics_.increment("srp6_ephemeral_pool_exhausted");
+		}
+
+		return std::nullopt;
+	}
+
+	auto entry = std::move(entries_.front());
+	entries_.pop_front();
+	guard.unlock();
+	cond_.notify_one();
+	return entry;
+}
+
+std::size_t EphemeralPool::available() {
+	std::lock_guard guard(lock_);
+	return entries_.size();
+}
+
+std::uint64_t EphemeralPool::exhausted() const {
+	return exhausted_;
+}
+
+} // ember
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <srp6/Server.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+class Metrics;
+
+/*
+ * Keeps a stock of precomputed SRP6 server ephemerals (b, g^b mod N).
+ *
+ * The modular exponentiation is the most expensive part of building a
+ * login challenge but it doesn't depend on the user, so it can be done
+ * ahead of time by the pool's worker threads rather than on a network
+ * thread once the user's details have been fetched.
+ *
+ * If the pool is empty, the caller should fall back to generating
+ * the ephemeral itself.
+ */
+class EphemeralPool final {
+	const srp6::Generator& gen_;
+	const std::size_t depth_;
+	Metrics& metrics_;
+
+	std::mutex lock_;
+	std::condition_variable_any cond_;
+	std::deque<srp6::Ephemeral> entries_;
+	std::size_t pending_;
+	std::atomic<std::uint64_t> exhausted_;
+	std::vector<std::jthread> workers_;
+
+	void refill(std::stop_token token);
+
+public:
+	EphemeralPool(const srp6::Generator& gen, std::size_t depth,
+	              std::size_t threads, Metrics& metrics);
+	~EphemeralPool();
+
+	std::optional<srp6::Ephemeral> pop();
+
+	std::size_t available();
+	std::uint64_t exhausted() const;
+};
+
+} // ember
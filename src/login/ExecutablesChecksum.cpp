@@ -7,6 +7,7 @@
  */
 
 #include "ExecutablesChecksum.h"
+#include <srp6/crypto/ThreadLocal.h>
 #include <boost/assert.hpp>
 #include <botan/hash.h>
 #include <botan/mac.h>
@@ -15,23 +16,32 @@ namespace ember::client_integrity {
 
 std::array<std::uint8_t, 20> checksum(std::span<const std::uint8_t> seed,
                                       std::span<const std::byte> buffer) {
+	auto& hmac = crypto::mac(crypto::Mac::HMAC_SHA1);
+	return checksum(hmac, seed, buffer);
+}
+
+/*
+ * Allows the caller to reuse an HMAC(SHA-1) instance across checksums
+ */
+std::array<std::uint8_t, 20> checksum(Botan::MessageAuthenticationCode& hmac,
+                                      std::span<const std::uint8_t> seed,
+                                      std::span<const std::byte> buffer) {
 	std::array<std::uint8_t, 20> res;
-	auto hmac = Botan::MessageAuthenticationCode::create_or_throw("HMAC(SHA-1)");
-	BOOST_ASSERT_MSG(hmac->output_length() == res.size(), "Bad hash size");
-	hmac->set_key(seed.data(), seed.size());
-	hmac->update(reinterpret_cast<const std::uint8_t*>(buffer.data()), buffer.size_bytes());
-	hmac->final(res.data());
+	BOOST_ASSERT_MSG(hmac.output_length() == res.size(), "Bad hash size");
+	hmac.set_key(seed.data(), seed.size());
+	hmac.update(reinterpret_cast<const std::uint8_t*>(buffer.data()), buffer.size_bytes());
+	hmac.final(res.data());
 	return res;
 }
 
 std::array<std::uint8_t, 20> finalise(std::span<const std::uint8_t> checksum,
                                       std::span<const std::uint8_t> client_seed) {
 	std::array<std::uint8_t, 20> res;
-	auto hasher = Botan::HashFunction::create_or_throw("SHA-1");
-	BOOST_ASSERT_MSG(hasher->output_length() == res.size(), "Bad hash size");
-	hasher->update(client_seed.data(), client_seed.size_bytes());
-	hasher->update(checksum.data(), checksum.size_bytes());
-	hasher->final(res.data());
+	auto& hasher = crypto::hasher(crypto::Hash::SHA1);
+	BOOST_ASSERT_MSG(hasher.output_length() == res.size(), "Bad hash size");
+	hasher.update(client_seed.data(), client_seed.size_bytes());
+	hasher.update(checksum.data(), checksum.size_bytes());
+	hasher.final(res.data());
 	return res;
 }
 
@@ -13,10 +13,19 @@
 #include <cstdint>
 #include <cstddef>
 
+namespace Botan {
+
+class MessageAuthenticationCode;
+
+} // Botan
+
 namespace ember::client_integrity {
 
 std::array<std::uint8_t, 20> checksum(std::span<const std::uint8_t> seed,
                                       std::span<const std::byte> buffer);
+std::array<std::uint8_t, 20> checksum(Botan::MessageAuthenticationCode& hmac,
+                                      std::span<const std::uint8_t> seed,
+                                      std::span<const std::byte> buffer);
 std::array<std::uint8_t, 20> finalise(std::span<const std::uint8_t> checksum,
                                       std::span<const std::uint8_t> seed);
 
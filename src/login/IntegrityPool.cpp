@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "IntegrityPool.h"
+#include "ExecutablesChecksum.h"
+#include <shared/metrics/Metrics.h>
+#include <shared/threading/Utility.h>
+#include <botan/auto_rng.h>
+#include <botan/mac.h>
+#include <algorithm>
+
+namespace ember {
+
+IntegrityPool::IntegrityPool(const IntegrityData& data, const std::size_t depth,
+                             const std::size_t threads, Metrics& metrics)
+	: data_(data), depth_(depth), metrics_(metrics), exhausted_(0) {
+	for(const auto& key : data_.keys()) {
+		stock_[key].data = *data_.lookup(key);
+	}
+
+	if(!depth_ || stock_.empty()) {
+		return;
+	}
+
+	for(std::size_t i = 0; i < threads; ++i) {
+		workers_.emplace_back([&](std::stop_token token) { refill(token); });
+		thread::set_name(workers_.back(), "Integrity Pool");
+	}
+}
+
+IntegrityPool::~IntegrityPool() {
+	for(auto& worker : workers_) {
+		worker.request_stop();
+	}
+
+	cond_.notify_all();
+}
+
+/*
+ * Finds the stock that's furthest below the target depth, taking any
+ * in-progress work into account so workers don't overfill it
+ */
+auto IntegrityPool::next_stock() -> Stock* {
+	Stock* next = nullptr;
+	std::size_t lowest = depth_;
+
+	for(auto& [_, stock] : stock_) {
+		const auto level = stock.entries.size() + stock.pending;
+
+		if(level < lowest) {
+			lowest = level;
+			next = &stock;
+		}
+	}
+
+	return next;
+}
+
+void IntegrityPool::refill(std::stop_token token) {
+	Botan::AutoSeeded_RNG rng;
+	auto hmac = Botan::MessageAuthenticationCode::create_or_throw("HMAC(SHA-1)");
+
+	while(!token.stop_requested()) {
+		Stock* stock = nullptr;
+
+		{
+			std::unique_lock guard(lock_);
+
+			if(!cond_.wait(guard, token, [&] { return (stock = next_stock()) != nullptr; })) {
+				return;
+			}
+
+			++stock->pending;
+		}
+
+		Entry entry;
+		rng.randomize(entry.salt.data(), entry.salt.size());
+		entry.checksum = client_integrity::checksum(*hmac, entry.salt, stock->data);
+
+		std::lock_guard guard(lock_);
+		--stock->pending;
+		stock->entries.emplace_back(entry);
+	}
+}
+
+std::optional<IntegrityPool::Entry> IntegrityPool::pop(const GameVersion version,
+                                                       const grunt::Platform platform,
+                                                       const grunt::System os) {
+	std::unique_lock guard(lock_);
+	auto it = stock_.find(detail::Key{ version.build, platform, os });
+
+	if(it == stock_.end()) {
+		return std::nullopt;
+	}
+
+	if(it->second.entries.empty()) {
+		guard.unlock();
+		++exhausted_;
+		metrics_.increment("integrity_pool_exhausted");
+		return std::nullopt;
+	}
+
+	auto entry = it->second.entries.front();
+	it->second.entries.pop_front();
+	guard.unlock();
+	cond_.notify_one();
+	return entry;
+}
+
+std::size_t IntegrityPool::available() {
+	std::lock_guard guard(lock_);
+	std::size_t count = 0;
+
+	for(const auto& [_, stock] : stock_) {
+		count += stock.entries.size();
+	}
+
+	return count;
+}
+
+std::uint64_t IntegrityPool::exhausted() const {
+	return exhausted_;
+}
+
+} // ember
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "Authenticator.h"
+#include "GameVersion.h"
+#include "IntegrityData.h"
+#include "grunt/Magic.h"
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+class Metrics;
+
+/*
+ * Keeps a stock of precomputed (salt, checksum) pairs for each client
+ * version/platform/OS combination that has integrity data.
+ *
+ * Generating the checksum means HMACing megabytes of client binaries,
+ * which is far too expensive to be doing on a network thread for every
+ * login attempt. Instead, the salt sent in the login challenge is taken
+ * from the pool, leaving only the cheap finalisation step for the proof.
+ *
+ * The pool is topped back up by its own worker threads as entries
+ * are taken. If a pool is empty, the caller should fall back to
+ * generating a salt and computing the checksum itself.
+ */
+class IntegrityPool final {
+public:
+	struct Entry {
+		std::array<std::uint8_t, CHECKSUM_SALT_LEN> salt;
+		std::array<std::uint8_t, 20> checksum;
+	};
+
+private:
+	struct Stock {
+		std::span<const std::byte> data;
+		std::deque<Entry> entries;
+		std::size_t pending = 0;
+	};
+
+	const IntegrityData& data_;
+	const std::size_t depth_;
+	Metrics& metrics_;
+
+	std::mutex lock_;
+	std::condition_variable_any cond_;
+	boost::unordered_flat_map<detail::Key, Stock, detail::KeyHash> stock_;
+	std::atomic<std::uint64_t> exhausted_;
+	std::vector<std::jthread> workers_;
+
+	void refill(std::stop_token token);
+	Stock* next_stock();
+
+public:
+	IntegrityPool(const IntegrityData& data, std::size_t depth,
+	              std::size_t threads, Metrics& metrics);
+	~IntegrityPool();
+
+	std::optional<Entry> pop(GameVersion version, grunt::Platform platform, grunt::System os);
+
+	std::size_t available();
+	std::uint64_t exhausted() const;
+};
+
+} // ember
@@ -8,14 +8,18 @@
 
 #include "LoginHandler.h"
 #include "AccountClient.h"
+#include "EphemeralPool.h"
 #include "ExecutablesChecksum.h"
 #include "IntegrityData.h"
+#include "IntegrityPool.h"
 #include "LocaleMap.h"
+#include "LoginLatency.h"
 #include "Patcher.h"
-#include "RealmList.h"
+#include "RealmListCache.h"
 #include "Survey.h"
 #include "grunt/Packets.h"
 #include <logger/Logger.h>
+#include <srp6/crypto/ThreadLocal.h>
 #include <shared/database/daos/UserDAO.h>
 #include <shared/metrics/Metrics.h>
 #include <shared/utility/EnumHelper.h>
@@ -23,6 +27,7 @@
 #include <gsl/gsl_util>
 #include <ranges>
 #include <stdexcept>
+#include <utility>
 
 namespace ember {
 
@@ -30,6 +35,7 @@ bool LoginHandler::update_state(const grunt::Packet& packet) try {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
 	const LoginState prev_state = state_;
+	ScopedLatency latency(&latency_.states, std::to_underlying(prev_state));
 	update_state(LoginState::CLOSED);
 
 	switch(prev_state) {
@@ -76,6 +82,7 @@ bool LoginHandler::update_state(const Action& action) try {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
 	const LoginState prev_state = state_;
+	ScopedLatency latency(&latency_.states, std::to_underlying(prev_state));
 	update_state(LoginState::CLOSED);
 
 	switch(prev_state) {
@@ -88,12 +95,18 @@ bool LoginHandler::update_state(const Action& action) try {
 		case LoginState::FETCHING_SESSION:
 			send_reconnect_challenge(static_cast<const FetchSessionKeyAction&>(action));
 			break;
+		case LoginState::VERIFYING_PROOF:
+			on_proof_verified(static_cast<const VerifyProofAction&>(action));
+			break;
 		case LoginState::WRITING_SESSION:
 			on_session_write(static_cast<const RegisterSessionAction&>(action));
 			break;
 		case LoginState::REQUEST_REALMS:
 			on_survey_write(static_cast<const SaveSurveyAction&>(action));
 			break;
+		case LoginState::FETCHING_PATCH:
+			on_patch_mapped(static_cast<const MapPatchAction&>(action));
+			break;
 		case LoginState::FETCHING_CHARACTER_DATA:
 			on_character_data(static_cast<const FetchCharacterCounts&>(action));
 			break;
@@ -114,6 +127,10 @@ bool LoginHandler::update_state(const Action& action) try {
 void LoginHandler::initiate_login(const grunt::Packet& packet) {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
+	if(latency_.phases.enabled()) {
+		challenge_tsc_ = util::tsc::now();
+	}
+
 	auto& challenge = dynamic_cast<const grunt::client::LoginChallenge&>(packet);
 
 	/* 
@@ -229,7 +246,20 @@ grunt::server::LoginChallenge LoginHandler::build_login_challenge() {
 		packet.pin_salt = pin_salt_ = PINAuthenticator::generate_salt();
 	}
 
-	Botan::AutoSeeded_RNG().randomize(checksum_salt_.data(), checksum_salt_.size());
+	// use a precomputed salt & checksum if one's available, otherwise compute it during the proof
+	std::optional<IntegrityPool::Entry> entry;
+
+	if(integrity_enforce_) {
+		entry = integrity_pool_.pop(challenge_.version, challenge_.platform, challenge_.os);
+	}
+
+	if(entry) {
+		checksum_salt_ = entry->salt;
+		checksum_ = entry->checksum;
+	} else {
+		crypto::rng().randomize(checksum_salt_.data(), checksum_salt_.size());
+	}
+
 	packet.checksum_salt = checksum_salt_;
 	return packet;
 }
@@ -246,7 +276,7 @@ void LoginHandler::send_login_challenge(const FetchUserAction& action) {
 				metrics_.increment("login_failure");
 				LOG_DEBUG(logger_) << "Account not verified: {} " << user_->username() << LOG_ASYNC;
 			} else {
-				state_data_.emplace<LoginAuthenticator>(*user_);
+				state_data_.emplace<LoginAuthenticator>(*user_, ephemeral_pool_.pop());
 				response = build_login_challenge();
 				response.result = grunt::Result::SUCCESS;
 				update_state(LoginState::PROOF);
@@ -292,7 +322,7 @@ void LoginHandler::send_reconnect_challenge(const FetchSessionKeyAction& action)
 	grunt::server::ReconnectChallenge response;
 	response.result = grunt::Result::SUCCESS;
 
-	Botan::AutoSeeded_RNG().randomize(checksum_salt_.data(), checksum_salt_.size());
+	crypto::rng().randomize(checksum_salt_.data(), checksum_salt_.size());
 	response.salt = checksum_salt_;
 
 	const auto& [status, key] = action.get_result();
@@ -386,6 +416,8 @@ bool LoginHandler::validate_client_integrity(std::span<const std::uint8_t> clien
 	if(reconnect) {
 		constexpr std::array<std::uint8_t, SHA1_LENGTH> checksum{}; // all-zero hash
 		hash = client_integrity::finalise(checksum, salt);
+	} else if(checksum_) {
+		hash = client_integrity::finalise(*checksum_, salt);
 	} else {
 		const auto& checksum = client_integrity::checksum(checksum_salt_, *data);
 		hash = client_integrity::finalise(checksum, salt);
@@ -397,6 +429,12 @@ bool LoginHandler::validate_client_integrity(std::span<const std::uint8_t> clien
 void LoginHandler::handle_login_proof(const grunt::Packet& packet) {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
+	if(latency_.phases.enabled() && challenge_tsc_) {
+		proof_tsc_ = util::tsc::now();
+		latency_.phases.record(std::to_underlying(LoginPhase::CHALLENGE_TO_PROOF),
+		                       proof_tsc_ - challenge_tsc_);
+	}
+
 	auto& proof_packet = dynamic_cast<const grunt::client::LoginProof&>(packet);
 
 	if(!validate_client_integrity(proof_packet.client_checksum, proof_packet.A, false)) {
@@ -409,12 +447,28 @@ void LoginHandler::handle_login_proof(const grunt::Packet& packet) {
 		return;
 	}
 
+	/*
+	 * Deriving the session key and checking the proof is the expensive part
+	 * of the exchange, so it's handed off to the crypto pool rather than
+	 * being done on the network thread
+	 */
+	update_state(LoginState::VERIFYING_PROOF);
+
 	const auto& authenticator = std::get<LoginAuthenticator>(state_data_);
-	const auto key = authenticator.session_key(proof_packet.A);
-	auto proof = authenticator.expected_proof(key, proof_packet.A);
+
+	auto action = std::make_unique<VerifyProofAction>(
+		authenticator, proof_packet.A, proof_packet.M1
+	);
+
+	execute_async(std::move(action));
+}
+
+void LoginHandler::on_proof_verified(const VerifyProofAction& action) {
+	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
+
 	auto result = grunt::Result::FAIL_INCORRECT_PASSWORD;
-	
-	if(proof_packet.M1 == proof) {
+
+	if(action.get_result()) {
 		if(user_->banned()) {
 			result = grunt::Result::FAIL_BANNED;
 		} else if(user_->suspended()) {
@@ -430,14 +484,13 @@ void LoginHandler::handle_login_proof(const grunt::Packet& packet) {
 
 	if(result == grunt::Result::SUCCESS) {
 		update_state(LoginState::WRITING_SESSION);
-		server_proof_ = authenticator.server_proof(key, proof_packet.A, proof_packet.M1);
+		server_proof_ = action.server_proof();
 
-		auto action = std::make_unique<RegisterSessionAction>(
-			acct_svc_, user_->id(),
-			authenticator.session_key(proof_packet.A)
+		auto register_action = std::make_unique<RegisterSessionAction>(
+			acct_svc_, user_->id(), action.session_key()
 		);
 
-		execute_async(std::move(action));
+		execute_async(std::move(register_action));
 	} else {
 		send_login_proof(result);
 	}
@@ -474,6 +527,10 @@ void LoginHandler::on_character_data(const FetchCharacterCounts& action) {
 
 	update_state(LoginState::REQUEST_REALMS);
 
+	if(authenticated) {
+		authenticated();
+	}
+
 	if(action.reconnect()) {
 		send_reconnect_proof(grunt::Result::SUCCESS);
 		return;
@@ -490,6 +547,7 @@ void LoginHandler::on_character_data(const FetchCharacterCounts& action) {
 		LOG_DEBUG(logger_) << "Initiating survey transfer..." << LOG_ASYNC;
 		auto meta = survey_.meta(challenge_.platform, challenge_.os);
 		assert(meta);
+		transfer_state_.data = *survey_.data(challenge_.platform, challenge_.os);
 		initiate_file_transfer(*meta);
 	}
 }
@@ -502,6 +560,12 @@ void LoginHandler::on_session_write(const RegisterSessionAction& action) {
 
 	if(result == rpc::Account::Status::OK) {
 		update_state(LoginState::FETCHING_CHARACTER_DATA);
+
+		if(latency_.phases.enabled() && proof_tsc_) {
+			const auto now = util::tsc::now();
+			latency_.phases.record(std::to_underlying(LoginPhase::PROOF_TO_SESSION), now - proof_tsc_);
+			latency_.phases.record(std::to_underlying(LoginPhase::CHALLENGE_TO_SESSION), now - challenge_tsc_);
+		}
 	} else if(result == rpc::Account::Status::ALREADY_LOGGED_IN) {
 		response = grunt::Result::FAIL_ALREADY_ONLINE;
 	} else {
@@ -555,19 +619,9 @@ void LoginHandler::send_realm_list(const grunt::Packet& packet) {
 	}
 
 	const auto& [_, region] = *it;
-	const std::shared_ptr<const RealmMap> realms = realm_list_.realms();
 	const auto& char_count = std::get<CharacterCount>(state_data_);
-	grunt::server::RealmList response;
-
-	for(const auto& realm : *realms | std::views::values) {
-		if(!locale_enforce_ || realm.region == region) {
-			if(auto count = char_count.find(realm.id); count != char_count.end()) {
-				response.realms.emplace_back(realm, count->second);
-			} else {
-				response.realms.emplace_back(realm, 0);
-			}
-		}
-	}
+	auto body = realm_cache_.get(locale_enforce_? std::optional(region) : std::nullopt);
+	const CachedRealmList response(std::move(body), char_count);
 
 	update_state(LoginState::REQUEST_REALMS);
 	send(response);
@@ -584,23 +638,32 @@ void LoginHandler::patch_client(const grunt::client::LoginChallenge& challenge)
 		return;
 	}
 
+	// mapping the patch may hit the disk, so it's done on the thread pool
+	update_state(LoginState::FETCHING_PATCH);
+	execute_async(std::make_unique<MapPatchAction>(patch_cache_, std::move(*meta)));
+}
+
+void LoginHandler::on_patch_mapped(const MapPatchAction& action) {
+	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
+
 	grunt::server::LoginChallenge response;
 	response.result = grunt::Result::FAIL_VERSION_UPDATE;
 	send(response);
 
-	auto& fmeta = meta->file_meta;
+	const auto& meta = action.meta();
+	auto fmeta = meta.file_meta;
 
 	LOG_DEBUG(logger_) << "Initiating patch transfer, " << fmeta.name << LOG_ASYNC;
-	std::ifstream patch(fmeta.path + fmeta.name, std::ifstream::binary);
 
-	if(!patch) {
-		LOG_ERROR_ASYNC(logger_, "Could not open patch, {}", fmeta.name);
+	try {
+		transfer_state_.mapping = action.get_result();
+		transfer_state_.data = transfer_state_.mapping->data();
+	} catch(const std::exception& e) {
+		LOG_ERROR_ASYNC(logger_, "Could not open patch, {}: {}", fmeta.name, e.what());
 		return;
 	}
 
-	transfer_state_.file = std::move(patch);
-	
-	if(meta->mpq) {
+	if(meta.mpq) {
 		fmeta.name = "Patch";
 	}
 
@@ -676,7 +739,7 @@ void LoginHandler::handle_transfer_ack(const grunt::Packet& packet, bool survey)
 			[[fallthrough]];
 		case grunt::Opcode::CMD_XFER_ACCEPT:
 			update_state(survey? LoginState::SURVEY_TRANSFER : LoginState::PATCH_TRANSFER);
-			transfer_chunk();
+			transfer_chunks();
 			break;
 		case grunt::Opcode::CMD_XFER_CANCEL:
 			update_state(survey? LoginState::SURVEY_RESULT : LoginState::CLOSED);
@@ -692,60 +755,78 @@ void LoginHandler::handle_transfer_abort() {
 	transfer_state_.abort = true;
 }
 
-void LoginHandler::transfer_chunk() {
+/*
+ * Keeps up to transfer_window_ chunks queued on the session, topping
+ * the window back up as each chunk is sent. Chunks are views into the
+ * shared patch mapping or survey data, so nothing is read here.
+ */
+void LoginHandler::transfer_chunks() {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
-	auto remaining = transfer_state_.size - transfer_state_.offset;
-	std::uint16_t read_size = grunt::server::TransferData::MAX_CHUNK_SIZE;
-
-	if(read_size > remaining) {
-		read_size = gsl::narrow<std::uint16_t>(remaining);
+	if(transfer_state_.offset > transfer_state_.size) {
+		LOG_DEBUG_ASYNC(logger_, "Invalid transfer offset from {}", source_ip_);
+		update_state(LoginState::CLOSED);
+		return;
 	}
 
-	grunt::server::TransferData response;
-	response.size = read_size;
-
-	if(state_ == LoginState::SURVEY_TRANSFER) {
-		auto survey_mpq = survey_.data(challenge_.platform, challenge_.os)->begin();
-		survey_mpq += gsl::narrow<int>(transfer_state_.offset);
-		std::copy(survey_mpq, survey_mpq + read_size, response.chunk.data());
-	} else {
-		transfer_state_.file.read(reinterpret_cast<char*>(response.chunk.data()), read_size);
+	while(transfer_state_.in_flight < transfer_window_
+	      && transfer_state_.offset < transfer_state_.size) {
+		const auto remaining = transfer_state_.size - transfer_state_.offset;
+		std::uint16_t read_size = grunt::server::TransferData::MAX_CHUNK_SIZE;
 
-		if(!transfer_state_.file.good()) {
-			LOG_ERROR(logger_) << "Patch reading failed during transfer" << LOG_ASYNC;
-			return;
+		if(read_size > remaining) {
+			read_size = gsl::narrow<std::uint16_t>(remaining);
 		}
-	}
 
-	transfer_state_.offset += read_size;
+		grunt::server::TransferData response;
+		response.size = read_size;
+		response.chunk = transfer_state_.data.subspan(transfer_state_.offset, read_size);
+
+		transfer_state_.offset += read_size;
+		++transfer_state_.in_flight;
+
+		send_cb(response, [&]() {
+			on_chunk_complete();
+		});
+	}
 
-	send_cb(response, [&]() {
-		on_chunk_complete();
-	});
+	// resuming from the end leaves nothing to send, so no chunk will complete it
+	if(transfer_state_.offset == transfer_state_.size && !transfer_state_.in_flight) {
+		complete_transfer();
+	}
 }
 
 void LoginHandler::on_chunk_complete() {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
+	--transfer_state_.in_flight;
+
 	if(transfer_state_.abort) {
 		return;
 	}
 
 	// transfer complete?
 	if(transfer_state_.offset == transfer_state_.size) {
-		switch(state_) {
-			case LoginState::SURVEY_TRANSFER:
-				update_state(LoginState::SURVEY_RESULT);
-				break;
-			case LoginState::PATCH_TRANSFER:
-				update_state(LoginState::CLOSED);
-				break;
-			default:
-				break;
+		if(!transfer_state_.in_flight) {
+			complete_transfer();
 		}
 	} else {
-		transfer_chunk();
+		transfer_chunks();
+	}
+}
+
+void LoginHandler::complete_transfer() {
+	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
+
+	switch(state_) {
+		case LoginState::SURVEY_TRANSFER:
+			update_state(LoginState::SURVEY_RESULT);
+			break;
+		case LoginState::PATCH_TRANSFER:
+			update_state(LoginState::CLOSED);
+			break;
+		default:
+			break;
 	}
 }
 
@@ -13,6 +13,7 @@
 #include "GameVersion.h"
 #include "LoginHandlerFwd.h"
 #include "LoginState.h"
+#include "PatchCache.h"
 #include "PINAuthenticator.h"
 #include "grunt/PacketFwd.h"
 #include "grunt/client/LoginChallenge.h"
@@ -20,7 +21,6 @@
 #include <logger/LoggerFwd.h>
 #include <botan/bigint.h>
 #include <array>
-#include <fstream>
 #include <functional>
 #include <memory>
 #include <span>
@@ -33,9 +33,11 @@
 namespace ember {
 
 struct TransferState {
-	std::ifstream file;
+	std::shared_ptr<const PatchCache::Mapping> mapping;
+	std::span<const std::byte> data;
 	std::uint64_t offset;
 	std::uint64_t size;
+	std::size_t in_flight;
 	bool abort;
 };
 
@@ -51,26 +53,34 @@ class LoginHandler final {
 
 	LoginState state_ { LoginState::CHALLENGE };
 	Metrics& metrics_;
+	LoginLatency& latency_;
 	log::Logger& logger_;
 	const Patcher& patcher_;
-	const RealmList& realm_list_;
+	PatchCache& patch_cache_;
+	RealmListCache& realm_cache_;
 	const dal::UserDAO& user_src_;
 	const std::string source_ip_;
 	const AccountClient& acct_svc_;
 	const IntegrityData& bin_data_;
+	IntegrityPool& integrity_pool_;
+	EphemeralPool& ephemeral_pool_;
 	const Survey& survey_;
 
 	StateContainer state_data_;
 	std::optional<User> user_;
 	Botan::BigInt server_proof_;
 	std::array<std::uint8_t, CHECKSUM_SALT_LEN> checksum_salt_;
+	std::optional<std::array<std::uint8_t, 20>> checksum_;
 	PINAuthenticator::SaltBytes pin_salt_;
 	std::uint32_t pin_grid_seed_;
 	grunt::client::LoginChallenge challenge_;
 	TransferState transfer_state_;
+	const std::size_t transfer_window_;
 	const bool locale_enforce_;
 	const bool integrity_enforce_;
 	const bool require_verified_email_;
+	std::uint64_t challenge_tsc_;
+	std::uint64_t proof_tsc_;
 
 	void initiate_login(const grunt::Packet& packet);
 	void initiate_file_transfer(const FileMeta& meta);
@@ -88,11 +98,14 @@ class LoginHandler final {
 	void send_realm_list(const grunt::Packet& packet);
 	grunt::server::LoginChallenge build_login_challenge();
 
+	void on_proof_verified(const VerifyProofAction& action);
+	void on_patch_mapped(const MapPatchAction& action);
 	void on_character_data(const FetchCharacterCounts& action);
 	void on_session_write(const RegisterSessionAction& action);
 	void on_survey_write(const SaveSurveyAction& action);
 
-	void transfer_chunk();
+	void transfer_chunks();
+	void complete_transfer();
 	void set_transfer_offset(const grunt::Packet& packet);
 
 	bool validate_pin(const grunt::client::LoginProof& packet) const;
@@ -118,20 +131,25 @@ public:
 	std::function<void(std::unique_ptr<Action> action)> execute_async;
 	std::function<void(const grunt::Packet&)> send;
 	std::function<void(const grunt::Packet&, std::function<void()>)> send_cb;
+	std::function<void()> authenticated;
 
 	bool update_state(const Action& action);
 	bool update_state(const grunt::Packet& packet);
 	void on_chunk_complete();
 
 	LoginHandler(const dal::UserDAO& users, const AccountClient& acct_svc, const Patcher& patcher,
-	             const IntegrityData& bin_data, const Survey& survey, log::Logger& logger,
-	             const RealmList& realm_list, std::string source, Metrics& metrics,
-	             bool locale_enforce, bool integrity_enforce, bool verified_email)
-	             : user_src_(users), patcher_(patcher), logger_(logger), acct_svc_(acct_svc),
-	               realm_list_(realm_list), source_ip_(std::move(source)), metrics_(metrics),
-	               bin_data_(bin_data), survey_(survey), transfer_state_{},
-	               locale_enforce_(locale_enforce), integrity_enforce_(integrity_enforce),
-	               require_verified_email_(verified_email), pin_grid_seed_(0) { }
+	             PatchCache& patch_cache, const IntegrityData& bin_data, IntegrityPool& integrity_pool,
+	             EphemeralPool& ephemeral_pool, const Survey& survey, log::Logger& logger,
+	             RealmListCache& realm_cache, std::string source, Metrics& metrics,
+	             LoginLatency& latency, std::size_t transfer_window, bool locale_enforce,
+	             bool integrity_enforce, bool verified_email)
+	             : user_src_(users), patcher_(patcher), patch_cache_(patch_cache), logger_(logger), acct_svc_(acct_svc),
+	               realm_cache_(realm_cache), source_ip_(std::move(source)), metrics_(metrics),
+	               latency_(latency), bin_data_(bin_data), integrity_pool_(integrity_pool),
+	               ephemeral_pool_(ephemeral_pool), survey_(survey), transfer_state_{},
+	               transfer_window_(transfer_window), locale_enforce_(locale_enforce), integrity_enforce_(integrity_enforce),
+	               require_verified_email_(verified_email), pin_grid_seed_(0),
+	               challenge_tsc_(0), proof_tsc_(0) { }
 };
 
 } // ember
\ No newline at end of file
@@ -16,30 +16,43 @@ namespace ember {
 class LoginHandlerBuilder final {
 	log::Logger& logger_;
 	const Patcher& patcher_;
-	const RealmList& realm_list_;
+	PatchCache& patch_cache_;
+	RealmListCache& realm_cache_;
 	const dal::UserDAO& user_dao_;
 	const AccountClient &acct_svc_;
 	const Survey& survey_;
 	const IntegrityData& bin_data_;
+	IntegrityPool& integrity_pool_;
+	EphemeralPool& ephemeral_pool_;
 	Metrics& metrics_;
+	LoginLatency& latency_;
+	std::size_t transfer_window_;
 	bool locale_enforce_;
 	bool integrity_enforce_;
 	bool verified_email_;
 
 public:
-	LoginHandlerBuilder(log::Logger& logger, const Patcher& patcher, const Survey& survey,
-	                    const IntegrityData& exe_data, const dal::UserDAO& user_dao,
-	                    const AccountClient& acct_svc, const RealmList& realm_list,
-	                    Metrics& metrics, bool locale_enforce, bool integrity_enforce,
-	                    bool verified_email)
-	                    : logger_(logger), patcher_(patcher), user_dao_(user_dao),
-	                      acct_svc_(acct_svc), realm_list_(realm_list), metrics_(metrics),
-	                      survey_(survey), bin_data_(exe_data), locale_enforce_(locale_enforce),
+	LoginHandlerBuilder(log::Logger& logger, const Patcher& patcher, PatchCache& patch_cache,
+	                    const Survey& survey,
+	                    const IntegrityData& exe_data, IntegrityPool& integrity_pool,
+	                    EphemeralPool& ephemeral_pool, const dal::UserDAO& user_dao,
+	                    const AccountClient& acct_svc, RealmListCache& realm_cache,
+	                    Metrics& metrics, LoginLatency& latency,
+	                    std::size_t transfer_window, bool locale_enforce,
+	                    bool integrity_enforce, bool verified_email)
+	                    : logger_(logger), patcher_(patcher), patch_cache_(patch_cache),
+	                      user_dao_(user_dao),
+	                      acct_svc_(acct_svc), realm_cache_(realm_cache), metrics_(metrics),
+	                      latency_(latency), transfer_window_(transfer_window),
+	                      survey_(survey), bin_data_(exe_data), integrity_pool_(integrity_pool),
+	                      ephemeral_pool_(ephemeral_pool), locale_enforce_(locale_enforce),
 	                      integrity_enforce_(integrity_enforce), verified_email_(verified_email) {}
 
 	LoginHandler create(std::string source) const {
-		return { user_dao_, acct_svc_, patcher_, bin_data_, survey_, logger_, realm_list_,
-		         std::move(source), metrics_, locale_enforce_, integrity_enforce_, verified_email_ };
+		return { user_dao_, acct_svc_, patcher_, patch_cache_, bin_data_, integrity_pool_,
+		         ephemeral_pool_, survey_, logger_, realm_cache_, std::move(source), metrics_,
+		         latency_, transfer_window_, locale_enforce_, integrity_enforce_,
+		         verified_email_ };
 	}
 };
 
@@ -12,11 +12,15 @@ namespace ember {
 
 struct FileMeta;
 class Patcher;
+class PatchCache;
 class Metrics;
+struct LoginLatency;
 class Survey;
 class IntegrityData;
+class IntegrityPool;
+class EphemeralPool;
 class AccountClient;
-class RealmList;
+class RealmListCache;
 namespace dal { class UserDAO; }
 
 } // ember
\ No newline at end of file
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "LoginLatency.h"
+#include <utility>
+
+namespace ember {
+
+std::string to_string(const LoginState state) {
+	switch(state) {
+		case LoginState::CHALLENGE:
+			return "challenge";
+		case LoginState::PROOF:
+			return "proof";
+		case LoginState::RECONNECT_PROOF:
+			return "reconnect_proof";
+		case LoginState::REQUEST_REALMS:
+			return "request_realms";
+		case LoginState::SURVEY_INITIATE:
+			return "survey_initiate";
+		case LoginState::SURVEY_TRANSFER:
+			return "survey_transfer";
+		case LoginState::SURVEY_RESULT:
+			return "survey_result";
+		case LoginState::PATCH_INITIATE:
+			return "patch_initiate";
+		case LoginState::PATCH_TRANSFER:
+			return "patch_transfer";
+		case LoginState::FETCHING_USER_LOGIN:
+			return "fetching_user_login";
+		case LoginState::FETCHING_USER_RECONNECT:
+			return "fetching_user_reconnect";
+		case LoginState::FETCHING_SESSION:
+			return "fetching_session";
+		case LoginState::FETCHING_CHARACTER_DATA:
+			return "fetching_character_data";
+		case LoginState::FETCHING_PATCH:
+			return "fetching_patch";
+		case LoginState::VERIFYING_PROOF:
+			return "verifying_proof";
+		case LoginState::WRITING_SESSION:
+			return "writing_session";
+		case LoginState::WRITING_SURVEY:
+			return "writing_survey";
+		case LoginState::CLOSED:
+			return "closed";
+	}
+
+	return "unknown";
+}
+
+std::string to_string(const LoginPhase phase) {
+	switch(phase) {
+		case LoginPhase::CHALLENGE_TO_PROOF:
+			return "challenge_to_proof";
+		case LoginPhase::PROOF_TO_SESSION:
+			return "proof_to_session";
+		case LoginPhase::CHALLENGE_TO_SESSION:
+			return "challenge_to_session";
+		case LoginPhase::MAX:
+			break;
+	}
+
+	return "unknown";
+}
+
+LoginLatency::LoginLatency(const bool enabled)
+	: states("login_states", std::to_underlying(LoginState::CLOSED) + 1, [](const std::size_t key) {
+		  return to_string(static_cast<LoginState>(key));
+	  }, enabled),
+	  phases("login_phases", std::to_underlying(LoginPhase::MAX), [](const std::size_t key) {
+		  return to_string(static_cast<LoginPhase>(key));
+	  }, enabled) {}
+
+} // ember
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "LoginState.h"
+#include <shared/metrics/LatencyTracker.h>
+#include <string>
+#include <cstddef>
+
+namespace ember {
+
+enum class LoginPhase {
+	CHALLENGE_TO_PROOF,   // includes the client's round trip & key derivation
+	PROOF_TO_SESSION,     // proof verification & registering the session key
+	CHALLENGE_TO_SESSION, // the whole handshake, as far as we can see it
+
+	MAX
+};
+
+std::string to_string(LoginState state);
+std::string to_string(LoginPhase phase);
+
+/*
+ * Opt-in timings for the login handler, shared by all sessions.
+ * states covers the time spent in each state's handler, phases the
+ * end-to-end progress of a login through the handshake.
+ */
+struct LoginLatency {
+	LatencyTracker states;
+	LatencyTracker phases;
+
+	explicit LoginLatency(bool enabled);
+};
+
+} // ember
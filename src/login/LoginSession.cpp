@@ -20,12 +20,16 @@
 
 namespace ember {
 
-LoginSession::LoginSession(SessionManager& sessions, tcp_socket socket, log::Logger& logger,
-                           ThreadPool& pool, const LoginHandlerBuilder& builder)
+LoginSession::LoginSession(SessionManager& sessions, tcp_socket socket,
+                           AdmissionControl::Ticket ticket, log::Logger& logger,
+                           ThreadPool& pool, ThreadPool& crypto_pool,
+                           const LoginHandlerBuilder& builder)
                            : NetworkSession(sessions, std::move(socket), logger),
                              handler_(builder.create(remote_address())),
                              logger_(logger),
                              pool_(pool),
+                             crypto_pool_(crypto_pool),
+                             ticket_(std::move(ticket)),
                              grunt_handler_(logger) {
 	handler_.send = [&](auto& packet) {
 		write_packet(packet, nullptr);
@@ -38,33 +42,43 @@ LoginSession::LoginSession(SessionManager& sessions, tcp_socket socket, log::Log
 	handler_.execute_async = [&](auto action) {
 		execute_async(std::move(action));
 	};
+
+	// the handshake slot is only needed until the client has authenticated
+	handler_.authenticated = [&]() {
+		ticket_.release();
+	};
 }
 
-bool LoginSession::handle_packet(spark::io::pmr::Buffer& buffer) try {
+bool LoginSession::handle_packet(spark::io::pmr::Buffer& buffer) {
 	LOG_TRACE(logger_) << log_func << LOG_ASYNC;
 
-	auto result = grunt_handler_.process_buffer(buffer);
+	const auto result = grunt_handler_.process_buffer(buffer);
+
+	if(!result) {
+		LOG_DEBUG(logger_) << remote_address() << " sent bad data ("
+			<< grunt::to_string(result.error()) << ")" << LOG_ASYNC;
+		return false;
+	}
 
-	if(result) {
-		const auto& packet = result->get();
+	if(*result) {
+		const auto& packet = result->value().get();
 		LOG_TRACE(logger_) << remote_address() << " -> "
 			<< grunt::to_string(packet.opcode) << LOG_ASYNC;
 		return handler_.update_state(packet);
 	}
 
 	return true;
-} catch(grunt::bad_packet& e) {
-	LOG_DEBUG(logger_) << e.what() << LOG_ASYNC;
-	return false;
 }
 
 void LoginSession::execute_async(std::unique_ptr<Action> action) {
 	LOG_TRACE_FILTER(logger_, LF_NETWORK) << log_func << LOG_ASYNC;
 
 	auto self(shared_from_this());
+	const auto priority = action->priority();
+	auto& pool = action->cpu_bound()? crypto_pool_ : pool_;
 	std::shared_ptr<Action> shared_act(std::move(action));
 
-	pool_.run([&, action = std::move(shared_act), self]() mutable {
+	const auto admitted = pool.try_run([&, action = std::move(shared_act), self]() mutable {
 		action->execute();
 
 		boost::asio::post(get_executor(), [&, action = std::move(action), self] {
@@ -72,7 +86,13 @@ void LoginSession::execute_async(std::unique_ptr<Action> action) {
 				async_completion(*action.get());
 			}
 		});
-	});
+	}, priority);
+
+	// the pools are backed up, better to turn this client away than add to it
+	if(!admitted) {
+		LOG_DEBUG(logger_) << "Work queue full, closing " << remote_address() << LOG_ASYNC;
+		close_session();
+	}
 }
 
 void LoginSession::async_completion(Action& action) try {
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "AdmissionControl.h"
 #include "LoginHandler.h"
 #include "NetworkSession.h"
 #include "SocketType.h"
@@ -25,6 +26,8 @@ class ThreadPool;
 
 class LoginSession final : public NetworkSession<LoginSession> {
 	ThreadPool& pool_;
+	ThreadPool& crypto_pool_;
+	AdmissionControl::Ticket ticket_;
 	LoginHandler handler_;
 	log::Logger& logger_;
 	grunt::Handler grunt_handler_;
@@ -34,8 +37,9 @@ class LoginSession final : public NetworkSession<LoginSession> {
 	void execute_async(std::unique_ptr<Action> action);
 
 public:
-	LoginSession(SessionManager& sessions, tcp_socket socket, log::Logger& logger,
-	             ThreadPool& pool, const LoginHandlerBuilder& builder);
+	LoginSession(SessionManager& sessions, tcp_socket socket,
+	             AdmissionControl::Ticket ticket, log::Logger& logger,
+	             ThreadPool& pool, ThreadPool& crypto_pool, const LoginHandlerBuilder& builder);
 
 	bool handle_packet(spark::io::pmr::Buffer& buffer);
 };
@@ -27,6 +27,9 @@ enum class LoginState {
 	FETCHING_USER_RECONNECT,
 	FETCHING_SESSION,
 	FETCHING_CHARACTER_DATA,
+	FETCHING_PATCH,
+
+	VERIFYING_PROOF,
 
 	WRITING_SESSION,
 	WRITING_SURVEY,
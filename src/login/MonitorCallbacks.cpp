@@ -9,7 +9,12 @@
 #include "FilterTypes.h"
 #include "MonitorCallbacks.h"
 #include "NetworkListener.h"
+#include <shared/IPBanCache.h>
+#include <shared/database/daos/shared_base/IPBanBase.h>
+#include <exception>
+#include <format>
 #include <sstream>
+#include <string>
 
 namespace ember {
 
@@ -31,6 +36,23 @@ void install_net_monitor(Monitor& monitor, const NetworkListener& server, log::L
 
 }
 
+/*
+ * Allows bans added directly to the database to be picked up by
+ * sending 'bans reload' to the monitor, without a restart
+ */
+void install_ban_commands(Monitor& monitor, IPBanCache& bans, const dal::IPBanDAO& dao,
+                          log::Logger& logger) {
+	monitor.add_command("bans reload", [&]() -> std::string {
+		try {
+			bans.reload(dao.all_bans());
+			LOG_INFO_ASYNC(logger, "IP ban list reloaded by monitor command, {} entries", bans.size());
+			return std::format("OK; {} entries", bans.size());
+		} catch(const std::exception& e) {
+			return std::format("ERROR; {}", e.what());
+		}
+	});
+}
+
 void monitor_log_callback(const Monitor::Source& source, Monitor::Severity severity,
                           std::intmax_t value, log::Logger& logger) {
 	std::stringstream message;
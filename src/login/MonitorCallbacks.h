@@ -18,8 +18,12 @@ namespace ember {
 using namespace std::chrono_literals;
 
 class NetworkListener;
+class IPBanCache;
+namespace dal { class IPBanDAO; }
 
 void install_net_monitor(Monitor& monitor, const NetworkListener& server, log::Logger& logger);
+void install_ban_commands(Monitor& monitor, IPBanCache& bans, const dal::IPBanDAO& dao,
+                          log::Logger& logger);
 void monitor_log_callback(const Monitor::Source& source, Monitor::Severity severity,
                           std::intmax_t value, log::Logger& logger);
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "AdmissionControl.h"
 #include "FilterTypes.h"
 #include "NetworkSession.h"
 #include "SessionBuilders.h"
@@ -40,6 +41,7 @@ class NetworkListener final {
 	log::Logger& logger_;
 	Metrics& metrics_;
 	IPBanCache& ban_list_;
+	AdmissionControl& admission_;
 
 	void accept_connection() {
 		LOG_TRACE_FILTER(logger_, LF_NETWORK) << log_func << LOG_ASYNC;
@@ -65,16 +67,21 @@ class NetworkListener final {
 
 				const auto& ip = ep.address();
 
-				if(!ban_list_.is_banned(ip)) {
-					LOG_DEBUG_FILTER(logger_, LF_NETWORK)
-						<< "Accepted connection " << ip.to_string() << LOG_ASYNC;
-					metrics_.increment("accepted_connections");
-					start_session(std::move(socket_));
-				} else {
+				if(ban_list_.is_banned(ip)) {
 					LOG_DEBUG_FILTER(logger_, LF_NETWORK)
 						<< "Rejected connection " << ip.to_string()
 						<< " from banned IP range" << LOG_ASYNC;
 					metrics_.increment("rejected_connections");
+				} else if(auto ticket = admission_.admit(ip); !ticket) {
+					LOG_DEBUG_FILTER(logger_, LF_NETWORK)
+						<< "Rejected connection " << ip.to_string() << ", "
+						<< to_string(ticket.error()) << LOG_ASYNC;
+					metrics_.increment(admission_metric(ticket.error()));
+				} else {
+					LOG_DEBUG_FILTER(logger_, LF_NETWORK)
+						<< "Accepted connection " << ip.to_string() << LOG_ASYNC;
+					metrics_.increment("accepted_connections");
+					start_session(std::move(socket_), std::move(*ticket));
 				}
 			}
 
@@ -83,16 +90,28 @@ class NetworkListener final {
 		});
 	}
 
-	void start_session(tcp_socket socket) {
+	void start_session(tcp_socket socket, AdmissionControl::Ticket ticket) {
 		LOG_TRACE_FILTER(logger_, LF_NETWORK) << log_func << LOG_ASYNC;
-		auto session = session_builder_.create(sessions_, std::move(socket), logger_);
+		auto session = session_builder_.create(sessions_, std::move(socket),
+		                                       std::move(ticket), logger_);
 		sessions_.start(session);
 	}
 
+	static const char* admission_metric(const AdmissionControl::Rejection rejection) {
+		switch(rejection) {
+			case AdmissionControl::Rejection::IP_RATE_LIMITED:
+				return "admission_rejected_ip";
+			case AdmissionControl::Rejection::SUBNET_RATE_LIMITED:
+				return "admission_rejected_subnet";
+			default:
+				return "admission_rejected_handshakes";
+		}
+	}
+
 public:
 	NetworkListener(boost::asio::io_context& io_context, const std::string& interface, std::uint16_t port,
 	                bool tcp_no_delay, const NetworkSessionBuilder& session_create, IPBanCache& bans,
-	                log::Logger& logger, Metrics& metrics)
+	                AdmissionControl& admission, log::Logger& logger, Metrics& metrics)
 	                : acceptor_(io_context, boost::asio::ip::tcp::endpoint(
 	                            boost::asio::ip::address::from_string(interface), port)),
 	                  io_context_(io_context),
@@ -100,7 +119,8 @@ public:
 	                  session_builder_(session_create),
 	                  logger_(logger),
 	                  metrics_(metrics),
-	                  ban_list_(bans) {
+	                  ban_list_(bans),
+	                  admission_(admission) {
 		acceptor_.set_option(boost::asio::ip::tcp::no_delay(tcp_no_delay));
 		acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
 		accept_connection();
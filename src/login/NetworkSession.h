@@ -16,8 +16,8 @@
 #include <spark/buffers/DynamicBuffer.h>
 #include <spark/buffers/BufferSequence.h>
 #include <shared/memory/ASIOAllocator.h>
+#include <shared/threading/TimingWheel.h>
 #include <boost/asio/io_context.hpp>
-#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <array>
 #include <chrono>
@@ -25,6 +25,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #include <cstdint>
 
 namespace ember {
@@ -37,19 +38,28 @@ public:
 private:
 	using Buffer = spark::io::DynamicBuffer<1024>;
 
+	/*
+	 * Write callbacks are held alongside the buffer their data was
+	 * written to and are only invoked once that buffer has been sent,
+	 * allowing callers to use them for flow control
+	 */
+	struct Outbound {
+		Buffer buffer;
+		std::vector<WriteCallback> callbacks;
+	};
+
 	const std::chrono::seconds SOCKET_ACTIVITY_TIMEOUT { 60 };
 	ASIOAllocator<thread_safe> allocator_;
 
 	SessionManager& sessions_;
 	tcp_socket socket_;
-	boost::asio::steady_timer timer_;
+	TimingWheel::Handle idle_timer_;
 
 	Buffer inbound_buffer_;
-	Buffer* outbound_front_;
-	Buffer* outbound_back_;
-	std::array<Buffer, 2> outbound_buffers_{};
+	Outbound* outbound_front_;
+	Outbound* outbound_back_;
+	std::array<Outbound, 2> outbound_buffers_{};
 	bool write_in_progress_;
-	bool is_active_;
 
 	log::Logger& logger_;
 	bool stopped_;
@@ -65,7 +75,7 @@ private:
 			inbound_buffer_.push_back(tail);
 		}
 
-		set_is_active(true);
+		idle_timer_.touch();
 
 		socket_.async_receive(boost::asio::buffer(tail->write_data(), tail->free()), 
 			create_alloc_handler(allocator_,
@@ -89,30 +99,32 @@ private:
 		));
 	}
 
-	void write(WriteCallback cb) {
+	void write() {
 		auto self(this->shared_from_this());
-		const spark::io::BufferSequence sequence(*outbound_front_);
+		const spark::io::BufferSequence sequence(outbound_front_->buffer);
 
-		set_is_active(true);
+		idle_timer_.touch();
 
 		socket_.async_send(sequence, create_alloc_handler(allocator_,
-			[this, self, cb = std::move(cb)](boost::system::error_code ec, std::size_t size) mutable {
-			outbound_front_->skip(size);
+			[this, self](boost::system::error_code ec, std::size_t size) mutable {
+			outbound_front_->buffer.skip(size);
 
 			if(!ec) {
-				if(!outbound_front_->empty()) {
-					write(std::move(cb)); // entire buffer wasn't sent, hit gather-write limits?
+				if(!outbound_front_->buffer.empty()) {
+					write(); // entire buffer wasn't sent, hit gather-write limits?
 				} else {
+					auto callbacks = std::move(outbound_front_->callbacks);
+					outbound_front_->callbacks.clear();
 					std::swap(outbound_front_, outbound_back_);
 
-					if(!outbound_front_->empty()) {
-						write(std::move(cb));
+					if(!outbound_front_->buffer.empty()) {
+						write();
 					} else { // all done!
 						write_in_progress_ = false;
-					
-						if(cb) {
-							cb();
-						}
+					}
+
+					for(auto& cb : callbacks) {
+						cb();
 					}
 				}
 			} else if(ec != boost::asio::error::operation_aborted) {
@@ -122,46 +134,33 @@ private:
 	}
 
 	/*
-	 * Timeout works by starting a timer that elapses every n seconds
-	 * and checks whether any activity has occured on the socket since
-	 * the last run. If not, the connection is considered inactive and
-	 * will be closed. Any activity marks the socket as active, with
-	 * the timer setting it back to inactive each time it elapses.
-	 * 
-	 * The previous method restarted the timer on any activity but restarting
-	 * the timer on every packet is expensive. The only drawback
-	 * is that the timeout won't be as precise but the upperbound will
-	 * be roughly n*2, except in the case where the socket has never sent
-	 * any data at all (still n). Acceptable!
+	 * Idle timeouts are tracked by the io_context's timing wheel rather
+	 * than a timer per session. Any socket activity pushes the deadline
+	 * back, which only stores a timestamp, and the wheel closes sessions
+	 * that haven't seen any activity for the timeout period.
 	 * 
-	 * Better yet would be a single timer per thread but this is complicated
-	 * by the way the threading model and session lifetime management has
-	 * been designed for the login service.
+	 * The wheel only holds a weak reference, so it won't keep a session
+	 * alive past its closure. Expiry is handed back to the session's strand.
 	 */
 	void start_timer() {
-		auto self(this->shared_from_this());
-		set_is_active(false);
-
-		timer_.expires_from_now(SOCKET_ACTIVITY_TIMEOUT);
-		timer_.async_wait([this, self](const boost::system::error_code& ec) {
-			if(ec == boost::asio::error::operation_aborted) {
-				return;
-			}
-
-			if(is_active_) {
-				start_timer();
-			} else {
-				timeout(ec);
+		std::weak_ptr<NetworkSession> weak = this->shared_from_this();
+		auto& wheel = TimingWheel::get(socket_.get_executor().get_inner_executor().context());
+
+		idle_timer_ = wheel.schedule(SOCKET_ACTIVITY_TIMEOUT, [weak] {
+			if(auto self = weak.lock()) {
+				boost::asio::post(self->socket_.get_executor(), [self] {
+					self->timeout();
+				});
 			}
 		});
 	}
 
 	void stop_timer() {
-		timer_.cancel();
+		idle_timer_.cancel();
 	}
 
-	void timeout(const boost::system::error_code& ec) {
-		if(ec || stopped_) { // if ec is set, the timer was aborted (session close / refreshed)
+	void timeout() {
+		if(stopped_) {
 			return;
 		}
 
@@ -171,26 +170,20 @@ private:
 		close_session();
 	}
 
-	void set_is_active(const bool state) {
-		is_active_ = state;
-	}
-
 public:
 	NetworkSession(SessionManager& sessions, tcp_socket socket, log::Logger& logger)
 	               : sessions_(sessions),
 	                 socket_(std::move(socket)),
-	                 timer_(socket_.get_executor()),
 	                 outbound_front_(&outbound_buffers_.front()),
 	                 outbound_back_(&outbound_buffers_.back()),
 	                 write_in_progress_(false),
-	                 is_active_(false),
 	                 logger_(logger),
 	                 stopped_(false),
 	                 address_(socket_.remote_endpoint().address()) {}
 
 	void start() {
-		read();
 		start_timer();
+		read();
 	}
 
 	std::string remote_address() const {
@@ -206,15 +199,17 @@ public:
 			return;
 		}
 
-		spark::io::pmr::BinaryStream stream(*outbound_back_);
+		spark::io::pmr::BinaryStream stream(outbound_back_->buffer);
 		data.write_to_stream(stream); // todo, provide operator<< for packets?
 
+		if(cb) {
+			outbound_back_->callbacks.emplace_back(std::move(cb));
+		}
+
 		if(!write_in_progress_) {
 			write_in_progress_ = true;
 			std::swap(outbound_front_, outbound_back_);
-			write(std::move(cb));
-		} else {
-			cb();
+			write();
 		}
 	}
 
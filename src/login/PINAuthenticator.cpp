@@ -8,6 +8,7 @@
 
 #include "PINAuthenticator.h"
 #include <logger/Logger.h>
+#include <srp6/crypto/ThreadLocal.h>
 #include <shared/utility/xoroshiro128plus.h>
 #include <shared/utility/base32.h>
 #include <boost/assert.hpp>
@@ -115,15 +116,15 @@ auto PINAuthenticator::calculate_hash(const SaltBytes& server_salt,
 
 	// x = H(client_salt | H(server_salt | ascii(pin_bytes)))
 	HashBytes hash;
-	auto hasher = Botan::HashFunction::create_or_throw("SHA-1");
-	BOOST_ASSERT_MSG(hasher->output_length() == hash.size(), "Bad hash size");
-	hasher->update(server_salt.data(), server_salt.size());
-	hasher->update(pin_bytes_.data(), pin_bytes_.size());
-	hasher->final(hash.data());
-
-	hasher->update(client_salt.data(), client_salt.size());
-	hasher->update(hash.data(), hash.size());
-	hasher->final(hash.data());
+	auto& hasher = crypto::hasher(crypto::Hash::SHA1);
+	BOOST_ASSERT_MSG(hasher.output_length() == hash.size(), "Bad hash size");
+	hasher.update(server_salt.data(), server_salt.size());
+	hasher.update(pin_bytes_.data(), pin_bytes_.size());
+	hasher.final(hash.data());
+
+	hasher.update(client_salt.data(), client_salt.size());
+	hasher.update(hash.data(), hash.size());
+	hasher.final(hash.data());
 	return hash;
 }
 
@@ -153,17 +154,17 @@ std::uint32_t PINAuthenticator::generate_totp_pin(const std::string& secret,
 	auto step = static_cast<std::uint64_t>((std::floor(now / 30))) + interval;
 
 	HashBytes hmac_result;
-	auto hmac = Botan::MessageAuthenticationCode::create_or_throw("HMAC(SHA-1)");
-	BOOST_ASSERT_MSG(hmac->output_length() == hmac_result.size(), "Bad hash size");
-	hmac->set_key(decoded_key.data(), key_size);
+	auto& hmac = crypto::mac(crypto::Mac::HMAC_SHA1);
+	BOOST_ASSERT_MSG(hmac.output_length() == hmac_result.size(), "Bad hash size");
+	hmac.set_key(decoded_key.data(), key_size);
 
 	if constexpr(std::endian::native == std::endian::little) {
-		hmac->update_be(step);
+		hmac.update_be(step);
 	} else {
-		hmac->update_le(step);
+		hmac.update_le(step);
 	}
 
-	hmac->final(hmac_result.data());
+	hmac.final(hmac_result.data());
 
 	const unsigned int offset = hmac_result[19] & 0xF;
 	std::uint32_t pin = (hmac_result[offset] & 0x7f) << 24 | (hmac_result[offset + 1] & 0xff) << 16
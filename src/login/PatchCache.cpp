@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "PatchCache.h"
+#include <stdexcept>
+#include <string>
+
+namespace bip = boost::interprocess;
+
+namespace ember {
+
+PatchCache::Mapping::Mapping(const FileMeta& meta)
+	: file_((meta.path + meta.name).c_str(), bip::read_only),
+	  region_(file_, bip::read_only) {
+	if(region_.get_size() != meta.size) {
+		throw std::runtime_error("Patch size mismatch, " + meta.name);
+	}
+
+	region_.advise(bip::mapped_region::advice_willneed);
+
+	// touch every page so the reads happen here rather than on a network thread
+	const auto page_size = bip::mapped_region::get_page_size();
+	const auto bytes = static_cast<const volatile std::byte*>(region_.get_address());
+
+	for(std::size_t i = 0; i < region_.get_size(); i += page_size) {
+		(void)bytes[i];
+	}
+}
+
+std::span<const std::byte> PatchCache::Mapping::data() const {
+	return { static_cast<const std::byte*>(region_.get_address()), region_.get_size() };
+}
+
+std::shared_ptr<const PatchCache::Mapping> PatchCache::acquire(const PatchMeta& meta) {
+	{
+		std::lock_guard guard(lock_);
+
+		if(auto it = mappings_.find(meta.id); it != mappings_.end()) {
+			return it->second;
+		}
+	}
+
+	// map outside of the lock, a duplicate mapping in a race is harmless
+	auto mapping = std::make_shared<const Mapping>(meta.file_meta);
+
+	std::lock_guard guard(lock_);
+	const auto& [it, _] = mappings_.emplace(meta.id, std::move(mapping));
+	return it->second;
+}
+
+std::size_t PatchCache::size() const {
+	std::lock_guard guard(lock_);
+	return mappings_.size();
+}
+
+} // ember
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <shared/database/objects/PatchMeta.h>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Memory maps patch files on first use and shares the mapping between
+ * all sessions transferring the same patch, so transfer chunks can be
+ * sent straight from the page cache without each session holding
+ * its own file handle & read buffer.
+ *
+ * acquire() may block on disk, so it must not be called from a
+ * network thread. Newly mapped files are prefaulted before being
+ * returned so the network threads don't end up doing the reads
+ * via page faults instead.
+ */
+class PatchCache final {
+public:
+	class Mapping final {
+		boost::interprocess::file_mapping file_;
+		boost::interprocess::mapped_region region_;
+
+	public:
+		explicit Mapping(const FileMeta& meta);
+
+		std::span<const std::byte> data() const;
+	};
+
+private:
+	mutable std::mutex lock_;
+	std::unordered_map<std::uint32_t, std::shared_ptr<const Mapping>> mappings_;
+
+public:
+	std::shared_ptr<const Mapping> acquire(const PatchMeta& meta);
+	std::size_t size() const;
+};
+
+} // ember
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "RealmListCache.h"
+#include "grunt/server/RealmList.h"
+#include <spark/buffers/pmr/BinaryStream.h>
+#include <spark/buffers/pmr/BufferAdaptor.h>
+#include <boost/assert.hpp>
+#include <boost/endian/conversion.hpp>
+#include <gsl/gsl_util>
+#include <algorithm>
+#include <ranges>
+#include <utility>
+#include <cstring>
+
+namespace ember {
+
+auto RealmListCache::build(std::shared_ptr<const RealmMap> realms,
+                           const std::optional<Region> region) -> std::shared_ptr<const Body> {
+	auto body = std::make_shared<Body>();
+	spark::io::pmr::BufferAdaptor adaptor(body->data);
+	spark::io::pmr::BinaryStream stream(adaptor);
+
+	std::vector<const Realm*> entries;
+
+	for(const auto& realm : *realms | std::views::values) {
+		if(!region || realm.region == *region) {
+			entries.emplace_back(&realm);
+		}
+	}
+
+	// the map is unordered, so sort to keep the client's list stable between rebuilds
+	std::ranges::sort(entries, {}, &Realm::id);
+
+	const grunt::server::RealmList defaults;
+	stream << grunt::Opcode::CMD_REALM_LIST;
+	stream << std::uint16_t(0); // size placeholder
+	stream << defaults.unknown;
+	stream << gsl::narrow<std::uint8_t>(entries.size());
+
+	for(const auto realm : entries) {
+		const auto offset = grunt::server::RealmList::write_entry(stream, *realm, 0);
+		body->slots.emplace_back(realm->id, offset);
+	}
+
+	stream << defaults.unknown2;
+
+	const auto size = boost::endian::native_to_little(
+		gsl::narrow<std::uint16_t>(body->data.size() - 3)
+	);
+
+	std::memcpy(body->data.data() + 1, &size, sizeof(size));
+	body->source = std::move(realms);
+	return body;
+}
+
+auto RealmListCache::get(const std::optional<Region> region) -> std::shared_ptr<const Body> {
+	auto realms = realm_list_.realms();
+
+	{
+		std::lock_guard guard(lock_);
+		auto it = bodies_.find(region);
+
+		if(it != bodies_.end() && it->second->source == realms) {
+			return it->second;
+		}
+	}
+
+	// stale or missing, rebuild outside of the lock - concurrent rebuilds are harmless
+	auto body = build(std::move(realms), region);
+
+	std::lock_guard guard(lock_);
+	auto& entry = bodies_[region];
+
+	if(!entry || entry->source != body->source) {
+		entry = body;
+	}
+
+	return body;
+}
+
+auto CachedRealmList::read_from_stream(spark::io::pmr::BinaryStream&) -> State {
+	BOOST_ASSERT_MSG(false, "Cached realm lists are write-only");
+	return State::ERRORED;
+}
+
+void CachedRealmList::write_to_stream(spark::io::pmr::BinaryStream& stream) const {
+	const auto& data = body_->data;
+	std::size_t written = 0;
+
+	for(const auto& [realm_id, offset] : body_->slots) {
+		stream.put(data.data() + written, offset - written);
+
+		std::uint32_t characters = 0;
+
+		if(auto it = counts_.find(realm_id); it != counts_.end()) {
+			characters = it->second;
+		}
+
+		stream << gsl::narrow_cast<std::uint8_t>(characters);
+		written = offset + 1;
+	}
+
+	stream.put(data.data() + written, data.size() - written);
+}
+
+} // ember
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "RealmList.h"
+#include "grunt/Packet.h"
+#include <dbcreader/MemoryDefs.h>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ember {
+
+/*
+ * Clients poll the realm list for as long as they sit on the realm
+ * selection screen, so rather than building and serialising the list
+ * for every request, each region's response is serialised once and
+ * reused until the realm list publishes a new map.
+ *
+ * The only per-account data in the response is the character count
+ * for each realm, which is patched in as the cached body is written out.
+ */
+class RealmListCache final {
+public:
+	using Region = dbc::Cfg_Categories::Region;
+
+	struct CountSlot {
+		std::uint32_t realm_id;
+		std::size_t offset;
+	};
+
+	struct Body {
+		std::shared_ptr<const RealmMap> source;
+		std::vector<std::uint8_t> data;
+		std::vector<CountSlot> slots;
+	};
+
+private:
+	const RealmList& realm_list_;
+
+	std::mutex lock_;
+	std::unordered_map<std::optional<Region>, std::shared_ptr<const Body>> bodies_;
+
+	static std::shared_ptr<const Body> build(std::shared_ptr<const RealmMap> realms,
+	                                         std::optional<Region> region);
+
+public:
+	explicit RealmListCache(const RealmList& realm_list) : realm_list_(realm_list) {}
+
+	/*
+	 * Returns the list for the given region, or every realm if
+	 * no region is provided
+	 */
+	std::shared_ptr<const Body> get(std::optional<Region> region);
+};
+
+/*
+ * Writes a cached realm list body to the stream, filling in the
+ * character counts for the account that requested it
+ */
+class CachedRealmList final : public grunt::Packet {
+	using CharacterCount = std::unordered_map<std::uint32_t, std::uint32_t>;
+
+	std::shared_ptr<const RealmListCache::Body> body_;
+	const CharacterCount& counts_;
+
+public:
+	CachedRealmList(std::shared_ptr<const RealmListCache::Body> body, const CharacterCount& counts)
+		: Packet(grunt::Opcode::CMD_REALM_LIST), body_(std::move(body)), counts_(counts) {}
+
+	State read_from_stream(spark::io::pmr::BinaryStream& stream) override;
+	void write_to_stream(spark::io::pmr::BinaryStream& stream) const override;
+};
+
+} // ember
@@ -8,26 +8,36 @@
 
 #include "Runner.h"
 #include "AccountClient.h"
+#include "AdmissionControl.h"
 #include "FilterTypes.h"
 #include "GameVersion.h"
 #include "IntegrityData.h"
+#include "EphemeralPool.h"
+#include "IntegrityPool.h"
 #include "LoginHandlerBuilder.h"
+#include "LoginLatency.h"
 #include "MonitorCallbacks.h"
 #include "NetworkListener.h"
+#include "PatchCache.h"
 #include "Patcher.h"
 #include "RealmClient.h"
 #include "RealmList.h"
+#include "RealmListCache.h"
 #include "SessionBuilders.h"
 #include "Survey.h"
 #include <logger/Logger.h>
 #include <conpool/ConnectionPool.h>
 #include <conpool/Policies.h>
 #include <conpool/drivers/AutoSelect.h>
+#include <shared/metrics/CounterDelta.h>
 #include <shared/metrics/MetricsImpl.h>
 #include <shared/metrics/Monitor.h>
 #include <shared/metrics/MetricsPoll.h>
+#include <shared/metrics/MetricsRegistry.h>
+#include <shared/metrics/PrometheusExporter.h>
 #include <shared/threading/ThreadPool.h>
 #include <shared/threading/Utility.h>
+#include <shared/database/daos/BatchedUserDAO.h>
 #include <shared/database/daos/IPBanDAO.h>
 #include <shared/database/daos/PatchDAO.h>
 #include <shared/database/daos/RealmDAO.h>
@@ -38,6 +48,8 @@
 #include <shared/utility/xoroshiro128plus.h>
 #include <shared/utility/STUN.h>
 #include <shared/utility/PortForward.h>
+#include <shared/utility/ThreadPlacement.h>
+#include <shared/utility/ProfilerSetup.h>
 #include <spark/Server.h>
 #include <stun/Client.h>
 #include <stun/Utility.h>
@@ -48,6 +60,7 @@
 #include <boost/program_options.hpp>
 #include <pcre.h>
 #include <zlib.h>
+#include <algorithm>
 #include <exception>
 #include <functional>
 #include <memory>
@@ -106,12 +119,20 @@ int run(const po::variables_map& args, log::Logger& logger) try {
 		launch(args, service, stop_flag, logger);
 	});
 
-	// Spawn worker threads for ASIO
+	// Spawn worker threads for ASIO, pinning them before they touch any thread-local pools
+	const auto layout = placement_layout(args, concurrency, logger);
 	boost::container::small_vector<std::jthread, WORKER_NUM_HINT> workers;
 
 	for(unsigned int i = 0; i < concurrency; ++i) {
-		workers.emplace_back(static_cast<std::size_t(boost::asio::io_context::*)()>
-							 (&boost::asio::io_context::run), &service);
+		workers.emplace_back([&service, &layout, i] {
+			if(!layout.empty()) {
+				thread::set_affinity(layout[i]);
+			}
+
+			Profiler::register_thread("asio_worker");
+			service.run();
+		});
+
 		thread::set_name(workers[i], "ASIO Worker");
 	}
 
@@ -191,6 +212,15 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	auto ip_ban_dao = dal::ip_ban_dao(pool); 
 	auto ip_ban_cache = IPBanCache(ip_ban_dao.all_bans());
 
+	// login records and survey results are written behind in batches
+	dal::BatchedUserDAO batched_user_dao(
+		user_dao, args["database.write_batch_size"].as<std::size_t>(),
+		std::chrono::milliseconds(args["database.write_interval"].as<std::uint32_t>()),
+		[&logger](std::string_view error) {
+			LOG_ERROR_ASYNC(logger, "Batched database write failed: {}", error);
+		}
+	);
+
 	// Load integrity, patch and survey data
 	LOG_INFO(logger) << "Loading client integrity validation data..." << LOG_SYNC;
 	IntegrityData bin_data;
@@ -209,6 +239,10 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	);
 
 	Patcher patcher(allowed_clients, patches);
+	PatchCache patch_cache;
+	const auto transfer_window = std::max<std::size_t>(
+		args["patches.transfer_window"].as<std::size_t>(), 1
+	);
 	Survey survey(args["survey.id"].as<std::uint32_t>());
 
 	if(survey.id()) {
@@ -234,6 +268,7 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 	spark::Server spark(service, "login", s_address, s_port, logger);
 	AccountClient acct_svc(spark, logger);
 	RealmClient realm_svcv2(spark, realm_list, logger);
+	RealmListCache realm_cache(realm_list);
 
 	// Start metrics service
 	auto metrics = std::make_unique<Metrics>();
@@ -246,28 +281,96 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 		);
 	}
 
+	// Expose metrics for scraping, forwarding everything on to StatsD as before
+	std::unique_ptr<PrometheusExporter> exporter;
+
+	if(args["metrics.prometheus_enabled"].as<bool>()) {
+		auto registry = std::make_unique<MetricsRegistry>("ember_login_", std::move(metrics));
+		const auto& prom_iface = args["metrics.prometheus_interface"].as<std::string>();
+		const auto prom_port = args["metrics.prometheus_port"].as<std::uint16_t>();
+
+		exporter = std::make_unique<PrometheusExporter>(service, prom_iface, prom_port, *registry);
+		metrics = std::move(registry);
+
+		LOG_INFO_SYNC(logger, "Serving Prometheus metrics on {}:{}", prom_iface, exporter->port());
+	}
+
+	const auto max_queued = args["admission.max_queued_actions"].as<std::size_t>();
+
 	LOG_INFO_SYNC(logger, "Starting thread pool with {} threads...", concurrency);
-	ThreadPool thread_pool(concurrency);
+	ThreadPool thread_pool(concurrency, max_queued);
+
+	// Per-state handler & login phase timings, opt-in as they add a little overhead
+	LoginLatency latency(args["metrics.latency_instrumentation"].as<bool>());
+
+	if(latency.states.enabled()) {
+		LOG_INFO_SYNC(logger, "Latency instrumentation enabled ({:.3f} TSC ticks/ns)",
+		              util::tsc::ticks_per_ns());
+	}
+
+	// Precompute client integrity checksums off the network threads
+	const auto integrity_enabled = args["integrity.enabled"].as<bool>();
+	const auto pool_depth = args["integrity.pool_depth"].as<std::size_t>();
+	const auto pool_threads = integrity_enabled? args["integrity.pool_threads"].as<unsigned int>() : 0;
+	IntegrityPool integrity_pool(bin_data, pool_depth, pool_threads, *metrics);
+
+	if(integrity_enabled) {
+		LOG_INFO_SYNC(logger, "Client integrity pool depth {}, {} refill thread(s)",
+		              pool_depth, pool_threads);
+	}
+
+	/*
+	 * SRP6 work is kept off the network threads & out of the way of DB/RPC actions.
+	 * The general pool already has a thread per core, so by default this only
+	 * takes half as many again rather than oversubscribing the machine further.
+	 */
+	auto crypto_threads = args["srp6.crypto_threads"].as<unsigned int>();
+
+	if(!crypto_threads) {
+		crypto_threads = std::max(1u, concurrency / 2);
+	}
+
+	ThreadPool crypto_pool(crypto_threads, max_queued);
+
+	EphemeralPool ephemeral_pool(LoginAuthenticator::generator(),
+	                             args["srp6.ephemeral_pool_depth"].as<std::size_t>(),
+	                             args["srp6.ephemeral_threads"].as<unsigned int>(), *metrics);
 
-	LoginHandlerBuilder builder(logger, patcher, survey, bin_data, user_dao,
-	                            acct_svc, realm_list, *metrics,
+	LOG_INFO_SYNC(logger, "SRP6 crypto pool with {} threads, ephemeral pool depth {}",
+	              crypto_threads, args["srp6.ephemeral_pool_depth"].as<std::size_t>());
+
+	LoginHandlerBuilder builder(logger, patcher, patch_cache, survey, bin_data, integrity_pool,
+	                            ephemeral_pool, batched_user_dao,
+	                            acct_svc, realm_cache, *metrics, latency, transfer_window,
 	                            args["misc.locale_enforce"].as<bool>(),
-	                            args["integrity.enabled"].as<bool>(),
+	                            integrity_enabled,
 	                            args["misc.verified_email"].as<bool>());
-	LoginSessionBuilder s_builder(builder, thread_pool);
+	LoginSessionBuilder s_builder(builder, thread_pool, crypto_pool);
 
 	const auto& interface = args["network.interface"].as<std::string>();
 	const auto port = args["network.port"].as<std::uint16_t>();
 	const auto tcp_no_delay = args["network.tcp_no_delay"].as<bool>();
 
+	AdmissionControl admission({
+		.ip_rate = args["admission.ip_rate"].as<double>(),
+		.ip_burst = args["admission.ip_burst"].as<double>(),
+		.subnet_rate = args["admission.subnet_rate"].as<double>(),
+		.subnet_burst = args["admission.subnet_burst"].as<double>(),
+		.ipv4_prefix = args["admission.ipv4_prefix"].as<unsigned int>(),
+		.ipv6_prefix = args["admission.ipv6_prefix"].as<unsigned int>(),
+		.max_handshakes = args["admission.max_handshakes"].as<std::size_t>()
+	});
+
 	LOG_INFO_SYNC(logger, "Starting network service...");
 
 	NetworkListener server(
-		service, interface, port, tcp_no_delay, s_builder, ip_ban_cache, logger, *metrics
+		service, interface, port, tcp_no_delay, s_builder, ip_ban_cache, admission, logger, *metrics
 	);
 
 	LOG_INFO_SYNC(logger, "Started network service on {}:{}", interface, server.port());
 
+	auto profiler = create_profiler(args, logger);
+
 	// Start monitoring service
 	std::unique_ptr<Monitor> monitor;
 
@@ -281,6 +384,8 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 
 		install_net_monitor(*monitor, server, logger);
 		install_pool_monitor(*monitor, pool, logger);
+		install_ban_commands(*monitor, ip_ban_cache, ip_ban_dao, logger);
+		install_profiler_commands(*monitor, *profiler, logger);
 	}
 
 	// Start metrics polling
@@ -290,10 +395,76 @@ void launch(const po::variables_map& args, boost::asio::io_context& service,
 		metrics.gauge("db_connections", pool.size());
 	}, 5s);
 
+	poller.add_source([&batched_user_dao, coalesced = CounterDelta(), failed = CounterDelta(),
+	                   dropped = CounterDelta()](Metrics& metrics) mutable {
+		const auto logins = batched_user_dao.login_stats();
+		const auto surveys = batched_user_dao.survey_stats();
+		metrics.gauge("db_write_queue_logins", logins.queued);
+		metrics.gauge("db_write_queue_surveys", surveys.queued);
+		metrics.increment("db_write_coalesced", coalesced(logins.coalesced + surveys.coalesced));
+		metrics.increment("db_write_failed", failed(logins.failed + surveys.failed));
+		metrics.increment("db_write_dropped", dropped(logins.dropped + surveys.dropped));
+	}, 5s);
+
 	poller.add_source([&server](Metrics& metrics) {
 		metrics.gauge("sessions", server.connection_count());
 	}, 5s);
 
+	poller.add_source([&admission](Metrics& metrics) {
+		metrics.gauge("admission_handshakes", admission.handshakes());
+		metrics.gauge("admission_tracked", admission.tracked());
+	}, 5s);
+
+	poller.add_source([&integrity_pool](Metrics& metrics) {
+		metrics.gauge("integrity_pool_available", integrity_pool.available());
+	}, 5s);
+
+	poller.add_source([&patch_cache](Metrics& metrics) {
+		metrics.gauge("patch_cache_mappings", patch_cache.size());
+	}, 5s);
+
+	poller.add_source([&ephemeral_pool](Metrics& metrics) {
+		metrics.gauge("srp6_ephemeral_pool_available", ephemeral_pool.available());
+	}, 5s);
+
+	poller.add_source([&crypto_pool, rejected = CounterDelta()](Metrics& metrics) mutable {
+		const auto stats = crypto_pool.stats();
+		const auto high = std::to_underlying(ThreadPool::Priority::HIGH);
+		metrics.gauge("crypto_pool_queued", stats.queued[high]);
+		metrics.increment("crypto_pool_rejected", rejected(stats.rejected));
+	}, 5s);
+
+	poller.add_source([&thread_pool, rejected = CounterDelta()](Metrics& metrics) mutable {
+		const auto stats = thread_pool.stats();
+		const auto high = std::to_underlying(ThreadPool::Priority::HIGH);
+		const auto normal = std::to_underlying(ThreadPool::Priority::NORMAL);
+		const auto low = std::to_underlying(ThreadPool::Priority::LOW);
+
+		metrics.gauge("thread_pool_queued_high", stats.queued[high]);
+		metrics.gauge("thread_pool_queued_normal", stats.queued[normal]);
+		metrics.gauge("thread_pool_queued_low", stats.queued[low]);
+		metrics.increment("thread_pool_rejected", rejected(stats.rejected));
+		metrics.timing("thread_pool_max_wait_high",
+		               std::chrono::duration_cast<std::chrono::milliseconds>(stats.max_wait[high]));
+		metrics.timing("thread_pool_max_wait_low",
+		               std::chrono::duration_cast<std::chrono::milliseconds>(stats.max_wait[low]));
+	}, 5s);
+
+	poller.add_source([&latency, &logger](Metrics& metrics) {
+		for(auto tracker : { &latency.states, &latency.phases }) {
+			if(!tracker->enabled()) {
+				continue;
+			}
+
+			const auto summaries = tracker->collect();
+			tracker->publish(summaries, metrics);
+
+			if(!summaries.empty()) {
+				LOG_INFO(logger) << tracker->describe_slowest(summaries, 5) << LOG_ASYNC;
+			}
+		}
+	}, 60s);
+
 	// Misc. information
 	LOG_INFO_SYNC(logger, "Max allowed sockets: {}", util::max_sockets_desc());
 	std::string builds;
@@ -386,10 +557,24 @@ po::options_description options() {
 		("misc.locale_enforce", po::value<bool>()->required())
 		("misc.verified_emails", po::value<bool>()->required())
 		("patches.bin_path", po::value<std::string>()->required())
+		("patches.transfer_window", po::value<std::size_t>()->default_value(4))
 		("survey.path", po::value<std::string>()->required())
 		("survey.id", po::value<std::uint32_t>()->required())
 		("integrity.enabled", po::value<bool>()->default_value(false))
 		("integrity.bin_path", po::value<std::string>()->required())
+		("integrity.pool_depth", po::value<std::size_t>()->default_value(64))
+		("integrity.pool_threads", po::value<unsigned int>()->default_value(1))
+		("srp6.crypto_threads", po::value<unsigned int>()->default_value(0))
+		("srp6.ephemeral_pool_depth", po::value<std::size_t>()->default_value(256))
+		("srp6.ephemeral_threads", po::value<unsigned int>()->default_value(1))
+		("admission.ip_rate", po::value<double>()->default_value(1.0))
+		("admission.ip_burst", po::value<double>()->default_value(10.0))
+		("admission.subnet_rate", po::value<double>()->default_value(20.0))
+		("admission.subnet_burst", po::value<double>()->default_value(100.0))
+		("admission.ipv4_prefix", po::value<unsigned int>()->default_value(24))
+		("admission.ipv6_prefix", po::value<unsigned int>()->default_value(64))
+		("admission.max_handshakes", po::value<std::size_t>()->default_value(2048))
+		("admission.max_queued_actions", po::value<std::size_t>()->default_value(4096))
 		("spark.address", po::value<std::string>()->required())
 		("spark.port", po::value<std::uint16_t>()->required())
 		("nsd.host", po::value<std::string>()->required())
@@ -424,13 +609,21 @@ po::options_description options() {
 		("database.config_path", po::value<std::string>()->required())
 		("database.min_connections", po::value<unsigned short>()->required())
 		("database.max_connections", po::value<unsigned short>()->required())
+		("database.write_batch_size", po::value<std::size_t>()->default_value(500))
+		("database.write_interval", po::value<std::uint32_t>()->default_value(1000))
 		("metrics.enabled", po::value<bool>()->required())
 		("metrics.statsd_host", po::value<std::string>()->required())
 		("metrics.statsd_port", po::value<std::uint16_t>()->required())
+		("metrics.prometheus_enabled", po::value<bool>()->default_value(false))
+		("metrics.prometheus_interface", po::value<std::string>()->default_value("0.0.0.0"))
+		("metrics.prometheus_port", po::value<std::uint16_t>()->default_value(9100))
+		("metrics.latency_instrumentation", po::value<bool>()->default_value(false))
 		("monitor.enabled", po::value<bool>()->required())
 		("monitor.interface", po::value<std::string>()->required())
 		("monitor.port", po::value<std::uint16_t>()->required());
 
+	opts.add(placement_options("none"));
+	opts.add(profiler_options("login.folded"));
 	return opts;
 }
 
@@ -26,6 +26,7 @@ class NetworkSessionBuilder {
 public:
 	virtual std::shared_ptr<LoginSession> create(SessionManager& sessions,
 	                                             tcp_socket socket,
+	                                             AdmissionControl::Ticket ticket,
 	                                             log::Logger& logger) const = 0;
 
 	virtual ~NetworkSessionBuilder() = default;
@@ -34,15 +35,18 @@ public:
 class LoginSessionBuilder final : public NetworkSessionBuilder {
 	const LoginHandlerBuilder& builder_;
 	ThreadPool& pool_;
+	ThreadPool& crypto_pool_;
 
 public:
-	LoginSessionBuilder(const LoginHandlerBuilder& builder, ThreadPool& pool)
-	                    : builder_(builder), pool_(pool) { }
+	LoginSessionBuilder(const LoginHandlerBuilder& builder, ThreadPool& pool, ThreadPool& crypto_pool)
+	                    : builder_(builder), pool_(pool), crypto_pool_(crypto_pool) { }
 
 	std::shared_ptr<LoginSession> create(SessionManager& sessions,
 	                                     tcp_socket socket,
+	                                     AdmissionControl::Ticket ticket,
 	                                     log::Logger& logger) const override {
-		return std::make_shared<LoginSession>(sessions, std::move(socket), logger, pool_, builder_);
+		return std::make_shared<LoginSession>(sessions, std::move(socket), std::move(ticket),
+		                                      logger, pool_, crypto_pool_, builder_);
 	}
 };
 
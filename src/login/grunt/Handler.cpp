@@ -7,14 +7,9 @@
  */
 
 #include "Handler.h"
-#include "Exceptions.h"
 #include "Packets.h"
 #include <logger/Logger.h>
-#include <spark/buffers/pmr/BinaryStream.h>
-#include <shared/utility/FormatPacket.h>
 #include <boost/assert.hpp>
-#include <vector>
-#include <cstdint>
 
 namespace ember::grunt {
 
@@ -23,28 +18,7 @@ void Handler::create_packet() {
 	curr_packet_ = &packet_.emplace<T>();
 }
 
-void Handler::dump_bad_packet(const spark::io::buffer_underrun& e,
-                              spark::io::pmr::Buffer& buffer,
-                              std::size_t offset) {
-	std::size_t valid_bytes = offset - buffer.size();
-
-	spark::io::pmr::BinaryStream stream(buffer);
-	stream.skip(stream.size()); // discard any remaining data, we don't care about it anymore
-
-	// recombobulate the data by serialising the packet
-	curr_packet_->write_to_stream(stream);
-	std::vector<std::uint8_t> contig_buff(stream.size());
-	stream.get(contig_buff.data(), stream.size());
-
-	auto output = util::format_packet(contig_buff.data(), contig_buff.size());
-
-	LOG_ERROR(logger_) << "Buffer stream underrun! \nRead request: "
-	                   << e.read_size << " bytes \nBuffer size: " << e.buff_size
-	                   << " bytes \nError triggered by first "
-	                   << valid_bytes << " bytes \n" << output << LOG_ASYNC;
-}
-
-void Handler::handle_new_packet(spark::io::pmr::Buffer& buffer) {
+bool Handler::handle_new_packet(spark::io::pmr::Buffer& buffer) {
 	Opcode opcode;
 	buffer.copy(&opcode, sizeof(opcode));
 
@@ -76,45 +50,64 @@ void Handler::handle_new_packet(spark::io::pmr::Buffer& buffer) {
 			create_packet<client::TransferCancel>();
 			break;
 		default:
-			throw bad_packet("Unknown opcode encountered!");
+			LOG_DEBUG(logger_) << "Unknown opcode encountered: "
+			                   << static_cast<int>(opcode) << LOG_ASYNC;
+			state_ = State::ERRORED;
+			return false;
 	}
 
 	state_ = State::READ;
+	return true;
 }
 
-void Handler::handle_read(spark::io::pmr::Buffer& buffer, std::size_t offset) try {
+void Handler::handle_read(spark::io::pmr::Buffer& buffer) {
 	spark::io::pmr::BinaryStream stream(buffer);
-	Packet::State state = curr_packet_->read_from_stream(stream);
+	const Packet::State state = curr_packet_->read_from_stream(stream);
 
 	switch(state) {
 		case Packet::State::DONE:
 			state_ = State::NEW_PACKET;
 			break;
+		case Packet::State::INITIAL:
+			[[fallthrough]];
 		case Packet::State::CALL_AGAIN:
 			state_ = State::READ;
 			break;
+		case Packet::State::ERRORED:
+			LOG_DEBUG(logger_) << "Malformed packet: " << to_string(curr_packet_->opcode)
+			                   << ", " << buffer.size() << " bytes remaining" << LOG_ASYNC;
+			state_ = State::ERRORED;
+			break;
 		default:
 			BOOST_ASSERT_MSG(false, "Unreachable condition hit!");
 	}
-} catch(const spark::io::buffer_underrun& e) {
-	dump_bad_packet(e, buffer, offset);
-	throw bad_packet(e.what());
 }
 
-auto Handler::process_buffer(spark::io::pmr::Buffer& buffer) -> std::optional<const PacketRef> {
+auto Handler::process_buffer(spark::io::pmr::Buffer& buffer) -> Result {
 	switch(state_) {
 		case State::NEW_PACKET:
-			handle_new_packet(buffer);
+			if(buffer.empty()) {
+				return std::nullopt;
+			}
+
+			if(!handle_new_packet(buffer)) {
+				return std::unexpected(Error::UNKNOWN_OPCODE);
+			}
 			[[fallthrough]];
 		case State::READ:
-			handle_read(buffer, buffer.size());
+			handle_read(buffer);
 			break;
+		case State::ERRORED:
+			return std::unexpected(Error::MALFORMED_PACKET);
 	}
 
-	if(state_ == State::NEW_PACKET) {
-		return *curr_packet_;
-	} else {
-		return std::nullopt;
+	switch(state_) {
+		case State::NEW_PACKET:
+			return *curr_packet_;
+		case State::ERRORED:
+			return std::unexpected(Error::MALFORMED_PACKET);
+		default:
+			return std::nullopt;
 	}
 }
 
@@ -11,6 +11,7 @@
 #include "Packets.h"
 #include <spark/buffers/pmr/Buffer.h>
 #include <logger/LoggerFwd.h>
+#include <expected>
 #include <functional>
 #include <optional>
 #include <type_traits>
@@ -19,9 +20,24 @@
 
 namespace ember::grunt {
 
+/*
+ * Incrementally decodes client packets from the session's inbound buffer.
+ * Fragmented packets are resumed as more data arrives and malformed ones
+ * are reported through the return value rather than by throwing, so junk
+ * data costs no more to reject than a valid packet costs to accept.
+ */
 class Handler final {
+public:
+	enum class Error {
+		UNKNOWN_OPCODE, MALFORMED_PACKET
+	};
+
+	using PacketRef = std::reference_wrapper<const Packet>;
+	using Result = std::expected<std::optional<PacketRef>, Error>;
+
+private:
 	enum class State {
-		NEW_PACKET, READ
+		NEW_PACKET, READ, ERRORED
 	};
 
 	std::variant<
@@ -41,18 +57,24 @@ class Handler final {
 	log::Logger& logger_;
 
 	template<typename T> void create_packet();
-	void handle_new_packet(spark::io::pmr::Buffer& buffer);
-	void handle_read(spark::io::pmr::Buffer& buffer, std::size_t offset);
-	void dump_bad_packet(const spark::io::buffer_underrun& e,
-	                     spark::io::pmr::Buffer& buffer,
-	                     std::size_t offset);
+	bool handle_new_packet(spark::io::pmr::Buffer& buffer);
+	void handle_read(spark::io::pmr::Buffer& buffer);
 
 public:
-	using PacketRef = std::reference_wrapper<const Packet>;
-
 	explicit Handler(log::Logger& logger) : logger_(logger) { }
 
-	std::optional<const PacketRef> process_buffer(spark::io::pmr::Buffer& buffer);
+	Result process_buffer(spark::io::pmr::Buffer& buffer);
 };
 
+constexpr const char* to_string(const Handler::Error error) {
+	switch(error) {
+		case Handler::Error::UNKNOWN_OPCODE:
+			return "unknown opcode";
+		case Handler::Error::MALFORMED_PACKET:
+			return "malformed packet";
+		default:
+			return "unknown error";
+	}
+}
+
 } // grunt, ember
\ No newline at end of file
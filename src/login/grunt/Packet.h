@@ -14,8 +14,14 @@
 namespace ember::grunt {
 
 struct Packet {
+	/*
+	 * Reads never run past the end of the buffer. If there isn't enough data
+	 * to make progress, CALL_AGAIN is returned and the read resumes from the
+	 * same point once more data has arrived. ERRORED means the packet is
+	 * malformed and the connection should be dropped.
+	 */
 	enum class State {
-		INITIAL, CALL_AGAIN, DONE
+		INITIAL, CALL_AGAIN, DONE, ERRORED
 	};
 
 	Opcode opcode;
@@ -30,19 +30,30 @@ namespace be = boost::endian;
 class LoginChallenge final : public Packet {
 	static const std::size_t MAX_USERNAME_LEN = 16;
 	static const std::size_t HEADER_LENGTH = 4;
+	static const std::size_t BODY_FIXED_LENGTH = 30; // everything up to and including the username length
 
 	State state_ = State::INITIAL;
 	std::uint8_t username_len_ = 0;
 
-	void read_header(spark::io::pmr::BinaryStream& stream) {
+	bool read_header(spark::io::pmr::BinaryStream& stream) {
 		if(stream.size() < HEADER_LENGTH) {
-			return;
+			return false;
 		}
 
 		stream >> opcode;
 		stream >> protocol_ver;
 		stream >> body_size;
 		be::little_to_native_inplace(body_size);
+
+		// reject bad lengths before waiting on the body, otherwise a client could
+		// have us buffer up to 64KB for a packet that can never be valid
+		if(body_size < BODY_FIXED_LENGTH || body_size > BODY_FIXED_LENGTH + MAX_USERNAME_LEN) {
+			state_ = State::ERRORED;
+		} else {
+			state_ = State::CALL_AGAIN;
+		}
+
+		return true;
 	}
 
 	void read_body(spark::io::pmr::BinaryStream& stream) {
@@ -63,18 +74,16 @@ class LoginChallenge final : public Packet {
 		stream >> ip;
 		stream >> username_len_;
 
-		if(username_len_ > MAX_USERNAME_LEN) {
-			throw bad_packet("Username length was too long!");
+		// the body must contain exactly the username, no more and no less
+		if(username_len_ > MAX_USERNAME_LEN || BODY_FIXED_LENGTH + username_len_ != body_size) {
+			state_ = State::ERRORED;
+			return;
 		}
 
-		if(stream.size() >= username_len_) {
-			username.resize_and_overwrite(username_len_, [&](char* strlen, std::size_t size) {
-				stream.get(strlen, size);
-				return size;
-			});
-		} else {
-			throw bad_packet("Invalid username length supplied!");
-		}
+		username.resize_and_overwrite(username_len_, [&](char* strlen, std::size_t size) {
+			stream.get(strlen, size);
+			return size;
+		});
 
 		// handle endianness
 		be::little_to_native_inplace(game);
@@ -107,7 +116,13 @@ public:
 
 		switch(state_) {
 			case State::INITIAL:
-				read_header(stream);
+				if(!read_header(stream)) {
+					return State::CALL_AGAIN;
+				}
+
+				if(state_ == State::ERRORED) {
+					break;
+				}
 				[[fallthrough]];
 			case State::CALL_AGAIN:
 				read_body(stream);
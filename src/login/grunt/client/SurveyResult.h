@@ -63,11 +63,7 @@ class SurveyResult final : public Packet {
 			return dest_len;
 		});
 
-		if(ret != Z_OK) {
-			throw bad_packet("Decompression of survey data failed with code " + std::to_string(ret));
-		}
-		
-		state_ = State::DONE;
+		state_ = (ret == Z_OK)? State::DONE : State::ERRORED;
 	}
 
 public:
@@ -108,6 +108,24 @@ public:
 		return state_;
 	}
 
+	/*
+	 * Returns the stream position of the character count, allowing
+	 * it to be patched without reserialising the entry
+	 */
+	static std::size_t write_entry(spark::io::pmr::BinaryStreamWriter& stream,
+	                               const Realm& realm, const std::uint32_t characters) {
+		stream << be::native_to_little(realm.type);
+		stream << realm.flags;
+		stream << realm.name;
+		stream << realm.address;
+		stream << realm.population;
+		const auto count_pos = stream.total_write();
+		stream << gsl::narrow_cast<std::uint8_t>(characters);
+		stream << gsl::narrow<std::uint8_t>(realm.category);
+		stream << gsl::narrow<std::uint8_t>(realm.id);
+		return count_pos;
+	}
+
 	std::size_t write_body(spark::io::pmr::BinaryStreamWriter& stream) const {
 		const auto initial_write = stream.total_write();
 
@@ -115,15 +133,7 @@ public:
 		stream << gsl::narrow<std::uint8_t>(realms.size());
 
 		for(const auto& entry : realms) {
-			auto& realm = entry.realm;
-			stream << be::native_to_little(realm.type);
-			stream << realm.flags;
-			stream << realm.name;
-			stream << realm.address;
-			stream << realm.population;
-			stream << gsl::narrow_cast<std::uint8_t>(entry.characters);
-			stream << gsl::narrow<std::uint8_t>(realm.category);
-			stream << gsl::narrow<std::uint8_t>(realm.id);
+			write_entry(stream, entry.realm, entry.characters);
 		}
 
 		stream << unknown2;
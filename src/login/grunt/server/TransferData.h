@@ -13,7 +13,7 @@
 #include "../Exceptions.h"
 #include <boost/assert.hpp>
 #include <boost/endian/arithmetic.hpp>
-#include <vector>
+#include <span>
 #include <cstdint>
 #include <cstddef>
 
@@ -31,7 +31,9 @@ public:
 	TransferData() : Packet(Opcode::CMD_XFER_DATA) {}
 
 	be::little_uint16_t size = 0;
-	std::array<std::byte, MAX_CHUNK_SIZE> chunk;
+
+	// view into the file being transferred, must remain valid until serialised
+	std::span<const std::byte> chunk;
 
 	State read_from_stream(spark::io::pmr::BinaryStream& stream) override {
 		BOOST_ASSERT_MSG(state_ != State::DONE, "Packet already complete - check your logic!");
@@ -47,9 +49,10 @@ public:
 	}
 
 	void write_to_stream(spark::io::pmr::BinaryStream& stream) const override {
+		BOOST_ASSERT_MSG(chunk.size() == size, "Chunk size mismatch");
 		stream << opcode;
 		stream << size;
-		stream.put(chunk.data(), size);
+		stream.put(chunk.data(), chunk.size());
 	}
 };
 
@@ -81,6 +81,36 @@ std::string parent_alias(const types::Definitions& defs, const std::string& pare
 	return parent; // couldn't find parent, will just assume the validator caught the problem, if any
 }
 
+std::string index_name(const std::string& store_name, const types::Index& index) {
+	return store_name + "_by_" + index.name;
+}
+
+// e.g. Index<CharStartSpells, &CharStartSpells::race_id, &CharStartSpells::class__id>
+std::string index_type(const types::Struct& dbc, const types::Index& index) {
+	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
+
+	std::stringstream type;
+	type << "Index<" << dbc.name;
+
+	for(const auto& name : index.fields) {
+		const auto field = std::ranges::find(dbc.fields, name, &types::Field::name);
+
+		if(field == dbc.fields.end()) {
+			throw std::runtime_error("Could not locate indexed field: " + name + " in DBC: " + dbc.name);
+		}
+
+		const bool foreign = std::ranges::any_of(field->keys, [](const auto& key) {
+			return key.type == "foreign";
+		});
+
+		// foreign keys are resolved to pointers, so index the original ID instead
+		type << ", &" << dbc.name << "::" << name << (foreign? "_id" : "");
+	}
+
+	type << ">";
+	return type.str();
+}
+
 void save_output(const std::string& path, const std::string& name, const std::string& output) {
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
 
@@ -119,9 +149,9 @@ std::stringstream read_template(const std::string& path, const std::string& file
 void generate_linker(const types::Definitions& defs, const std::string& output, const std::string& path) {
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
 
-	std::regex pattern(R"(([^]+)<%TEMPLATE_LINKING_FUNCTIONS%>([^]+)<%TEMPLATE_LINKING_FUNCTION_CALLS%>([^]+))");
+	std::regex pattern(R"(([^]+)<%TEMPLATE_LINKING_FUNCTIONS%>([^]+)<%TEMPLATE_LINKING_FUNCTION_CALLS%>([^]+)<%TEMPLATE_INDEX_BUILD_CALLS%>([^]+))");
 	std::stringstream buffer(read_template(path, "Linker.cpp_"));
-	std::stringstream functions, calls;
+	std::stringstream functions, calls, indexes;
 
 	for(const auto& def : defs) {
 		if(def->type != types::Type::STRUCT) {
@@ -136,6 +166,12 @@ void generate_linker(const types::Definitions& defs, const std::string& output,
 		}
 
 		std::string store_name = def->alias.empty()? pascal_to_underscore(dbc->name) : dbc->alias;
+
+		for(const auto& index : dbc->indexes) {
+			indexes << "\t" << "storage." << index_name(store_name, index)
+				<< ".build(storage." << store_name << ");" << '\n';
+		}
+
 		std::stringstream call, func;
 		bool write_func = false;
 		bool double_spaced = false;
@@ -205,7 +241,7 @@ void generate_linker(const types::Definitions& defs, const std::string& output,
 		}
 	}
 
-	std::string replace_pattern("$1" + functions.str() + "$2" + calls.str() + "$3");
+	std::string replace_pattern("$1" + functions.str() + "$2" + calls.str() + "$3" + indexes.str() + "$4");
 	std::string out = std::regex_replace(buffer.str(), pattern, replace_pattern);
 	save_output(output, "Linker.cpp", out);
 }
@@ -616,7 +652,7 @@ void generate_storage(const types::Definitions& defs, const std::string& output,
 	std::regex pattern(R"(([^]+)<%TEMPLATE_DBC_MAPS%>)");
 
 	std::stringstream buffer(read_template(path, "Storage.h_"));
-	std::stringstream declarations;
+	std::stringstream declarations, indexes;
 
 	for(const auto& def : defs) {
 		if(def->type != types::Type::STRUCT) {
@@ -632,6 +668,14 @@ void generate_storage(const types::Definitions& defs, const std::string& output,
 
 		std::string store_name = dbc->alias.empty()? pascal_to_underscore(dbc->name) : dbc->alias;
 		declarations << "\tStore<" << dbc->name << "> " << store_name << ";\n";
+
+		for(const auto& index : dbc->indexes) {
+			indexes << "\t" << index_type(*dbc, index) << " " << index_name(store_name, index) << ";\n";
+		}
+	}
+
+	if(!indexes.str().empty()) {
+		declarations << "\n\t// built by link()\n" << indexes.str();
 	}
 
 	std::string replace_pattern("$1" + declarations.str() + "$2");
@@ -48,6 +48,29 @@ types::Key Parser::parse_field_key(rxml::xml_node<>* property) {
 	return key;
 }
 
+types::Index Parser::parse_index(rxml::xml_node<>* root) {
+	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
+
+	types::Index index;
+	bool has_name = false;
+
+	for(rxml::xml_node<>* node = root->first_node(); node; node = node->next_sibling()) {
+		if(strcmp(node->name(), "name") == 0) {
+			assign_unique(index.name, has_name, node);
+		} else if(strcmp(node->name(), "field") == 0) {
+			index.fields.emplace_back(node->value());
+		} else {
+			throw exception(std::format("Unexpected element in <index>: {}", node->name()));
+		}
+	}
+
+	if(!has_name || index.fields.empty()) {
+		throw exception("An <index> must have a <name> and at least one <field> node");
+	}
+
+	return index;
+}
+
 void Parser::parse_enum_options(std::vector<std::pair<std::string, std::string>>& key,
                                 rxml::xml_node<>* property) {
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
@@ -111,6 +134,9 @@ void Parser::parse_struct_node(types::Struct& type, UniqueCheck& check, rxml::xm
 		auto f = parse_field(node, &type);
 		type.fields.emplace_back(f);
 		return;
+	} else if(strcmp(node->name(), "index") == 0) {
+		type.indexes.emplace_back(parse_index(node));
+		return;
 	}
 
 	auto msg = std::format("Unexpected node in {}: {}", (type.dbc? "<dbc>" : "<struct>"), node->name());
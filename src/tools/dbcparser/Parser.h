@@ -34,6 +34,7 @@ class Parser final {
 	types::Field parse_field(rapidxml::xml_node<>* root, types::Base* parent = nullptr);
 	void parse_field_node(types::Field& field, UniqueCheck& check, rapidxml::xml_node<>* node);
 	types::Key parse_field_key(rapidxml::xml_node<>* node);
+	types::Index parse_index(rapidxml::xml_node<>* root);
 
 	types::Enum parse_enum(rapidxml::xml_node<>* root, types::Base* parent = nullptr);
 	void parse_enum_node(types::Enum& structure, UniqueCheck& check, rapidxml::xml_node<>* node);
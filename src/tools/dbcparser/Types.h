@@ -40,6 +40,12 @@ struct Key {
 	bool ignore_type_mismatch = false;
 };
 
+// composite lookup over one or more fields, generated into dbc::Storage
+struct Index {
+	std::string name;
+	std::vector<std::string> fields;
+};
+
 struct IVisitor {
 	virtual void accept(TypeVisitor* visitor) = 0;
 };
@@ -78,6 +84,7 @@ struct Enum final : Base {
 struct Struct final : Base {
 	Struct() : Base(Type::STRUCT), dbc(false) {}
 	std::vector<Field> fields;
+	std::vector<Index> indexes;
 	std::vector<std::unique_ptr<Base>> children;
 	bool dbc;
 
@@ -10,6 +10,7 @@
 #include "Defines.h"
 #include "TypeUtils.h"
 #include <logger/Logger.h>
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <string_view>
@@ -167,6 +168,48 @@ void Validator::check_dup_key_types(const types::Struct* def) {
 	}
 }
 
+void Validator::check_indexes(const types::Struct* def) {
+	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
+
+	if(!def->indexes.empty() && !def->dbc) {
+		throw exception("Only DBC nodes may contain indexes");
+	}
+
+	std::vector<std::string> names;
+
+	for(const auto& index : def->indexes) {
+		name_check_(index.name);
+
+		if(std::ranges::find(names, index.name) != names.end()) {
+			throw exception(index.name + " - multiple indexes with the same name");
+		}
+
+		names.emplace_back(index.name);
+
+		for(auto it = index.fields.begin(); it != index.fields.end(); ++it) {
+			if(std::find(index.fields.begin(), it, *it) != it) {
+				throw exception(index.name + " - " + *it + " is indexed more than once");
+			}
+
+			const auto field = std::ranges::find(def->fields, *it, &types::Field::name);
+
+			if(field == def->fields.end()) {
+				throw exception(index.name + " - " + *it + " is not a field in " + def->name);
+			}
+
+			const auto components = extract_components(field->underlying_type);
+
+			if(components.second) {
+				throw exception(index.name + " - array fields cannot be indexed");
+			}
+
+			if(components.first == "string_ref" || components.first == "string_ref_loc") {
+				throw exception(index.name + " - string fields cannot be indexed");
+			}
+		}
+	}
+}
+
 void Validator::add_user_type(TreeNode<std::string>* node, const std::string& type) {
 	LOG_TRACE_GLOB << log_func << LOG_ASYNC;
 
@@ -312,6 +355,7 @@ void Validator::validate_struct(const types::Struct* def, const TreeNode<std::st
 
 	check_dup_key_types(def);
 	check_field_types(def, node);
+	check_indexes(def);
 
 	for(const auto& field : def->fields) {
 		if(!field.keys.empty() && !def->dbc) {
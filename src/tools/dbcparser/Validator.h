@@ -71,6 +71,7 @@ private:
 	void validate_struct(const types::Struct* def, const TreeNode<std::string>* types);
 	void validate_enum(const types::Enum* def);
 	void check_dup_key_types(const types::Struct* def);
+	void check_indexes(const types::Struct* def);
 	void validate_enum_options(const types::Enum* def);
 	void validate_enum_option_value(const std::string& type, const std::string& value);
 	void check_field_types(const types::Struct* def, const TreeNode<std::string>* curr_def);
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <login/AdmissionControl.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+
+using namespace ember;
+using namespace std::chrono_literals;
+namespace bai = boost::asio::ip;
+
+namespace {
+
+AdmissionControl::Config config() {
+	return {
+		.ip_rate = 1.0,
+		.ip_burst = 3.0,
+		.subnet_rate = 0.0,
+		.subnet_burst = 0.0,
+		.ipv4_prefix = 24,
+		.ipv6_prefix = 64,
+		.max_handshakes = 0
+	};
+}
+
+} // unnamed
+
+TEST(AdmissionControl, IPBurst) {
+	AdmissionControl admission(config());
+	const auto ip = bai::make_address("10.0.0.1");
+	const auto now = AdmissionControl::clock::now();
+
+	for(auto i = 0; i < 3; ++i) {
+		ASSERT_TRUE(admission.admit(ip, now));
+	}
+
+	const auto result = admission.admit(ip, now);
+	ASSERT_FALSE(result);
+	ASSERT_EQ(AdmissionControl::Rejection::IP_RATE_LIMITED, result.error());
+
+	// other addresses have their own buckets
+	ASSERT_TRUE(admission.admit(bai::make_address("10.0.0.2"), now));
+}
+
+TEST(AdmissionControl, IPRefill) {
+	AdmissionControl admission(config());
+	const auto ip = bai::make_address("10.0.0.1");
+	const auto now = AdmissionControl::clock::now();
+
+	for(auto i = 0; i < 3; ++i) {
+		ASSERT_TRUE(admission.admit(ip, now));
+	}
+
+	ASSERT_FALSE(admission.admit(ip, now + 500ms));
+	ASSERT_TRUE(admission.admit(ip, now + 1s));
+	ASSERT_FALSE(admission.admit(ip, now + 1s));
+
+	// shouldn't refill beyond the burst
+	for(auto i = 0; i < 3; ++i) {
+		ASSERT_TRUE(admission.admit(ip, now + 60s));
+	}
+
+	ASSERT_FALSE(admission.admit(ip, now + 60s));
+}
+
+TEST(AdmissionControl, SubnetV4) {
+	auto cfg = config();
+	cfg.ip_rate = 0.0;
+	cfg.subnet_rate = 1.0;
+	cfg.subnet_burst = 2.0;
+
+	AdmissionControl admission(cfg);
+	const auto now = AdmissionControl::clock::now();
+
+	ASSERT_TRUE(admission.admit(bai::make_address("192.168.1.1"), now));
+	ASSERT_TRUE(admission.admit(bai::make_address("192.168.1.200"), now));
+
+	const auto result = admission.admit(bai::make_address("192.168.1.50"), now);
+	ASSERT_FALSE(result);
+	ASSERT_EQ(AdmissionControl::Rejection::SUBNET_RATE_LIMITED, result.error());
+
+	ASSERT_TRUE(admission.admit(bai::make_address("192.168.2.1"), now));
+}
+
+// dual-stack listeners deliver IPv4 clients as mapped addresses
+TEST(AdmissionControl, SubnetV4Mapped) {
+	auto cfg = config();
+	cfg.ip_rate = 0.0;
+	cfg.subnet_rate = 1.0;
+	cfg.subnet_burst = 1.0;
+
+	AdmissionControl admission(cfg);
+	const auto now = AdmissionControl::clock::now();
+
+	ASSERT_TRUE(admission.admit(bai::make_address("::ffff:192.168.1.1"), now));
+	ASSERT_TRUE(admission.admit(bai::make_address("::ffff:192.168.2.1"), now));
+	ASSERT_TRUE(admission.admit(bai::make_address("::ffff:10.0.0.1"), now));
+
+	// mapped and plain IPv4 addresses share buckets
+	ASSERT_FALSE(admission.admit(bai::make_address("192.168.1.20"), now));
+	ASSERT_FALSE(admission.admit(bai::make_address("::ffff:192.168.2.30"), now));
+}
+
+// a connection turned away by a later check shouldn't use up tokens
+TEST(AdmissionControl, RejectionsDontSpend) {
+	auto cfg = config();
+	cfg.ip_rate = 0.1;
+	cfg.ip_burst = 1.0;
+	cfg.subnet_rate = 1.0;
+	cfg.subnet_burst = 1.0;
+	cfg.max_handshakes = 1;
+
+	AdmissionControl admission(cfg);
+	const auto now = AdmissionControl::clock::now();
+
+	auto ticket = admission.admit(bai::make_address("10.0.0.1"), now);
+	ASSERT_TRUE(ticket);
+
+	// subnet rejection, shouldn't take 10.0.0.2's token
+	auto result = admission.admit(bai::make_address("10.0.0.2"), now);
+	ASSERT_FALSE(result);
+	ASSERT_EQ(AdmissionControl::Rejection::SUBNET_RATE_LIMITED, result.error());
+
+	// handshake rejection, shouldn't take 10.0.1.1's or its subnet's tokens
+	result = admission.admit(bai::make_address("10.0.1.1"), now);
+	ASSERT_FALSE(result);
+	ASSERT_EQ(AdmissionControl::Rejection::HANDSHAKE_LIMIT, result.error());
+
+	ticket->release();
+	ASSERT_TRUE(admission.admit(bai::make_address("10.0.1.1"), now));
+	ASSERT_FALSE(admission.admit(bai::make_address("10.0.0.2"), now));
+	ASSERT_TRUE(admission.admit(bai::make_address("10.0.0.2"), now + 1s));
+}
+
+TEST(AdmissionControl, SubnetV6) {
+	auto cfg = config();
+	cfg.ip_rate = 0.0;
+	cfg.subnet_rate = 1.0;
+	cfg.subnet_burst = 1.0;
+
+	AdmissionControl admission(cfg);
+	const auto now = AdmissionControl::clock::now();
+
+	ASSERT_TRUE(admission.admit(bai::make_address("2001:db8:0:1::1"), now));
+	ASSERT_FALSE(admission.admit(bai::make_address("2001:db8:0:1:ffff::2"), now));
+	ASSERT_TRUE(admission.admit(bai::make_address("2001:db8:0:2::1"), now));
+}
+
+TEST(AdmissionControl, HandshakeLimit) {
+	auto cfg = config();
+	cfg.ip_rate = 0.0;
+	cfg.max_handshakes = 2;
+
+	AdmissionControl admission(cfg);
+	const auto ip = bai::make_address("10.0.0.1");
+
+	std::vector<AdmissionControl::Ticket> tickets;
+	tickets.emplace_back(*admission.admit(ip));
+	tickets.emplace_back(*admission.admit(ip));
+	ASSERT_EQ(2, admission.handshakes());
+
+	const auto result = admission.admit(ip);
+	ASSERT_FALSE(result);
+	ASSERT_EQ(AdmissionControl::Rejection::HANDSHAKE_LIMIT, result.error());
+
+	// releasing should free the slot, releasing twice should not
+	tickets[0].release();
+	tickets[0].release();
+	ASSERT_EQ(1, admission.handshakes());
+
+	tickets.pop_back();
+	ASSERT_EQ(0, admission.handshakes());
+
+	{
+		auto ticket = admission.admit(ip);
+		ASSERT_TRUE(ticket);
+		ASSERT_EQ(1, admission.handshakes());
+	}
+
+	ASSERT_EQ(0, admission.handshakes());
+}
+
+TEST(AdmissionControl, Prune) {
+	AdmissionControl admission(config());
+	const auto now = AdmissionControl::clock::now();
+
+	ASSERT_TRUE(admission.admit(bai::make_address("10.0.0.1"), now));
+	ASSERT_TRUE(admission.admit(bai::make_address("10.0.0.2"), now));
+	ASSERT_EQ(2, admission.tracked());
+
+	// both buckets will have refilled, so they should be swept on the next admission
+	ASSERT_TRUE(admission.admit(bai::make_address("10.0.0.3"), now + 5min));
+	ASSERT_EQ(1, admission.tracked());
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+#include <login/ExecutablesChecksum.h>
+#include <login/PINAuthenticator.h>
+#include <srp6/Client.h>
+#include <srp6/Generator.h>
+#include <srp6/Server.h>
+#include <srp6/Util.h>
+#include <srp6/crypto/ThreadLocal.h>
+#include <array>
+#include <new>
+#include <string>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace ember;
+
+namespace {
+
+thread_local bool counting = false;
+thread_local std::size_t allocations = 0;
+
+class AllocationCounter final {
+	const std::size_t start_;
+
+public:
+	AllocationCounter() : start_(allocations) {
+		counting = true;
+	}
+
+	~AllocationCounter() {
+		counting = false;
+	}
+
+	std::size_t count() const {
+		return allocations - start_;
+	}
+};
+
+} // unnamed
+
+void* operator new(std::size_t size) {
+	if(counting) {
+		++allocations;
+	}
+
+	if(void* ptr = std::malloc(size ? size : 1)) {
+		return ptr;
+	}
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+namespace {
+
+/*
+ * The server's side of a login handshake, as performed by LoginHandler
+ * & LoginAuthenticator, from the challenge through to the session proof
+ */
+std::size_t handshake(const srp6::Generator& gen, const Botan::BigInt& v,
+                      const Botan::BigInt& A, const std::array<std::uint8_t, 32>& salt) {
+	AllocationCounter counter;
+
+	std::array<std::uint8_t, 16> checksum_salt;
+	crypto::rng().randomize(checksum_salt.data(), checksum_salt.size());
+
+	srp6::Server server(gen, v);
+	const auto key = server.session_key(A);
+	const auto M1 = srp6::generate_client_proof("CHAOSVEX", key, gen.prime(), gen.generator(),
+	                                            A, server.public_ephemeral(), salt);
+	server.generate_proof(key, A, M1);
+
+	const PINAuthenticator::SaltBytes pin_salt{};
+	std::array<std::uint8_t, 20> pin_hash{};
+	PINAuthenticator pin_auth(0x3a0442e3u);
+	pin_auth.validate_pin(pin_salt, pin_salt, pin_hash, 123456);
+
+	const std::array<std::byte, 64> binary{};
+	const auto checksum = client_integrity::checksum(checksum_salt, binary);
+	client_integrity::finalise(checksum, checksum_salt);
+
+	return counter.count();
+}
+
+/*
+ * Runs the function on a thread that hasn't yet constructed any of
+ * its per-thread instances, regardless of what earlier tests have done
+ */
+template<typename Func>
+auto on_new_thread(Func&& func) {
+	decltype(func()) result{};
+	std::thread thread([&] { result = func(); });
+	thread.join();
+	return result;
+}
+
+} // unnamed
+
+TEST(CryptoAllocations, CachedHashers) {
+	std::array<std::uint8_t, 20> out;
+	const std::array<std::uint8_t, 16> key{};
+
+	// first use constructs the thread's instances
+	crypto::hasher(crypto::Hash::SHA1).final(out.data());
+	crypto::mac(crypto::Mac::HMAC_SHA1).set_key(key.data(), key.size());
+
+	AllocationCounter counter;
+
+	for(int i = 0; i < 16; ++i) {
+		auto& hasher = crypto::hasher(crypto::Hash::SHA1);
+		hasher.update(key.data(), key.size());
+		hasher.final(out.data());
+
+		auto& hmac = crypto::mac(crypto::Mac::HMAC_SHA1);
+		hmac.set_key(key.data(), key.size());
+		hmac.update(out.data(), out.size());
+		hmac.final(out.data());
+	}
+
+	EXPECT_EQ(0, counter.count());
+}
+
+TEST(CryptoAllocations, HasherReset) {
+	std::array<std::uint8_t, 20> expected, out;
+	const std::string input("input");
+
+	auto& hasher = crypto::hasher(crypto::Hash::SHA1);
+	hasher.update(input);
+	hasher.final(expected.data());
+
+	// state left behind by an abandoned operation must not leak into the next
+	crypto::hasher(crypto::Hash::SHA1).update("garbage");
+
+	auto& reused = crypto::hasher(crypto::Hash::SHA1);
+	reused.update(input);
+	reused.final(out.data());
+	EXPECT_EQ(expected, out);
+}
+
+TEST(CryptoAllocations, LoginHandshake) {
+	const srp6::Generator gen(srp6::Generator::Group::_256_BIT, 256);
+	std::array<std::uint8_t, 32> salt{};
+	srp6::generate_salt(salt);
+	const auto v = srp6::generate_verifier("CHAOSVEX", "ABC", gen, salt, srp6::Compliance::GAME);
+	const auto A = srp6::Client("CHAOSVEX", "ABC", gen).public_ephemeral();
+
+	// what it costs to construct the instances the handshake uses
+	const auto construction = on_new_thread([] {
+		AllocationCounter counter;
+		crypto::rng();
+		crypto::hasher(crypto::Hash::SHA1);
+		crypto::mac(crypto::Mac::HMAC_SHA1);
+		return counter.count();
+	});
+
+	ASSERT_GT(construction, 0u);
+
+	on_new_thread([&] {
+		const auto cold = handshake(gen, v, A, salt);
+		const auto* rng = &crypto::rng();
+		const auto* hasher = &crypto::hasher(crypto::Hash::SHA1);
+		const auto* hmac = &crypto::mac(crypto::Mac::HMAC_SHA1);
+
+		/*
+		 * Bignum arithmetic still allocates but none of the instances
+		 * should be constructed again once the thread is warm, so every
+		 * subsequent handshake should save at least the construction cost
+		 */
+		for(int i = 0; i < 8; ++i) {
+			EXPECT_GE(cold, handshake(gen, v, A, salt) + construction);
+		}
+
+		EXPECT_EQ(rng, &crypto::rng());
+		EXPECT_EQ(hasher, &crypto::hasher(crypto::Hash::SHA1));
+		EXPECT_EQ(hmac, &crypto::mac(crypto::Mac::HMAC_SHA1));
+		return 0;
+	});
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <dbcreader/Index.h>
+#include <dbcreader/Store.h>
+#include <tools/dbcparser/Validator.h>
+#include <logger/Logger.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+
+namespace {
+
+enum class Race : std::uint8_t {
+	HUMAN = 1, ORC, DWARF
+};
+
+struct StartInfo {
+	std::uint32_t id;
+	Race race;
+	std::uint8_t class_id;
+	std::int32_t zone;
+};
+
+using RaceClassIndex = dbc::Index<StartInfo, &StartInfo::race, &StartInfo::class_id>;
+
+dbc::Store<StartInfo> start_info() {
+	dbc::Store<StartInfo> store;
+
+	// out of order, to check the records come back in primary key order
+	store.emplace_back(4, StartInfo{ 4, Race::HUMAN, 1, 40 });
+	store.emplace_back(1, StartInfo{ 1, Race::HUMAN, 1, 10 });
+	store.emplace_back(2, StartInfo{ 2, Race::ORC, 1, 20 });
+	store.emplace_back(3, StartInfo{ 3, Race::HUMAN, 2, 30 });
+	return store;
+}
+
+dbc::types::Field field(std::string name, std::string type) {
+	dbc::types::Field field;
+	field.name = std::move(name);
+	field.underlying_type = std::move(type);
+	return field;
+}
+
+/*
+ * A DBC (or plain struct) with integer, array and string fields,
+ * indexed by whatever the test gives it
+ */
+dbc::types::Definitions definition(std::vector<dbc::types::Index> indexes, bool dbc = true) {
+	auto def = std::make_unique<dbc::types::Struct>();
+	def->name = "StartInfo";
+	def->dbc = dbc;
+
+	auto id = field("id", "uint32");
+
+	if(dbc) {
+		id.keys.emplace_back(dbc::types::Key{ .type = "primary" });
+	}
+
+	def->fields.emplace_back(std::move(id));
+	def->fields.emplace_back(field("race", "uint8"));
+	def->fields.emplace_back(field("class_id", "uint8"));
+	def->fields.emplace_back(field("zones", "int32[2]"));
+	def->fields.emplace_back(field("name", "string_ref"));
+	def->indexes = std::move(indexes);
+
+	dbc::types::Definitions defs;
+	defs.emplace_back(std::move(def));
+	return defs;
+}
+
+// returns the validation error, if any
+std::string validate(std::vector<dbc::types::Index> indexes, bool dbc = true) {
+	static log::Logger logger;
+	log::global_logger(logger);
+
+	const auto defs = definition(std::move(indexes), dbc);
+	dbc::Validator validator;
+
+	try {
+		validator.validate(defs);
+	} catch(const dbc::exception& e) {
+		return e.what();
+	}
+
+	return {};
+}
+
+bool rejected(const std::string& error, const std::string& reason) {
+	return error.find(reason) != std::string::npos;
+}
+
+} // unnamed
+
+TEST(DBCIndex, Find) {
+	const auto store = start_info();
+	RaceClassIndex index;
+	index.build(store);
+
+	ASSERT_EQ(3, index.size());
+
+	const auto humans = index.find(Race::HUMAN, 1);
+	ASSERT_EQ(2, humans.size());
+	ASSERT_EQ(1, humans[0]->id);
+	ASSERT_EQ(4, humans[1]->id);
+
+	// arguments are converted to the field types
+	const auto orcs = index.find(2, 1u);
+	ASSERT_EQ(1, orcs.size());
+	ASSERT_EQ(2, orcs[0]->id);
+
+	ASSERT_TRUE(index.find(Race::DWARF, 1).empty());
+	ASSERT_TRUE(index.find(Race::ORC, 2).empty());
+}
+
+TEST(DBCIndex, First) {
+	const auto store = start_info();
+	RaceClassIndex index;
+	index.build(store);
+
+	const auto record = index.first(Race::HUMAN, 1);
+	ASSERT_NE(nullptr, record);
+	ASSERT_EQ(1, record->id);
+	ASSERT_EQ(10, record->zone);
+	ASSERT_EQ(store[1], record);
+
+	ASSERT_EQ(nullptr, index.first(Race::DWARF, 1));
+}
+
+TEST(DBCIndex, Rebuild) {
+	auto store = start_info();
+	RaceClassIndex index;
+	index.build(store);
+
+	store.emplace_back(5, StartInfo{ 5, Race::DWARF, 1, 50 });
+	ASSERT_EQ(nullptr, index.first(Race::DWARF, 1));
+
+	index.build(store);
+	ASSERT_EQ(4, index.size());
+	ASSERT_EQ(5, index.first(Race::DWARF, 1)->id);
+	ASSERT_EQ(2, index.find(Race::HUMAN, 1).size());
+}
+
+TEST(DBCIndexValidation, Valid) {
+	const auto error = validate({
+		{ "by_race", { "race" } },
+		{ "by_race_class", { "race", "class_id" } }
+	});
+
+	ASSERT_TRUE(error.empty()) << error;
+}
+
+TEST(DBCIndexValidation, NonDBC) {
+	ASSERT_TRUE(validate({}, false).empty());
+
+	const auto error = validate({ { "by_race", { "race" } } }, false);
+	ASSERT_TRUE(rejected(error, "Only DBC nodes may contain indexes")) << error;
+}
+
+TEST(DBCIndexValidation, InvalidName) {
+	auto error = validate({ { "by race", { "race" } } });
+	ASSERT_TRUE(rejected(error, "not a valid C++ identifier")) << error;
+
+	error = validate({ { "class", { "race" } } });
+	ASSERT_TRUE(rejected(error, "reserved word")) << error;
+}
+
+TEST(DBCIndexValidation, DuplicateName) {
+	const auto error = validate({
+		{ "by_race", { "race" } },
+		{ "by_race", { "class_id" } }
+	});
+
+	ASSERT_TRUE(rejected(error, "multiple indexes with the same name")) << error;
+}
+
+TEST(DBCIndexValidation, DuplicateField) {
+	const auto error = validate({ { "by_race", { "race", "race" } } });
+	ASSERT_TRUE(rejected(error, "race is indexed more than once")) << error;
+}
+
+TEST(DBCIndexValidation, UnknownField) {
+	const auto error = validate({ { "by_gender", { "gender" } } });
+	ASSERT_TRUE(rejected(error, "gender is not a field in StartInfo")) << error;
+}
+
+TEST(DBCIndexValidation, ArrayField) {
+	const auto error = validate({ { "by_zones", { "zones" } } });
+	ASSERT_TRUE(rejected(error, "array fields cannot be indexed")) << error;
+}
+
+TEST(DBCIndexValidation, StringField) {
+	const auto error = validate({ { "by_name", { "name" } } });
+	ASSERT_TRUE(rejected(error, "string fields cannot be indexed")) << error;
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "GruntPacketDumps.h"
+#include <login/grunt/Handler.h>
+#include <login/grunt/Packets.h>
+#include <logger/Logger.h>
+#include <spark/buffers/DynamicBuffer.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <span>
+#include <vector>
+#include <cstdint>
+
+/*
+ * These tests feed the Grunt handler the same packet dumps used by the
+ * protocol tests, but split, truncated and mangled in the ways a client
+ * (or somebody pretending to be one) might send them. None of them should
+ * ever cause an exception to escape the handler.
+ */
+
+using namespace ember;
+
+namespace {
+
+using Dump = std::span<const unsigned char>;
+
+const Dump client_dumps[] = {
+	client_login_challenge,
+	client_login_proof,
+	client_reconnect_proof,
+	request_realm_list
+};
+
+const grunt::Opcode client_opcodes[] = {
+	grunt::Opcode::CMD_AUTH_LOGON_CHALLENGE,
+	grunt::Opcode::CMD_AUTH_LOGON_PROOF,
+	grunt::Opcode::CMD_AUTH_RECONNECT_CHALLENGE,
+	grunt::Opcode::CMD_AUTH_RECONNECT_PROOF,
+	grunt::Opcode::CMD_SURVEY_RESULT,
+	grunt::Opcode::CMD_REALM_LIST,
+	grunt::Opcode::CMD_XFER_ACCEPT,
+	grunt::Opcode::CMD_XFER_RESUME,
+	grunt::Opcode::CMD_XFER_CANCEL
+};
+
+} // unnamed
+
+TEST(GruntParser, WholePackets) {
+	log::Logger logger;
+
+	for(const auto dump : client_dumps) {
+		grunt::Handler handler(logger);
+		spark::io::DynamicBuffer<1024> buffer;
+		buffer.write(dump.data(), dump.size());
+
+		const auto result = handler.process_buffer(buffer);
+		ASSERT_TRUE(result);
+		ASSERT_TRUE(*result);
+		ASSERT_EQ(static_cast<grunt::Opcode>(dump[0]), result->value().get().opcode);
+		ASSERT_TRUE(buffer.empty());
+	}
+}
+
+TEST(GruntParser, Fragmented) {
+	log::Logger logger;
+
+	for(const auto dump : client_dumps) {
+		grunt::Handler handler(logger);
+		spark::io::DynamicBuffer<1024> buffer;
+
+		for(std::size_t i = 0; i < dump.size() - 1; ++i) {
+			buffer.write(&dump[i], 1);
+			grunt::Handler::Result result;
+			ASSERT_NO_THROW(result = handler.process_buffer(buffer));
+			ASSERT_TRUE(result) << "Error after " << i + 1 << " bytes";
+			ASSERT_FALSE(*result) << "Completed after " << i + 1 << " bytes";
+		}
+
+		buffer.write(&dump.back(), 1);
+		const auto result = handler.process_buffer(buffer);
+		ASSERT_TRUE(result);
+		ASSERT_TRUE(*result);
+		ASSERT_EQ(static_cast<grunt::Opcode>(dump[0]), result->value().get().opcode);
+		ASSERT_TRUE(buffer.empty());
+	}
+}
+
+TEST(GruntParser, Pipelined) {
+	log::Logger logger;
+	grunt::Handler handler(logger);
+	spark::io::DynamicBuffer<1024> buffer;
+
+	for(const auto dump : client_dumps) {
+		buffer.write(dump.data(), dump.size());
+	}
+
+	for(const auto dump : client_dumps) {
+		const auto result = handler.process_buffer(buffer);
+		ASSERT_TRUE(result);
+		ASSERT_TRUE(*result);
+		ASSERT_EQ(static_cast<grunt::Opcode>(dump[0]), result->value().get().opcode);
+	}
+
+	ASSERT_TRUE(buffer.empty());
+}
+
+TEST(GruntParser, Truncated) {
+	log::Logger logger;
+
+	for(const auto dump : client_dumps) {
+		for(std::size_t len = 1; len < dump.size(); ++len) {
+			grunt::Handler handler(logger);
+			spark::io::DynamicBuffer<1024> buffer;
+			buffer.write(dump.data(), len);
+
+			grunt::Handler::Result result;
+			ASSERT_NO_THROW(result = handler.process_buffer(buffer));
+			ASSERT_TRUE(result);
+			ASSERT_FALSE(*result);
+		}
+	}
+}
+
+TEST(GruntParser, UnknownOpcode) {
+	log::Logger logger;
+	grunt::Handler handler(logger);
+	spark::io::DynamicBuffer<1024> buffer;
+	const std::uint8_t junk[] = { 0xff, 0x00, 0x00, 0x00 };
+	buffer.write(junk, sizeof(junk));
+
+	const auto result = handler.process_buffer(buffer);
+	ASSERT_FALSE(result);
+	ASSERT_EQ(grunt::Handler::Error::UNKNOWN_OPCODE, result.error());
+
+	// once errored, the handler should refuse any further data
+	buffer.write(request_realm_list, sizeof(request_realm_list));
+	ASSERT_FALSE(handler.process_buffer(buffer));
+}
+
+TEST(GruntParser, BadUsernameLength) {
+	log::Logger logger;
+	std::vector<unsigned char> packet(std::begin(client_login_challenge),
+	                                  std::end(client_login_challenge));
+	packet[33] = 0x10; // username length, longer than the remaining body
+
+	grunt::Handler handler(logger);
+	spark::io::DynamicBuffer<1024> buffer;
+	buffer.write(packet.data(), packet.size());
+
+	const auto result = handler.process_buffer(buffer);
+	ASSERT_FALSE(result);
+	ASSERT_EQ(grunt::Handler::Error::MALFORMED_PACKET, result.error());
+}
+
+TEST(GruntParser, BadBodySize) {
+	log::Logger logger;
+	std::vector<unsigned char> packet(std::begin(client_login_challenge),
+	                                  std::end(client_login_challenge));
+	packet[2] = 0xff; // body size, larger than any valid challenge
+	packet[3] = 0xff;
+
+	grunt::Handler handler(logger);
+	spark::io::DynamicBuffer<1024> buffer;
+
+	// the header alone should be enough to reject it
+	buffer.write(packet.data(), 4);
+
+	const auto result = handler.process_buffer(buffer);
+	ASSERT_FALSE(result);
+	ASSERT_EQ(grunt::Handler::Error::MALFORMED_PACKET, result.error());
+}
+
+TEST(GruntParser, RandomJunk) {
+	log::Logger logger;
+	std::mt19937 gen(0x454d4252);
+	std::uniform_int_distribution<unsigned int> byte_dist(0, 255);
+	std::uniform_int_distribution<std::size_t> len_dist(1, 256);
+
+	for(auto i = 0; i < 5000; ++i) {
+		grunt::Handler handler(logger);
+		spark::io::DynamicBuffer<1024> buffer;
+		std::vector<std::uint8_t> junk(len_dist(gen));
+		std::ranges::generate(junk, [&] { return static_cast<std::uint8_t>(byte_dist(gen)); });
+
+		// give the junk a valid opcode half of the time to get past the first check
+		if(i % 2) {
+			const auto index = i % std::size(client_opcodes);
+			junk[0] = static_cast<std::uint8_t>(client_opcodes[index]);
+		}
+
+		std::size_t offset = 0;
+		bool errored = false;
+
+		while(offset < junk.size() && !errored) {
+			const auto chunk = std::min(len_dist(gen) % 32 + 1, junk.size() - offset);
+			buffer.write(junk.data() + offset, chunk);
+			offset += chunk;
+
+			// keep going until the handler needs more data or gives up
+			grunt::Handler::Result result;
+
+			do {
+				ASSERT_NO_THROW(result = handler.process_buffer(buffer));
+				errored = !result;
+			} while(result && *result && !buffer.empty());
+		}
+	}
+}
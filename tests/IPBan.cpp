@@ -9,6 +9,8 @@
 #include <shared/IPBanCache.h>
 #include <gtest/gtest.h>
 #include <memory>
+#include <random>
+#include <utility>
 #include <vector>
 
 using namespace ember;
@@ -107,3 +109,78 @@ TEST_F(IPBanTest, IPv6BannedInRange) {
 TEST_F(IPBanTest, IPv6NotBanned) {
 	EXPECT_FALSE(bans->is_banned("2001:0db9::"));
 }
+
+TEST_F(IPBanTest, IPv4Mapped) {
+	EXPECT_TRUE(bans->is_banned("::ffff:192.88.99.62"));
+	EXPECT_FALSE(bans->is_banned("::ffff:192.88.99.63"));
+}
+
+TEST_F(IPBanTest, Reload) {
+	EXPECT_TRUE(bans->is_banned("192.88.99.62"));
+
+	const std::vector<IPEntry> entries {
+		{ "10.0.0.0", 8 }
+	};
+
+	bans->reload(entries);
+	EXPECT_FALSE(bans->is_banned("192.88.99.62"));
+	EXPECT_TRUE(bans->is_banned("10.1.2.3"));
+	EXPECT_EQ(1, bans->size());
+}
+
+TEST_F(IPBanTest, AddBan) {
+	EXPECT_FALSE(bans->is_banned("10.1.2.3"));
+	bans->ban("10.1.2.0", 24);
+	EXPECT_TRUE(bans->is_banned("10.1.2.3"));
+	EXPECT_FALSE(bans->is_banned("10.1.3.3"));
+	EXPECT_TRUE(bans->is_banned("192.88.99.62"));
+}
+
+TEST_F(IPBanTest, CoveredPrefixes) {
+	const std::vector<IPEntry> entries {
+		{ "10.1.2.0",  24 },
+		{ "10.1.2.77", 32 },
+		{ "10.0.0.0",   8 }, // covers both of the above
+		{ "10.1.0.0",  16 }, // already covered
+		{ "11.0.0.0",   8 }
+	};
+
+	bans->reload(entries);
+	EXPECT_TRUE(bans->is_banned("10.255.0.1"));
+	EXPECT_TRUE(bans->is_banned("10.1.2.77"));
+	EXPECT_TRUE(bans->is_banned("11.0.0.1"));
+	EXPECT_FALSE(bans->is_banned("12.0.0.1"));
+	EXPECT_FALSE(bans->is_banned("9.255.255.255"));
+}
+
+TEST_F(IPBanTest, MatchesLinearScan) {
+	std::mt19937 gen(1337);
+	std::uniform_int_distribution<std::uint32_t> addr_dist;
+	std::uniform_int_distribution<std::uint32_t> cidr_dist(8, 32);
+
+	std::vector<IPEntry> entries;
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+
+	for(auto i = 0; i < 2000; ++i) {
+		const auto address = boost::asio::ip::make_address_v4(addr_dist(gen));
+		const auto cidr = cidr_dist(gen);
+		entries.emplace_back(address.to_string(), cidr);
+		ranges.emplace_back(address.to_uint(), (~0U) << (32 - cidr));
+	}
+
+	bans->reload(entries);
+
+	for(auto i = 0; i < 20000; ++i) {
+		const auto value = addr_dist(gen);
+		bool expected = false;
+
+		for(const auto& [range, mask] : ranges) {
+			if((value & mask) == (range & mask)) {
+				expected = true;
+				break;
+			}
+		}
+
+		ASSERT_EQ(expected, bans->is_banned(boost::asio::ip::make_address_v4(value)));
+	}
+}
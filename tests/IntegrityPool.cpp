@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <login/IntegrityPool.h>
+#include <login/ExecutablesChecksum.h>
+#include <shared/metrics/Metrics.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+namespace {
+
+const GameVersion version {
+	.major = 1,
+	.minor = 12,
+	.build = 5875,
+};
+
+} // unnamed
+
+TEST(IntegrityPool, Refill) {
+	IntegrityData data;
+	data.add_version(version, "test_data/");
+
+	Metrics metrics;
+	IntegrityPool pool(data, 8, 2, metrics);
+
+	for(auto i = 0; i < 500 && pool.available() < 8; ++i) {
+		std::this_thread::sleep_for(10ms);
+	}
+
+	ASSERT_EQ(pool.available(), 8);
+
+	const auto entry = pool.pop(version, grunt::Platform::x86, grunt::System::Win);
+	ASSERT_TRUE(entry);
+
+	const auto bin = data.lookup(version, grunt::Platform::x86, grunt::System::Win);
+	ASSERT_EQ(entry->checksum, client_integrity::checksum(entry->salt, *bin));
+	ASSERT_EQ(pool.exhausted(), 0);
+}
+
+TEST(IntegrityPool, Exhausted) {
+	IntegrityData data;
+	data.add_version(version, "test_data/");
+
+	Metrics metrics;
+	IntegrityPool pool(data, 8, 0, metrics);
+
+	ASSERT_FALSE(pool.pop(version, grunt::Platform::x86, grunt::System::Win));
+	ASSERT_EQ(pool.exhausted(), 1);
+}
+
+TEST(IntegrityPool, UnknownVersion) {
+	IntegrityData data;
+	data.add_version(version, "test_data/");
+
+	Metrics metrics;
+	IntegrityPool pool(data, 8, 1, metrics);
+
+	ASSERT_FALSE(pool.pop(version, grunt::Platform::PPC, grunt::System::OSX));
+	ASSERT_EQ(pool.exhausted(), 0);
+}
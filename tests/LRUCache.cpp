@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/utility/LRUCache.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+TEST(LRUCache, GetPut) {
+	LRUCache<std::string, std::uint32_t> cache(16, 1h);
+	ASSERT_FALSE(cache.get("PLAYER"));
+	cache.put("PLAYER", 42);
+	ASSERT_EQ(42, cache.get("PLAYER"));
+	cache.put("PLAYER", 43);
+	ASSERT_EQ(43, cache.get("PLAYER"));
+
+	const auto stats = cache.stats();
+	ASSERT_EQ(2, stats.hits);
+	ASSERT_EQ(1, stats.misses);
+	ASSERT_EQ(1, stats.size);
+}
+
+TEST(LRUCache, Eviction) {
+	// single shard to make the eviction order deterministic
+	LRUCache<std::uint32_t, std::uint32_t> cache(3, 1h, 1);
+	cache.put(1, 1);
+	cache.put(2, 2);
+	cache.put(3, 3);
+
+	// touch the oldest entry so that the next oldest is evicted instead
+	ASSERT_TRUE(cache.get(1));
+	cache.put(4, 4);
+
+	ASSERT_TRUE(cache.get(1));
+	ASSERT_FALSE(cache.get(2));
+	ASSERT_TRUE(cache.get(3));
+	ASSERT_TRUE(cache.get(4));
+	ASSERT_EQ(1, cache.stats().evictions);
+	ASSERT_EQ(3, cache.stats().size);
+}
+
+TEST(LRUCache, Expiry) {
+	LRUCache<std::uint32_t, std::uint32_t> cache(16, 10ms);
+	cache.put(1, 1);
+	ASSERT_TRUE(cache.get(1));
+	std::this_thread::sleep_for(20ms);
+	ASSERT_FALSE(cache.get(1));
+	ASSERT_EQ(1, cache.stats().expirations);
+	ASSERT_EQ(0, cache.stats().size);
+}
+
+TEST(LRUCache, Erase) {
+	LRUCache<std::uint32_t, std::string> cache(16, 1h);
+	cache.put(1, "one");
+	cache.put(2, "two");
+	ASSERT_EQ("one", cache.erase(1));
+	ASSERT_FALSE(cache.erase(1));
+	ASSERT_FALSE(cache.get(1));
+	cache.clear();
+	ASSERT_FALSE(cache.get(2));
+	ASSERT_EQ(0, cache.stats().size);
+}
+
+TEST(LRUCache, Take) {
+	LRUCache<std::uint32_t, std::string> cache(16, 1h);
+	cache.put(1, "one");
+	ASSERT_EQ("one", cache.take(1));
+	ASSERT_FALSE(cache.take(1));
+	ASSERT_FALSE(cache.get(1));
+	ASSERT_EQ(0, cache.stats().size);
+}
+
+// only one of any number of racing takers should get the entry
+TEST(LRUCache, TakeOnce) {
+	LRUCache<std::uint32_t, std::uint32_t> cache(1024, 1h);
+	std::atomic<std::uint32_t> taken = 0;
+
+	for(std::uint32_t i = 0; i < 256; ++i) {
+		cache.put(i, i);
+	}
+
+	{
+		std::vector<std::jthread> threads;
+
+		for(auto t = 0; t < 4; ++t) {
+			threads.emplace_back([&] {
+				for(std::uint32_t i = 0; i < 256; ++i) {
+					if(cache.take(i)) {
+						++taken;
+					}
+				}
+			});
+		}
+	}
+
+	ASSERT_EQ(256, taken);
+	ASSERT_EQ(0, cache.stats().size);
+}
+
+TEST(LRUCache, Capacity) {
+	// capacity is split between shards, so a single shard can't take over the cache
+	LRUCache<std::uint32_t, std::uint32_t> cache(64, 1h, 4);
+	ASSERT_EQ(64, cache.capacity());
+
+	for(std::uint32_t i = 0; i < 1000; ++i) {
+		cache.put(i, i);
+	}
+
+	ASSERT_LE(cache.stats().size, 64);
+}
+
+TEST(LRUCache, Concurrent) {
+	LRUCache<std::uint32_t, std::uint32_t> cache(1024, 1h);
+	std::vector<std::jthread> threads;
+
+	for(std::uint32_t t = 0; t < 4; ++t) {
+		threads.emplace_back([&cache, t] {
+			for(std::uint32_t i = 0; i < 10000; ++i) {
+				const auto key = (i * 4 + t) % 512;
+
+				if(const auto value = cache.get(key)) {
+					ASSERT_EQ(key, *value);
+				} else {
+					cache.put(key, key);
+				}
+			}
+		});
+	}
+
+	threads.clear();
+	const auto stats = cache.stats();
+	ASSERT_EQ(40000, stats.hits + stats.misses);
+	ASSERT_EQ(512, stats.size);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/metrics/LatencyTracker.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ember;
+
+namespace {
+
+std::uint64_t ticks(const std::chrono::nanoseconds ns) {
+	return static_cast<std::uint64_t>(ns.count() * util::tsc::ticks_per_ns());
+}
+
+std::string key_name(const std::size_t key) {
+	return std::to_string(key);
+}
+
+} // unnamed
+
+TEST(LatencyTracker, Disabled) {
+	LatencyTracker tracker("test", 4, key_name);
+
+	{
+		ScopedLatency timer(&tracker, 1);
+	}
+
+	ASSERT_TRUE(tracker.collect().empty());
+}
+
+TEST(LatencyTracker, Percentiles) {
+	using namespace std::chrono_literals;
+	LatencyTracker tracker("test", 4, key_name, true);
+
+	for(auto i = 0; i < 99; ++i) {
+		tracker.record(2, ticks(1us));
+	}
+
+	tracker.record(2, ticks(10ms));
+
+	const auto summaries = tracker.collect();
+	ASSERT_EQ(summaries.size(), 1);
+	ASSERT_EQ(summaries[0].key, 2);
+	ASSERT_EQ(summaries[0].count, 100);
+	ASSERT_LE(summaries[0].p50, 4us);
+	ASSERT_LE(summaries[0].p99, 4us);
+	ASSERT_GE(summaries[0].max, 5ms);
+
+	// collecting again should only report activity since the last collection
+	ASSERT_TRUE(tracker.collect().empty());
+}
+
+TEST(LatencyTracker, MultipleThreads) {
+	constexpr auto threads = 4;
+	constexpr auto iterations = 1000;
+	LatencyTracker tracker("test", 4, key_name, true);
+	std::vector<std::jthread> workers;
+
+	for(auto i = 0; i < threads; ++i) {
+		workers.emplace_back([&, i] {
+			for(auto j = 0; j < iterations; ++j) {
+				ScopedLatency timer(&tracker, i % 2);
+			}
+		});
+	}
+
+	workers.clear();
+
+	const auto summaries = tracker.collect();
+	ASSERT_EQ(summaries.size(), 2);
+	ASSERT_EQ(summaries[0].count + summaries[1].count, threads * iterations);
+}
+
+TEST(LatencyTracker, Slowest) {
+	using namespace std::chrono_literals;
+	LatencyTracker tracker("opcodes", 4, key_name, true);
+	tracker.record(0, ticks(1us));
+	tracker.record(1, ticks(1ms));
+	tracker.record(3, ticks(100us));
+
+	const auto summaries = tracker.collect();
+	const auto line = tracker.describe_slowest(summaries, 2);
+	ASSERT_TRUE(line.starts_with("Slowest opcodes"));
+	ASSERT_LT(line.find(" 1 "), line.find(" 3 "));
+	ASSERT_EQ(line.find(" 0 "), std::string::npos);
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/metrics/MetricsRegistry.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+TEST(MetricsRegistry, Counter) {
+	MetricsRegistry registry("test_");
+	registry.increment("logins");
+	registry.increment("logins", 4);
+
+	std::string out;
+	registry.render(out);
+	ASSERT_NE(out.find("# TYPE test_logins counter\n"), std::string::npos);
+	ASSERT_NE(out.find("test_logins 5\n"), std::string::npos);
+}
+
+TEST(MetricsRegistry, GaugeAdjustment) {
+	MetricsRegistry registry("");
+	registry.gauge("sessions", 10);
+	registry.gauge("sessions", 5, Metrics::Adjustment::POSITIVE);
+	registry.gauge("sessions", 3, Metrics::Adjustment::NEGATIVE);
+
+	std::string out;
+	registry.render(out);
+	ASSERT_NE(out.find("# TYPE sessions gauge\n"), std::string::npos);
+	ASSERT_NE(out.find("sessions 12\n"), std::string::npos);
+}
+
+TEST(MetricsRegistry, HistogramBuckets) {
+	MetricsRegistry registry("");
+	registry.timing("query", 1ms);
+	registry.timing("query", 7ms);
+	registry.timing("query", 60000ms);
+
+	std::string out;
+	registry.render(out);
+	ASSERT_NE(out.find("# TYPE query histogram\n"), std::string::npos);
+	ASSERT_NE(out.find("query_bucket{le=\"1\"} 1\n"), std::string::npos);
+	ASSERT_NE(out.find("query_bucket{le=\"5\"} 1\n"), std::string::npos);
+	ASSERT_NE(out.find("query_bucket{le=\"10\"} 2\n"), std::string::npos);
+	ASSERT_NE(out.find("query_bucket{le=\"30000\"} 2\n"), std::string::npos);
+	ASSERT_NE(out.find("query_bucket{le=\"+Inf\"} 3\n"), std::string::npos);
+	ASSERT_NE(out.find("query_sum 60008\n"), std::string::npos);
+	ASSERT_NE(out.find("query_count 3\n"), std::string::npos);
+}
+
+TEST(MetricsRegistry, NameSanitisation) {
+	MetricsRegistry registry("");
+	registry.increment("db.connections-opened");
+	registry.increment("2fa");
+
+	std::string out;
+	registry.render(out);
+	ASSERT_NE(out.find("db_connections_opened 1\n"), std::string::npos);
+	ASSERT_NE(out.find("_2fa 1\n"), std::string::npos);
+}
+
+TEST(MetricsRegistry, Forwarding) {
+	struct Counting final : Metrics {
+		int& calls;
+		explicit Counting(int& calls) : calls(calls) {}
+		void increment(const char*, std::intmax_t) override { ++calls; }
+	};
+
+	int calls = 0;
+	MetricsRegistry registry("", std::make_unique<Counting>(calls));
+	registry.increment("a");
+	registry.increment("b");
+	ASSERT_EQ(calls, 2);
+	ASSERT_EQ(registry.size(), 2);
+}
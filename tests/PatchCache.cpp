@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+#include <login/PatchCache.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace ember;
+
+class PatchCacheTest : public ::testing::Test {
+protected:
+	std::filesystem::path dir_;
+	std::vector<std::byte> contents_;
+	PatchMeta meta_{};
+
+	void SetUp() override {
+		dir_ = std::filesystem::temp_directory_path() / "ember_patch_cache_test";
+		std::filesystem::create_directories(dir_);
+
+		contents_.resize(200'000);
+
+		for(std::size_t i = 0; i < contents_.size(); ++i) {
+			contents_[i] = static_cast<std::byte>(i * 31);
+		}
+
+		std::ofstream file(dir_ / "patch.mpq", std::ios::binary);
+		file.write(reinterpret_cast<const char*>(contents_.data()), contents_.size());
+
+		meta_.id = 7;
+		meta_.file_meta.path = dir_.string() + "/";
+		meta_.file_meta.name = "patch.mpq";
+		meta_.file_meta.size = contents_.size();
+	}
+
+	void TearDown() override {
+		std::filesystem::remove_all(dir_);
+	}
+};
+
+TEST_F(PatchCacheTest, MapsFile) {
+	PatchCache cache;
+	const auto mapping = cache.acquire(meta_);
+	ASSERT_TRUE(mapping);
+	ASSERT_TRUE(std::ranges::equal(contents_, mapping->data()));
+}
+
+TEST_F(PatchCacheTest, SharedMapping) {
+	PatchCache cache;
+	const auto first = cache.acquire(meta_);
+	const auto second = cache.acquire(meta_);
+	ASSERT_EQ(first, second);
+	ASSERT_EQ(1, cache.size());
+}
+
+TEST_F(PatchCacheTest, SizeMismatch) {
+	PatchCache cache;
+	meta_.file_meta.size += 1;
+	ASSERT_THROW(cache.acquire(meta_), std::runtime_error);
+	ASSERT_EQ(0, cache.size());
+}
+
+TEST_F(PatchCacheTest, MissingFile) {
+	PatchCache cache;
+	meta_.file_meta.name = "missing.mpq";
+	ASSERT_ANY_THROW(cache.acquire(meta_));
+}
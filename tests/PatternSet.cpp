@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/utility/PatternSet.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <pcre.h>
+
+using namespace ember::util;
+
+TEST(PatternSet, Match) {
+	const std::vector<std::string> patterns {
+		"^blizz", "thrall$", "^ar+thas$", R"(\<jaina\>)"
+	};
+
+	const pcre::PatternSet set(patterns);
+	ASSERT_EQ(4, set.size());
+	ASSERT_EQ(1, set.expressions());
+
+	ASSERT_GE(set.match("Blizzard"), 0);
+	ASSERT_GE(set.match("Notthrall"), 0);
+	ASSERT_GE(set.match("Arrrthas"), 0);
+	ASSERT_EQ(PCRE_ERROR_NOMATCH, set.match("Thralled"));
+	ASSERT_EQ(PCRE_ERROR_NOMATCH, set.match("Xarthas"));
+	ASSERT_EQ(PCRE_ERROR_NOMATCH, set.match("Bob"));
+}
+
+TEST(PatternSet, Empty) {
+	const pcre::PatternSet set;
+	ASSERT_EQ(0, set.size());
+	ASSERT_EQ(0, set.expressions());
+	ASSERT_EQ(PCRE_ERROR_NOMATCH, set.match("Bob"));
+}
+
+// anchors and word boundaries must stay with the pattern they belong to
+TEST(PatternSet, Isolation) {
+	const std::vector<std::string> patterns { "^ab|cd$", "^x" };
+	const pcre::PatternSet set(patterns);
+	ASSERT_GE(set.match("abzz"), 0);
+	ASSERT_GE(set.match("zzcd"), 0);
+	ASSERT_GE(set.match("xylo"), 0);
+	ASSERT_EQ(PCRE_ERROR_NOMATCH, set.match("zx"));
+}
+
+TEST(PatternSet, Backreferences) {
+	const std::vector<std::string> patterns { "^(a)b", "(.)\\1", "^c" };
+	const pcre::PatternSet set(patterns);
+	ASSERT_EQ(3, set.size());
+	ASSERT_EQ(2, set.expressions());
+
+	// \1 refers to its own group rather than the first in the set
+	ASSERT_GE(set.match("xyzzy"), 0);
+	ASSERT_EQ(PCRE_ERROR_NOMATCH, set.match("xyz"));
+	ASSERT_GE(set.match("ab"), 0);
+}
+
+// conditionals on a group number must test their own group, as with backreferences
+TEST(PatternSet, Conditionals) {
+	const std::vector<std::string> patterns {
+		"^(d)e", "^(a)?(?(1)b|c)$", "^(x)?(?(-1)y|z)$", "^(?(+1)q|r)(s)$", "^(?(?=f)fg|h)$"
+	};
+
+	const pcre::PatternSet set(patterns);
+	ASSERT_EQ(5, set.size());
+	ASSERT_EQ(4, set.expressions());
+
+	for(const auto& name : { "de", "ab", "c", "xy", "z", "rs", "fg", "h" }) {
+		ASSERT_GE(set.match(name), 0) << name;
+	}
+
+	ASSERT_EQ(PCRE_ERROR_NOMATCH, set.match("ac"));
+	ASSERT_EQ(PCRE_ERROR_NOMATCH, set.match("qs"));
+}
+
+TEST(PatternSet, Splitting) {
+	std::vector<std::string> patterns;
+
+	for(auto i = 0; i < 2000; ++i) {
+		patterns.emplace_back("^name" + std::to_string(i) + "$");
+	}
+
+	const pcre::PatternSet set(patterns);
+	ASSERT_EQ(patterns.size(), set.size());
+	ASSERT_GT(set.expressions(), 1);
+	ASSERT_LT(set.expressions(), patterns.size() / 10);
+
+	for(auto i = 0; i < 2000; ++i) {
+		ASSERT_GE(set.match("Name" + std::to_string(i)), 0);
+	}
+
+	ASSERT_EQ(PCRE_ERROR_NOMATCH, set.match("Name2000"));
+}
+
+TEST(PatternSet, Invalid) {
+	const std::vector<std::string> patterns { "^a", "(b" };
+	ASSERT_THROW(pcre::PatternSet set(patterns), std::runtime_error);
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <conpool/ConnectionPool.h>
+#include <conpool/Policies.h>
+#include <conpool/Statement.h>
+#include <conpool/drivers/PostgreSQL/Driver.h>
+#include <shared/database/daos/postgresql/IPBanDAO.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace ember;
+using namespace std::chrono_literals;
+namespace ep = connection_pool;
+namespace pg = drivers::pg;
+
+/*
+ * These run against a live server, given by a libpq connection string in
+ * the EMBER_TEST_POSTGRESQL environment variable, and are skipped without
+ * one, e.g. EMBER_TEST_POSTGRESQL="host=127.0.0.1 user=ember dbname=ember_test"
+ */
+namespace {
+
+const ep::Statement TYPES {
+	"SELECT $1::smallint AS i2, $2::integer AS i4, $3::bigint AS i8, $4::real AS f4, "
+	"$5::double precision AS f8, $6::text AS str, $7::bytea AS bytes, $8::boolean AS flag, "
+	"NULL::integer AS missing"
+};
+
+const ep::Statement ECHO { "SELECT $1::integer AS value" };
+const ep::Statement DIVIDE { "SELECT 1 / $1::integer AS value" };
+const ep::Statement INVALID { "SELECT value FROM table_that_does_not_exist" };
+
+class PostgreSQL : public ::testing::Test {
+protected:
+	std::optional<drivers::PostgreSQL> driver;
+	PGconn* conn = nullptr;
+	drivers::PostgreSQL::ConnectionState state;
+
+	void SetUp() override {
+		const auto conninfo = std::getenv("EMBER_TEST_POSTGRESQL");
+
+		if(!conninfo) {
+			GTEST_SKIP() << "EMBER_TEST_POSTGRESQL not set";
+		}
+
+		driver.emplace(conninfo);
+		conn = driver->open();
+		driver->open_state(conn, state);
+	}
+
+	void TearDown() override {
+		if(conn) {
+			driver->close(conn);
+		}
+	}
+};
+
+} // unnamed
+
+TEST_F(PostgreSQL, BinaryTypes) {
+	const std::vector<std::uint8_t> bytes { 0x00, 0xff, 0x10 };
+
+	const auto res = driver->execute(conn, state, TYPES, pg::Params(
+		-2, 123456, 9000000000ll, 1.5f, 2.25, std::string("hello"), bytes, true
+	));
+
+	ASSERT_EQ(1, res.rows());
+	ASSERT_EQ(-2, res.get<std::int16_t>(0, "i2"));
+	ASSERT_EQ(123456, res.get<std::int32_t>(0, "i4"));
+	ASSERT_EQ(9000000000ll, res.get<std::int64_t>(0, "i8"));
+	ASSERT_FLOAT_EQ(1.5f, res.get<float>(0, "f4"));
+	ASSERT_DOUBLE_EQ(2.25, res.get<double>(0, "f8"));
+	ASSERT_EQ("hello", res.get<std::string>(0, "str"));
+	ASSERT_EQ(bytes, res.get<std::vector<std::uint8_t>>(0, "bytes"));
+	ASSERT_TRUE(res.get<bool>(0, "flag"));
+	ASSERT_FALSE(res.get_optional<std::int32_t>(0, "missing"));
+
+	// lossy conversions should be rejected rather than truncated
+	ASSERT_THROW(res.get<std::uint16_t>(0, "i4"), pg::error);
+	ASSERT_THROW(res.get<std::uint32_t>(0, "i2"), pg::error);
+	ASSERT_THROW(res.get<std::string>(0, "i4"), pg::error);
+	ASSERT_THROW(res.get<std::int32_t>(0, "missing"), pg::error);
+}
+
+TEST_F(PostgreSQL, OpenState) {
+	// registered statements are prepared up front, other than those that can't be
+	ASSERT_TRUE(state.prepared[ECHO.id()]);
+	ASSERT_FALSE(state.prepared[INVALID.id()]);
+	ASSERT_THROW(driver->execute(conn, state, INVALID), pg::error);
+	ASSERT_TRUE(driver->clean(conn));
+	ASSERT_TRUE(driver->keep_alive(conn));
+}
+
+TEST_F(PostgreSQL, Pipeline) {
+	state.prepared[ECHO.id()] = false;
+	driver->simple_query(conn, ("DEALLOCATE " + std::string(pg::StatementName(ECHO.id()).c_str())).c_str());
+
+	pg::Pipeline pipeline(conn, state);
+	std::vector<std::size_t> indices;
+
+	for(auto i = 0; i < 10; ++i) {
+		indices.emplace_back(pipeline.send(ECHO, pg::Params(i)));
+	}
+
+	const auto results = pipeline.sync();
+	ASSERT_EQ(10, results.size());
+
+	// the statement should have been prepared once as part of the batch
+	ASSERT_TRUE(state.prepared[ECHO.id()]);
+
+	for(auto i = 0; i < 10; ++i) {
+		ASSERT_EQ(i, results[indices[i]].get<std::int32_t>(0, "value"));
+	}
+}
+
+TEST_F(PostgreSQL, PipelineFailure) {
+	{
+		pg::Pipeline pipeline(conn, state);
+		pipeline.send(ECHO, pg::Params(1));
+		pipeline.send(DIVIDE, pg::Params(0));
+		pipeline.send(ECHO, pg::Params(2));
+		ASSERT_THROW(pipeline.sync(), pg::error);
+	}
+
+	{
+		// abandoned without syncing
+		pg::Pipeline pipeline(conn, state);
+		pipeline.send(ECHO, pg::Params(3));
+	}
+
+	// connection should be left usable
+	ASSERT_TRUE(driver->clean(conn));
+	const auto res = driver->execute(conn, state, ECHO, pg::Params(4));
+	ASSERT_EQ(4, res.get<std::int32_t>(0, "value"));
+}
+
+TEST_F(PostgreSQL, Clean) {
+	driver->simple_query(conn, "BEGIN");
+	ASSERT_EQ(PQTRANS_INTRANS, PQtransactionStatus(conn));
+	ASSERT_TRUE(driver->clean(conn));
+	ASSERT_EQ(PQTRANS_IDLE, PQtransactionStatus(conn));
+}
+
+TEST_F(PostgreSQL, IPBanDAO) {
+	ep::Pool<drivers::PostgreSQL, ep::CheckinClean, ep::FixedSize> pool(*driver, 1, 1, 30s);
+
+	{
+		// temporary tables are per-session, hence the single connection
+		auto pooled = pool.try_acquire_for(5s);
+		driver->simple_query(*pooled, "CREATE TEMPORARY TABLE ip_bans "
+		                              "(id serial, ip varchar(45) NOT NULL, cidr integer NOT NULL)");
+	}
+
+	auto dao = dal::ip_ban_dao(pool);
+	ASSERT_FALSE(dao.get_mask("10.0.0.0"));
+	dao.ban({ "10.0.0.0", 8 });
+	dao.ban({ "192.168.0.0", 16 });
+	ASSERT_EQ(8, dao.get_mask("10.0.0.0"));
+	ASSERT_EQ(2, dao.all_bans().size());
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/metrics/Profiler.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+#if defined __linux__
+
+namespace {
+
+// something for the profiler to find
+[[gnu::noinline]] std::uint64_t burn(const std::chrono::milliseconds duration) {
+	volatile std::uint64_t value = 0;
+	const auto end = std::chrono::steady_clock::now() + duration;
+
+	while(std::chrono::steady_clock::now() < end) {
+		for(auto i = 0; i < 1000; ++i) {
+			value = value + i;
+		}
+	}
+
+	return value;
+}
+
+} // unnamed
+
+TEST(Profiler, TaggedSamples) {
+	const auto path = std::filesystem::temp_directory_path() / "ember_profiler_test.folded";
+	Profiler profiler(path, 1000, 0s);
+	profiler.start();
+	ASSERT_TRUE(Profiler::tagging());
+
+	std::jthread worker([] {
+		Profiler::register_thread("test_worker");
+		Profiler::ScopedTag state(Profiler::Tag::STATE, "BURNING");
+		Profiler::ScopedTag opcode(Profiler::Tag::OPCODE, "CMSG_TEST");
+		burn(300ms);
+	});
+
+	worker.join();
+	profiler.stop();
+	ASSERT_FALSE(Profiler::tagging());
+	ASSERT_GT(profiler.samples(), 0);
+
+	std::ifstream file(path);
+	std::string line;
+	bool found = false;
+
+	while(std::getline(file, line)) {
+		if(line.starts_with("test_worker;[BURNING];[CMSG_TEST];")) {
+			found = true;
+		}
+	}
+
+	ASSERT_TRUE(found);
+	std::filesystem::remove(path);
+}
+
+TEST(Profiler, UnregisteredThreads) {
+	const auto path = std::filesystem::temp_directory_path() / "ember_profiler_test_unreg.folded";
+	Profiler profiler(path, 1000, 0s);
+	profiler.start();
+
+	std::jthread worker([] {
+		burn(100ms);
+	});
+
+	worker.join();
+	profiler.stop();
+	ASSERT_EQ(profiler.samples(), 0);
+	std::filesystem::remove(path);
+}
+
+// samples taken by a thread that exits before the next drain shouldn't be lost
+TEST(Profiler, ExitedThreads) {
+	const auto path = std::filesystem::temp_directory_path() / "ember_profiler_test_exit.folded";
+	Profiler profiler(path, 1000, 0s);
+	profiler.start();
+
+	std::jthread worker([] {
+		Profiler::register_thread("short_lived");
+		burn(30ms);
+	});
+
+	worker.join();
+	profiler.stop();
+	ASSERT_GT(profiler.samples() + profiler.dropped(), 0);
+	std::filesystem::remove(path);
+}
+
+TEST(Profiler, WriteErrors) {
+	const auto path = std::filesystem::temp_directory_path() / "ember_no_such_dir" / "profile.folded";
+	std::vector<std::string> errors;
+
+	{
+		Profiler profiler(path, 100, 0s, [&](std::string_view error) {
+			errors.emplace_back(error);
+		});
+
+		profiler.start();
+		ASSERT_THROW(profiler.stop(), std::runtime_error);
+		ASSERT_FALSE(profiler.running());
+
+		// destruction has nowhere to throw to, so goes through the handler
+		profiler.start();
+	}
+
+	ASSERT_EQ(1, errors.size());
+}
+
+#endif
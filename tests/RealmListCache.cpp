@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <login/RealmList.h>
+#include <login/RealmListCache.h>
+#include <login/grunt/server/RealmList.h>
+#include <spark/buffers/DynamicBuffer.h>
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+
+namespace {
+
+using Region = dbc::Cfg_Categories::Region;
+
+const auto region_a = static_cast<Region>(1);
+const auto region_b = static_cast<Region>(2);
+
+Realm make_realm(const std::uint32_t id, const Region region) {
+	Realm realm{};
+	realm.id = id;
+	realm.name = "Realm " + std::to_string(id);
+	realm.address = "127.0.0.1:8085";
+	realm.population = 1.0f;
+	realm.type = Realm::Type::PvP;
+	realm.flags = Realm::Flags::NONE;
+	realm.category = static_cast<dbc::Cfg_Categories::Category>(1);
+	realm.region = region;
+	return realm;
+}
+
+std::vector<std::uint8_t> serialise(const grunt::Packet& packet) {
+	spark::io::DynamicBuffer<1024> buffer;
+	spark::io::pmr::BinaryStream stream(buffer);
+	packet.write_to_stream(stream);
+
+	std::vector<std::uint8_t> output(buffer.size());
+	buffer.read(output.data(), output.size());
+	return output;
+}
+
+} // unnamed
+
+TEST(RealmListCache, MatchesPacket) {
+	const std::vector<Realm> realms {
+		make_realm(3, region_a), make_realm(1, region_a), make_realm(2, region_b)
+	};
+
+	RealmList list(realms);
+	RealmListCache cache(list);
+	const std::unordered_map<std::uint32_t, std::uint32_t> counts { { 1, 4 }, { 3, 10 } };
+
+	grunt::server::RealmList expected;
+	expected.realms.emplace_back(realms[1], 4);
+	expected.realms.emplace_back(realms[0], 10);
+
+	const CachedRealmList cached(cache.get(region_a), counts);
+	ASSERT_EQ(serialise(expected), serialise(cached));
+
+	// every region
+	expected.realms.clear();
+	expected.realms.emplace_back(realms[1], 4);
+	expected.realms.emplace_back(realms[2], 0);
+	expected.realms.emplace_back(realms[0], 10);
+
+	const CachedRealmList all(cache.get(std::nullopt), counts);
+	ASSERT_EQ(serialise(expected), serialise(all));
+}
+
+TEST(RealmListCache, Empty) {
+	RealmList list;
+	RealmListCache cache(list);
+	const std::unordered_map<std::uint32_t, std::uint32_t> counts;
+
+	const grunt::server::RealmList expected;
+	const CachedRealmList cached(cache.get(region_a), counts);
+	ASSERT_EQ(serialise(expected), serialise(cached));
+}
+
+TEST(RealmListCache, Reuse) {
+	const std::vector<Realm> realms { make_realm(1, region_a) };
+	RealmList list(realms);
+	RealmListCache cache(list);
+
+	const auto first = cache.get(region_a);
+	ASSERT_EQ(first, cache.get(region_a));
+	ASSERT_NE(first, cache.get(region_b));
+}
+
+TEST(RealmListCache, Invalidation) {
+	const std::vector<Realm> realms { make_realm(1, region_a) };
+	RealmList list(realms);
+	RealmListCache cache(list);
+	const std::unordered_map<std::uint32_t, std::uint32_t> counts;
+
+	const auto before = cache.get(region_a);
+	ASSERT_EQ(1, before->slots.size());
+
+	auto realm = make_realm(2, region_a);
+	list.add_realm(realm);
+
+	const auto after = cache.get(region_a);
+	ASSERT_NE(before, after);
+	ASSERT_EQ(2, after->slots.size());
+
+	// bodies handed out before the update must remain usable
+	grunt::server::RealmList expected;
+	expected.realms.emplace_back(realms[0], 0);
+	const CachedRealmList cached(before, counts);
+	ASSERT_EQ(serialise(expected), serialise(cached));
+}
@@ -10,7 +10,10 @@
 #include <srp6/Server.h>
 #include <srp6/Client.h>
 #include <srp6/Generator.h>
+#include <srp6/detail/Modular.h>
+#include <botan/auto_rng.h>
 #include <botan/bigint.h>
+#include <botan/numthry.h>
 #include <array>
 #include <memory>
 #include <string>
@@ -223,4 +226,73 @@ TEST(srp6Regressions, SPad_VerifyKey) {
 	const Botan::BigInt sbytes(key.t.data(), key.t.size());
 	const Botan::BigInt correct_key("0xEE57F5996D4EEDFFDE38EE79492AB4A5E57CD25C3CE98B035D4BA9A7E05D56C0DAF0F30D9797C216");
 	EXPECT_EQ(correct_key, sbytes) << "Computed key incorrectly";
-}
\ No newline at end of file
+}
+
+TEST(srp6Regressions, PrecomputedEphemeral) {
+	const srp6::Generator gen(srp6::Generator::Group::_256_BIT);
+	const Botan::BigInt v("0x7E273DE8696FFC4F4E337D05B4B375BEB0DDE1569E8FA00A9886D8129BADA1F1");
+
+	const auto ephemeral = srp6::Server::generate_ephemeral(gen);
+	ASSERT_EQ(ephemeral.g_b, gen(ephemeral.b));
+
+	srp6::Server expected(gen, v, ephemeral.b);
+	srp6::Server server(gen, v, ephemeral);
+	ASSERT_EQ(expected.public_ephemeral(), server.public_ephemeral());
+
+	const Botan::BigInt A("0x61D5E490F6F1B79547B0704C436F523DD0E560F0C64115BB72557EC44352E890");
+	ASSERT_EQ(expected.session_key(A).t, server.session_key(A).t);
+}
+
+TEST(srp6FixedBase, MatchesPowerMod) {
+	Botan::AutoSeeded_RNG rng;
+
+	for(auto group : { srp6::Generator::Group::_256_BIT, srp6::Generator::Group::_1024_BIT }) {
+		const srp6::Generator gen(group, 256);
+
+		for(int i = 0; i < 32; ++i) {
+			const Botan::BigInt x(rng, 256);
+			ASSERT_EQ(Botan::power_mod(gen.generator(), x, gen.prime()), gen(x));
+		}
+
+		ASSERT_EQ(Botan::BigInt(1), gen(Botan::BigInt(0)));
+		ASSERT_EQ(gen.generator(), gen(Botan::BigInt(1)));
+
+		// wider than the table, should fall back to the generic path
+		const Botan::BigInt wide(rng, 512);
+		ASSERT_EQ(Botan::power_mod(gen.generator(), wide, gen.prime()), gen(wide));
+	}
+}
+
+TEST(srp6FixedBase, RFC5054_TestVectors) {
+	const srp6::Generator gen(srp6::Generator::Group::_1024_BIT, 256);
+
+	Botan::BigInt v("0x7E273DE8696FFC4F4E337D05B4B375BEB0DDE1569E8FA00A9886D8129BADA1F1822"
+	                "223CA1A605B530E379BA4729FDC59F105B4787E5186F5C671085A1447B52A48CF1970"
+	                "B4FB6F8400BBF4CEBFBB168152E08AB5EA53D15C1AFF87B2B9DA6E04E058AD51CC72B"
+	                "FC9033B564E26480D78E955A5E29E7AB245DB2BE315E2099AFB");
+	Botan::BigInt test_b("0xE487CB59D31AC550471E81F00F6928E01DDA08E974A004F49E61F5D105284D20");
+
+	srp6::Server server(gen, v, test_b, true);
+
+	Botan::BigInt expected_B("0xBD0C61512C692C0CB6D041FA01BB152D4916A1E77AF46AE105393011"
+	                         "BAF38964DC46A0670DD125B95A981652236F99D9B681CBF87837EC99"
+	                         "6C6DA04453728610D0C6DDB58B318885D7D82C7F8DEB75CE7BD4FBAA"
+	                         "37089E6F9C6059F388838E7A00030B331EB76840910440B1B27AAEAE"
+	                         "EB4012B7D7665238A8E3FB004B117B58");
+	ASSERT_EQ(expected_B, server.public_ephemeral());
+}
+
+TEST(srp6FixedBase, ModularContextSwitch) {
+	const srp6::Generator small(srp6::Generator::Group::_256_BIT);
+	const srp6::Generator large(srp6::Generator::Group::_1024_BIT);
+	const Botan::BigInt base(12345), exp(67890);
+
+	// alternating moduli must not reuse a stale per-thread context
+	for(int i = 0; i < 4; ++i) {
+		const auto& gen = (i % 2)? small : large;
+		ASSERT_EQ(Botan::power_mod(base, exp, gen.prime()),
+		          srp6::detail::power_mod(base, exp, gen.prime()));
+		ASSERT_EQ((base * exp) % gen.prime(),
+		          srp6::detail::multiply_mod(base, exp, gen.prime()));
+	}
+}
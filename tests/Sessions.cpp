@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <account/Sessions.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<std::uint8_t> make_key(const std::uint32_t seed, const std::size_t size = Sessions::KEY_SIZE) {
+	std::vector<std::uint8_t> key(size);
+
+	for(std::size_t i = 0; i < size; ++i) {
+		key[i] = static_cast<std::uint8_t>(seed + i + 1);
+	}
+
+	return key;
+}
+
+bool matches(const Sessions::Key& stored, const std::vector<std::uint8_t>& key) {
+	return std::equal(key.rbegin(), key.rend(), stored.rbegin());
+}
+
+} // unnamed
+
+TEST(Sessions, RegisterLookup) {
+	Sessions sessions(false);
+	const auto key = make_key(1);
+	ASSERT_FALSE(sessions.lookup_session(1));
+	ASSERT_TRUE(sessions.register_session(1, key));
+
+	const auto stored = sessions.lookup_session(1);
+	ASSERT_TRUE(stored);
+	ASSERT_TRUE(matches(*stored, key));
+	ASSERT_FALSE(sessions.lookup_session(2));
+}
+
+TEST(Sessions, Overwrite) {
+	Sessions strict(false);
+	ASSERT_TRUE(strict.register_session(1, make_key(1)));
+	ASSERT_FALSE(strict.register_session(1, make_key(2)));
+	ASSERT_TRUE(matches(*strict.lookup_session(1), make_key(1)));
+
+	Sessions lenient(true);
+	ASSERT_TRUE(lenient.register_session(1, make_key(1)));
+	ASSERT_TRUE(lenient.register_session(1, make_key(2)));
+	ASSERT_TRUE(matches(*lenient.lookup_session(1), make_key(2)));
+	ASSERT_EQ(1, lenient.size());
+}
+
+TEST(Sessions, KeySize) {
+	Sessions sessions(true);
+
+	// short keys are padded, leading zeroes don't count towards the size
+	const auto short_key = make_key(1, 32);
+	ASSERT_TRUE(sessions.register_session(1, short_key));
+	const auto stored = sessions.lookup_session(1);
+	ASSERT_TRUE(matches(*stored, short_key));
+	ASSERT_EQ(0, (*stored)[0]);
+
+	auto padded = make_key(2);
+	padded.insert(padded.begin(), 4, 0);
+	ASSERT_TRUE(sessions.register_session(2, padded));
+	ASSERT_TRUE(matches(*sessions.lookup_session(2), make_key(2)));
+
+	ASSERT_FALSE(sessions.register_session(3, make_key(3, Sessions::KEY_SIZE + 1)));
+	ASSERT_FALSE(sessions.register_session(0, make_key(4)));
+}
+
+TEST(Sessions, Expiry) {
+	Sessions sessions(false, 50ms);
+	ASSERT_TRUE(sessions.register_session(1, make_key(1)));
+	ASSERT_TRUE(sessions.lookup_session(1));
+	std::this_thread::sleep_for(100ms);
+
+	// expired sessions are gone straight away and can be replaced without overwrites
+	ASSERT_FALSE(sessions.lookup_session(1));
+	ASSERT_EQ(1, sessions.purge_expired());
+	ASSERT_EQ(0, sessions.size());
+	ASSERT_TRUE(sessions.register_session(1, make_key(2)));
+	ASSERT_TRUE(matches(*sessions.lookup_session(1), make_key(2)));
+}
+
+TEST(Sessions, Growth) {
+	constexpr std::uint32_t count = 50000;
+	Sessions sessions(false);
+
+	for(std::uint32_t i = 1; i <= count; ++i) {
+		ASSERT_TRUE(sessions.register_session(i, make_key(i)));
+	}
+
+	ASSERT_EQ(count, sessions.size());
+
+	for(std::uint32_t i = 1; i <= count; ++i) {
+		const auto stored = sessions.lookup_session(i);
+		ASSERT_TRUE(stored);
+		ASSERT_TRUE(matches(*stored, make_key(i)));
+	}
+}
+
+TEST(Sessions, Snapshot) {
+	const auto path = std::filesystem::temp_directory_path() / "ember_sessions_test.bin";
+
+	{
+		Sessions sessions(false, 1h);
+
+		for(std::uint32_t i = 1; i <= 100; ++i) {
+			ASSERT_TRUE(sessions.register_session(i, make_key(i)));
+		}
+
+		sessions.save(path);
+	}
+
+	Sessions sessions(false, 1h);
+	ASSERT_EQ(100, sessions.load(path));
+	ASSERT_EQ(100, sessions.size());
+
+	for(std::uint32_t i = 1; i <= 100; ++i) {
+		ASSERT_TRUE(matches(*sessions.lookup_session(i), make_key(i)));
+	}
+
+	std::filesystem::remove(path);
+	ASSERT_EQ(0, Sessions(false).load(path));
+}
+
+TEST(Sessions, ConcurrentReads) {
+	constexpr std::uint32_t count = 10000;
+	Sessions sessions(true);
+	std::atomic_bool done = false;
+	std::atomic_bool torn = false;
+
+	for(std::uint32_t i = 1; i <= count; ++i) {
+		sessions.register_session(i, make_key(i));
+	}
+
+	std::vector<std::jthread> readers;
+
+	for(auto t = 0; t < 4; ++t) {
+		readers.emplace_back([&] {
+			while(!done) {
+				for(std::uint32_t i = 1; i <= count; ++i) {
+					const auto stored = sessions.lookup_session(i);
+
+					// every key written is either the original or a replacement, never a mix
+					if(!stored || (!matches(*stored, make_key(i)) && !matches(*stored, make_key(i + count)))) {
+						torn = true;
+					}
+				}
+			}
+		});
+	}
+
+	// replacing keys and adding new accounts while being read, the latter forcing rebuilds
+	for(std::uint32_t i = 1; i <= count; ++i) {
+		sessions.register_session(i, make_key(i + count));
+		sessions.register_session(i + count, make_key(i + count * 2));
+	}
+
+	done = true;
+	readers.clear();
+	ASSERT_FALSE(torn);
+	ASSERT_EQ(count * 2, sessions.size());
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/threading/ThreadPool.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <vector>
+
+using namespace ember;
+
+TEST(ThreadPool, RunAll) {
+	constexpr auto iterations = 10000;
+	std::atomic_int counter = 0;
+	std::latch done(iterations);
+
+	ThreadPool pool(4);
+
+	for(auto i = 0; i < iterations; ++i) {
+		pool.run([&] {
+			++counter;
+			done.count_down();
+		});
+	}
+
+	done.wait();
+	ASSERT_EQ(counter, iterations);
+	ASSERT_EQ(pool.stats().executed, iterations);
+}
+
+TEST(ThreadPool, MoveOnlyWork) {
+	std::binary_semaphore done(0);
+	auto value = std::make_unique<int>(42);
+	int result = 0;
+
+	ThreadPool pool(1);
+
+	pool.run([&, value = std::move(value)] {
+		result = *value;
+		done.release();
+	});
+
+	done.acquire();
+	ASSERT_EQ(result, 42);
+}
+
+TEST(ThreadPool, PriorityOrder) {
+	std::binary_semaphore blocked(0), started(0);
+	std::latch done(3);
+	std::mutex lock;
+	std::vector<ThreadPool::Priority> order;
+
+	ThreadPool pool(1);
+
+	// occupy the only worker so the remaining work queues up behind it
+	pool.run([&] {
+		started.release();
+		blocked.acquire();
+	});
+
+	started.acquire();
+
+	for(auto priority : { ThreadPool::Priority::LOW, ThreadPool::Priority::NORMAL,
+	                      ThreadPool::Priority::HIGH }) {
+		pool.run([&, priority] {
+			std::lock_guard guard(lock);
+			order.emplace_back(priority);
+			done.count_down();
+		}, priority);
+	}
+
+	ASSERT_EQ(pool.stats().queued[0], 1);
+	blocked.release();
+	done.wait();
+
+	ASSERT_EQ(order.size(), 3);
+	ASSERT_EQ(order[0], ThreadPool::Priority::HIGH);
+	ASSERT_EQ(order[1], ThreadPool::Priority::NORMAL);
+	ASSERT_EQ(order[2], ThreadPool::Priority::LOW);
+}
+
+TEST(ThreadPool, BoundedAdmission) {
+	std::binary_semaphore blocked(0), started(0);
+	std::latch done(2);
+
+	ThreadPool pool(1, 2);
+
+	pool.run([&] {
+		started.release();
+		blocked.acquire();
+	});
+
+	started.acquire();
+
+	ASSERT_TRUE(pool.try_run([&] { done.count_down(); }));
+	ASSERT_TRUE(pool.try_run([&] { done.count_down(); }));
+	ASSERT_FALSE(pool.try_run([&] { done.count_down(); }));
+	ASSERT_EQ(pool.stats().rejected, 1);
+
+	blocked.release();
+	done.wait();
+}
+
+TEST(ThreadPool, Stealing) {
+	constexpr auto workers = 4;
+	std::latch all_running(workers);
+	std::atomic_int counter = 0;
+
+	ThreadPool pool(workers);
+
+	// every task is posted from a single worker, so completing requires stealing
+	pool.run([&] {
+		for(auto i = 0; i < workers; ++i) {
+			pool.run([&] {
+				++counter;
+				all_running.arrive_and_wait();
+			});
+		}
+	});
+
+	all_running.wait();
+	ASSERT_EQ(counter, workers);
+	ASSERT_GT(pool.stats().stolen, 0);
+}
@@ -6,11 +6,13 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/.
 */
 
+#include <shared/threading/Topology.h>
 #include <shared/threading/Utility.h>
 #include <gtest/gtest.h>
 #include <semaphore>
 #include <string>
 #include <thread>
+#include <vector>
 #include <cstring>
 
 using namespace ember;
@@ -70,3 +72,76 @@ TEST(ThreadUtility, NameTooLongBoundary) {
 TEST(ThreadUtility, NameTooLong) {
 	ASSERT_ANY_THROW(thread::set_name("This thread name is far too long to be valid"));
 }
+
+// two packages, two cores per package, two threads per core
+static thread::Topology dual_socket() {
+	return thread::Topology({
+		{ .id = 0, .core = 0, .package = 0, .node = 0, .isolated = false },
+		{ .id = 1, .core = 1, .package = 0, .node = 0, .isolated = false },
+		{ .id = 2, .core = 2, .package = 1, .node = 1, .isolated = false },
+		{ .id = 3, .core = 3, .package = 1, .node = 1, .isolated = true },
+		{ .id = 4, .core = 0, .package = 0, .node = 0, .isolated = false },
+		{ .id = 5, .core = 1, .package = 0, .node = 0, .isolated = false },
+		{ .id = 6, .core = 2, .package = 1, .node = 1, .isolated = false },
+		{ .id = 7, .core = 3, .package = 1, .node = 1, .isolated = true },
+	});
+}
+
+TEST(ThreadPlacement, ParseCPUList) {
+	const std::vector<unsigned int> expected { 0, 1, 2, 3, 8, 10, 11 };
+	ASSERT_EQ(thread::parse_cpu_list("0-3,8,10-11"), expected);
+	ASSERT_EQ(thread::parse_cpu_list(" 0-3, 8 ,10-11\n"), expected);
+	ASSERT_TRUE(thread::parse_cpu_list("").empty());
+	ASSERT_ANY_THROW(thread::parse_cpu_list("3-1"));
+	ASSERT_ANY_THROW(thread::parse_cpu_list("a-b"));
+}
+
+TEST(ThreadPlacement, PhysicalCores) {
+	const auto topology = dual_socket();
+	const std::vector<unsigned int> expected { 0, 1, 2, 3 };
+	ASSERT_EQ(topology.physical_cores(), expected);
+	ASSERT_EQ(topology.node_count(), 2);
+}
+
+TEST(ThreadPlacement, PlanPhysicalCores) {
+	const thread::PlacementConfig config { .mode = thread::PlacementMode::physical_cores };
+	const auto layout = thread::plan_placement(dual_socket(), config, 4);
+	
+	// CPU 3 is isolated, so the layout wraps around the remaining cores
+	const std::vector<unsigned int> expected { 0, 1, 2, 0 };
+	ASSERT_EQ(layout, expected);
+}
+
+TEST(ThreadPlacement, PlanRoundRobinExclude) {
+	const thread::PlacementConfig config {
+		.mode = thread::PlacementMode::round_robin,
+		.exclude = { 0, 4 }
+	};
+
+	const auto layout = thread::plan_placement(dual_socket(), config, 4);
+	const std::vector<unsigned int> expected { 1, 2, 5, 6 };
+	ASSERT_EQ(layout, expected);
+}
+
+TEST(ThreadPlacement, PlanCPUList) {
+	const thread::PlacementConfig config {
+		.mode = thread::PlacementMode::cpu_list,
+		.cpus = { 3, 7 }
+	};
+
+	const auto layout = thread::plan_placement(dual_socket(), config, 3);
+	const std::vector<unsigned int> expected { 3, 7, 3 };
+	ASSERT_EQ(layout, expected);
+
+	const thread::PlacementConfig bad_config {
+		.mode = thread::PlacementMode::cpu_list,
+		.cpus = { 64 }
+	};
+
+	ASSERT_ANY_THROW(thread::plan_placement(dual_socket(), bad_config, 1));
+}
+
+TEST(ThreadPlacement, PlanNone) {
+	const thread::PlacementConfig config { .mode = thread::PlacementMode::none };
+	ASSERT_TRUE(thread::plan_placement(dual_socket(), config, 4).empty());
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/threading/TimingWheel.h>
+#include <gtest/gtest.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+namespace {
+
+TimingWheel& make_wheel(boost::asio::io_context& ctx) {
+	auto wheel = new TimingWheel(ctx, 1ms);
+	boost::asio::add_service(ctx, wheel);
+	return *wheel;
+}
+
+} // unnamed
+
+TEST(TimingWheel, Expiry) {
+	boost::asio::io_context ctx;
+	auto& wheel = make_wheel(ctx);
+	ASSERT_EQ(&wheel, &TimingWheel::get(ctx));
+
+	TimingWheel::clock::time_point expired;
+	const auto start = TimingWheel::clock::now();
+	auto handle = wheel.schedule(20ms, [&] { expired = TimingWheel::clock::now(); });
+	ASSERT_TRUE(handle.active());
+	ASSERT_EQ(1, wheel.size());
+
+	// the wheel stops ticking once empty, so run() returning means it's idle
+	ctx.run();
+	ASSERT_GE(expired - start, 20ms);
+	ASSERT_FALSE(handle.active());
+	ASSERT_EQ(0, wheel.size());
+}
+
+TEST(TimingWheel, Touch) {
+	boost::asio::io_context ctx;
+	auto& wheel = make_wheel(ctx);
+	bool expired = false;
+	auto handle = wheel.schedule(30ms, [&] { expired = true; });
+
+	boost::asio::steady_timer timer(ctx);
+	auto remaining = 10;
+	const auto start = TimingWheel::clock::now();
+
+	// keep the entry active for far longer than its timeout
+	std::function<void()> keep_alive = [&] {
+		timer.expires_after(10ms);
+		timer.async_wait([&](const boost::system::error_code&) {
+			ASSERT_FALSE(expired);
+			handle.touch();
+
+			if(--remaining) {
+				keep_alive();
+			}
+		});
+	};
+
+	keep_alive();
+	ctx.run();
+	ASSERT_TRUE(expired);
+	ASSERT_GE(TimingWheel::clock::now() - start, 130ms);
+}
+
+TEST(TimingWheel, Cancel) {
+	boost::asio::io_context ctx;
+	auto& wheel = make_wheel(ctx);
+	auto count = 0;
+
+	auto cancelled = wheel.schedule(10ms, [&] { ++count; });
+	auto replaced = wheel.schedule(10ms, [&] { ++count; });
+	auto kept = wheel.schedule(10ms, [&] { ++count; });
+
+	{
+		auto destroyed = wheel.schedule(10ms, [&] { ++count; });
+	}
+
+	cancelled.cancel();
+	ASSERT_FALSE(cancelled.active());
+	replaced = TimingWheel::Handle();
+	ASSERT_FALSE(replaced.active());
+
+	ctx.run();
+	ASSERT_EQ(1, count);
+	ASSERT_EQ(0, wheel.size());
+}
+
+TEST(TimingWheel, BeyondHorizon) {
+	boost::asio::io_context ctx;
+	auto& wheel = make_wheel(ctx);
+
+	// with a 1ms tick, this wraps around the wheel before expiring
+	const auto timeout = TimingWheel::SLOTS * 1ms + 100ms;
+	const auto start = TimingWheel::clock::now();
+	TimingWheel::clock::time_point expired;
+	auto handle = wheel.schedule(timeout, [&] { expired = TimingWheel::clock::now(); });
+
+	ctx.run();
+	ASSERT_GE(expired - start, timeout);
+}
+
+TEST(TimingWheel, Batch) {
+	boost::asio::io_context ctx;
+	auto& wheel = make_wheel(ctx);
+	std::vector<TimingWheel::Handle> handles;
+	auto count = 0;
+
+	for(auto i = 0; i < 10000; ++i) {
+		handles.emplace_back(wheel.schedule(5ms + (i % 20) * 1ms, [&] { ++count; }));
+	}
+
+	ASSERT_EQ(10000, wheel.size());
+	ctx.run();
+	ASSERT_EQ(10000, count);
+	ASSERT_EQ(0, wheel.size());
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <shared/database/WriteBehind.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Record {
+	std::uint32_t id;
+	std::string value;
+};
+
+struct Sink {
+	std::mutex lock;
+	std::vector<std::vector<Record>> batches;
+	std::counting_semaphore<> written { 0 };
+	int failures = 0;
+	std::optional<std::uint32_t> reject;
+
+	void write(std::span<const Record> batch) {
+		std::lock_guard guard(lock);
+
+		if(failures) {
+			--failures;
+			throw std::runtime_error("write failed");
+		}
+
+		for(const auto& record : batch) {
+			if(record.id == reject) {
+				throw std::runtime_error("bad record");
+			}
+		}
+
+		batches.emplace_back(batch.begin(), batch.end());
+		written.release();
+	}
+
+	std::size_t total() {
+		std::lock_guard guard(lock);
+		std::size_t total = 0;
+
+		for(const auto& batch : batches) {
+			total += batch.size();
+		}
+
+		return total;
+	}
+};
+
+using Queue = dal::WriteBehind<std::uint32_t, Record>;
+
+} // unnamed
+
+TEST(WriteBehind, Coalesce) {
+	Sink sink;
+
+	{
+		Queue queue([&](auto batch) { sink.write(batch); }, 100, 1h);
+		queue.push(1, { 1, "first" });
+		queue.push(2, { 2, "second" });
+		queue.push(1, { 1, "third" });
+
+		const auto stats = queue.stats();
+		ASSERT_EQ(2, stats.queued);
+		ASSERT_EQ(1, stats.coalesced);
+		ASSERT_TRUE(sink.batches.empty());
+	}
+
+	// written on destruction, with the newer record taking the original's place
+	ASSERT_EQ(1, sink.batches.size());
+	ASSERT_EQ(2, sink.batches[0].size());
+	ASSERT_EQ("third", sink.batches[0][0].value);
+	ASSERT_EQ("second", sink.batches[0][1].value);
+}
+
+TEST(WriteBehind, BatchSize) {
+	Sink sink;
+	Queue queue([&](auto batch) { sink.write(batch); }, 10, 1h);
+
+	for(std::uint32_t i = 0; i < 10; ++i) {
+		queue.push(i, { i, "" });
+	}
+
+	// reaching the batch size should wake the writer long before the interval
+	ASSERT_TRUE(sink.written.try_acquire_for(5s));
+	ASSERT_EQ(10, sink.total());
+	ASSERT_EQ(1, sink.batches.size());
+}
+
+TEST(WriteBehind, Interval) {
+	Sink sink;
+	Queue queue([&](auto batch) { sink.write(batch); }, 100, 10ms);
+	queue.push(1, { 1, "" });
+	ASSERT_TRUE(sink.written.try_acquire_for(5s));
+	ASSERT_EQ(1, sink.total());
+}
+
+TEST(WriteBehind, Chunking) {
+	Sink sink;
+	Queue queue([&](auto batch) { sink.write(batch); }, 4, 1h);
+
+	for(std::uint32_t i = 0; i < 10; ++i) {
+		queue.push(i, { i, "" });
+	}
+
+	queue.flush();
+	ASSERT_EQ(10, sink.total());
+	ASSERT_EQ(0, queue.stats().queued);
+
+	for(const auto& batch : sink.batches) {
+		ASSERT_LE(batch.size(), 4);
+	}
+}
+
+TEST(WriteBehind, Retry) {
+	Sink sink;
+	sink.failures = 1;
+	std::vector<std::string> errors;
+
+	Queue queue([&](auto batch) { sink.write(batch); }, 100, 1h,
+	            [&](std::string_view error) { errors.emplace_back(error); });
+
+	queue.push(1, { 1, "" });
+	ASSERT_THROW(queue.flush(), std::runtime_error);
+	ASSERT_EQ(1, errors.size());
+	ASSERT_EQ(1, queue.stats().queued);
+	ASSERT_EQ(1, queue.stats().failed);
+
+	// requeued record should go out with the next batch
+	queue.push(2, { 2, "" });
+	queue.flush();
+	ASSERT_EQ(2, sink.total());
+	ASSERT_EQ(0, queue.stats().queued);
+}
+
+TEST(WriteBehind, Drop) {
+	Sink sink;
+	sink.failures = Queue::MAX_ATTEMPTS;
+	Queue queue([&](auto batch) { sink.write(batch); }, 100, 1h);
+	queue.push(1, { 1, "" });
+
+	for(auto i = 0; i < Queue::MAX_ATTEMPTS; ++i) {
+		ASSERT_THROW(queue.flush(), std::runtime_error);
+	}
+
+	const auto stats = queue.stats();
+	ASSERT_EQ(0, stats.queued);
+	ASSERT_EQ(1, stats.dropped);
+	ASSERT_EQ(0, sink.total());
+}
+
+// a record the database rejects shouldn't take the rest of its chunk with it
+TEST(WriteBehind, Isolation) {
+	Sink sink;
+	sink.reject = 5;
+	Queue queue([&](auto batch) { sink.write(batch); }, 100, 1h);
+
+	for(std::uint32_t i = 0; i < 10; ++i) {
+		queue.push(i, { i, "" });
+	}
+
+	ASSERT_THROW(queue.flush(), std::runtime_error);
+	ASSERT_EQ(9, sink.total());
+	ASSERT_EQ(1, queue.stats().queued);
+
+	for(auto i = 1; i < Queue::MAX_ATTEMPTS; ++i) {
+		ASSERT_THROW(queue.flush(), std::runtime_error);
+	}
+
+	const auto stats = queue.stats();
+	ASSERT_EQ(0, stats.queued);
+	ASSERT_EQ(1, stats.dropped);
+	ASSERT_EQ(9, stats.written);
+}
+
+// if nothing gets through, the rest of the batch shouldn't be penalised
+TEST(WriteBehind, Outage) {
+	Sink sink;
+	sink.failures = 1 + Queue::MAX_ISOLATION_FAILURES;
+	Queue queue([&](auto batch) { sink.write(batch); }, 100, 1h);
+
+	for(std::uint32_t i = 0; i < 10; ++i) {
+		queue.push(i, { i, "" });
+	}
+
+	ASSERT_THROW(queue.flush(), std::runtime_error);
+	ASSERT_EQ(0, sink.total());
+	ASSERT_EQ(10, queue.stats().queued);
+
+	queue.flush();
+	ASSERT_EQ(10, sink.total());
+	ASSERT_EQ(0, queue.stats().dropped);
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+#include <conpool/ConnectionPool.h>
+#include <conpool/Policies.h>
+#include <conpool/drivers/DummyDriver.h>
+#include <chrono>
+#include <cstddef>
+
+using namespace ember;
+using namespace std::chrono_literals;
+namespace ep = connection_pool;
+
+namespace {
+
+using DummyPool = ep::Pool<drivers::DummyDriver, ep::CheckinClean, ep::ExponentialGrowth>;
+
+// shared by every benchmark thread, so has to outlive any single run
+template<std::size_t connections>
+DummyPool& pool() {
+	static drivers::DummyDriver driver;
+	static DummyPool pool(driver, connections, connections, 30s);
+	return pool;
+}
+
+// stand-in for the time spent running a short query
+void query(const std::int64_t iterations) {
+	for(std::int64_t i = 0; i < iterations; ++i) {
+		benchmark::DoNotOptimize(i);
+	}
+}
+
+} // unnamed
+
+template<std::size_t connections>
+static void pool_acquire(benchmark::State& state) {
+	auto& conpool = pool<connections>();
+
+	for(auto _ : state) {
+		auto conn = conpool.try_acquire_for(5s);
+		query(state.range(0));
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(pool_acquire<8>)->Arg(0)->Arg(500)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(pool_acquire<32>)->Arg(0)->Arg(500)->ThreadRange(1, 64)->UseRealTime();
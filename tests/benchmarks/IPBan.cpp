@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+#include <shared/IPBanCache.h>
+#include <boost/asio/ip/address.hpp>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace ember;
+namespace bai = boost::asio::ip;
+
+namespace {
+
+struct Bans {
+	std::vector<IPEntry> entries;
+	std::vector<bai::address> probes;
+};
+
+// mostly narrow ranges, as you'd expect to see after banning abusive hosts
+Bans generate(const std::size_t count, const bool ipv6) {
+	std::mt19937_64 gen(count);
+	std::uniform_int_distribution<std::uint32_t> v4_cidr(16, 32);
+	std::uniform_int_distribution<std::uint32_t> v6_cidr(32, 128);
+	Bans bans;
+
+	for(std::size_t i = 0; i < count; ++i) {
+		if(ipv6) {
+			bai::address_v6::bytes_type bytes;
+
+			for(auto& byte : bytes) {
+				byte = static_cast<std::uint8_t>(gen());
+			}
+
+			bans.entries.emplace_back(bai::address_v6(bytes).to_string(), v6_cidr(gen));
+		} else {
+			const auto address = bai::make_address_v4(static_cast<std::uint32_t>(gen()));
+			bans.entries.emplace_back(address.to_string(), v4_cidr(gen));
+		}
+	}
+
+	for(auto i = 0; i < 1024; ++i) {
+		if(ipv6) {
+			bai::address_v6::bytes_type bytes;
+
+			for(auto& byte : bytes) {
+				byte = static_cast<std::uint8_t>(gen());
+			}
+
+			bans.probes.emplace_back(bai::address_v6(bytes));
+		} else {
+			bans.probes.emplace_back(bai::make_address_v4(static_cast<std::uint32_t>(gen())));
+		}
+	}
+
+	return bans;
+}
+
+// the previous implementation, checking every entry in turn
+struct LinearScan {
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> entries;
+
+	explicit LinearScan(const std::vector<IPEntry>& bans) {
+		for(const auto& [ip, cidr] : bans) {
+			const auto mask = cidr? (~0U) << (32 - cidr) : 0U;
+			entries.emplace_back(bai::make_address_v4(ip).to_uint(), mask);
+		}
+	}
+
+	bool is_banned(const bai::address_v4& ip) const {
+		const auto value = ip.to_uint();
+
+		for(const auto& [range, mask] : entries) {
+			if((value & mask) == (range & mask)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+};
+
+} // unnamed
+
+static void ipban_lookup_v4(benchmark::State& state) {
+	const auto bans = generate(state.range(0), false);
+	const IPBanCache cache(bans.entries);
+	std::size_t i = 0;
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(cache.is_banned(bans.probes[i++ % bans.probes.size()]));
+	}
+}
+
+static void ipban_lookup_v6(benchmark::State& state) {
+	const auto bans = generate(state.range(0), true);
+	const IPBanCache cache(bans.entries);
+	std::size_t i = 0;
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(cache.is_banned(bans.probes[i++ % bans.probes.size()]));
+	}
+}
+
+static void ipban_lookup_v4_linear(benchmark::State& state) {
+	const auto bans = generate(state.range(0), false);
+	const LinearScan scan(bans.entries);
+	std::size_t i = 0;
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(scan.is_banned(bans.probes[i++ % bans.probes.size()].to_v4()));
+	}
+}
+
+static void ipban_reload(benchmark::State& state) {
+	const auto bans = generate(state.range(0), state.range(1));
+	IPBanCache cache;
+
+	for(auto _ : state) {
+		cache.reload(bans.entries);
+	}
+
+	state.SetItemsProcessed(state.iterations() * bans.entries.size());
+}
+
+BENCHMARK(ipban_lookup_v4)->Arg(1'000)->Arg(100'000)->Arg(1'000'000);
+BENCHMARK(ipban_lookup_v6)->Arg(1'000)->Arg(100'000)->Arg(1'000'000);
+BENCHMARK(ipban_lookup_v4_linear)->Arg(1'000)->Arg(100'000);
+BENCHMARK(ipban_reload)->ArgsProduct({{ 100'000 }, { 0, 1 }})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+#include <shared/utility/PCREHelper.h>
+#include <shared/utility/PatternSet.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <pcre.h>
+
+using namespace ember;
+
+namespace {
+
+std::string random_word(std::mt19937& rng, const std::size_t min, const std::size_t max) {
+	std::uniform_int_distribution<std::size_t> length(min, max);
+	std::uniform_int_distribution<int> letter('a', 'z');
+	std::string word(length(rng), ' ');
+
+	for(auto& c : word) {
+		c = static_cast<char>(letter(rng));
+	}
+
+	return word;
+}
+
+// roughly the mix of prefix, substring and whole word patterns found in NamesProfanity
+std::vector<std::string> patterns(const std::size_t count) {
+	std::mt19937 rng(count);
+	std::vector<std::string> patterns;
+
+	for(std::size_t i = 0; i < count; ++i) {
+		const auto word = random_word(rng, 4, 8);
+
+		switch(i % 3) {
+			case 0:
+				patterns.emplace_back("^" + word);
+				break;
+			case 1:
+				patterns.emplace_back(word);
+				break;
+			default:
+				patterns.emplace_back(R"(\<)" + word + R"(\>)");
+		}
+	}
+
+	return patterns;
+}
+
+// names that pass, the common case and the one that has to try every pattern
+std::vector<std::string> names() {
+	std::mt19937 rng(0);
+	std::vector<std::string> names;
+
+	for(auto i = 0; i < 64; ++i) {
+		auto name = random_word(rng, 4, 12);
+		name[0] -= 'a' - 'A';
+		names.emplace_back(std::move(name));
+	}
+
+	return names;
+}
+
+} // unnamed
+
+static void name_filter_individual(benchmark::State& state) {
+	std::vector<util::pcre::Result> regexes;
+
+	for(const auto& pattern : patterns(state.range(0))) {
+		regexes.emplace_back(util::pcre::utf8_jit_compile(pattern));
+	}
+
+	const auto candidates = names();
+	std::size_t i = 0;
+
+	for(auto _ : state) {
+		const auto& name = candidates[i++ % candidates.size()];
+		int ret = PCRE_ERROR_NOMATCH;
+
+		for(const auto& regex : regexes) {
+			ret = util::pcre::match(name, regex);
+
+			if(ret != PCRE_ERROR_NOMATCH) {
+				break;
+			}
+		}
+
+		benchmark::DoNotOptimize(ret);
+	}
+}
+
+static void name_filter_set(benchmark::State& state) {
+	const util::pcre::PatternSet set(patterns(state.range(0)));
+	const auto candidates = names();
+	std::size_t i = 0;
+
+	for(auto _ : state) {
+		auto ret = set.match(candidates[i++ % candidates.size()]);
+		benchmark::DoNotOptimize(ret);
+	}
+
+	state.counters["expressions"] = static_cast<double>(set.expressions());
+}
+
+static void name_filter_compile(benchmark::State& state) {
+	const auto list = patterns(state.range(0));
+
+	for(auto _ : state) {
+		util::pcre::PatternSet set(list);
+		benchmark::DoNotOptimize(set);
+	}
+}
+
+BENCHMARK(name_filter_individual)->Arg(100)->Arg(1000)->Arg(5000);
+BENCHMARK(name_filter_set)->Arg(100)->Arg(1000)->Arg(5000);
+BENCHMARK(name_filter_compile)->Arg(1000)->Arg(5000)->Unit(benchmark::kMillisecond);
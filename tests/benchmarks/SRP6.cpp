@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+#include <srp6/Client.h>
+#include <srp6/Generator.h>
+#include <srp6/Server.h>
+#include <srp6/Util.h>
+#include <botan/bigint.h>
+#include <botan/numthry.h>
+#include <array>
+#include <string>
+
+using namespace ember;
+
+namespace {
+
+const Botan::BigInt rfc_v("0x7E273DE8696FFC4F4E337D05B4B375BEB0DDE1569E8FA00A9886D8129BADA1F1822"
+                          "223CA1A605B530E379BA4729FDC59F105B4787E5186F5C671085A1447B52A48CF1970"
+                          "B4FB6F8400BBF4CEBFBB168152E08AB5EA53D15C1AFF87B2B9DA6E04E058AD51CC72B"
+                          "FC9033B564E26480D78E955A5E29E7AB245DB2BE315E2099AFB");
+const Botan::BigInt rfc_a("0x60975527035CF2AD1989806F0407210BC81EDC04E2762A56AFD529DDDA2D4393");
+const Botan::BigInt rfc_b("0xE487CB59D31AC550471E81F00F6928E01DDA08E974A004F49E61F5D105284D20");
+
+srp6::Generator::Group group(const benchmark::State& state) {
+	return state.range(0) == 256? srp6::Generator::Group::_256_BIT
+	                            : srp6::Generator::Group::_1024_BIT;
+}
+
+// Game clients use the 256-bit group, RFC5054 vectors use the 1024-bit group
+struct Vectors {
+	srp6::Generator gen;
+	Botan::BigInt v, A, b;
+	srp6::Compliance mode;
+
+	Vectors(srp6::Generator::Group grp, std::size_t fixed_base_bits)
+		: gen(grp, fixed_base_bits) {
+		if(grp == srp6::Generator::Group::_1024_BIT) {
+			v = rfc_v;
+			A = gen(rfc_a);
+			b = rfc_b;
+			mode = srp6::Compliance::RFC5054;
+		} else {
+			std::array<std::uint8_t, 32> salt{};
+			srp6::generate_salt(salt);
+			v = srp6::generate_verifier("CHAOSVEX", "ABC", gen, salt, srp6::Compliance::GAME);
+			A = srp6::Client("CHAOSVEX", "ABC", gen).public_ephemeral();
+			b = rfc_b % gen.prime();
+			mode = srp6::Compliance::GAME;
+		}
+	}
+};
+
+} // unnamed
+
+static void ephemeral_power_mod(benchmark::State& state) {
+	const Vectors vec(group(state), 0);
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(Botan::power_mod(vec.gen.generator(), vec.b, vec.gen.prime()));
+	}
+}
+
+static void ephemeral_fixed_base(benchmark::State& state) {
+	const Vectors vec(group(state), 256);
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(vec.gen(vec.b));
+	}
+}
+
+static void session_key_reference(benchmark::State& state) {
+	const Vectors vec(group(state), 0);
+	const srp6::Server server(vec.gen, vec.v, vec.b);
+	const auto& N = vec.gen.prime();
+	const auto u = srp6::detail::scrambler(vec.A, server.public_ephemeral(), N.bytes(), vec.mode);
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(
+			Botan::power_mod(vec.A * Botan::power_mod(vec.v, u, N), vec.b, N)
+		);
+	}
+}
+
+static void session_key(benchmark::State& state) {
+	const Vectors vec(group(state), 256);
+	const srp6::Server server(vec.gen, vec.v, vec.b);
+
+	for(auto _ : state) {
+		benchmark::DoNotOptimize(server.session_key(vec.A, vec.mode));
+	}
+}
+
+// server side of a login: generate an ephemeral, derive the key & prove it
+static void server_handshake(benchmark::State& state) {
+	const Vectors vec(group(state), state.range(1)? 256 : 0);
+
+	for(auto _ : state) {
+		const srp6::Server server(vec.gen, vec.v);
+		const auto key = server.session_key(vec.A, vec.mode);
+		benchmark::DoNotOptimize(server.generate_proof(key, vec.A, vec.b));
+	}
+}
+
+BENCHMARK(ephemeral_power_mod)->Arg(256)->Arg(1024);
+BENCHMARK(ephemeral_fixed_base)->Arg(256)->Arg(1024);
+BENCHMARK(session_key_reference)->Arg(256)->Arg(1024);
+BENCHMARK(session_key)->Arg(256)->Arg(1024);
+BENCHMARK(server_handshake)->ArgsProduct({{ 256, 1024 }, { 0, 1 }});
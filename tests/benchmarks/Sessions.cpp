@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 Ember
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+#include <account/Sessions.h>
+#include <chrono>
+#include <cstdint>
+
+using namespace ember;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::uint32_t ACCOUNTS = 100000;
+constexpr Sessions::Key KEY { 0xAA, 0xBB, 0xCC, 0xDD };
+
+// shared by every benchmark thread, so has to outlive any single run
+Sessions& sessions() {
+	static Sessions sessions(true, 24h);
+
+	[[maybe_unused]] static const bool populated = [] {
+		for(std::uint32_t i = 1; i <= ACCOUNTS; ++i) {
+			sessions.register_session(i, KEY);
+		}
+
+		return true;
+	}();
+
+	return sessions;
+}
+
+// spreads each thread's accounts out so that they don't all start in the same shard
+std::uint32_t account_id(const benchmark::State& state, const std::uint32_t i) {
+	return ((i * 7919 + state.thread_index() * 104729) % ACCOUNTS) + 1;
+}
+
+} // unnamed
+
+static void session_lookup(benchmark::State& state) {
+	auto& store = sessions();
+	std::uint32_t i = 0;
+
+	for(auto _ : state) {
+		auto key = store.lookup_session(account_id(state, i++));
+		benchmark::DoNotOptimize(key);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+static void session_register(benchmark::State& state) {
+	auto& store = sessions();
+	std::uint32_t i = 0;
+
+	for(auto _ : state) {
+		auto result = store.register_session(account_id(state, i++), KEY);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+// one write for every range(0) reads, roughly a login for every few gateway authentications
+static void session_mixed(benchmark::State& state) {
+	auto& store = sessions();
+	const auto ratio = static_cast<std::uint32_t>(state.range(0));
+	std::uint32_t i = 0;
+
+	for(auto _ : state) {
+		const auto id = account_id(state, i++);
+
+		if(i % ratio == 0) {
+			auto result = store.register_session(id, KEY);
+			benchmark::DoNotOptimize(result);
+		} else {
+			auto key = store.lookup_session(id);
+			benchmark::DoNotOptimize(key);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(session_lookup)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(session_register)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(session_mixed)->Arg(4)->Arg(32)->ThreadRange(1, 64)->UseRealTime();